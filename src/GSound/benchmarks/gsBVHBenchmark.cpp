@@ -0,0 +1,789 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        benchmarks/gsBVHBenchmark.cpp
+ * Contents:    Ray tracing micro-benchmark and validation harness for the Om BVH
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+#include "gsBenchmarkScenes.h"
+#include "gsBenchmarkReport.h"
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Triangle Geometry Classes
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// A BVH geometry interface for the unprocessed triangles of a benchmark scene.
+/**
+  * The geometry reports the TRIANGLES primitive type, so that the BVH uses
+  * its cached triangle fast path, the same one that is used for sound meshes.
+  */
+class TriangleGeometry : public BVHGeometry
+{
+	public:
+		
+		GSOUND_INLINE TriangleGeometry( const BenchmarkScene& newScene )
+			:	scene( newScene )
+		{
+		}
+		
+		
+		virtual BVHGeometry::Type getPrimitiveType() const
+		{
+			return BVHGeometry::TRIANGLES;
+		}
+		
+		
+		virtual om::bvh::PrimitiveCount getPrimitiveCount() const
+		{
+			return (om::bvh::PrimitiveCount)scene.triangles.getSize();
+		}
+		
+		
+		virtual AABB3f getPrimitiveAABB( om::bvh::PrimitiveIndex primitiveIndex ) const
+		{
+			const SoundTriangle& t = scene.triangles[primitiveIndex];
+			AABB3f result( scene.vertices[t.v[0]] );
+			result.enlargeFor( scene.vertices[t.v[1]] );
+			result.enlargeFor( scene.vertices[t.v[2]] );
+			
+			return result;
+		}
+		
+		
+		virtual Bool getTriangle( om::bvh::PrimitiveIndex primitiveIndex, Vector3f& v0, Vector3f& v1, Vector3f& v2 ) const
+		{
+			if ( primitiveIndex >= scene.triangles.getSize() )
+				return false;
+			
+			const SoundTriangle& t = scene.triangles[primitiveIndex];
+			v0 = scene.vertices[t.v[0]];
+			v1 = scene.vertices[t.v[1]];
+			v2 = scene.vertices[t.v[2]];
+			
+			return true;
+		}
+		
+		
+		/// Intersect the ray with a single triangle, updating the ray if the hit is the closest so far.
+		GSOUND_FORCE_INLINE void intersectTriangle( om::bvh::PrimitiveIndex primitiveIndex, BVHRay& ray ) const
+		{
+			const SoundTriangle& t = scene.triangles[primitiveIndex];
+			const Vector3f& v0 = scene.vertices[t.v[0]];
+			const Vector3f& v1 = scene.vertices[t.v[1]];
+			const Vector3f& v2 = scene.vertices[t.v[2]];
+			const Ray3f r( Vector3f( ray.origin[0], ray.origin[1], ray.origin[2] ),
+						Vector3f( ray.direction[0], ray.direction[1], ray.direction[2] ) );
+			Float distance, u, v;
+			
+			if ( r.intersectsTriangle( v0, v1, v2, distance, u, v ) && distance >= ray.tMin && distance < ray.tMax )
+			{
+				const Vector3f normal = math::cross( v1 - v0, v2 - v0 );
+				ray.tMax = distance;
+				ray.bary0 = Float(1) - u - v;
+				ray.bary1 = u;
+				ray.normal = om::math::SIMDFloat4( normal.x, normal.y, normal.z, 0 );
+				ray.primitive = primitiveIndex;
+				ray.geometry = const_cast<TriangleGeometry*>( this );
+			}
+		}
+		
+		
+		/// The scene that contains the triangles.
+		const BenchmarkScene& scene;
+		
+		
+};
+
+
+
+
+/// A generic BVH geometry interface that counts the number of ray-triangle tests.
+/**
+  * A BVH built with this geometry has the same hierarchy as one built with
+  * TriangleGeometry, because only the primitive bounding boxes affect the build,
+  * but it traverses the generic primitive path so that every triangle test is seen.
+  */
+class CountingTriangleGeometry : public TriangleGeometry
+{
+	public:
+		
+		GSOUND_INLINE CountingTriangleGeometry( const BenchmarkScene& newScene )
+			:	TriangleGeometry( newScene ),
+				numTriangleTests( 0 )
+		{
+		}
+		
+		
+		virtual BVHGeometry::Type getPrimitiveType() const
+		{
+			return BVHGeometry::GENERIC;
+		}
+		
+		
+		virtual void intersectRay( om::bvh::PrimitiveIndex primitiveIndex, BVHRay& ray ) const
+		{
+			numTriangleTests++;
+			intersectTriangle( primitiveIndex, ray );
+		}
+		
+		
+		virtual void intersectRay( const om::bvh::PrimitiveIndex* primitiveIndices, om::bvh::PrimitiveCount numPrimitives, BVHRay& ray ) const
+		{
+			numTriangleTests += numPrimitives;
+			
+			for ( om::bvh::PrimitiveCount i = 0; i < numPrimitives; i++ )
+				intersectTriangle( primitiveIndices[i], ray );
+		}
+		
+		
+		/// The total number of ray-triangle tests that have been performed.
+		mutable Size numTriangleTests;
+		
+		
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Brute Force Reference BVH Class
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// A reference BVH implementation that tests every ray against every triangle.
+/**
+  * This class is used to validate the results of the accelerated BVH implementations.
+  */
+class BruteForceBVH : public BVH
+{
+	public:
+		
+		GSOUND_INLINE BruteForceBVH( const TriangleGeometry& newGeometry )
+			:	geometry( newGeometry )
+		{
+		}
+		
+		
+		virtual void rebuild()
+		{
+		}
+		
+		
+		virtual void intersectRay( BVHRay& ray ) const
+		{
+			const om::bvh::PrimitiveCount numTriangles = geometry.getPrimitiveCount();
+			
+			for ( om::bvh::PrimitiveIndex i = 0; i < numTriangles; i++ )
+				geometry.intersectTriangle( i, ray );
+		}
+		
+		
+		virtual void testRay( BVHRay& ray ) const
+		{
+			intersectRay( ray );
+		}
+		
+		
+		virtual Bool isValid() const
+		{
+			return true;
+		}
+		
+		
+		virtual Size getSizeInBytes() const
+		{
+			return sizeof(BruteForceBVH);
+		}
+		
+		
+		virtual AABB3f getAABB() const
+		{
+			AABB3f result( math::infinity<Float>(), math::negativeInfinity<Float>() );
+			
+			for ( Index i = 0; i < geometry.scene.vertices.getSize(); i++ )
+				result.enlargeFor( geometry.scene.vertices[i] );
+			
+			return result;
+		}
+		
+		
+	private:
+		
+		/// The geometry that is tested against rays.
+		const TriangleGeometry& geometry;
+		
+		
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Ray Set Class
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// A class that stores a set of query rays and the results of tracing them.
+class RaySet
+{
+	public:
+		
+		GSOUND_INLINE RaySet( const char* newName, Bool newIsShadow )
+			:	name( newName ),
+				isShadow( newIsShadow )
+		{
+		}
+		
+		
+		/// Add a ray with the specified origin, direction, and maximum distance to the set.
+		GSOUND_INLINE void add( const Vector3f& origin, const Vector3f& direction, Float tMax )
+		{
+			rays.add( Ray3f( origin, direction ) );
+			maxDistances.add( tMax );
+		}
+		
+		
+		/// Return a BVH query ray for the ray with the specified index.
+		GSOUND_FORCE_INLINE BVHRay getBVHRay( Index i ) const
+		{
+			return BVHRay( rays[i], Float(0), maxDistances[i] );
+		}
+		
+		
+		/// The name of the ray set that is used in the report.
+		const char* name;
+		
+		
+		/// Whether or not the rays are shadow rays that only need an occlusion result.
+		Bool isShadow;
+		
+		
+		/// The rays in this set.
+		ArrayList<Ray3f> rays;
+		
+		
+		/// The maximum distance along each ray where intersections are considered.
+		ArrayList<Float> maxDistances;
+		
+		
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Ray Generation
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// Return a unit vector that is uniformly distributed over the hemisphere around the specified normal.
+static Vector3f randomHemisphereDirection( const Vector3f& normal, math::Random<Float>& random )
+{
+	while ( true )
+	{
+		const Vector3f v( random.sample( Float(-1), Float(1) ), random.sample( Float(-1), Float(1) ), random.sample( Float(-1), Float(1) ) );
+		const Float length2 = v.getMagnitudeSquared();
+		
+		if ( length2 > Float(1) || length2 < Float(1e-6) )
+			continue;
+		
+		const Vector3f d = v / math::sqrt( length2 );
+		
+		return math::dot( d, normal ) < Float(0) ? -d : d;
+	}
+}
+
+
+
+
+/// Generate the primary, secondary, and shadow ray sets for a scene.
+/**
+  * Primary rays sweep a latitude-longitude grid around the listener in scanline order,
+  * so that consecutive rays are coherent. Coherent secondary rays are specular reflections
+  * of the primary hits, incoherent secondary rays are random diffuse directions visited
+  * in a shuffled order, and shadow rays connect the primary hits to the sound source.
+  */
+static void generateRays( const BenchmarkScene& scene, const BVH& bvh, Size resolution,
+						RaySet& primary, RaySet& coherent, RaySet& incoherent, RaySet& shadow )
+{
+	const Float offset = Float(1e-3);
+	math::Random<Float> random( 1 );
+	ArrayList<Vector3f> hitPoints;
+	ArrayList<Vector3f> hitNormals;
+	ArrayList<Vector3f> hitDirections;
+	
+	for ( Index i = 0; i < resolution; i++ )
+	{
+		const Float theta = math::pi<Float>()*(Float(i) + Float(0.5)) / Float(resolution);
+		
+		for ( Index j = 0; j < 2*resolution; j++ )
+		{
+			const Float phi = math::pi<Float>()*(Float(j) + Float(0.5)) / Float(resolution);
+			const Vector3f direction( math::sin(theta)*math::cos(phi), math::cos(theta), math::sin(theta)*math::sin(phi) );
+			primary.add( scene.listenerPosition, direction, math::infinity<Float>() );
+			
+			BVHRay ray = primary.getBVHRay( primary.rays.getSize() - 1 );
+			bvh.intersectRay( ray );
+			
+			if ( !ray.hitValid() )
+				continue;
+			
+			Vector3f normal = Vector3f( ray.normal[0], ray.normal[1], ray.normal[2] ).normalize();
+			
+			if ( math::dot( normal, direction ) > Float(0) )
+				normal = -normal;
+			
+			hitPoints.add( scene.listenerPosition + direction*ray.tMax + normal*offset );
+			hitNormals.add( normal );
+			hitDirections.add( direction );
+		}
+	}
+	
+	const Size numHits = hitPoints.getSize();
+	
+	for ( Index i = 0; i < numHits; i++ )
+	{
+		const Vector3f& d = hitDirections[i];
+		const Vector3f& n = hitNormals[i];
+		coherent.add( hitPoints[i], d - Float(2)*math::dot( d, n )*n, math::infinity<Float>() );
+		
+		const Vector3f toSource = scene.sourcePosition - hitPoints[i];
+		const Float sourceDistance = toSource.getMagnitude();
+		
+		if ( sourceDistance > offset )
+			shadow.add( hitPoints[i], toSource / sourceDistance, sourceDistance );
+	}
+	
+	// Visit the hit points in a random order to destroy any coherence between consecutive rays.
+	ArrayList<Index> order;
+	
+	for ( Index i = 0; i < numHits; i++ )
+		order.add( i );
+	
+	for ( Index i = numHits; i > 1; i-- )
+	{
+		const Index j = math::min( (Index)random.sample( Float(0), Float(i) ), i - 1 );
+		const Index temp = order[i - 1];
+		order[i - 1] = order[j];
+		order[j] = temp;
+	}
+	
+	for ( Index i = 0; i < numHits; i++ )
+	{
+		const Index h = order[i];
+		incoherent.add( hitPoints[h], randomHemisphereDirection( hitNormals[h], random ), math::infinity<Float>() );
+	}
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Ray Tracing Benchmarks
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// Trace all rays in the set with either intersectRay() or testRay() and return the throughput in rays per second.
+static Double measureRaysPerSecond( const BVH& bvh, const RaySet& rays, Bool test, Size numPasses, Size& numHits )
+{
+	const Size numRays = rays.rays.getSize();
+	numHits = 0;
+	
+	Timer timer;
+	
+	for ( Index p = 0; p < numPasses; p++ )
+	{
+		for ( Index i = 0; i < numRays; i++ )
+		{
+			BVHRay ray = rays.getBVHRay( i );
+			
+			if ( test )
+				bvh.testRay( ray );
+			else
+				bvh.intersectRay( ray );
+			
+			numHits += ray.hitValid();
+		}
+	}
+	
+	const Double seconds = timer.getElapsedTime();
+	numHits /= numPasses;
+	
+	return Double(numRays*numPasses) / seconds;
+}
+
+
+
+
+/// Return whether or not two ray query results are consistent with each other.
+/**
+  * Hits at the same distance on different triangles (e.g. on a shared edge)
+  * are considered to be consistent.
+  */
+static Bool resultsMatch( const BVHRay& a, const BVHRay& b, Bool onlyOcclusion )
+{
+	if ( a.hitValid() != b.hitValid() )
+		return false;
+	
+	if ( onlyOcclusion || !a.hitValid() )
+		return true;
+	
+	return math::abs( a.tMax - b.tMax ) <= Float(1e-4)*math::max( Float(1), a.tMax );
+}
+
+
+
+
+/// Cross-check a subset of the ray set between the BVH implementations and return the number of mismatches.
+static Size validateRays( const BVH& bvh, const BVH& genericBVH, const BVH& reference,
+						const RaySet& rays, Size maxNumChecks, Size& numChecked )
+{
+	const Size numRays = rays.rays.getSize();
+	const Size stride = math::max( numRays / math::max( maxNumChecks, Size(1) ), Size(1) );
+	Size numMismatches = 0;
+	numChecked = 0;
+	
+	for ( Index i = 0; i < numRays; i += stride )
+	{
+		BVHRay expected = rays.getBVHRay( i );
+		reference.intersectRay( expected );
+		
+		BVHRay closest = rays.getBVHRay( i );
+		bvh.intersectRay( closest );
+		
+		BVHRay generic = rays.getBVHRay( i );
+		genericBVH.intersectRay( generic );
+		
+		BVHRay occlusion = rays.getBVHRay( i );
+		bvh.testRay( occlusion );
+		
+		if ( !resultsMatch( expected, closest, false ) || !resultsMatch( expected, generic, false ) ||
+			!resultsMatch( expected, occlusion, true ) )
+			numMismatches++;
+		
+		numChecked++;
+	}
+	
+	return numMismatches;
+}
+
+
+
+
+/// Options that control the BVH benchmark.
+class BVHBenchmarkOptions
+{
+	public:
+		
+		GSOUND_INLINE BVHBenchmarkOptions()
+			:	outputPath( NULL ),
+				dataPath( GSOUND_BENCHMARK_DATA_PATH ),
+				resolution( 256 ),
+				numPasses( 4 ),
+				maxNumChecks( 4000 ),
+				tolerance( 0.001 )
+		{
+		}
+		
+		
+		/// The path of the JSON report, or NULL if the report is written to standard output.
+		const char* outputPath;
+		
+		
+		/// The directory that contains the example meshes.
+		const char* dataPath;
+		
+		
+		/// The number of latitude steps for the primary rays, the longitude has twice as many steps.
+		Size resolution;
+		
+		
+		/// The number of times that each ray set is traced when measuring throughput.
+		Size numPasses;
+		
+		
+		/// The maximum number of rays per set that are cross-checked against the reference implementation.
+		Size maxNumChecks;
+		
+		
+		/// The fraction of mismatched rays above which validation fails.
+		Double tolerance;
+		
+		
+};
+
+
+
+
+/// Benchmark and validate the BVH for a single scene, returning whether or not validation succeeded.
+static Bool benchmarkScene( const BenchmarkScene& scene, const BVHBenchmarkOptions& options, BenchmarkReport& report )
+{
+	TriangleGeometry geometry( scene );
+	CountingTriangleGeometry countingGeometry( scene );
+	BruteForceBVH reference( geometry );
+	
+	//***************************************************************************
+	// Build the BVHs.
+	
+	AABBTree4 bvh;
+	bvh.setGeometry( &geometry );
+	
+	report.beginResult( "bvhBuild", scene.name );
+	
+	Timer timer;
+	bvh.rebuild();
+	const Double buildSeconds = timer.getElapsedTime();
+	
+	report.add( "triangles", scene.triangles.getSize() );
+	report.add( "buildMs", buildSeconds*1000.0 );
+	report.add( "trianglesPerSecond", Double(scene.triangles.getSize()) / buildSeconds );
+	report.add( "maxDepth", bvh.getMaxDepth() );
+	report.add( "memoryBytes", bvh.getSizeInBytes() );
+	report.endResult();
+	
+	AABBTree4 genericBVH;
+	genericBVH.setGeometry( &countingGeometry );
+	genericBVH.rebuild();
+	
+	//***************************************************************************
+	// Generate the ray sets.
+	
+	RaySet primary( "primary", false );
+	RaySet coherent( "coherentSecondary", false );
+	RaySet incoherent( "incoherentSecondary", false );
+	RaySet shadow( "shadow", true );
+	generateRays( scene, bvh, options.resolution, primary, coherent, incoherent, shadow );
+	
+	const RaySet* raySets[] = { &primary, &coherent, &incoherent, &shadow };
+	Bool valid = true;
+	
+	for ( Index s = 0; s < 4; s++ )
+	{
+		const RaySet& rays = *raySets[s];
+		const Size numRays = rays.rays.getSize();
+		
+		if ( numRays == 0 )
+			continue;
+		
+		report.beginResult( "bvhTrace", scene.name );
+		report.add( "rays", rays.name );
+		report.add( "count", numRays );
+		
+		// Measure the throughput of the different query types.
+		Size numHits = 0, numTestHits = 0, numGenericHits = 0;
+		const Double intersectRate = measureRaysPerSecond( bvh, rays, false, options.numPasses, numHits );
+		const Double testRate = measureRaysPerSecond( bvh, rays, true, options.numPasses, numTestHits );
+		
+		countingGeometry.numTriangleTests = 0;
+		const Double genericRate = measureRaysPerSecond( genericBVH, rays, rays.isShadow, 1, numGenericHits );
+		const Size numTriangleTests = countingGeometry.numTriangleTests;
+		
+		// Validate the results against the brute force reference.
+		Size numChecked = 0;
+		const Size numMismatches = validateRays( bvh, genericBVH, reference, rays, options.maxNumChecks, numChecked );
+		const Double mismatchFraction = numChecked > 0 ? Double(numMismatches) / Double(numChecked) : 0.0;
+		
+		if ( mismatchFraction > options.tolerance || numHits != numTestHits )
+			valid = false;
+		
+		report.add( "hitFraction", Double(numHits) / Double(numRays) );
+		report.add( "intersectRaysPerSecond", intersectRate );
+		report.add( "testRaysPerSecond", testRate );
+		report.add( "genericRaysPerSecond", genericRate );
+		report.add( "triangleTestsPerRay", Double(numTriangleTests) / Double(numRays) );
+		
+#if OM_BVH_TRAVERSAL_STATISTICS
+		// Count the nodes and cached triangle lanes that are visited by the fast path.
+		om::bvh::BVHTraversalStatistics& traversal = om::bvh::BVHTraversalStatistics::getLocal();
+		Size numCountedHits = 0;
+		traversal.reset();
+		measureRaysPerSecond( bvh, rays, rays.isShadow, 1, numCountedHits );
+		
+		report.add( "nodesPerRay", Double(traversal.getAverageNodeCount()) );
+		report.add( "maxNodesPerRay", traversal.maxRayNodeCount );
+		report.add( "cachedTriangleTestsPerRay", Double(traversal.getAveragePrimitiveCount()) );
+#endif
+		report.add( "checked", numChecked );
+		report.add( "mismatches", numMismatches );
+		report.endResult();
+	}
+	
+	return valid;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Main
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+int main( int argc, char** argv )
+{
+	BVHBenchmarkOptions options;
+	ArrayList<UTF8String> meshPaths;
+	Bool quick = false;
+	
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( std::strcmp( argv[i], "--output" ) == 0 && i + 1 < argc )
+			options.outputPath = argv[++i];
+		else if ( std::strcmp( argv[i], "--data" ) == 0 && i + 1 < argc )
+			options.dataPath = argv[++i];
+		else if ( std::strcmp( argv[i], "--mesh" ) == 0 && i + 1 < argc )
+			meshPaths.add( UTF8String( argv[++i] ) );
+		else if ( std::strcmp( argv[i], "--tolerance" ) == 0 && i + 1 < argc )
+			options.tolerance = std::atof( argv[++i] );
+		else if ( std::strcmp( argv[i], "--quick" ) == 0 )
+			quick = true;
+		else
+		{
+			std::fprintf( stderr, "usage: gsBVHBenchmark [--output <file.json>] [--data <examples dir>] [--mesh <file.obj>]... [--tolerance F] [--quick]\n" );
+			return 1;
+		}
+	}
+	
+	if ( quick )
+	{
+		options.resolution = 96;
+		options.numPasses = 1;
+		options.maxNumChecks = 500;
+	}
+	
+	//***************************************************************************
+	// Create the scenes.
+	
+	ArrayList<BenchmarkScene> scenes;
+	
+	scenes.add( BenchmarkScene( "shoebox" ) );
+	BenchmarkScene::createShoebox( scenes.getLast(), Vector3f( 10, 6, 3 ) );
+	
+	scenes.add( BenchmarkScene( "building" ) );
+	BenchmarkScene::createBuilding( scenes.getLast(), 4, 3, quick ? 1 : 2 );
+	
+	scenes.add( BenchmarkScene( "clutteredHall" ) );
+	BenchmarkScene::createClutteredHall( scenes.getLast(), quick ? 300 : 3000 );
+	
+	meshPaths.add( UTF8String( options.dataPath ) + "/cube.obj" );
+	
+	for ( Index i = 0; i < meshPaths.getSize(); i++ )
+	{
+		const UTF8String& path = meshPaths[i];
+		BenchmarkScene scene( reinterpret_cast<const char*>( path.getCString() ) );
+		
+		if ( BenchmarkScene::loadOBJ( scene, path ) )
+			scenes.add( scene );
+		else
+			std::fprintf( stderr, "warning: unable to load '%s', skipping\n", reinterpret_cast<const char*>( path.getCString() ) );
+	}
+	
+	//***************************************************************************
+	// Run the benchmarks.
+	
+	BenchmarkReport report;
+	Bool valid = true;
+	
+	for ( Index i = 0; i < scenes.getSize(); i++ )
+	{
+		if ( !benchmarkScene( scenes[i], options, report ) )
+		{
+			std::fprintf( stderr, "error: BVH results for scene '%s' do not match the reference\n",
+						reinterpret_cast<const char*>( scenes[i].name.getCString() ) );
+			valid = false;
+		}
+	}
+	
+	if ( !report.write( options.outputPath ) )
+	{
+		std::fprintf( stderr, "error: unable to write the report to '%s'\n", options.outputPath );
+		return 1;
+	}
+	
+	return valid ? 0 : 2;
+}
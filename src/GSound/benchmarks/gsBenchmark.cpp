@@ -0,0 +1,520 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        benchmarks/gsBenchmark.cpp
+ * Contents:    End-to-end performance benchmarks for GSound
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+#include "gsBenchmarkScenes.h"
+#include "gsBenchmarkReport.h"
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Benchmark Options Class
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// A class that stores the command-line options for the benchmarks.
+class BenchmarkOptions
+{
+	public:
+		
+		GSOUND_INLINE BenchmarkOptions()
+			:	outputPath( NULL ),
+				dataPath( GSOUND_BENCHMARK_DATA_PATH ),
+				maxThreads( CPU::getCount() ),
+				quick( false )
+		{
+		}
+		
+		
+		/// The path of the JSON report, or NULL if the report is written to standard output.
+		const char* outputPath;
+		
+		
+		/// The directory that contains the example meshes.
+		const char* dataPath;
+		
+		
+		/// The maximum number of threads that are used for propagation.
+		Size maxThreads;
+		
+		
+		/// Whether or not the workloads are reduced for a quick check.
+		Bool quick;
+		
+		
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Mesh Processing Benchmark
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+static Bool benchmarkMeshProcessing( const BenchmarkScene& scene, SoundMesh& mesh, BenchmarkReport& report )
+{
+	report.beginResult( "processMesh", scene.name );
+	
+	Timer timer;
+	const Bool result = scene.processMesh( mesh, MeshRequest() );
+	const Double seconds = timer.getElapsedTime();
+	
+	report.add( "inputTriangles", scene.triangles.getSize() );
+	report.add( "triangles", mesh.getTriangleCount() );
+	report.add( "timeMs", seconds*1000.0 );
+	report.add( "trianglesPerSecond", Double(scene.triangles.getSize()) / seconds );
+	report.add( "memoryBytes", mesh.getSizeInBytes() );
+	report.endResult();
+	
+	return result;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Propagation Benchmark
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+static void benchmarkPropagation( const BenchmarkScene& benchmarkScene, SoundScene& scene, Size numRays, Size numThreads,
+								const BenchmarkOptions& options, BenchmarkReport& report, SoundSceneIR& sceneIR )
+{
+	const Size numWarmupFrames = options.quick ? 1 : 3;
+	const Size numFrames = options.quick ? 3 : 10;
+	
+	PropagationRequest request;
+	SoundStatistics statistics;
+	SoundPropagator propagator;
+	
+	request.numDiffuseRays = numRays;
+	request.numSpecularRays = numRays / 10;
+	request.numThreads = numThreads;
+	request.statistics = &statistics;
+	request.flags.set( PropagationFlags::STATISTICS, true );
+	request.dt = request.targetDt;
+	
+	report.beginResult( "propagateSound", benchmarkScene.name );
+	
+	// Warm up the propagation caches so that the measured frames are in a steady state.
+	for ( Index i = 0; i < numWarmupFrames; i++ )
+		propagator.propagateSound( scene, request, sceneIR );
+	
+	Double totalSeconds = 0;
+	Double maxSeconds = 0;
+	Size totalRays = 0;
+	
+	for ( Index i = 0; i < numFrames; i++ )
+	{
+		Timer timer;
+		propagator.propagateSound( scene, request, sceneIR );
+		const Double seconds = timer.getElapsedTime();
+		
+		totalSeconds += seconds;
+		maxSeconds = math::max( maxSeconds, seconds );
+		totalRays += statistics.diffuseRayCount + statistics.specularRayCount;
+	}
+	
+	report.add( "rays", numRays );
+	report.add( "threads", numThreads );
+	report.add( "frames", numFrames );
+	report.add( "meanFrameMs", totalSeconds*1000.0 / Double(numFrames) );
+	report.add( "maxFrameMs", maxSeconds*1000.0 );
+	report.add( "raysPerSecond", Double(totalRays) / totalSeconds );
+	report.add( "pathCount", sceneIR.getPathCount() );
+	report.add( "propagationMemoryBytes", request.internalData.getSizeInBytes() );
+	report.add( "irMemoryBytes", sceneIR.getSizeInBytes() );
+	report.endResult();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Impulse Response Benchmark
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+static void benchmarkImpulseResponse( const BenchmarkScene& benchmarkScene, const SoundSceneIR& sceneIR,
+									const SoundListener& listener, const BenchmarkOptions& options, BenchmarkReport& report )
+{
+	if ( sceneIR.getListenerCount() == 0 || sceneIR.getListenerIR(0).getSourceCount() == 0 )
+		return;
+	
+	const SoundSourceIR& sourceIR = sceneIR.getListenerIR(0).getSourceIR(0);
+	const Size numIterations = options.quick ? 5 : 50;
+	IRRequest request;
+	ImpulseResponse ir;
+	
+	report.beginResult( "setIR", benchmarkScene.name );
+	
+	Timer timer;
+	
+	for ( Index i = 0; i < numIterations; i++ )
+		ir.setIR( sourceIR, listener, request );
+	
+	const Double seconds = timer.getElapsedTime();
+	
+	report.add( "iterations", numIterations );
+	report.add( "irLengthSamples", ir.getLengthInSamples() );
+	report.add( "meanTimeMs", seconds*1000.0 / Double(numIterations) );
+	report.add( "irsPerSecond", Double(numIterations) / seconds );
+	report.endResult();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Rendering Benchmark
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+static void benchmarkRendering( const BenchmarkScene& benchmarkScene, const SoundSceneIR& sceneIR,
+								SoundSource& source, const BenchmarkOptions& options, BenchmarkReport& report )
+{
+	if ( sceneIR.getListenerCount() == 0 )
+		return;
+	
+	const SampleRate sampleRate = 44100;
+	const Size blockSize = 512;
+	const Double duration = options.quick ? 1.0 : 10.0;
+	const Size numBlocks = (Size)math::ceiling( duration*sampleRate / blockSize );
+	const Time blockTime( Double(blockSize) / sampleRate );
+	
+	// Play looping white noise from the source.
+	SoundBuffer noise( 1, (Size)sampleRate, sampleRate );
+	math::Random<Float> random( 1 );
+	
+	for ( Index i = 0; i < noise.getSize(); i++ )
+		noise.getChannel(0)[i] = random.sample( Float(-0.5), Float(0.5) );
+	
+	om::sound::Sound sound( noise );
+	source.playSound( &sound, Float(1), true );
+	
+	RenderRequest request;
+	request.sampleRate = sampleRate;
+	
+	SoundListenerRenderer renderer( request );
+	SourceSoundBuffer sourceBuffer;
+	SoundBuffer outputBuffer( renderer.getChannelLayout().getChannelCount(), blockSize, sampleRate );
+	
+	report.beginResult( "render", benchmarkScene.name );
+	
+	// Time the IR update separately from rendering.
+	Timer updateTimer;
+	renderer.updateIR( sceneIR.getListenerIR(0), request );
+	const Double updateSeconds = updateTimer.getElapsedTime();
+	
+	Double renderSeconds = 0;
+	
+	for ( Index b = 0; b < numBlocks; b++ )
+	{
+		sourceBuffer.clearSources();
+		SoundBuffer* input = sourceBuffer.addSource( &source );
+		
+		if ( input )
+			source.readSamples( *input, blockTime );
+		
+		Timer renderTimer;
+		renderer.render( sourceBuffer, outputBuffer, blockTime );
+		renderSeconds += renderTimer.getElapsedTime();
+	}
+	
+	source.stopSounds();
+	
+	const Double audioSeconds = Double(numBlocks*blockSize) / sampleRate;
+	
+	report.add( "sampleRate", Double(sampleRate) );
+	report.add( "blockSize", blockSize );
+	report.add( "channels", outputBuffer.getChannelCount() );
+	report.add( "irUpdateMs", updateSeconds*1000.0 );
+	report.add( "meanBlockMs", renderSeconds*1000.0 / Double(numBlocks) );
+	report.add( "realTimeFactor", audioSeconds / renderSeconds );
+	report.add( "memoryBytes", renderer.getSizeInBytes() );
+	report.endResult();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Multichannel Filter Benchmark
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+static void benchmarkFilter( const char* name, SoundFilter& filter, const BenchmarkOptions& options, BenchmarkReport& report )
+{
+	const Size numChannels = 64;
+	const SampleRate sampleRate = 48000;
+	const Size blockSize = 512;
+	const Double duration = options.quick ? 1.0 : 10.0;
+	const Size numBlocks = (Size)math::ceiling( duration*sampleRate / blockSize );
+	
+	SoundBuffer inputBuffer( numChannels, blockSize, sampleRate );
+	SoundBuffer outputBuffer( numChannels, blockSize, sampleRate );
+	math::Random<Float> random( 1 );
+	
+	for ( Index c = 0; c < numChannels; c++ )
+	{
+		for ( Index i = 0; i < blockSize; i++ )
+			inputBuffer.getChannel(c)[i] = random.sample( Float(-1), Float(1) );
+	}
+	
+	report.beginResult( name, UTF8String( "64 channels" ) );
+	
+	Timer timer;
+	
+	for ( Index b = 0; b < numBlocks; b++ )
+		filter.process( inputBuffer, outputBuffer, blockSize );
+	
+	const Double seconds = timer.getElapsedTime();
+	const Double audioSeconds = Double(numBlocks*blockSize) / sampleRate;
+	
+	report.add( "channels", numChannels );
+	report.add( "sampleRate", Double(sampleRate) );
+	report.add( "blockSize", blockSize );
+	report.add( "channelSamplesPerSecond", Double(numChannels*numBlocks*blockSize) / seconds );
+	report.add( "realTimeFactor", audioSeconds / seconds );
+	report.endResult();
+}
+
+
+
+
+static void benchmarkFilters( const BenchmarkOptions& options, BenchmarkReport& report )
+{
+	om::sound::ReverbFilter reverb( Float(2) );
+	benchmarkFilter( "reverbFilter", reverb, options, report );
+	
+	om::sound::Compressor compressor( Float(0.25), Float(4), Float(0.005), Float(0.1) );
+	compressor.setChannelsAreLinked( true );
+	benchmarkFilter( "compressorLinked", compressor, options, report );
+	
+	om::sound::Limiter limiter( Float(0.5), Float(1), Float(1), Float(0.1) );
+	limiter.setChannelsAreLinked( true );
+	benchmarkFilter( "limiterLinked", limiter, options, report );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Scene Benchmarks
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+static void benchmarkScene( const BenchmarkScene& benchmarkScene, const BenchmarkOptions& options, BenchmarkReport& report )
+{
+	SoundMesh mesh;
+	
+	if ( !benchmarkMeshProcessing( benchmarkScene, mesh, report ) )
+	{
+		std::fprintf( stderr, "error: unable to process the mesh for scene '%s'\n",
+					reinterpret_cast<const char*>( benchmarkScene.name.getCString() ) );
+		return;
+	}
+	
+	SoundObject object( &mesh );
+	SoundSource source( benchmarkScene.sourcePosition, Real(0.1) );
+	SoundListener listener( benchmarkScene.listenerPosition, Real(0.1) );
+	SoundScene scene;
+	scene.addObject( &object );
+	scene.addSource( &source );
+	scene.addListener( &listener );
+	
+	//***************************************************************************
+	// Propagate sound with several ray budgets and thread counts.
+	
+	const Size rayBudgets[] = { 1000, 10000, 100000 };
+	const Size numRayBudgets = options.quick ? 2 : 3;
+	SoundSceneIR sceneIR;
+	
+	for ( Index r = 0; r < numRayBudgets; r++ )
+	{
+		benchmarkPropagation( benchmarkScene, scene, rayBudgets[r], 1, options, report, sceneIR );
+		
+		if ( options.maxThreads > 1 )
+			benchmarkPropagation( benchmarkScene, scene, rayBudgets[r], options.maxThreads, options, report, sceneIR );
+	}
+	
+	//***************************************************************************
+	// Compute and render the IR from the last propagation run.
+	
+	benchmarkImpulseResponse( benchmarkScene, sceneIR, listener, options, report );
+	benchmarkRendering( benchmarkScene, sceneIR, source, options, report );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Main
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+int main( int argc, char** argv )
+{
+	BenchmarkOptions options;
+	
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( std::strcmp( argv[i], "--output" ) == 0 && i + 1 < argc )
+			options.outputPath = argv[++i];
+		else if ( std::strcmp( argv[i], "--data" ) == 0 && i + 1 < argc )
+			options.dataPath = argv[++i];
+		else if ( std::strcmp( argv[i], "--threads" ) == 0 && i + 1 < argc )
+			options.maxThreads = math::max( (Size)std::atoi( argv[++i] ), Size(1) );
+		else if ( std::strcmp( argv[i], "--quick" ) == 0 )
+			options.quick = true;
+		else
+		{
+			std::fprintf( stderr, "usage: gsBenchmark [--output <file.json>] [--data <examples dir>] [--threads N] [--quick]\n" );
+			return 1;
+		}
+	}
+	
+	BenchmarkReport report;
+	
+	//***************************************************************************
+	// Run the scene benchmarks.
+	
+	{
+		BenchmarkScene shoebox( "shoebox" );
+		BenchmarkScene::createShoebox( shoebox, Vector3f( 10, 6, 3 ) );
+		benchmarkScene( shoebox, options, report );
+	}
+	
+	{
+		BenchmarkScene cube( "cube.obj" );
+		const UTF8String cubePath = UTF8String( options.dataPath ) + "/cube.obj";
+		
+		if ( BenchmarkScene::loadOBJ( cube, cubePath ) )
+			benchmarkScene( cube, options, report );
+		else
+			std::fprintf( stderr, "warning: unable to load '%s', skipping\n", reinterpret_cast<const char*>( cubePath.getCString() ) );
+	}
+	
+	{
+		BenchmarkScene building( "building" );
+		BenchmarkScene::createBuilding( building, 4, 3, options.quick ? 1 : 2 );
+		benchmarkScene( building, options, report );
+	}
+	
+	{
+		BenchmarkScene hall( "clutteredHall" );
+		BenchmarkScene::createClutteredHall( hall, options.quick ? 300 : 3000 );
+		benchmarkScene( hall, options, report );
+	}
+	
+	//***************************************************************************
+	// Run the multichannel filter benchmarks.
+	
+	benchmarkFilters( options, report );
+	
+	if ( !report.write( options.outputPath ) )
+	{
+		std::fprintf( stderr, "error: unable to write the report to '%s'\n", options.outputPath );
+		return 1;
+	}
+	
+	return 0;
+}
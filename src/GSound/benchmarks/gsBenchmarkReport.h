@@ -0,0 +1,181 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        benchmarks/gsBenchmarkReport.h
+ * Contents:    A JSON report writer for the GSound benchmarks
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_BENCHMARK_REPORT_H
+#define INCLUDE_GSOUND_BENCHMARK_REPORT_H
+
+
+#include <cstdio>
+#include <string>
+
+
+#include "gsound/gsound.h"
+
+
+using namespace gsound;
+
+
+
+
+//********************************************************************************
+/// A class that collects benchmark results and formats them as JSON.
+class BenchmarkReport
+{
+	public:
+		
+		GSOUND_INLINE BenchmarkReport()
+			:	numResults( 0 ),
+				numValues( 0 )
+		{
+		}
+		
+		
+		/// Start a new result for the specified benchmark and scene.
+		void beginResult( const char* benchmark, const UTF8String& scene )
+		{
+			text += numResults == 0 ? "\n\t\t{ " : ",\n\t\t{ ";
+			numValues = 0;
+			numResults++;
+			
+			add( "benchmark", benchmark );
+			add( "scene", reinterpret_cast<const char*>( scene.getCString() ) );
+			
+			std::fprintf( stderr, "%s: %s", benchmark, reinterpret_cast<const char*>( scene.getCString() ) );
+		}
+		
+		
+		/// Add a string value to the current result.
+		void add( const char* key, const char* value )
+		{
+			addKey( key );
+			text += "\"";
+			text += value;
+			text += "\"";
+		}
+		
+		
+		/// Add an integer value to the current result.
+		void add( const char* key, Size value )
+		{
+			char number[32];
+			std::snprintf( number, sizeof(number), "%llu", (unsigned long long)value );
+			addKey( key );
+			text += number;
+		}
+		
+		
+		/// Add a floating-point value to the current result.
+		void add( const char* key, Double value )
+		{
+			char number[32];
+			std::snprintf( number, sizeof(number), "%.6g", value );
+			addKey( key );
+			text += number;
+		}
+		
+		
+		/// Finish the current result.
+		void endResult()
+		{
+			text += " }";
+			std::fprintf( stderr, "\n" );
+		}
+		
+		
+		/// Write the report to the specified file, or to standard output if the path is NULL.
+		Bool write( const char* outputPath ) const
+		{
+			std::FILE* file = outputPath ? std::fopen( outputPath, "w" ) : stdout;
+			
+			if ( file == NULL )
+				return false;
+			
+			std::fprintf( file, "{\n\t\"version\": \"%s\",\n\t\"cpuCount\": %u,\n\t\"frequencyCount\": %u,\n\t\"results\": [%s\n\t]\n}\n",
+						GSOUND_VERSION_STRING, (unsigned int)CPU::getCount(), (unsigned int)GSOUND_FREQUENCY_COUNT, text.c_str() );
+			
+			if ( outputPath )
+				std::fclose( file );
+			
+			return true;
+		}
+		
+		
+	private:
+		
+		/// Add the key for the next value of the current result.
+		void addKey( const char* key )
+		{
+			if ( numValues > 0 )
+				text += ", ";
+			
+			text += "\"";
+			text += key;
+			text += "\": ";
+			numValues++;
+		}
+		
+		
+		/// The JSON text for the results so far.
+		std::string text;
+		
+		
+		/// The number of results in the report.
+		Size numResults;
+		
+		
+		/// The number of values in the current result.
+		Size numValues;
+		
+		
+};
+
+
+
+
+#endif // INCLUDE_GSOUND_BENCHMARK_REPORT_H
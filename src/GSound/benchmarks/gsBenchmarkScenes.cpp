@@ -0,0 +1,352 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        benchmarks/gsBenchmarkScenes.cpp
+ * Contents:    Procedural and file-based scenes for the GSound benchmarks
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "gsBenchmarkScenes.h"
+
+
+#include <string>
+#include <vector>
+
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+
+/// The absorption coefficient of the default benchmark material.
+#define DEFAULT_ABSORPTION 0.3f
+
+
+/// The scattering coefficient of the default benchmark material.
+#define DEFAULT_SCATTERING 0.5f
+
+
+/// The random seed that is used to generate scenes.
+#define SCENE_RANDOM_SEED 12345
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Constructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+BenchmarkScene:: BenchmarkScene( const char* newName )
+	:	name( newName ),
+		sourcePosition( 0, 0, 0 ),
+		listenerPosition( 0, 0, 0 )
+{
+	// Use a material that is similar to the default material for pygsound shoebox rooms.
+	materials.add( SoundMaterial( FrequencyResponse( math::sqrt( 1.0f - DEFAULT_ABSORPTION ) ),
+									FrequencyResponse( DEFAULT_SCATTERING ),
+									FrequencyResponse( 0.0f ) ) );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Scene Generation Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void BenchmarkScene:: createShoebox( BenchmarkScene& scene, const Vector3f& size )
+{
+	scene.addBox( AABB3f( Vector3f( 0, 0, 0 ), size ) );
+	scene.sourcePosition = size*Vector3f( 0.25f, 0.3f, 0.5f );
+	scene.listenerPosition = size*Vector3f( 0.7f, 0.6f, 0.5f );
+}
+
+
+
+
+void BenchmarkScene:: createBuilding( BenchmarkScene& scene, Size numRoomsX, Size numRoomsY, Size numFloors )
+{
+	const Real roomWidth = 5;
+	const Real roomDepth = 4;
+	const Real roomHeight = 3;
+	const Real doorWidth = 1;
+	const Real doorHeight = 2.2f;
+	const Real stairSize = 2;
+	const Real width = roomWidth*numRoomsX;
+	const Real depth = roomDepth*numRoomsY;
+	
+	//***************************************************************************
+	// Add the floor slabs, with a stairwell opening in the first room of each upper floor.
+	
+	for ( Index f = 0; f <= numFloors; f++ )
+	{
+		const Real z = roomHeight*f;
+		
+		if ( f == 0 || f == numFloors )
+		{
+			scene.addQuad( Vector3f( 0, 0, z ), Vector3f( width, 0, z ), Vector3f( width, depth, z ), Vector3f( 0, depth, z ) );
+			continue;
+		}
+		
+		scene.addQuad( Vector3f( stairSize, 0, z ), Vector3f( width, 0, z ), Vector3f( width, stairSize, z ), Vector3f( stairSize, stairSize, z ) );
+		scene.addQuad( Vector3f( 0, stairSize, z ), Vector3f( width, stairSize, z ), Vector3f( width, depth, z ), Vector3f( 0, depth, z ) );
+	}
+	
+	//***************************************************************************
+	// Add the walls for each floor.
+	
+	for ( Index f = 0; f < numFloors; f++ )
+	{
+		const Real z0 = roomHeight*f;
+		const Real z1 = z0 + roomHeight;
+		const Real doorTop = z0 + doorHeight;
+		
+		// Exterior walls.
+		scene.addQuad( Vector3f( 0, 0, z0 ), Vector3f( width, 0, z0 ), Vector3f( width, 0, z1 ), Vector3f( 0, 0, z1 ) );
+		scene.addQuad( Vector3f( 0, depth, z0 ), Vector3f( width, depth, z0 ), Vector3f( width, depth, z1 ), Vector3f( 0, depth, z1 ) );
+		scene.addQuad( Vector3f( 0, 0, z0 ), Vector3f( 0, depth, z0 ), Vector3f( 0, depth, z1 ), Vector3f( 0, 0, z1 ) );
+		scene.addQuad( Vector3f( width, 0, z0 ), Vector3f( width, depth, z0 ), Vector3f( width, depth, z1 ), Vector3f( width, 0, z1 ) );
+		
+		// Interior walls perpendicular to the X axis, with a doorway in the middle of each room's wall.
+		for ( Index i = 1; i < numRoomsX; i++ )
+		{
+			const Real x = roomWidth*i;
+			
+			for ( Index j = 0; j < numRoomsY; j++ )
+			{
+				const Real y0 = roomDepth*j;
+				const Real y1 = y0 + roomDepth;
+				const Real doorStart = (y0 + y1 - doorWidth)*Real(0.5);
+				const Real doorEnd = doorStart + doorWidth;
+				
+				scene.addQuad( Vector3f( x, y0, z0 ), Vector3f( x, doorStart, z0 ), Vector3f( x, doorStart, z1 ), Vector3f( x, y0, z1 ) );
+				scene.addQuad( Vector3f( x, doorEnd, z0 ), Vector3f( x, y1, z0 ), Vector3f( x, y1, z1 ), Vector3f( x, doorEnd, z1 ) );
+				scene.addQuad( Vector3f( x, doorStart, doorTop ), Vector3f( x, doorEnd, doorTop ), Vector3f( x, doorEnd, z1 ), Vector3f( x, doorStart, z1 ) );
+			}
+		}
+		
+		// Interior walls perpendicular to the Y axis.
+		for ( Index j = 1; j < numRoomsY; j++ )
+		{
+			const Real y = roomDepth*j;
+			
+			for ( Index i = 0; i < numRoomsX; i++ )
+			{
+				const Real x0 = roomWidth*i;
+				const Real x1 = x0 + roomWidth;
+				const Real doorStart = (x0 + x1 - doorWidth)*Real(0.5);
+				const Real doorEnd = doorStart + doorWidth;
+				
+				scene.addQuad( Vector3f( x0, y, z0 ), Vector3f( doorStart, y, z0 ), Vector3f( doorStart, y, z1 ), Vector3f( x0, y, z1 ) );
+				scene.addQuad( Vector3f( doorEnd, y, z0 ), Vector3f( x1, y, z0 ), Vector3f( x1, y, z1 ), Vector3f( doorEnd, y, z1 ) );
+				scene.addQuad( Vector3f( doorStart, y, doorTop ), Vector3f( doorEnd, y, doorTop ), Vector3f( doorEnd, y, z1 ), Vector3f( doorStart, y, z1 ) );
+			}
+		}
+	}
+	
+	// Place the source in the first room and the listener in the farthest room on the ground floor.
+	scene.sourcePosition = Vector3f( roomWidth*Real(0.6), roomDepth*Real(0.6), Real(1.5) );
+	scene.listenerPosition = Vector3f( width - roomWidth*Real(0.4), depth - roomDepth*Real(0.4), Real(1.5) );
+}
+
+
+
+
+void BenchmarkScene:: createClutteredHall( BenchmarkScene& scene, Size numBoxes )
+{
+	const Vector3f hallSize( 40, 30, 8 );
+	const Real minBoxSize = 0.3f;
+	const Real maxBoxSize = 2.0f;
+	const Real clearance = 2.0f;
+	
+	scene.addBox( AABB3f( Vector3f( 0, 0, 0 ), hallSize ) );
+	scene.sourcePosition = Vector3f( 5, 5, 1.5f );
+	scene.listenerPosition = Vector3f( 35, 25, 1.5f );
+	
+	math::Random<Real> random( SCENE_RANDOM_SEED );
+	
+	for ( Index i = 0; i < numBoxes; i++ )
+	{
+		const Vector3f boxSize( random.sample( minBoxSize, maxBoxSize ),
+								random.sample( minBoxSize, maxBoxSize ),
+								random.sample( minBoxSize, maxBoxSize ) );
+		const Vector3f boxMin( random.sample( Real(0), hallSize.x - boxSize.x ),
+								random.sample( Real(0), hallSize.y - boxSize.y ),
+								random.sample( Real(0), hallSize.z - boxSize.z ) );
+		const AABB3f box( boxMin, boxMin + boxSize );
+		const AABB3f clearanceBox( box.min - Vector3f( clearance ), box.max + Vector3f( clearance ) );
+		
+		// Keep the source and listener out of the clutter.
+		if ( clearanceBox.contains( scene.sourcePosition ) || clearanceBox.contains( scene.listenerPosition ) )
+			continue;
+		
+		scene.addBox( box );
+	}
+}
+
+
+
+
+Bool BenchmarkScene:: loadOBJ( BenchmarkScene& scene, const UTF8String& filePath )
+{
+	const std::string path( reinterpret_cast<const char*>( filePath.getCString() ) );
+	const std::string::size_type separator = path.rfind( '/' );
+	const std::string basePath = separator == std::string::npos ? std::string() : path.substr( 0, separator + 1 );
+	
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> objMaterials;
+	std::string error;
+	
+	if ( !tinyobj::LoadObj( &attrib, &shapes, &objMaterials, &error, path.c_str(), basePath.c_str() ) )
+		return false;
+	
+	const Size numVertices = attrib.vertices.size() / 3;
+	
+	if ( numVertices == 0 )
+		return false;
+	
+	AABB3f bounds( Vector3f( attrib.vertices[0], attrib.vertices[1], attrib.vertices[2] ) );
+	
+	for ( Index v = 0; v < numVertices; v++ )
+	{
+		const Vector3f vertex( attrib.vertices[3*v], attrib.vertices[3*v + 1], attrib.vertices[3*v + 2] );
+		scene.vertices.add( vertex );
+		bounds.enlargeFor( vertex );
+	}
+	
+	for ( Index s = 0; s < shapes.size(); s++ )
+	{
+		const std::vector<tinyobj::index_t>& indices = shapes[s].mesh.indices;
+		
+		for ( Index i = 0; i + 2 < indices.size(); i += 3 )
+			scene.triangles.add( SoundTriangle( indices[i].vertex_index, indices[i + 1].vertex_index, indices[i + 2].vertex_index, 0 ) );
+	}
+	
+	// Place the source and listener on either side of the center of the mesh.
+	const Vector3f center = bounds.getCenter();
+	const Vector3f offset( (bounds.max.x - bounds.min.x)*Real(0.25), 0, 0 );
+	
+	scene.sourcePosition = center - offset;
+	scene.listenerPosition = center + offset;
+	
+	return scene.triangles.getSize() > 0;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Mesh Processing Method
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool BenchmarkScene:: processMesh( SoundMesh& mesh, const MeshRequest& request ) const
+{
+	SoundMeshPreprocessor preprocessor;
+	
+	return preprocessor.processMesh( vertices.getPointer(), vertices.getSize(),
+									triangles.getPointer(), triangles.getSize(),
+									materials.getPointer(), materials.getSize(), request, mesh );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Geometry Helper Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void BenchmarkScene:: addQuad( const Vector3f& v0, const Vector3f& v1, const Vector3f& v2, const Vector3f& v3 )
+{
+	const Index base = vertices.getSize();
+	
+	vertices.add( v0 );
+	vertices.add( v1 );
+	vertices.add( v2 );
+	vertices.add( v3 );
+	
+	triangles.add( SoundTriangle( base, base + 1, base + 2, 0 ) );
+	triangles.add( SoundTriangle( base, base + 2, base + 3, 0 ) );
+}
+
+
+
+
+void BenchmarkScene:: addBox( const AABB3f& box )
+{
+	const Vector3f& a = box.min;
+	const Vector3f& b = box.max;
+	
+	addQuad( Vector3f( a.x, a.y, a.z ), Vector3f( a.x, b.y, a.z ), Vector3f( b.x, b.y, a.z ), Vector3f( b.x, a.y, a.z ) );
+	addQuad( Vector3f( a.x, a.y, b.z ), Vector3f( b.x, a.y, b.z ), Vector3f( b.x, b.y, b.z ), Vector3f( a.x, b.y, b.z ) );
+	addQuad( Vector3f( a.x, a.y, a.z ), Vector3f( b.x, a.y, a.z ), Vector3f( b.x, a.y, b.z ), Vector3f( a.x, a.y, b.z ) );
+	addQuad( Vector3f( a.x, b.y, a.z ), Vector3f( a.x, b.y, b.z ), Vector3f( b.x, b.y, b.z ), Vector3f( b.x, b.y, a.z ) );
+	addQuad( Vector3f( a.x, a.y, a.z ), Vector3f( a.x, a.y, b.z ), Vector3f( a.x, b.y, b.z ), Vector3f( a.x, b.y, a.z ) );
+	addQuad( Vector3f( b.x, a.y, a.z ), Vector3f( b.x, b.y, a.z ), Vector3f( b.x, b.y, b.z ), Vector3f( b.x, a.y, b.z ) );
+}
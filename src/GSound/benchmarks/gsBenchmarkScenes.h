@@ -0,0 +1,155 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        benchmarks/gsBenchmarkScenes.h
+ * Contents:    Procedural and file-based scenes for the GSound benchmarks
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_BENCHMARK_SCENES_H
+#define INCLUDE_GSOUND_BENCHMARK_SCENES_H
+
+
+#include "gsound/gsound.h"
+
+
+using namespace gsound;
+
+
+//********************************************************************************
+/// A class that stores the unprocessed geometry and test positions for a benchmark scene.
+/**
+  * All of the scenes are generated deterministically, so that results from
+  * different builds and machines can be compared.
+  */
+class BenchmarkScene
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new empty benchmark scene with the specified name.
+			BenchmarkScene( const char* newName );
+			
+			
+		//********************************************************************************
+		//******	Scene Generation Methods
+			
+			
+			/// Create a closed shoebox room with the specified dimensions.
+			static void createShoebox( BenchmarkScene& scene, const Vector3f& size );
+			
+			
+			/// Create a building with a grid of rooms on several floors that are connected by doorways.
+			static void createBuilding( BenchmarkScene& scene, Size numRoomsX, Size numRoomsY, Size numFloors );
+			
+			
+			/// Create a large hall that is cluttered with randomly placed boxes.
+			static void createClutteredHall( BenchmarkScene& scene, Size numBoxes );
+			
+			
+			/// Load a scene from an OBJ file, using the default material for all triangles.
+			/**
+			  * The source and listener are placed on either side of the mesh's bounding box center.
+			  * The method returns whether or not the file was successfully loaded.
+			  */
+			static Bool loadOBJ( BenchmarkScene& scene, const UTF8String& filePath );
+			
+			
+		//********************************************************************************
+		//******	Mesh Processing Method
+			
+			
+			/// Preprocess the scene's geometry into the specified sound mesh.
+			Bool processMesh( SoundMesh& mesh, const MeshRequest& request ) const;
+			
+			
+		//********************************************************************************
+		//******	Geometry Helper Methods
+			
+			
+			/// Add a quad with the specified vertices in counter-clockwise order to the scene.
+			void addQuad( const Vector3f& v0, const Vector3f& v1, const Vector3f& v2, const Vector3f& v3 );
+			
+			
+			/// Add an axis-aligned box to the scene.
+			void addBox( const AABB3f& box );
+			
+			
+		//********************************************************************************
+		//******	Public Data Members
+			
+			
+			/// The name of the scene that is used in benchmark reports.
+			UTF8String name;
+			
+			
+			/// The unprocessed vertices of the scene's mesh.
+			ArrayList<SoundVertex> vertices;
+			
+			
+			/// The unprocessed triangles of the scene's mesh.
+			ArrayList<SoundTriangle> triangles;
+			
+			
+			/// The materials that are used by the scene's triangles.
+			ArrayList<SoundMaterial> materials;
+			
+			
+			/// The position of the sound source in the scene.
+			Vector3f sourcePosition;
+			
+			
+			/// The position of the listener in the scene.
+			Vector3f listenerPosition;
+			
+			
+};
+
+
+
+
+#endif // INCLUDE_GSOUND_BENCHMARK_SCENES_H
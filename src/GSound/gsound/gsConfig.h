@@ -226,6 +226,32 @@
 
 
 
+#ifndef GSOUND_ENABLE_PROFILING
+	/// Determine whether or not timing zones are recorded for the SoundProfiler.
+	/**
+	  * If set to 1, the propagation and rendering phases are instrumented with
+	  * scoped timing zones that can be recorded and exported as a Chrome trace.
+	  * If set to 0, the zones compile to nothing and have no runtime cost.
+	  */
+	#define GSOUND_ENABLE_PROFILING 0
+#endif
+
+
+
+
+#ifndef GSOUND_ENABLE_HEAT_MAP
+	/// Determine whether or not propagation rays count their hits in a SoundHeatMap.
+	/**
+	  * If set to 1, each diffuse and specular ray hit is counted for the intersected
+	  * object and triangle in the PropagationRequest's heat map, if there is one.
+	  * If set to 0, the counting code is compiled out and has no runtime cost.
+	  */
+	#define GSOUND_ENABLE_HEAT_MAP 0
+#endif
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############
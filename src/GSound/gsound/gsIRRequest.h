@@ -78,6 +78,7 @@ class IRRequest
 				:	frequencies(),
 					channelLayout( ChannelLayout::STEREO ),
 					hrtf( NULL ),
+					hrtfCachePath(),
 					ir( true ),
 					normalize( false ),
 					binEnergy( true ),
@@ -103,6 +104,10 @@ class IRRequest
 			const HRTF* hrtf;
 			
 			
+			/// The path of a directory where processed HRTFs are cached between runs, or empty to disable the cache.
+			UTF8String hrtfCachePath;
+			
+			
 			/// If set to TRUE, a spatialized pressure impulse response for auralization is computed.
 			/**
 			  * If this flag is not set, not IR is computed.
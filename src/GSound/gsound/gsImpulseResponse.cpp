@@ -240,6 +240,7 @@ void ImpulseResponse:: setIR( const SoundSourceIR& sourceIR, const SoundListener
 		if ( request.hrtf != hrtf )
 		{
 			hrtf = request.hrtf;
+			hrtfFilter.setCachePath( request.hrtfCachePath );
 			hrtfFilter.setHRTF( *hrtf, sampleRate, maxHRTFOrder );
 
 			const Size bufferLength = hrtfFilter.getFilterLength() + 2;
@@ -83,6 +83,7 @@ PropagationRequest:: PropagationRequest()
 		debugFlags( DebugFlags::UNDEFINED ),
 		debugCache( NULL ),
 		statistics( NULL ),
+		heatMap( NULL ),
 		
 		// Rendering parameters.
 		sampleRate( 44100.0 ),
@@ -97,6 +98,7 @@ PropagationRequest:: PropagationRequest()
 		numSpecularSamples( 20 ),
 		maxDiffuseDepth( 200 ),
 		numDiffuseRays( 2000 ),
+		raySliceCount( 1 ),
 		numDiffuseSamples( 1 ),
 		numVisibilityRays( 200 ),
 		rayOffset( 0.0001f ),
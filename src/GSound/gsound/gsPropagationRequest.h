@@ -59,6 +59,7 @@
 #include "gsDebugCache.h"
 #include "gsFrequencyBands.h"
 #include "gsSoundStatistics.h"
+#include "gsSoundHeatMap.h"
 #include "internal/gsPropagationData.h"
 
 
@@ -205,6 +206,15 @@ class PropagationRequest
 			SoundStatistics* statistics;
 			
 			
+			/// A pointer to an optional heat map which accumulates the number of ray hits on each scene triangle.
+			/**
+			  * Hits are only counted if GSOUND_ENABLE_HEAT_MAP is enabled. The counts accumulate
+			  * over all propagation frames until the heat map is cleared.
+			  * This pointer may be NULL, indicating that hits should not be counted.
+			  */
+			SoundHeatMap* heatMap;
+			
+			
 		//********************************************************************************
 		//******	Rendering Parameters
 			
@@ -293,6 +303,21 @@ class PropagationRequest
 			Size numDiffuseRays;
 			
 			
+			/// The number of propagation frames that the specular and diffuse ray budgets are spread over.
+			/**
+			  * If this value is greater than 1, each frame of sound propagation traces only
+			  * a 1/raySliceCount fraction of numSpecularRays and numDiffuseRays. The results
+			  * of consecutive frames accumulate in the specular, diffuse, and IR caches, so the
+			  * frame cost is smaller and more uniform, at the expense of a slower response to changes.
+			  * The SoundPropagationSystem propagates raySliceCount frames per target time step
+			  * when slicing is used, so that the total number of rays per time step does not change.
+			  *
+			  * The response time should span several slices so that the caches can average the
+			  * partial results. The default value is 1, where all rays are traced on every frame.
+			  */
+			Size raySliceCount;
+			
+			
 			/// The number of ray occlusion query samples that are taken when estimating a source's visibility for diffuse rain.
 			/**
 			  * A value of 1 causes a single visibility ray to be traced from a reflection point
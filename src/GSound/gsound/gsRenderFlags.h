@@ -112,6 +112,26 @@ class RenderFlags
 				  */
 				REVERB = (1 << 3),
 				
+				/// A flag indicating whether or not hybrid convolution and late reverb rendering is enabled.
+				/**
+				  * If this flag is set, convolution is only used to render the early part of each
+				  * impulse response, up to the request's early IR length. The late part is rendered
+				  * by a single feedback delay network per listener whose decay time and level are
+				  * estimated from the late energy of each source's IR. This greatly reduces the
+				  * convolution cost for long reverberant IRs.
+				  */
+				LATE_REVERB = (1 << 4),
+				
+				/// A flag indicating whether or not the rendering quality of each cluster is scheduled by importance.
+				/**
+				  * If this flag is set, the renderer ranks the source clusters by their loudness
+				  * and distance from the listener, then divides the request's rendering time budget
+				  * among them, using the measured cost of recent audio blocks. Less important clusters
+				  * are rendered with shorter IRs, fewer discrete paths and lower-order HRTFs, so that
+				  * the rendering cost grows slowly with the number of sources.
+				  */
+				ADAPTIVE_QUALITY = (1 << 5),
+				
 				/// A flag indicating whether or not analytical information about the rendering system should be output.
 				/**
 				  * If this flag is set and a corresponding statistics object is set in the request,
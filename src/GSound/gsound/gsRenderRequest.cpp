@@ -73,13 +73,17 @@ RenderRequest:: RenderRequest()
 		channelLayout( ChannelLayout::STEREO ),
 		hrtf( NULL ),
 		maxHRTFOrder( 4 ),
+		hrtfCachePath(),
 		sampleRate( 44100.0 ),
 		statistics( NULL ),
 		numThreads( math::max( Size(CPU::getCount()*Float(0.5)), Size(1) ) ),
 		numUpdateThreads( /*math::max( Size(CPU::getCount()*Float(0.5)), Size(1) )*/ Size(1) ),
 		maxIRLength( 5.0f ),
+		earlyIRLength( 0.3f ),
 		maxLatency( 0.02f ),
 		maxSourcePathCount( 10 ),
+		renderingLoadBudget( 0.5f ),
+		minClusterQuality( 0.1f ),
 		maxPathDelay( 1.0f ),
 		maxDelayRate( 0.1f ),
 		irFadeTime( 0.066f ),
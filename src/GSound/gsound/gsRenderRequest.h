@@ -124,6 +124,17 @@ class RenderRequest
 			Size maxHRTFOrder;
 			
 			
+			/// The path of a directory where processed HRTFs are cached between runs.
+			/**
+			  * Processing an HRTF for rendering requires an expensive spherical harmonic fit.
+			  * If this path is not empty, the processed HRTF is written to the directory and
+			  * memory-mapped from there the next time the same HRTF is used with the same
+			  * sample rate and order, so that the fit is skipped. An empty path (the default)
+			  * disables the cache.
+			  */
+			UTF8String hrtfCachePath;
+			
+			
 			/// The sample rate at which sampled impulse responses should be computed and audio rendering should be performed.
 			/**
 			  * If using sampled impulse responses, this value should match the sample rate of the
@@ -180,6 +191,15 @@ class RenderRequest
 			Float maxIRLength;
 			
 			
+			/// The length in seconds of the early part of the IR that is rendered using convolution in late reverb mode.
+			/**
+			  * If the LATE_REVERB flag is set, only the part of each IR before this time
+			  * is rendered using convolution, while the rest of the IR is approximated by
+			  * a feedback delay network. This value is clamped to the range [0,maxIRLength].
+			  */
+			Float earlyIRLength;
+			
+			
 			/// The maximum allowed processing latency in seconds for the sound propagation renderer.
 			/**
 			  * The renderer will attempt, if it is possible, to process its audio stream with a latency that is
@@ -196,6 +216,23 @@ class RenderRequest
 			Size maxSourcePathCount;
 			
 			
+			/// The CPU time allowed for rendering each audio block if the ADAPTIVE_QUALITY flag is set.
+			/**
+			  * The budget is given as a fraction of the duration of each block, in the same units
+			  * as SoundStatistics::renderingLoad. The renderer measures the time it takes to render
+			  * each block and estimates the cost of rendering one unit of cluster quality from it.
+			  * It then gives each cluster a quality between minClusterQuality and 1, in order of
+			  * decreasing importance, so that the estimated rendering time stays within the budget.
+			  * The quality scales a cluster's IR length, path count and number of HRTF
+			  * spherical harmonic coefficients. The default value is 0.5.
+			  */
+			Float renderingLoadBudget;
+			
+			
+			/// The minimum quality, from 0 to 1, that any cluster is rendered with if the ADAPTIVE_QUALITY flag is set.
+			Float minClusterQuality;
+			
+			
 			/// The maximum delay time in seconds that a discrete propagation path is allowed to have.
 			/**
 			  * This value determines how much of a sound source's input audio is buffered in time domain
@@ -0,0 +1,356 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundHeatMap.cpp
+ * Contents:    gsound::SoundHeatMap class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "gsSoundHeatMap.h"
+
+
+#include <cstdio>
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Constructor
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundHeatMap:: SoundHeatMap()
+	:	lastObject( NULL ),
+		lastObjectIndex( 0 )
+{
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Hit Counting Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundHeatMap:: addHits( const SoundHeatMap& other )
+{
+	const Size numOtherObjects = other.objects.getSize();
+	
+	for ( Index i = 0; i < numOtherObjects; i++ )
+	{
+		const ObjectHits& otherHits = other.objects[i];
+		
+		if ( otherHits.totalHits == 0 )
+			continue;
+		
+		ObjectHits& objectHits = objects[getObjectIndex( otherHits.object )];
+		
+		// Ignore hits that were counted for a different mesh.
+		if ( objectHits.mesh != otherHits.mesh )
+			continue;
+		
+		const Size numTriangles = otherHits.hits.getSize();
+		
+		for ( Index t = 0; t < numTriangles; t++ )
+			objectHits.hits[t] += otherHits.hits[t];
+		
+		objectHits.totalHits += otherHits.totalHits;
+		objectHits.transform = otherHits.transform;
+	}
+}
+
+
+
+
+void SoundHeatMap:: clear()
+{
+	objects.clear();
+	objectIndices.clear();
+	lastObject = NULL;
+	lastObjectIndex = 0;
+}
+
+
+
+
+UInt64 SoundHeatMap:: getTotalHitCount() const
+{
+	UInt64 totalHits = 0;
+	
+	for ( Index i = 0; i < objects.getSize(); i++ )
+		totalHits += objects[i].totalHits;
+	
+	return totalHits;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Export Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundHeatMap:: savePLY( const UTF8String& filePath ) const
+{
+	om::File file( filePath );
+	
+	// Erase the file if it exists.
+	if ( !file.erase() )
+		return false;
+	
+	om::FileWriter writer( file );
+	
+	if ( !writer.open() )
+		return false;
+	
+	// Find the total number of triangles and the largest hit count for the color scale.
+	Size numTriangles = 0;
+	UInt64 maxHits = 0;
+	
+	for ( Index i = 0; i < objects.getSize(); i++ )
+	{
+		const ObjectHits& objectHits = objects[i];
+		numTriangles += objectHits.hits.getSize();
+		
+		for ( Index t = 0; t < objectHits.hits.getSize(); t++ )
+			maxHits = math::max( maxHits, objectHits.hits[t] );
+	}
+	
+	const Float logMaxHits = math::ln( Float(maxHits) + Float(1) );
+	char line[256];
+	
+	writer.writeASCII( "ply\nformat ascii 1.0\ncomment GSound ray hit heat map\n" );
+	
+	std::snprintf( line, sizeof(line), "element vertex %llu\n", (unsigned long long)(3*numTriangles) );
+	writer.writeASCII( line );
+	writer.writeASCII( "property float x\nproperty float y\nproperty float z\n" );
+	
+	std::snprintf( line, sizeof(line), "element face %llu\n", (unsigned long long)numTriangles );
+	writer.writeASCII( line );
+	writer.writeASCII( "property list uchar int vertex_indices\n"
+						"property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uint hits\nend_header\n" );
+	
+	// Write 3 unshared vertices per triangle so that each face can be colored independently.
+	Vector3f v[3];
+	
+	for ( Index i = 0; i < objects.getSize(); i++ )
+	{
+		const ObjectHits& objectHits = objects[i];
+		
+		for ( Index t = 0; t < objectHits.hits.getSize(); t++ )
+		{
+			getWorldTriangle( objectHits, t, v[0], v[1], v[2] );
+			
+			for ( Index k = 0; k < 3; k++ )
+			{
+				std::snprintf( line, sizeof(line), "%g %g %g\n", v[k].x, v[k].y, v[k].z );
+				writer.writeASCII( line );
+			}
+		}
+	}
+	
+	// Write the faces, interpolating from blue to red with the logarithm of the hit count.
+	Size vertexIndex = 0;
+	
+	for ( Index i = 0; i < objects.getSize(); i++ )
+	{
+		const ObjectHits& objectHits = objects[i];
+		
+		for ( Index t = 0; t < objectHits.hits.getSize(); t++, vertexIndex += 3 )
+		{
+			const UInt64 hits = objectHits.hits[t];
+			const Float a = logMaxHits > Float(0) ? math::ln( Float(hits) + Float(1) ) / logMaxHits : Float(0);
+			const UInt red = UInt(Float(255)*a);
+			const UInt green = UInt(Float(255)*(Float(1) - math::abs( Float(2)*a - Float(1) )));
+			const UInt blue = UInt(Float(255)*(Float(1) - a));
+			
+			std::snprintf( line, sizeof(line), "3 %llu %llu %llu %u %u %u %llu\n",
+							(unsigned long long)vertexIndex, (unsigned long long)(vertexIndex + 1),
+							(unsigned long long)(vertexIndex + 2), red, green, blue, (unsigned long long)hits );
+			writer.writeASCII( line );
+		}
+	}
+	
+	writer.close();
+	
+	return true;
+}
+
+
+
+
+Bool SoundHeatMap:: saveCSV( const UTF8String& filePath ) const
+{
+	om::File file( filePath );
+	
+	// Erase the file if it exists.
+	if ( !file.erase() )
+		return false;
+	
+	om::FileWriter writer( file );
+	
+	if ( !writer.open() )
+		return false;
+	
+	char line[256];
+	Vector3f v0, v1, v2;
+	
+	writer.writeASCII( "object,triangle,hits,area,hitsPerSquareMeter,centerX,centerY,centerZ\n" );
+	
+	for ( Index i = 0; i < objects.getSize(); i++ )
+	{
+		const ObjectHits& objectHits = objects[i];
+		
+		for ( Index t = 0; t < objectHits.hits.getSize(); t++ )
+		{
+			const UInt64 hits = objectHits.hits[t];
+			
+			if ( hits == 0 )
+				continue;
+			
+			getWorldTriangle( objectHits, t, v0, v1, v2 );
+			
+			const Float area = Float(0.5)*math::cross( v1 - v0, v2 - v0 ).getMagnitude();
+			const Vector3f center = (v0 + v1 + v2) / Float(3);
+			const Float density = area > Float(0) ? Float(hits) / area : Float(0);
+			
+			std::snprintf( line, sizeof(line), "%llu,%llu,%llu,%g,%g,%g,%g,%g\n",
+							(unsigned long long)i, (unsigned long long)t, (unsigned long long)hits,
+							area, density, center.x, center.y, center.z );
+			writer.writeASCII( line );
+		}
+	}
+	
+	writer.close();
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Private Helper Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Index SoundHeatMap:: getObjectIndex( const SoundObject* object )
+{
+	const Hash objectHash = getObjectHash( object );
+	Index* objectIndex;
+	
+	if ( objectIndices.find( objectHash, object, objectIndex ) )
+	{
+		ObjectHits& objectHits = objects[*objectIndex];
+		
+		// Restart the counts if the object's mesh has changed, since the triangle indices are no longer valid.
+		if ( objectHits.mesh != object->getMesh() )
+			objectHits = ObjectHits( object );
+		else
+			objectHits.transform = object->getTransform();
+		
+		return *objectIndex;
+	}
+	
+	const Index newIndex = objects.getSize();
+	objects.add( ObjectHits( object ) );
+	objectIndices.add( objectHash, object, newIndex );
+	
+	return newIndex;
+}
+
+
+
+
+void SoundHeatMap:: getWorldTriangle( const ObjectHits& objectHits, Index triangleIndex,
+									Vector3f& v0, Vector3f& v1, Vector3f& v2 )
+{
+	const SoundTriangle triangle = objectHits.mesh->getTriangle( triangleIndex );
+	
+	v0 = objectHits.transform.transformToWorld( objectHits.mesh->getVertex( triangle.v[0] ) );
+	v1 = objectHits.transform.transformToWorld( objectHits.mesh->getVertex( triangle.v[1] ) );
+	v2 = objectHits.transform.transformToWorld( objectHits.mesh->getVertex( triangle.v[2] ) );
+}
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
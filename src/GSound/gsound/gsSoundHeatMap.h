@@ -0,0 +1,297 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundHeatMap.h
+ * Contents:    gsound::SoundHeatMap class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_SOUND_HEAT_MAP_H
+#define INCLUDE_GSOUND_SOUND_HEAT_MAP_H
+
+
+#include "gsConfig.h"
+
+
+#include "gsSoundObject.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that counts the number of propagation ray hits on each triangle of each object.
+/**
+  * A heat map is attached to a PropagationRequest and accumulates hits over any number
+  * of propagation frames. The result shows which parts of a scene's geometry are hit
+  * most often, and therefore dominate the ray tracing cost, so that they can be
+  * simplified or given a lower level of detail. The counts can be exported for viewing
+  * as a PLY mesh with per-face colors or as a CSV table.
+  *
+  * Hits are only recorded when GSOUND_ENABLE_HEAT_MAP is enabled. The heat map should
+  * not be accessed while propagation that uses it is in progress.
+  *
+  * When the heat map is used with a SoundPropagationSystem, the objects that are
+  * hit are the system's internal snapshot copies, which share their mesh and user data
+  * with the original objects. Use getMesh() or getUserData() to identify them.
+  */
+class SoundHeatMap
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new empty heat map.
+			SoundHeatMap();
+			
+			
+		//********************************************************************************
+		//******	Hit Counting Methods
+			
+			
+			/// Count a hit on the triangle with the specified index in the given object's mesh.
+			GSOUND_FORCE_INLINE void addHit( const SoundObject* object, Index triangleIndex )
+			{
+				if ( object != lastObject )
+				{
+					lastObjectIndex = getObjectIndex( object );
+					lastObject = object;
+				}
+				
+				ObjectHits& objectHits = objects[lastObjectIndex];
+				objectHits.hits[triangleIndex]++;
+				objectHits.totalHits++;
+			}
+			
+			
+			/// Add all of the hits from another heat map to this heat map.
+			void addHits( const SoundHeatMap& other );
+			
+			
+			/// Remove all objects and hits from this heat map.
+			void clear();
+			
+			
+		//********************************************************************************
+		//******	Hit Accessor Methods
+			
+			
+			/// Return the number of objects that have been hit.
+			GSOUND_INLINE Size getObjectCount() const
+			{
+				return objects.getSize();
+			}
+			
+			
+			/// Return a pointer to the mesh of the object with the specified index.
+			GSOUND_INLINE const SoundMesh* getMesh( Index objectIndex ) const
+			{
+				return objects[objectIndex].mesh;
+			}
+			
+			
+			/// Return the transform of the object with the specified index when it was last hit.
+			GSOUND_INLINE const Transform3f& getTransform( Index objectIndex ) const
+			{
+				return objects[objectIndex].transform;
+			}
+			
+			
+			/// Return the user data of the object with the specified index.
+			GSOUND_INLINE void* getUserData( Index objectIndex ) const
+			{
+				return objects[objectIndex].userData;
+			}
+			
+			
+			/// Return the number of hits on the triangle with the specified index in the given object.
+			GSOUND_INLINE UInt64 getHitCount( Index objectIndex, Index triangleIndex ) const
+			{
+				return objects[objectIndex].hits[triangleIndex];
+			}
+			
+			
+			/// Return the total number of hits on all triangles of the object with the specified index.
+			GSOUND_INLINE UInt64 getHitCount( Index objectIndex ) const
+			{
+				return objects[objectIndex].totalHits;
+			}
+			
+			
+			/// Return the total number of hits on all objects.
+			UInt64 getTotalHitCount() const;
+			
+			
+		//********************************************************************************
+		//******	Export Methods
+			
+			
+			/// Save the heat map as an ASCII PLY mesh with a per-face color and hit count.
+			/**
+			  * The triangles are written in world space. Colors range from blue for
+			  * the least hit triangles to red for the most hit, using a logarithmic scale.
+			  * The method returns whether or not the file was successfully written.
+			  */
+			Bool savePLY( const UTF8String& filePath ) const;
+			
+			
+			/// Save the heat map as a CSV table with one row per triangle that was hit.
+			/**
+			  * Each row contains the object and triangle index, the hit count, the triangle's
+			  * world-space area and center, and the number of hits per square meter.
+			  * The method returns whether or not the file was successfully written.
+			  */
+			Bool saveCSV( const UTF8String& filePath ) const;
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Class Declaration
+			
+			
+			/// A class that stores the hit counts for a single object.
+			class ObjectHits
+			{
+				public:
+					
+					GSOUND_INLINE ObjectHits( const SoundObject* newObject )
+						:	object( newObject ),
+							mesh( newObject->getMesh() ),
+							transform( newObject->getTransform() ),
+							userData( newObject->getUserData() ),
+							hits( newObject->getMesh()->getTriangleCount(), UInt64(0) ),
+							totalHits( 0 )
+					{
+					}
+					
+					
+					/// The object that was hit.
+					const SoundObject* object;
+					
+					
+					/// The mesh of the object that was hit.
+					const SoundMesh* mesh;
+					
+					
+					/// The transform of the object when it was last hit.
+					Transform3f transform;
+					
+					
+					/// The user data of the object that was hit.
+					void* userData;
+					
+					
+					/// The number of hits for each triangle in the object's mesh.
+					Array<UInt64> hits;
+					
+					
+					/// The total number of hits for all triangles in the object's mesh.
+					UInt64 totalHits;
+					
+					
+			};
+			
+			
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Return the index of the hit counts for the specified object, adding a new entry if necessary.
+			Index getObjectIndex( const SoundObject* object );
+			
+			
+			/// Write the world-space vertices of the specified triangle of an object.
+			static void getWorldTriangle( const ObjectHits& objectHits, Index triangleIndex,
+										Vector3f& v0, Vector3f& v1, Vector3f& v2 );
+			
+			
+			/// Return a hash code for the specified object pointer.
+			GSOUND_FORCE_INLINE static Hash getObjectHash( const SoundObject* object )
+			{
+				return Hash(PointerInt(object) >> 4);
+			}
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// A list of the hit counts for each object that has been hit.
+			ArrayList<ObjectHits> objects;
+			
+			
+			/// A map from objects to the index of their hit counts.
+			HashMap<const SoundObject*,Index> objectIndices;
+			
+			
+			/// The last object that was hit, used to avoid a map lookup for consecutive hits on the same object.
+			const SoundObject* lastObject;
+			
+			
+			/// The index of the hit counts for the last object that was hit.
+			Index lastObjectIndex;
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SOUND_HEAT_MAP_H
@@ -127,6 +127,24 @@ class SoundListenerIR
 			}
 			
 			
+			/// Return a copy of the listener's state at the time when this IR was computed.
+			/**
+			  * Renderers that update from this IR on another thread read this copy
+			  * rather than the listener, which the application may be modifying.
+			  */
+			GSOUND_INLINE const SoundListener& getListenerState() const
+			{
+				return listenerState;
+			}
+			
+			
+			/// Set the copy of the listener's state that this IR is computed for.
+			GSOUND_INLINE void setListenerState( const SoundListener& newListenerState )
+			{
+				listenerState = newListenerState;
+			}
+			
+			
 		//********************************************************************************
 		//******	Sound Source Accessor Methods
 			
@@ -289,6 +307,10 @@ class SoundListenerIR
 			const SoundListener* listener;
 			
 			
+			/// A copy of the listener's state at the time when this IR was computed.
+			SoundListener listenerState;
+			
+			
 			/// An object specifying which frequencies this IR corresponds to.
 			FrequencyBands frequencies;
 			
@@ -52,6 +52,7 @@
 
 #include <algorithm>
 #include "fftw3.h"
+#include "gsSoundProfiler.h"
 
 
 /// A bias applied to input source audio in order to avoid denormal floating point numbers.
@@ -71,6 +72,9 @@ GSOUND_NAMESPACE_START
 //##########################################################################################
 
 
+const Float SoundListenerRenderer:: LOAD_ESTIMATE_RESPONSE = Float(0.25);
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -929,7 +933,19 @@ class SoundListenerRenderer:: ClusterState
 				:	sourceIR( NULL ),
 					gain( 1, 1, 0 ),
 					timeStamp( 0 ),
-					convolutionStateIndex( 0 )
+					convolutionStateIndex( 0 ),
+					lateReverbEnergy( Real(0) ),
+					lateReverbDecayTime( Real(0) ),
+					newLateReverbEnergy( Real(0) ),
+					newLateReverbDecayTime( Real(0) ),
+					hasNewLateReverb( 0 ),
+					importance( 0 ),
+					quality( 1 ),
+					maxPathCount( math::max<Size>() ),
+					maxIRLengthInSamples( math::max<Size>() ),
+					maxHRTFOrder( math::max<Size>() ),
+					lateReverbHistory( new ( om::util::allocateAligned<CrossoverType::History>( 1, 16 ) )
+											CrossoverType::History() )
 			{
 				reverb.setDryGain( 0 );
 				reverb.setWetGainDB( -25 );
@@ -941,6 +957,17 @@ class SoundListenerRenderer:: ClusterState
 			}
 			
 			
+		//********************************************************************************
+		//******	Destructor
+			
+			
+			/// Destroy this cluster render state, releasing all internal resources.
+			GSOUND_INLINE ~ClusterState()
+			{
+				om::util::deallocateAligned( lateReverbHistory );
+			}
+			
+			
 		//********************************************************************************
 		//******	Deallocate Method
 			
@@ -961,7 +988,8 @@ class SoundListenerRenderer:: ClusterState
 			GSOUND_INLINE Size getSizeInBytes() const
 			{
 				return sizeof(ClusterState) + sources.getCapacity()*sizeof(ClusteredSourceState*) +
-						pathRenderer.getSizeInBytes() + inputBuffer.getSizeInBytes() + outputBuffer.getSizeInBytes();
+						pathRenderer.getSizeInBytes() + inputBuffer.getSizeInBytes() + outputBuffer.getSizeInBytes() +
+						sizeof(CrossoverType::History);
 			}
 			
 			
@@ -1013,6 +1041,50 @@ class SoundListenerRenderer:: ClusterState
 			Index timeStamp;
 			
 			
+			/// The energy in each frequency band of the late part of this cluster's IR, used by the rendering thread.
+			FrequencyBandResponse lateReverbEnergy;
+			
+			
+			/// The decay time in seconds of the late part of this cluster's IR, used by the rendering thread.
+			FrequencyBandResponse lateReverbDecayTime;
+			
+			
+			/// The late IR energy that was most recently computed by the update thread.
+			FrequencyBandResponse newLateReverbEnergy;
+			
+			
+			/// The late IR decay time that was most recently computed by the update thread.
+			FrequencyBandResponse newLateReverbDecayTime;
+			
+			
+			/// An atomic flag indicating whether or not there are new late reverb parameters for the rendering thread.
+			Atomic<Size> hasNewLateReverb;
+			
+			
+			/// The crossover history used to split this cluster's input into bands for the late reverb.
+			CrossoverType::History* lateReverbHistory;
+			
+			
+			/// The perceptual importance of this cluster on the current frame.
+			Float importance;
+			
+			
+			/// The fraction of the full rendering quality, from 0 to 1, that this cluster was assigned.
+			Float quality;
+			
+			
+			/// The maximum number of discrete paths that are rendered for this cluster.
+			Size maxPathCount;
+			
+			
+			/// The maximum length in samples of this cluster's IR that is rendered using convolution.
+			Size maxIRLengthInSamples;
+			
+			
+			/// The maximum spherical harmonic order used to compute this cluster's HRTF filter.
+			Size maxHRTFOrder;
+			
+			
 };
 
 
@@ -1250,6 +1322,10 @@ SoundListenerRenderer:: SoundListenerRenderer()
 	:	request(),
 		timeStamp( 0 ),
 		processingLoad( 0 ),
+		totalBlockLoad( 0 ),
+		numLoadBlocks( 0 ),
+		loadPerQuality( 0 ),
+		scheduledQuality( 0 ),
 		maxFDLCount( DEFAULT_MAX_FDL_COUNT ),
 		minFDLSize( DEFAULT_MIN_FDL_SIZE ),
 		maxFDLSize( DEFAULT_MAX_FDL_SIZE ),
@@ -1273,6 +1349,10 @@ SoundListenerRenderer:: SoundListenerRenderer( const RenderRequest& newRequest )
 	:	request(),
 		timeStamp( 0 ),
 		processingLoad( 0 ),
+		totalBlockLoad( 0 ),
+		numLoadBlocks( 0 ),
+		loadPerQuality( 0 ),
+		scheduledQuality( 0 ),
 		maxFDLCount( DEFAULT_MAX_FDL_COUNT ),
 		minFDLSize( DEFAULT_MIN_FDL_SIZE ),
 		maxFDLSize( DEFAULT_MAX_FDL_SIZE ),
@@ -1440,7 +1520,7 @@ SoundListenerRenderer& SoundListenerRenderer:: operator = ( const SoundListenerR
 //##########################################################################################
 //##########################################################################################
 //############		
-//############		Size in Bytes Accessor Method
+//############		Size in Bytes Accessor Methods
 //############		
 //##########################################################################################
 //##########################################################################################
@@ -1490,12 +1570,62 @@ Size SoundListenerRenderer:: getSizeInBytesInternal() const
 	for ( Index i = 0; i < numUpdateStates; i++ )
 		totalSize += updateStates[i].getSizeInBytes();
 	
+	totalSize += lateReverb.getSizeInBytes() - sizeof(internal::FDNReverb);
+	totalSize += lateReverbInput.getSizeInBytes() + lateReverbClusterInput.getSizeInBytes();
+	totalSize += silentInputBuffer.getSizeInBytes();
+	
 	return totalSize;
 }
 
 
 
 
+void SoundListenerRenderer:: getMemoryUsage( SoundMemoryUsage& usage ) const
+{
+	renderingMutex.lock();
+	
+	usage.addLocalSize( sizeof(SoundListenerRenderer) );
+	
+	const Size numSourceStates = sourceStates.getSize();
+	SoundMemoryUsage& sourceUsage = usage.addChild( "source states", sourceStates.getSizeInBytes() );
+	
+	for ( Index i = 0; i < numSourceStates; i++ )
+		sourceUsage.addLocalSize( sourceStates[i]->getSizeInBytes() );
+	
+	const Size numClusterStates = clusterStates.getSize();
+	SoundMemoryUsage& clusterUsage = usage.addChild( "cluster states", clusterStates.getSizeInBytes() );
+	
+	for ( Index i = 0; i < numClusterStates; i++ )
+		clusterUsage.addLocalSize( clusterStates[i]->getSizeInBytes() );
+	
+	const Size numConvolutionStates = convolutionStates.getSize();
+	SoundMemoryUsage& convolutionUsage = usage.addChild( "convolution states", convolutionStates.getSizeInBytes() );
+	
+	for ( Index i = 0; i < numConvolutionStates; i++ )
+		convolutionUsage.addLocalSize( convolutionStates[i]->getSizeInBytes() );
+	
+	const Size numFDLs = fdls.getSize();
+	SoundMemoryUsage& fdlUsage = usage.addChild( "delay lines", fdls.getCapacity()*sizeof(FDLState*) );
+	
+	for ( Index i = 0; i < numFDLs; i++ )
+		fdlUsage.addLocalSize( fdls[i]->getSizeInBytes() );
+	
+	const Size numUpdateStates = updateStates.getSize();
+	SoundMemoryUsage& updateUsage = usage.addChild( "update states" );
+	
+	for ( Index i = 0; i < numUpdateStates; i++ )
+		updateUsage.addLocalSize( updateStates[i].getSizeInBytes() );
+	
+	usage.addChild( "late reverb", lateReverb.getSizeInBytes() - sizeof(internal::FDNReverb) +
+									lateReverbInput.getSizeInBytes() + lateReverbClusterInput.getSizeInBytes() );
+	usage.addChild( "silent input", silentInputBuffer.getSizeInBytes() );
+	
+	renderingMutex.unlock();
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -1526,7 +1656,10 @@ void SoundListenerRenderer:: updateRequest( const RenderRequest& newRequest )
 	request.numThreads = math::max( newRequest.numThreads, Size(1) );
 	request.numUpdateThreads = math::max( newRequest.numUpdateThreads, Size(1) );
 	request.maxSourcePathCount = newRequest.maxSourcePathCount;
+	request.renderingLoadBudget = math::max( newRequest.renderingLoadBudget, Float(0) );
+	request.minClusterQuality = math::clamp( newRequest.minClusterQuality, Float(0), Float(1) );
 	request.maxPathDelay = math::clamp( newRequest.maxPathDelay, Float(0), newRequest.maxIRLength );
+	request.earlyIRLength = math::clamp( newRequest.earlyIRLength, Float(0), newRequest.maxIRLength );
 	request.maxDelayRate = math::max( newRequest.maxDelayRate, Float(0) );
 	request.irFadeTime = math::max( newRequest.irFadeTime, Float(0) );
 	request.pathFadeTime = math::max( newRequest.pathFadeTime, Float(0) );
@@ -1535,6 +1668,7 @@ void SoundListenerRenderer:: updateRequest( const RenderRequest& newRequest )
 	request.clusterFadeOutTime = math::max( newRequest.clusterFadeOutTime, Float(0) );
 	request.volume = math::max( newRequest.volume, Float(0) );
 	request.maxHRTFOrder = math::clamp( newRequest.maxHRTFOrder, Size(0), Size(9) );
+	request.hrtfCachePath = newRequest.hrtfCachePath;
 	
 	//******************************************************************************
 	// Make sure the rendering thread pool has the correct number of threads.
@@ -1578,7 +1712,10 @@ void SoundListenerRenderer:: updateRequest( const RenderRequest& newRequest )
 		request.hrtf = newRequest.hrtf;
 		
 		if ( newRequest.hrtf )
+		{
+			hrtf.setCachePath( request.hrtfCachePath );
 			hrtf.setHRTF( *newRequest.hrtf, request.sampleRate, request.maxHRTFOrder );
+		}
 	}
 }
 
@@ -1598,6 +1735,8 @@ void SoundListenerRenderer:: updateRequest( const RenderRequest& newRequest )
 
 Bool SoundListenerRenderer:: updateIR( const SoundListenerIR& listenerIR, const RenderRequest& newRequest )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::updateIR" );
+	
 	// Lock a mutex to exclude the rendering thread from access while we update the source clusters.
 	renderingMutex.lock();
 	
@@ -1609,8 +1748,8 @@ Bool SoundListenerRenderer:: updateIR( const SoundListenerIR& listenerIR, const
 	// Update the rendering parameters from the request's data.
 	updateRequest( newRequest );
 	
-	// Update the listener sensitivity.
-	const SoundListener& listener = *listenerIR.getListener();
+	// Update the listener sensitivity, reading the listener state that the IR was computed for.
+	const SoundListener& listener = listenerIR.getListenerState();
 	const Real listenerPowerDB = listener.getSensitivity() + Real(10)*math::log10( Real(4)*gsound::math::pi<Real>() );
 	const Real targetListenerGain = request.volume * math::pow( Real(10), listenerPowerDB / Real(10) ) / POWER_BIAS;
 	
@@ -1734,6 +1873,16 @@ Bool SoundListenerRenderer:: updateIR( const SoundListenerIR& listenerIR, const
 		}
 	}
 	
+	// Clusters that were not in this IR keep rendering their last state while they fade out.
+	// Forget their old source IRs, since the IR that they belong to may be reused by the caller.
+	const Size numClusters = clusterStates.getSize();
+	
+	for ( Index i = 0; i < numClusters; i++ )
+	{
+		if ( !clusterStates.isUnused(i) && clusterStates[i]->timeStamp != timeStamp )
+			clusterStates[i]->sourceIR = NULL;
+	}
+	
 	//***********************************************************************
 	// Report rendering analytic information.
 	
@@ -1744,9 +1893,25 @@ Bool SoundListenerRenderer:: updateIR( const SoundListenerIR& listenerIR, const
 		newRequest.statistics->renderedPathCount = totalRenderedPathCount;
 		
 		// Compute the size in bytes of this renderer.
-		newRequest.statistics->renderingMemory += this->getSizeInBytesInternal();
+		newRequest.statistics->renderingMemory = this->getSizeInBytesInternal();
 	}
 	
+	//***********************************************************************
+	// Estimate the cost of cluster quality from the blocks rendered since the last update.
+	
+	if ( numLoadBlocks > 0 && scheduledQuality > math::epsilon<Float>() )
+	{
+		const Float blockLoadPerQuality = (totalBlockLoad / Float(numLoadBlocks)) / scheduledQuality;
+		
+		if ( loadPerQuality > Float(0) )
+			loadPerQuality += LOAD_ESTIMATE_RESPONSE*(blockLoadPerQuality - loadPerQuality);
+		else
+			loadPerQuality = blockLoadPerQuality;
+	}
+	
+	totalBlockLoad = 0;
+	numLoadBlocks = 0;
+	
 	//***********************************************************************
 	
 	renderingMutex.unlock();
@@ -1754,6 +1919,9 @@ Bool SoundListenerRenderer:: updateIR( const SoundListenerIR& listenerIR, const
 	//***********************************************************************
 	// Update the cluster and source IRs asynchronously in parallel.
 	
+	// Decide how much rendering quality each cluster gets on this frame.
+	scheduleClusterQuality();
+	
 	const Size numClusterStates = clusterStates.getSize();
 	
 	for ( Index i = 0; i < numClusterStates; i++ )
@@ -1791,6 +1959,8 @@ Bool SoundListenerRenderer:: updateIR( const SoundListenerIR& listenerIR, const
 void SoundListenerRenderer:: updateClusterIR( ClusterState& clusterState, const SoundSourceIR& ir,
 											const SoundListener& listener, const FrequencyBands& frequencies )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::updateClusterIR" );
+	
 	const Size numOutputChannels = request.channelLayout.getChannelCount();
 	
 	//***********************************************************************
@@ -1858,13 +2028,22 @@ void SoundListenerRenderer:: updateClusterIR( ClusterState& clusterState, const
 	
 	clusterState.reverb.setDecayTime( ir.getReverbTime() );
 	
+	// Estimate the late reverb parameters if the rendering thread has consumed the previous ones.
+	if ( request.flags.isSet( RenderFlags::LATE_REVERB ) && !clusterState.hasNewLateReverb )
+	{
+		updateLateReverb( clusterState, ir );
+		
+		// Atomically increment the late reverb indicator, signaling that there are new parameters to the renderer.
+		clusterState.hasNewLateReverb++;
+	}
+	
 	//***********************************************************************
 	// Update the path renderer with the new paths.
 	
 	PathRenderState& pathRenderer = clusterState.pathRenderer;
 	
 	const Bool pathRenderingEnabled = request.flags.isSet( RenderFlags::DISCRETE_PATHS );
-	const Size maxNumPaths = pathRenderingEnabled ? request.maxSourcePathCount : 0;
+	const Size maxNumPaths = pathRenderingEnabled ? math::min( request.maxSourcePathCount, clusterState.maxPathCount ) : 0;
 	const Size numPaths = ir.getPathCount();
 	
 	// Sort the paths by decreasing intensity if there are too many.
@@ -1926,7 +2105,7 @@ void SoundListenerRenderer:: updateClusterIR( ClusterState& clusterState, const
 	{
 		ConvolutionState& hrtfState = *convolutionStates[clusterState.hrtfConvolutionIndex];
 		
-		updateHRTF( hrtfState, ir, listener, *threadState );
+		updateHRTF( clusterState, hrtfState, ir, listener, *threadState );
 	}
 	
 	//***********************************************************************
@@ -1934,7 +2113,200 @@ void SoundListenerRenderer:: updateClusterIR( ClusterState& clusterState, const
 	
 	ConvolutionState& convolutionState = *convolutionStates[clusterState.convolutionStateIndex];
 	
-	updateConvolutionIR( convolutionState, ir, listener, frequencies, *threadState );
+	updateConvolutionIR( clusterState, convolutionState, ir, listener, frequencies, *threadState );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Late Reverb Update Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundListenerRenderer:: updateLateReverb( ClusterState& clusterState, const SoundSourceIR& ir )
+{
+	const SampledIR& sampledIR = ir.getSampledIR();
+	const SampleRate sampleRate = sampledIR.getSampleRate();
+	const Size irLength = sampledIR.getLengthInSamples();
+	const Size earlyLength = math::min( Size(request.earlyIRLength*sampleRate), irLength );
+	
+	//******************************************************************************
+	// Compute the energy and the energy-weighted arrival time of the late part of the IR.
+	
+	const SIMDBands* intensity = (const SIMDBands*)sampledIR.getIntensity() + earlyLength;
+	const SIMDBands* const intensityEnd = (const SIMDBands*)sampledIR.getIntensity() + irLength;
+	SIMDBands energy( 0.0f );
+	SIMDBands weightedTime( 0.0f );
+	SIMDBands time( 0.0f );
+	
+	while ( intensity != intensityEnd )
+	{
+		energy += *intensity;
+		weightedTime += (*intensity)*time;
+		time += SIMDBands(1.0f);
+		intensity++;
+	}
+	
+	//******************************************************************************
+	// Estimate the decay time for each band from the centre time of the late energy.
+	
+	// For an exponential energy decay, the centre time is the time constant and T60 = ln(10^6)*tau.
+	const Float decayPerCentreTime = math::ln( Float(1.0e6) );
+	const Float reverbTime = ir.getReverbTime();
+	
+	for ( Index b = 0; b < GSOUND_FREQUENCY_COUNT; b++ )
+	{
+		clusterState.newLateReverbEnergy[b] = energy[b];
+		
+		if ( energy[b] > math::epsilon<Float>() )
+		{
+			const Float centreTime = Float(weightedTime[b] / (energy[b]*sampleRate));
+			clusterState.newLateReverbDecayTime[b] = math::clamp( decayPerCentreTime*centreTime, Float(0.05), Float(100) );
+		}
+		else
+			clusterState.newLateReverbDecayTime[b] = math::clamp( reverbTime, Float(0.05), Float(100) );
+	}
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Cluster Quality Scheduling Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundListenerRenderer:: scheduleClusterQuality()
+{
+	const Size numClusterStates = clusterStates.getSize();
+	
+	// The total quality is accumulated below for the next estimate of the cost per unit of quality.
+	scheduledQuality = 0;
+	
+	if ( !request.flags.isSet( RenderFlags::ADAPTIVE_QUALITY ) )
+	{
+		// Render all clusters at full quality.
+		for ( Index i = 0; i < numClusterStates; i++ )
+		{
+			ClusterState& clusterState = *clusterStates[i];
+			clusterState.quality = Float(1);
+			clusterState.maxPathCount = math::max<Size>();
+			clusterState.maxIRLengthInSamples = math::max<Size>();
+			clusterState.maxHRTFOrder = math::max<Size>();
+		}
+		
+		return;
+	}
+	
+	//******************************************************************************
+	// Rank the active clusters by decreasing importance.
+	
+	ArrayList<ClusterState*> activeClusters;
+	Float totalImportance = 0;
+	
+	for ( Index i = 0; i < numClusterStates; i++ )
+	{
+		ClusterState& clusterState = *clusterStates[i];
+		
+		if ( clusterStates.isUnused(i) || clusterState.sourceIR == NULL )
+			continue;
+		
+		clusterState.importance = getClusterImportance( *clusterState.sourceIR );
+		totalImportance += clusterState.importance;
+		
+		// Insertion sort, the number of clusters is small.
+		Index insertIndex = activeClusters.getSize();
+		
+		while ( insertIndex > 0 && activeClusters[insertIndex - 1]->importance < clusterState.importance )
+			insertIndex--;
+		
+		activeClusters.insert( insertIndex, &clusterState );
+	}
+	
+	const Size numActiveClusters = activeClusters.getSize();
+	
+	if ( numActiveClusters == 0 )
+		return;
+	
+	//******************************************************************************
+	// Convert the rendering time budget to a total cluster quality.
+	
+	// Until the cost has been measured, start with full quality and let the measurements reduce it.
+	Float qualityBudget = Float(numActiveClusters);
+	
+	if ( loadPerQuality > Float(0) )
+		qualityBudget = math::min( request.renderingLoadBudget / loadPerQuality, qualityBudget );
+	
+	//******************************************************************************
+	// Divide the budget among the clusters in proportion to their importance.
+	
+	// Every cluster gets the minimum quality, unless the budget is too small for that.
+	const Float minQuality = math::min( request.minClusterQuality, qualityBudget / Float(numActiveClusters) );
+	Float remainingBudget = qualityBudget - minQuality*Float(numActiveClusters);
+	Float remainingImportance = totalImportance;
+	
+	const Size fullIRLength = (Size)math::ceiling( request.maxIRLength*request.sampleRate );
+	const Size fullPathCount = request.maxSourcePathCount;
+	const Size fullHRTFOrder = request.maxHRTFOrder;
+	
+	for ( Index i = 0; i < numActiveClusters; i++ )
+	{
+		ClusterState& clusterState = *activeClusters[i];
+		
+		// Clusters that reach full quality pass the rest of their share to the less important clusters.
+		Float extraQuality = 0;
+		
+		if ( remainingImportance > math::epsilon<Float>() )
+			extraQuality = remainingBudget*(clusterState.importance / remainingImportance);
+		else
+			extraQuality = remainingBudget / Float(numActiveClusters - i);
+		
+		extraQuality = math::clamp( extraQuality, Float(0), Float(1) - minQuality );
+		remainingBudget = math::max( remainingBudget - extraQuality, Float(0) );
+		remainingImportance -= clusterState.importance;
+		
+		const Float quality = minQuality + extraQuality;
+		clusterState.quality = quality;
+		scheduledQuality += quality;
+		
+		// The convolution and path costs scale linearly with the IR length and path count.
+		clusterState.maxIRLengthInSamples = (Size)math::ceiling( quality*Float(fullIRLength) );
+		clusterState.maxPathCount = (Size)math::ceiling( quality*Float(fullPathCount) );
+		
+		// The HRTF cost scales with the number of SH coefficients, (order + 1)^2.
+		const Size hrtfOrderCount = (Size)math::floor( math::sqrt( quality )*Float(fullHRTFOrder + 1) );
+		clusterState.maxHRTFOrder = hrtfOrderCount > 0 ? hrtfOrderCount - 1 : 0;
+	}
+}
+
+
+
+
+Float SoundListenerRenderer:: getClusterImportance( const SoundSourceIR& ir )
+{
+	// Perceived loudness grows roughly like the 0.3 power of intensity.
+	const Float intensity = ir.getTotalIntensity().getAverage();
+	const Float loudness = math::pow( math::max( intensity, Float(0) ), Float(0.3) );
+	
+	// Estimate the distance to the closest source in the cluster from the IR's earliest arrival.
+	// The sources are not read because the application may be moving them during the update.
+	const Float distance = ir.getStartTime()*SoundMedium::AIR.getSpeed();
+	
+	// Nearby sources are more easily localized, so their quality matters more.
+	return loudness / (Float(1) + distance);
 }
 
 
@@ -1951,8 +2323,9 @@ void SoundListenerRenderer:: updateClusterIR( ClusterState& clusterState, const
 
 
 
-void SoundListenerRenderer:: updateHRTF( ConvolutionState& convolutionState, const SoundSourceIR& sourceIR,
-										const SoundListener& listener, UpdateThreadState& threadState )
+void SoundListenerRenderer:: updateHRTF( const ClusterState& clusterState, ConvolutionState& convolutionState,
+										const SoundSourceIR& sourceIR, const SoundListener& listener,
+										UpdateThreadState& threadState )
 {
 	const Size numOutputChannels = hrtf.getChannelCount();
 	
@@ -1960,7 +2333,7 @@ void SoundListenerRenderer:: updateHRTF( ConvolutionState& convolutionState, con
 	// Compute an orthonormal spherical harmonic basis of the direct sound that is arriving.
 	
 	const Size numPaths = sourceIR.getPathCount();
-	const Index hrtfOrder = hrtf.getSHOrder();
+	const Index hrtfOrder = math::min( hrtf.getSHOrder(), clusterState.maxHRTFOrder );
 	Size numDirectionSamples = 0;
 	
 	// Zero the spherical harmonic basis.
@@ -2086,19 +2459,27 @@ void SoundListenerRenderer:: updateHRTF( ConvolutionState& convolutionState, con
 
 
 
-void SoundListenerRenderer:: updateConvolutionIR( ConvolutionState& convolutionState, const SoundSourceIR& sourceIR,
-												const SoundListener& listener, const FrequencyBands& frequencies,
-												UpdateThreadState& threadState )
+void SoundListenerRenderer:: updateConvolutionIR( const ClusterState& clusterState, ConvolutionState& convolutionState,
+												const SoundSourceIR& sourceIR, const SoundListener& listener,
+												const FrequencyBands& frequencies, UpdateThreadState& threadState )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::updateConvolutionIR" );
+	
 	const SampledIR& ir = sourceIR.getSampledIR();
-	const Size sampledIRLength = math::min( ir.getLengthInSamples(), convolutionState.maxIRLengthInSamples );
 	const Index irStart = sourceIR.getStartTimeInSamples();
-	const Size irLength = math::min( sourceIR.getLengthInSamples(), convolutionState.maxIRLengthInSamples );
+	
+	// Only render the early part of the IR with convolution if late reverb is enabled.
+	const Size scheduledIRLength = math::min( convolutionState.maxIRLengthInSamples, clusterState.maxIRLengthInSamples );
+	const Size maxIRLengthInSamples = request.flags.isSet( RenderFlags::LATE_REVERB ) ?
+									math::min( Size(request.earlyIRLength*request.sampleRate), scheduledIRLength ) :
+									scheduledIRLength;
+	const Size sampledIRLength = math::min( ir.getLengthInSamples(), maxIRLengthInSamples );
+	const Size irLength = math::min( sourceIR.getLengthInSamples(), maxIRLengthInSamples );
 	const Size numOutputChannels = request.channelLayout.getChannelCount();
 	
 	const Size maxPathDelay = sourceIR.getMaxPathDelayInSamples();
 	const Bool pathRenderingEnabled = request.flags.isSet( RenderFlags::DISCRETE_PATHS );
-	const Size maxNumPaths = pathRenderingEnabled ? request.maxSourcePathCount : 0;
+	const Size maxNumPaths = pathRenderingEnabled ? math::min( request.maxSourcePathCount, clusterState.maxPathCount ) : 0;
 	const PathSortID* extraPaths = threadState.pathSortIDs.getPointer() + maxNumPaths;
 	const Size numExtraPaths = threadState.pathSortIDs.getSize() > maxNumPaths ? 
 								threadState.pathSortIDs.getSize() - maxNumPaths : 0;
@@ -2463,6 +2844,8 @@ void SoundListenerRenderer:: clearIR()
 
 Size SoundListenerRenderer:: render( const SourceSoundBuffer& sourceInputBuffers, SoundBuffer& outputBuffer, const Time& outputLength )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::render" );
+	
 	// Create a timer for this audio frame.
 	Timer frameTimer;
 	
@@ -2485,6 +2868,13 @@ Size SoundListenerRenderer:: render( const SourceSoundBuffer& sourceInputBuffers
 	// Zero the output buffer.
 	outputBuffer.zero( 0, numSamples );
 	
+	// Make sure there is enough silence for sources that have no input on this block.
+	if ( silentInputBuffer.getSize() < numSamples || silentInputBuffer.getChannelCount() != Size(1) )
+	{
+		silentInputBuffer.setFormat( Size(1), numSamples );
+		silentInputBuffer.zero();
+	}
+	
 	//******************************************************************************
 	
 	// Prepare the input audio for each sound source.
@@ -2547,6 +2937,10 @@ Size SoundListenerRenderer:: render( const SourceSoundBuffer& sourceInputBuffers
 	if ( request.flags.isSet( RenderFlags::REVERB ) )
 		renderReverb( numSamples );
 	
+	// Render the late part of the IRs using the shared feedback delay network.
+	if ( request.flags.isSet( RenderFlags::LATE_REVERB ) )
+		renderLateReverb( outputBuffer, numSamples );
+	
 	//******************************************************************************
 	// Accumulate the cluster output audio to the main output buffer.
 	
@@ -2556,6 +2950,8 @@ Size SoundListenerRenderer:: render( const SourceSoundBuffer& sourceInputBuffers
 	
 	// Compute the fraction of the time spent rendering the sound.
 	processingLoad = Float(frameTimer.getElapsedTime() / outputLength);
+	totalBlockLoad += processingLoad;
+	numLoadBlocks++;
 	
 	renderingMutex.unlock();
 	
@@ -2578,6 +2974,8 @@ Size SoundListenerRenderer:: render( const SourceSoundBuffer& sourceInputBuffers
 
 void SoundListenerRenderer:: bufferSourceInput( const SourceSoundBuffer& sourceInput, Size numSamples )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::bufferSourceInput" );
+	
 	// Prepare the input audio for each sound source.
 	const Size numInputSources = sourceInput.getSourceCount();
 	
@@ -2707,6 +3105,8 @@ void SoundListenerRenderer:: bufferSourceInput( const SourceSoundBuffer& sourceI
 
 void SoundListenerRenderer:: mixClusterInput( Size numSamples )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::mixClusterInput" );
+	
 	// The length of the output buffer in seconds.
 	const Float outputLength = Float(numSamples) / Float(request.sampleRate);
 	const Size numClusterStates = clusterStates.getSize();
@@ -2779,8 +3179,14 @@ void SoundListenerRenderer:: mixClusterInput( Size numSamples )
 				continue;
 			}
 			
+			// A source that was removed from the scene before its last IR was rendered
+			// may never have been buffered, so mix silence for it.
+			const Bool sourceBuffered = sourceInputBuffer.getChannelCount() >= Size(1) &&
+										sourceInputBuffer.getSize() >= numSamples;
+			
 			Sample32f* clusterInput = clusterInputStart;
-			const Sample32f* sourceInput = sourceInputBuffer.getChannel(0);
+			const Sample32f* sourceInput = sourceBuffered ? sourceInputBuffer.getChannel(0) :
+																silentInputBuffer.getChannel(0);
 			const Sample32f* const sourceInputEnd = sourceInput + numSamples;
 			
 			Gain currentSourceGain = sourceGain.current;
@@ -2875,6 +3281,8 @@ void SoundListenerRenderer:: mixClusterInput( Size numSamples )
 
 void SoundListenerRenderer:: mixClusterOutput( SoundBuffer& outputBuffer, Size numSamples )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::mixClusterOutput" );
+	
 	const Float outputLength = Float(numSamples) / Float(request.sampleRate);
 	const Size numClusterStates = clusterStates.getSize();
 	const Size numOutputChannels = request.channelLayout.getChannelCount();
@@ -3074,6 +3482,8 @@ void SoundListenerRenderer:: mixClusterOutput( SoundBuffer& outputBuffer, Size n
 
 void SoundListenerRenderer:: renderReverb( Size numSamples )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::renderReverb" );
+	
 	const Size numClusterStates = clusterStates.getSize();
 	SharedSoundBuffer sharedBuffer = SharedBufferPool::getGlobalBuffer( request.channelLayout.getChannelCount(), numSamples, request.sampleRate );
 	
@@ -3131,6 +3541,137 @@ void SoundListenerRenderer:: renderReverb( Size numSamples )
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Late Reverb Rendering Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundListenerRenderer:: renderLateReverb( SoundBuffer& outputBuffer, Size numSamples )
+{
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::renderLateReverb" );
+	
+	const Size numClusterStates = clusterStates.getSize();
+	const Size numOutputChannels = request.channelLayout.getChannelCount();
+	
+	if ( lateReverb.getSampleRate() != request.sampleRate )
+		lateReverb.setSampleRate( request.sampleRate );
+	
+	//******************************************************************************
+	// Update the late reverb parameters for each cluster and compute the energy-weighted decay time.
+	
+	SIMDBands totalEnergy( 0.0f );
+	SIMDBands totalDecayTime( 0.0f );
+	
+	for ( Index i = 0; i < numClusterStates; i++ )
+	{
+		ClusterState& clusterState = *clusterStates[i];
+		
+		// Skip unused cluster states.
+		if ( clusterStates.isUnused(i) )
+			continue;
+		
+		// Consume the latest parameters from the update thread.
+		if ( clusterState.hasNewLateReverb )
+		{
+			clusterState.lateReverbEnergy = clusterState.newLateReverbEnergy;
+			clusterState.lateReverbDecayTime = clusterState.newLateReverbDecayTime;
+			
+			// Atomically signal to the update thread that the parameters were consumed.
+			clusterState.hasNewLateReverb--;
+		}
+		
+		const Gain clusterGain2 = clusterState.gain.current*clusterState.gain.current;
+		
+		for ( Index b = 0; b < GSOUND_FREQUENCY_COUNT; b++ )
+		{
+			const Float32 energy = clusterState.lateReverbEnergy[b]*clusterGain2;
+			totalEnergy[b] += energy;
+			totalDecayTime[b] += energy*clusterState.lateReverbDecayTime[b];
+		}
+	}
+	
+	// Keep the previous decay time for bands that have no late energy.
+	SIMDBands decayTime = lateReverb.getDecayTime();
+	
+	for ( Index b = 0; b < GSOUND_FREQUENCY_COUNT; b++ )
+	{
+		if ( totalEnergy[b] > Float32(0) )
+			decayTime[b] = totalDecayTime[b] / totalEnergy[b];
+	}
+	
+	lateReverb.setDecayTime( decayTime );
+	
+	// Delay the network's input so that its first output coincides with the end of the early IR.
+	lateReverb.setPreDelay( math::max( request.earlyIRLength - lateReverb.getMinDelayTime(), Float(0) ) );
+	
+	//******************************************************************************
+	// Make sure the late reverb input buffers are big enough.
+	
+	const Size numBandSamples = numSamples*SIMDBands::getWidth();
+	
+	if ( lateReverbInput.getChannelCount() != Size(1) || lateReverbInput.getSampleCount() < numBandSamples )
+		lateReverbInput.setFormat( Size(1), numBandSamples );
+	
+	if ( lateReverbClusterInput.getChannelCount() != Size(1) || lateReverbClusterInput.getSampleCount() < numBandSamples )
+		lateReverbClusterInput.setFormat( Size(1), numBandSamples );
+	
+	lateReverbInput.allocate();
+	lateReverbClusterInput.allocate();
+	lateReverbInput.zero();
+	
+	//******************************************************************************
+	// Accumulate the band-split input audio for each cluster, scaled to match its late IR energy.
+	
+	const SIMDBands energyGain = lateReverb.getEnergyGain();
+	SIMDBands* const input = (SIMDBands*)lateReverbInput.getChannel(0);
+	SIMDBands* const clusterInput = (SIMDBands*)lateReverbClusterInput.getChannel(0);
+	
+	for ( Index i = 0; i < numClusterStates; i++ )
+	{
+		ClusterState& clusterState = *clusterStates[i];
+		
+		// Skip unused cluster states.
+		if ( clusterStates.isUnused(i) )
+			continue;
+		
+		SIMDBands energy;
+		
+		for ( Index b = 0; b < GSOUND_FREQUENCY_COUNT; b++ )
+			energy[b] = clusterState.lateReverbEnergy[b];
+		
+		// Skip clusters that don't contribute any late reverb.
+		if ( math::sumScalar( energy ) <= Float32(0) || clusterState.gain.current == Gain(0) )
+		{
+			clusterState.lateReverbHistory->reset();
+			continue;
+		}
+		
+		// Compute the gain for each band so that the network output has the same energy as the late IR.
+		// The factor of 3 matches the variance of the uniform noise used to synthesize the convolution IR.
+		const SIMDBands bandGain = math::sqrt( energy / (Float32(3)*energyGain) )*clusterState.gain.current;
+		
+		crossover.filterScalar( *clusterState.lateReverbHistory, clusterState.inputBuffer.getChannel(0),
+								(Float32*)clusterInput, numSamples );
+		
+		for ( Index n = 0; n < numSamples; n++ )
+			input[n] += clusterInput[n]*bandGain;
+	}
+	
+	//******************************************************************************
+	// Render the late reverb to the output.
+	
+	lateReverb.process( input, outputBuffer, numOutputChannels, numSamples );
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -3144,6 +3685,8 @@ void SoundListenerRenderer:: renderReverb( Size numSamples )
 
 void SoundListenerRenderer:: renderPaths( Size numSamples )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::renderPaths" );
+	
 	const Size numClusterStates = clusterStates.getSize();
 	
 	// Render the paths for each cluster state.
@@ -3572,6 +4115,8 @@ void SoundListenerRenderer:: updatePathIR( PathRenderState& renderer, RenderThre
 
 void SoundListenerRenderer:: renderConvolution( Size numSamples )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::renderConvolution" );
+	
 	const Size numClusterStates = clusterStates.getSize();
 	const Bool hrtfEnabled = request.flags.isSet( RenderFlags::HRTF );
 	
@@ -3815,6 +4360,8 @@ void SoundListenerRenderer:: advanceConvolutionOutput( ConvolutionState& convolu
 
 void SoundListenerRenderer:: processFFTFrame( Size numDeadlines )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::processFFTFrame" );
+	
 	//******************************************************************************
 	// Wait for all of the needed FDLs to finish processing.
 	
@@ -3988,6 +4535,8 @@ void SoundListenerRenderer:: processFFTFrame( Size numDeadlines )
 
 void SoundListenerRenderer:: renderFDL( const FDLState& fdlState, ConvolutionState& convolutionState, FDL& fdl )
 {
+	GSOUND_PROFILE_ZONE( "SoundListenerRenderer::renderFDL" );
+	
 	RenderThreadState& threadState = renderStates[renderThreadPool.getCurrentThreadIndex()];
 	SampleBuffer<ComplexSample>& fftBuffer = threadState.fftBuffer;
 	
@@ -4573,6 +5122,12 @@ SoundListenerRenderer::ClusterState* SoundListenerRenderer:: createCluster()
 	// Make sure the crossover history is zero.
 	pathRenderer.crossoverHistory->reset();
 	
+	//******************************************************************************
+	// Reset the late reverb state.
+	
+	clusterState->lateReverbEnergy = FrequencyBandResponse( Real(0) );
+	clusterState->lateReverbHistory->reset();
+	
 	
 	//******************************************************************************
 	
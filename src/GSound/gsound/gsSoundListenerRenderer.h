@@ -57,9 +57,11 @@
 #include "gsSoundListenerIR.h"
 #include "gsRenderRequest.h"
 #include "gsSourceSoundBuffer.h"
+#include "gsSoundMemoryUsage.h"
 #include "internal/gsPanLookupTable.h"
 #include "internal/gsSIMDCrossover.h"
 #include "internal/gsHRTFFilter.h"
+#include "internal/gsFDNReverb.h"
 #include "internal/gsSampleBuffer.h"
 
 
@@ -245,6 +247,15 @@ class SoundListenerRenderer
 			Size getSizeInBytes() const;
 			
 			
+			/// Add children to the memory usage object that break down the memory allocated by this listener renderer.
+			/**
+			  * There are children for the source states, cluster states, convolution states,
+			  * frequency-domain delay lines, IR update states, and late reverb.
+			  * Like getSizeInBytes(), this function requires acquiring the rendering mutex.
+			  */
+			void getMemoryUsage( SoundMemoryUsage& usage ) const;
+			
+			
 	private:
 		
 		//********************************************************************************
@@ -484,6 +495,10 @@ class SoundListenerRenderer
 			void renderReverb( Size numSamples );
 			
 			
+			/// Render the late part of each cluster's IR using the shared feedback delay network, mixing to the output.
+			void renderLateReverb( SoundBuffer& outputBuffer, Size numSamples );
+			
+			
 			/// Return the total size in bytes of the memory allocated by this listener renderer.
 			GSOUND_FORCE_INLINE Size getSizeInBytesInternal() const;
 			
@@ -602,14 +617,26 @@ class SoundListenerRenderer
 								const SoundListener& listener, const FrequencyBands& frequencies );
 			
 			
+			/// Estimate the energy and decay time of the late part of the specified IR for a cluster.
+			void updateLateReverb( ClusterState& clusterState, const SoundSourceIR& ir );
+			
+			
+			/// Rank the active clusters by importance and assign each a rendering quality within the request's budget.
+			void scheduleClusterQuality();
+			
+			
+			/// Return the perceptual importance of a cluster's IR, based on its loudness and distance from the listener.
+			static Float getClusterImportance( const SoundSourceIR& ir );
+			
+			
 			void updatePathIR( PathRenderState& renderer, RenderThreadState& threadState );
 			
 			
-			void updateHRTF( ConvolutionState& convolutionState, const SoundSourceIR& sourceIR,
+			void updateHRTF( const ClusterState& clusterState, ConvolutionState& convolutionState, const SoundSourceIR& sourceIR,
 							const SoundListener& listener, UpdateThreadState& threadState );
 			
 			
-			void updateConvolutionIR( ConvolutionState& convolutionState, const SoundSourceIR& sourceIR,
+			void updateConvolutionIR( const ClusterState& clusterState, ConvolutionState& convolutionState, const SoundSourceIR& sourceIR,
 										const SoundListener& listener, const FrequencyBands& frequencies,
 										UpdateThreadState& threadState );
 			
@@ -686,6 +713,10 @@ class SoundListenerRenderer
 			static const Size DEFAULT_MAX_FDL_SIZE = 32768;
 			
 			
+			/// The fraction of the difference from each new measurement that the cluster quality cost estimate moves by.
+			static const Float LOAD_ESTIMATE_RESPONSE;
+			
+			
 		//********************************************************************************
 		//******	Private Data Members
 			
@@ -717,6 +748,14 @@ class SoundListenerRenderer
 			RenderThreadState sharedRenderState;
 			
 			
+			/// A single-channel buffer of silence that is mixed for sources that have no buffered input.
+			/**
+			  * The buffer is resized only when the block size grows, so that mixing the cluster
+			  * input never allocates memory for a source on the rendering thread.
+			  */
+			SoundBuffer silentInputBuffer;
+			
+			
 			/// A list of objects that store thread-local state for each update thread.
 			ArrayList<UpdateThreadState> updateStates;
 			
@@ -733,6 +772,18 @@ class SoundListenerRenderer
 			CrossoverType crossover;
 			
 			
+			/// A feedback delay network that renders the late reverberation for all clusters in late reverb mode.
+			internal::FDNReverb lateReverb;
+			
+			
+			/// A buffer of band-interleaved samples that accumulates the input to the late reverb.
+			internal::SampleBuffer<Float32> lateReverbInput;
+			
+			
+			/// A temporary buffer of band-interleaved samples for a single cluster's late reverb input.
+			internal::SampleBuffer<Float32> lateReverbClusterInput;
+			
+			
 			/// The update timestamp for this listener renderer.
 			/**
 			  * This value is increased by 1 each time the IR for the renderer is updated.
@@ -758,6 +809,22 @@ class SoundListenerRenderer
 			Float processingLoad;
 			
 			
+			/// The sum of the processing loads of the blocks rendered since the cluster quality was last scheduled.
+			Float totalBlockLoad;
+			
+			
+			/// The number of blocks rendered since the cluster quality was last scheduled.
+			Size numLoadBlocks;
+			
+			
+			/// The smoothed processing load measured for each unit of cluster quality, or 0 if it is unknown.
+			Float loadPerQuality;
+			
+			
+			/// The total quality of the active clusters when the quality was last scheduled.
+			Float scheduledQuality;
+			
+			
 			/// A mutex that is locked whenever rendering is being done on the main rendering thread.
 			mutable Mutex renderingMutex;
 			
@@ -0,0 +1,330 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundMemoryUsage.cpp
+ * Contents:    gsound::SoundMemoryUsage class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "gsSoundMemoryUsage.h"
+
+
+#include <cstdio>
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+/// Write a size in bytes to a character buffer using the largest unit that keeps the value above 1.
+static void formatSize( Size numBytes, char* output, Size outputCapacity )
+{
+	if ( numBytes >= Size(1) << 30 )
+		std::snprintf( output, outputCapacity, "%.2f GB", Double(numBytes) / Double(Size(1) << 30) );
+	else if ( numBytes >= Size(1) << 20 )
+		std::snprintf( output, outputCapacity, "%.2f MB", Double(numBytes) / Double(Size(1) << 20) );
+	else if ( numBytes >= Size(1) << 10 )
+		std::snprintf( output, outputCapacity, "%.2f KB", Double(numBytes) / Double(Size(1) << 10) );
+	else
+		std::snprintf( output, outputCapacity, "%llu B", (unsigned long long)numBytes );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Constructors
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundMemoryUsage:: SoundMemoryUsage()
+	:	localSize( 0 ),
+		budget( 0 )
+{
+}
+
+
+
+
+SoundMemoryUsage:: SoundMemoryUsage( const UTF8String& newName, Size newSize )
+	:	name( newName ),
+		localSize( newSize ),
+		budget( 0 )
+{
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Size Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Size SoundMemoryUsage:: getSize() const
+{
+	Size totalSize = localSize;
+	const Size numChildren = children.getSize();
+	
+	for ( Index i = 0; i < numChildren; i++ )
+		totalSize += children[i].getSize();
+	
+	return totalSize;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Budget Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundMemoryUsage:: setBudget( const UTF8String& path, Size newBudget )
+{
+	SoundMemoryUsage* usage = this->findChild( path );
+	
+	if ( usage == NULL )
+		return false;
+	
+	usage->budget = newBudget;
+	
+	return true;
+}
+
+
+
+
+Size SoundMemoryUsage:: getWarnings( ArrayList<UTF8String>& warnings ) const
+{
+	return this->getWarnings( UTF8String(), warnings );
+}
+
+
+
+
+Size SoundMemoryUsage:: getWarnings( const UTF8String& prefix, ArrayList<UTF8String>& warnings ) const
+{
+	const UTF8String path = prefix.getLength() > 0 ? prefix + "/" + name : name;
+	Size numWarnings = 0;
+	
+	if ( this->isOverBudget() )
+	{
+		char sizeString[32];
+		char budgetString[32];
+		formatSize( this->getSize(), sizeString, sizeof(sizeString) );
+		formatSize( budget, budgetString, sizeof(budgetString) );
+		
+		warnings.add( (path.getLength() > 0 ? path : UTF8String("total")) +
+						UTF8String(" uses ") + UTF8String(sizeString) +
+						UTF8String(", which exceeds its budget of ") + UTF8String(budgetString) );
+		numWarnings++;
+	}
+	
+	const Size numChildren = children.getSize();
+	
+	for ( Index i = 0; i < numChildren; i++ )
+		numWarnings += children[i].getWarnings( path, warnings );
+	
+	return numWarnings;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Child Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundMemoryUsage* SoundMemoryUsage:: findChild( const UTF8String& path )
+{
+	return const_cast<SoundMemoryUsage*>( ((const SoundMemoryUsage*)this)->findChild( path ) );
+}
+
+
+
+
+const SoundMemoryUsage* SoundMemoryUsage:: findChild( const UTF8String& path ) const
+{
+	const SoundMemoryUsage* usage = this;
+	const om::UTF8Char* component = path.getCString();
+	
+	while ( usage != NULL && *component != '\0' )
+	{
+		// Find the end of the next path component.
+		const om::UTF8Char* componentEnd = component;
+		
+		while ( *componentEnd != '\0' && *componentEnd != '/' )
+			componentEnd++;
+		
+		const UTF8String childName( component, componentEnd - component );
+		const Size numChildren = usage->children.getSize();
+		const SoundMemoryUsage* child = NULL;
+		
+		for ( Index i = 0; i < numChildren; i++ )
+		{
+			if ( usage->children[i].name == childName )
+			{
+				child = &usage->children[i];
+				break;
+			}
+		}
+		
+		usage = child;
+		component = *componentEnd == '/' ? componentEnd + 1 : componentEnd;
+	}
+	
+	return usage;
+}
+
+
+
+
+SoundMemoryUsage& SoundMemoryUsage:: addChild( const UTF8String& childName, Size childSize )
+{
+	children.add( SoundMemoryUsage( childName, childSize ) );
+	
+	return children.getLast();
+}
+
+
+
+
+void SoundMemoryUsage:: clear()
+{
+	children.clear();
+	localSize = 0;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		String Conversion Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+UTF8String SoundMemoryUsage:: toString( Size maxDepth ) const
+{
+	om::UTF8StringBuffer buffer;
+	
+	this->toString( buffer, 0, maxDepth );
+	
+	return buffer.toString();
+}
+
+
+
+
+void SoundMemoryUsage:: toString( om::UTF8StringBuffer& buffer, Size depth, Size maxDepth ) const
+{
+	char line[128];
+	formatSize( this->getSize(), line, sizeof(line) );
+	
+	for ( Index i = 0; i < depth; i++ )
+		buffer << "  ";
+	
+	buffer << (name.getLength() > 0 ? name : UTF8String("total")) << ": " << line;
+	
+	if ( budget > 0 )
+	{
+		formatSize( budget, line, sizeof(line) );
+		buffer << " (budget " << line << (this->isOverBudget() ? ", exceeded)" : ")");
+	}
+	
+	buffer << '\n';
+	
+	if ( depth >= maxDepth )
+		return;
+	
+	const Size numChildren = children.getSize();
+	
+	for ( Index i = 0; i < numChildren; i++ )
+		children[i].toString( buffer, depth + 1, maxDepth );
+}
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,297 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundMemoryUsage.h
+ * Contents:    gsound::SoundMemoryUsage class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_SOUND_MEMORY_USAGE_H
+#define INCLUDE_GSOUND_SOUND_MEMORY_USAGE_H
+
+
+#include "gsConfig.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that describes a hierarchical breakdown of the memory used by part of a sound system.
+/**
+  * Each memory usage object has a name, a number of bytes that it uses directly,
+  * and a list of child objects that break the memory down further, e.g. a mesh
+  * has children for its vertices, triangles, BVH, and diffraction graph.
+  * The total size of an object includes the sizes of all of its children.
+  *
+  * Any object in the hierarchy can be given a memory budget in bytes. If the total
+  * size exceeds the budget, a warning is reported by getWarnings(). Objects
+  * can be looked up with a path of child names separated by '/', such as "rendering"
+  * or "scene/mesh 0/bvh".
+  */
+class SoundMemoryUsage
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructors
+			
+			
+			/// Create a new memory usage object with no name that uses no memory.
+			SoundMemoryUsage();
+			
+			
+			/// Create a new memory usage object with the specified name and size in bytes.
+			SoundMemoryUsage( const UTF8String& newName, Size newSize = 0 );
+			
+			
+		//********************************************************************************
+		//******	Name Accessor Methods
+			
+			
+			/// Return the name of this memory usage object.
+			GSOUND_INLINE const UTF8String& getName() const
+			{
+				return name;
+			}
+			
+			
+			/// Set the name of this memory usage object.
+			GSOUND_INLINE void setName( const UTF8String& newName )
+			{
+				name = newName;
+			}
+			
+			
+		//********************************************************************************
+		//******	Size Accessor Methods
+			
+			
+			/// Return the total number of bytes used by this object and all of its children.
+			Size getSize() const;
+			
+			
+			/// Return the number of bytes used directly by this object, not including its children.
+			GSOUND_INLINE Size getLocalSize() const
+			{
+				return localSize;
+			}
+			
+			
+			/// Set the number of bytes used directly by this object, not including its children.
+			GSOUND_INLINE void setLocalSize( Size newSize )
+			{
+				localSize = newSize;
+			}
+			
+			
+			/// Add to the number of bytes used directly by this object.
+			GSOUND_INLINE void addLocalSize( Size numBytes )
+			{
+				localSize += numBytes;
+			}
+			
+			
+		//********************************************************************************
+		//******	Budget Accessor Methods
+			
+			
+			/// Return the memory budget in bytes for this object, or 0 if it has no budget.
+			GSOUND_INLINE Size getBudget() const
+			{
+				return budget;
+			}
+			
+			
+			/// Set the memory budget in bytes for this object. A budget of 0 means there is no budget.
+			GSOUND_INLINE void setBudget( Size newBudget )
+			{
+				budget = newBudget;
+			}
+			
+			
+			/// Set the memory budget in bytes for the object with the specified path.
+			/**
+			  * The method returns whether or not an object with that path was found.
+			  */
+			Bool setBudget( const UTF8String& path, Size newBudget );
+			
+			
+			/// Return whether or not the total size of this object exceeds its budget.
+			GSOUND_INLINE Bool isOverBudget() const
+			{
+				return budget > 0 && this->getSize() > budget;
+			}
+			
+			
+			/// Add a warning message to the list for each object in the hierarchy that is over its budget.
+			/**
+			  * The method returns the number of warnings that were added.
+			  */
+			Size getWarnings( ArrayList<UTF8String>& warnings ) const;
+			
+			
+		//********************************************************************************
+		//******	Child Accessor Methods
+			
+			
+			/// Return the number of children that this memory usage object has.
+			GSOUND_INLINE Size getChildCount() const
+			{
+				return children.getSize();
+			}
+			
+			
+			/// Return a reference to the child at the specified index.
+			GSOUND_INLINE SoundMemoryUsage& getChild( Index childIndex )
+			{
+				return children[childIndex];
+			}
+			
+			
+			/// Return a const reference to the child at the specified index.
+			GSOUND_INLINE const SoundMemoryUsage& getChild( Index childIndex ) const
+			{
+				return children[childIndex];
+			}
+			
+			
+			/// Return a pointer to the object with the specified path relative to this one, or NULL if there is none.
+			/**
+			  * An empty path refers to this object.
+			  */
+			SoundMemoryUsage* findChild( const UTF8String& path );
+			
+			
+			/// Return a const pointer to the object with the specified path relative to this one, or NULL if there is none.
+			/**
+			  * An empty path refers to this object.
+			  */
+			const SoundMemoryUsage* findChild( const UTF8String& path ) const;
+			
+			
+			/// Add a new child with the specified name and size and return a reference to it.
+			/**
+			  * The reference is valid until another child is added to this object.
+			  */
+			SoundMemoryUsage& addChild( const UTF8String& childName, Size childSize = 0 );
+			
+			
+			/// Remove all children from this object and set its size to 0, keeping its name and budget.
+			void clear();
+			
+			
+		//********************************************************************************
+		//******	String Conversion Methods
+			
+			
+			/// Return a human-readable string that lists the sizes in this hierarchy, one object per line.
+			/**
+			  * Children deeper than the maximum depth are not listed, but are still
+			  * included in the sizes of their parents.
+			  */
+			UTF8String toString( Size maxDepth = math::max<Size>() ) const;
+			
+			
+			/// Convert this memory usage object to a human-readable string.
+			GSOUND_INLINE operator UTF8String () const
+			{
+				return this->toString();
+			}
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Add warnings for this object and its children, with the specified path prefix.
+			Size getWarnings( const UTF8String& prefix, ArrayList<UTF8String>& warnings ) const;
+			
+			
+			/// Append the lines for this object and its children to a string buffer.
+			void toString( om::UTF8StringBuffer& buffer, Size depth, Size maxDepth ) const;
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// The name of this memory usage object.
+			UTF8String name;
+			
+			
+			/// The number of bytes that are used directly by this object, not including its children.
+			Size localSize;
+			
+			
+			/// The memory budget in bytes for this object, or 0 if it has no budget.
+			Size budget;
+			
+			
+			/// A list of the children of this object that break its memory down further.
+			ArrayList<SoundMemoryUsage> children;
+			
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SOUND_MEMORY_USAGE_H
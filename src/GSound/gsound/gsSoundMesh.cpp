@@ -154,7 +154,7 @@ SoundMesh& SoundMesh:: operator = ( const SoundMesh& other )
 //##########################################################################################
 //##########################################################################################
 //############		
-//############		Size In Bytes Method
+//############		Size In Bytes Methods
 //############		
 //##########################################################################################
 //##########################################################################################
@@ -178,6 +178,18 @@ Size SoundMesh:: getSizeInBytes() const
 
 
 
+void SoundMesh:: getMemoryUsage( SoundMemoryUsage& usage ) const
+{
+	usage.addChild( "vertices", vertices.isSet() ? vertices->getCapacity()*sizeof(SoundVertex) : 0 );
+	usage.addChild( "triangles", triangles.isSet() ? triangles->getCapacity()*sizeof(TriangleType) : 0 );
+	usage.addChild( "materials", materials.isSet() ? materials->getCapacity()*sizeof(SoundMaterial) : 0 );
+	usage.addChild( "bvh", bvh ? bvh->bvh.getSizeInBytes() : 0 );
+	usage.addChild( "diffraction graph", diffractionGraph.isSet() ? diffractionGraph->getSizeInBytes() : 0 );
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -279,7 +291,19 @@ Bool SoundMesh:: load( const char* pathToFile, SoundMesh& mesh )
 	
 	om::UTF8String filePathString( reinterpret_cast<const om::UTF8Char*>(pathToFile) );
 	
-	// Open the file.
+	// Try to map the file into memory so that large meshes can be decoded in place.
+	om::MappedFileReader mappedReader( filePathString );
+	mappedReader.setAccessPattern( om::MappedFileReader::SEQUENTIAL );
+	
+	if ( mappedReader.open() )
+	{
+		Bool result = loadMeshFromStream( mappedReader, mesh );
+		mappedReader.close();
+		
+		return result;
+	}
+	
+	// Fall back to buffered file reading if the file could not be mapped.
 	om::FileReader reader( filePathString );
 	
 	if ( !reader.open() )
@@ -683,14 +707,21 @@ Bool SoundMesh:: loadMeshVersion1( om::DataInputStream& stream, om::data::Endian
 	const Size actualTriangleDataSize = (vertices64 ? 3*sizeof(UInt64) : 3*sizeof(UInt32)) + 
 										(edges64 ? 3*sizeof(UInt64) : 3*sizeof(UInt32)) + 4*sizeof(UInt32);
 	
+	// If the stream is backed by memory, decode the triangles in place without copying.
+	const Size totalTriangleDataSize = (Size)numTriangles*actualTriangleDataSize;
+	UByte* mappedTriangleData = (UByte*)stream.getPointer( stream.getPosition(), totalTriangleDataSize );
+	
 	for ( Index i = 0; i < numTriangles; i++ )
 	{
-		if ( stream.readData( triangleData, actualTriangleDataSize ) < actualTriangleDataSize )
+		UByte* readPosition = triangleData;
+		
+		if ( mappedTriangleData )
+			readPosition = mappedTriangleData + i*actualTriangleDataSize;
+		else if ( stream.readData( triangleData, actualTriangleDataSize ) < actualTriangleDataSize )
 			return false;
 		
 		UInt64 v0 = 0, v1 = 0, v2 = 0, e0 = 0, e1 = 0, e2 = 0, m;
 		UInt32 k = 0, r = 0, c = 0;
-		UByte* readPosition = triangleData;
 		
 		// Read vertex indices in 64 or 32 bit.
 		if ( vertices64 )
@@ -750,6 +781,9 @@ Bool SoundMesh:: loadMeshVersion1( om::DataInputStream& stream, om::data::Endian
 		triangles->add( t );
 	}
 	
+	if ( mappedTriangleData )
+		stream.seek( totalTriangleDataSize );
+	
 	const TriangleType* const trianglesStart = triangles->getPointer();
 	
 	//***************************************************************************
@@ -762,15 +796,22 @@ Bool SoundMesh:: loadMeshVersion1( om::DataInputStream& stream, om::data::Endian
 									(neighbors64 ? 2*sizeof(UInt64) : 2*sizeof(UInt32)) + 2*sizeof(UInt16) + 8*sizeof(Float32);
 	UByte edgeData[edgeDataSize];
 	
+	// If the stream is backed by memory, decode the edges in place without copying.
+	const Size totalEdgeDataSize = (Size)numEdges*actualEdgeDataSize;
+	UByte* mappedEdgeData = (UByte*)stream.getPointer( stream.getPosition(), totalEdgeDataSize );
+	
 	for ( Index i = 0; i < numEdges; i++ )
 	{
-		if ( stream.readData( edgeData, actualEdgeDataSize ) < actualEdgeDataSize )
+		UByte* readPosition = edgeData;
+		
+		if ( mappedEdgeData )
+			readPosition = mappedEdgeData + i*actualEdgeDataSize;
+		else if ( stream.readData( edgeData, actualEdgeDataSize ) < actualEdgeDataSize )
 			return false;
 		
 		UInt64 v0 = 0, v1 = 0, t0 = 0, t1 = 0, nn = 0, no = 0;
 		UInt16 e0 = 0, e1 = 0;
 		Plane3f p1, p2;
-		UByte* readPosition = edgeData;
 		
 		if ( vertices64 )
 		{
@@ -833,6 +874,9 @@ Bool SoundMesh:: loadMeshVersion1( om::DataInputStream& stream, om::data::Endian
 		edges->add( e );
 	}
 	
+	if ( mappedEdgeData )
+		stream.seek( totalEdgeDataSize );
+	
 	const internal::DiffractionEdge* const edgesStart = edges->getPointer();
 	
 	//***************************************************************************
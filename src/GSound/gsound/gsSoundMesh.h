@@ -59,6 +59,7 @@
 #include "gsSoundTriangle.h"
 #include "gsSoundMaterial.h"
 #include "gsSoundRay.h"
+#include "gsSoundMemoryUsage.h"
 
 
 //##########################################################################################
@@ -160,6 +161,22 @@ class SoundMesh
 			}
 			
 			
+			/// Return a pointer to the internal triangle in this mesh at the specified index.
+			GSOUND_FORCE_INLINE const internal::InternalSoundTriangle* getInternalTriangle( Index triangleIndex ) const
+			{
+				GSOUND_DEBUG_ASSERT( triangleIndex < triangles->getSize() );
+				
+				return triangles->getPointer() + triangleIndex;
+			}
+			
+			
+			/// Return the index in this mesh of the specified internal triangle, which must belong to this mesh.
+			GSOUND_FORCE_INLINE Index getTriangleIndex( const internal::InternalSoundTriangle* triangle ) const
+			{
+				return (Index)(triangle - triangles->getPointer());
+			}
+			
+			
 		//********************************************************************************
 		//******	Vertex Accessor Methods
 			
@@ -302,13 +319,20 @@ class SoundMesh
 			
 			
 		//********************************************************************************
-		//******	Size In Bytes Accessor Method
+		//******	Size In Bytes Accessor Methods
 			
 			
 			/// Return the approximate size in bytes of this mesh's allocated memory.
 			Size getSizeInBytes() const;
 			
 			
+			/// Add children to the memory usage object that break down this mesh's allocated memory.
+			/**
+			  * The children are the vertices, triangles, materials, BVH, and diffraction graph.
+			  */
+			void getMemoryUsage( SoundMemoryUsage& usage ) const;
+			
+			
 		//********************************************************************************
 		//******	Ray Tracing Methods
 			
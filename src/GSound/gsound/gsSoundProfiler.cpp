@@ -0,0 +1,396 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundProfiler.cpp
+ * Contents:    gsound::SoundProfiler class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "gsSoundProfiler.h"
+
+
+#include <cstdio>
+#include <cstring>
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+#define MAX_EVENTS_PER_THREAD 131072
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Thread Buffer Class Definition
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+class SoundProfiler:: ThreadBuffer
+{
+	public:
+		
+		/// A class that stores a single recorded zone.
+		class Event
+		{
+			public:
+				
+				/// The name of the zone.
+				const char* name;
+				
+				
+				/// The time in nanoseconds when the zone started.
+				Int64 startTime;
+				
+				
+				/// The duration of the zone in nanoseconds.
+				Int64 duration;
+				
+				
+		};
+		
+		
+		/// Create a new thread buffer for the thread with the specified index.
+		/**
+		  * All of the thread's events are allocated and touched here, so that recording
+		  * a zone never allocates memory or faults in new pages.
+		  */
+		GSOUND_INLINE ThreadBuffer( Index newThreadIndex, Size newGeneration )
+			:	threadIndex( newThreadIndex ),
+				events( util::allocate<Event>( MAX_EVENTS_PER_THREAD ) ),
+				numEvents( 0 ),
+				numDroppedEvents( 0 ),
+				generation( newGeneration ),
+				next( NULL )
+		{
+			std::memset( events, 0, sizeof(Event)*MAX_EVENTS_PER_THREAD );
+		}
+		
+		
+		/// Destroy the events for this thread.
+		GSOUND_INLINE ~ThreadBuffer()
+		{
+			util::deallocate( events );
+		}
+		
+		
+		/// Add a new event to the end of this thread's buffer. This must only be called by the buffer's thread.
+		GSOUND_FORCE_INLINE void add( const char* name, Int64 startTime, Int64 endTime, Size currentGeneration )
+		{
+			// Discard the events from before the last clear() the first time this thread records after it.
+			// The generation is published last, so that other threads don't read the new generation's events
+			// until the old ones have been discarded.
+			if ( generation != currentGeneration )
+			{
+				numEvents.testAndSet( numEvents, 0 );
+				numDroppedEvents.testAndSet( numDroppedEvents, 0 );
+				generation.testAndSet( generation, currentGeneration );
+			}
+			
+			const Size index = numEvents;
+			
+			// Drop the event if the buffer is full, rather than allocating more memory.
+			if ( index == MAX_EVENTS_PER_THREAD )
+			{
+				numDroppedEvents++;
+				return;
+			}
+			
+			Event& event = events[index];
+			event.name = name;
+			event.startTime = startTime;
+			event.duration = endTime - startTime;
+			
+			// Publish the event.
+			numEvents++;
+		}
+		
+		
+		/// Return the number of events in this buffer that were recorded in the specified generation.
+		GSOUND_INLINE Size getEventCount( Size currentGeneration ) const
+		{
+			return generation == currentGeneration ? Size(numEvents) : Size(0);
+		}
+		
+		
+		/// The index of the thread, used as its ID in the exported trace.
+		Index threadIndex;
+		
+		
+		/// The events that have been recorded for the thread.
+		Event* events;
+		
+		
+		/// The number of events that have been written, published atomically after each event.
+		Atomic<Size> numEvents;
+		
+		
+		/// The number of events that were dropped because the buffer was full.
+		Atomic<Size> numDroppedEvents;
+		
+		
+		/// The profiler generation that the events in this buffer belong to.
+		Atomic<Size> generation;
+		
+		
+		/// The next thread buffer in the profiler's list.
+		ThreadBuffer* next;
+		
+		
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Static Data Members
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Atomic<Size> SoundProfiler:: recording( 0 );
+SoundProfiler::ThreadBuffer* SoundProfiler:: threadBuffers = NULL;
+Atomic<Size> SoundProfiler:: numThreadBuffers( 0 );
+Atomic<Size> SoundProfiler:: generation( 0 );
+thread_local SoundProfiler::ThreadBuffer* SoundProfiler:: localThreadBuffer = NULL;
+
+
+/// A mutex that serializes adding new thread buffers and exporting the events.
+static Mutex threadBufferMutex;
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Recording Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundProfiler:: start()
+{
+	recording = Atomic<Size>( 1 );
+}
+
+
+
+
+void SoundProfiler:: stop()
+{
+	recording = Atomic<Size>( 0 );
+}
+
+
+
+
+void SoundProfiler:: clear()
+{
+	// Each thread discards its own events when it sees the new generation.
+	// The mutex keeps the generation from changing during an export.
+	threadBufferMutex.lock();
+	generation++;
+	threadBufferMutex.unlock();
+}
+
+
+
+
+Size SoundProfiler:: getEventCount()
+{
+	Size numEvents = 0;
+	
+	threadBufferMutex.lock();
+	
+	for ( ThreadBuffer* buffer = threadBuffers; buffer != NULL; buffer = buffer->next )
+		numEvents += buffer->getEventCount( generation );
+	
+	threadBufferMutex.unlock();
+	
+	return numEvents;
+}
+
+
+
+
+Size SoundProfiler:: getDroppedEventCount()
+{
+	Size numDroppedEvents = 0;
+	
+	threadBufferMutex.lock();
+	
+	for ( ThreadBuffer* buffer = threadBuffers; buffer != NULL; buffer = buffer->next )
+	{
+		if ( buffer->generation == generation )
+			numDroppedEvents += buffer->numDroppedEvents;
+	}
+	
+	threadBufferMutex.unlock();
+	
+	return numDroppedEvents;
+}
+
+
+
+
+void SoundProfiler:: record( const char* name, Int64 startTime, Int64 endTime )
+{
+	ThreadBuffer* buffer = localThreadBuffer;
+	
+	// Create the buffer for this thread the first time that it records an event.
+	if ( buffer == NULL )
+	{
+		threadBufferMutex.lock();
+		
+		buffer = util::construct<ThreadBuffer>( Index(numThreadBuffers++), Size(generation) );
+		buffer->next = threadBuffers;
+		threadBuffers = buffer;
+		
+		threadBufferMutex.unlock();
+		
+		localThreadBuffer = buffer;
+	}
+	
+	buffer->add( name, startTime, endTime, generation );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Export Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundProfiler:: saveChromeTrace( const UTF8String& filePath )
+{
+	om::File file( filePath );
+	
+	// Erase the file if it exists.
+	if ( !file.erase() )
+		return false;
+	
+	om::FileWriter writer( file );
+	
+	if ( !writer.open() )
+		return false;
+	
+	threadBufferMutex.lock();
+	
+	// Make the timestamps relative to the earliest event.
+	Int64 baseTime = math::max<Int64>();
+	
+	for ( ThreadBuffer* buffer = threadBuffers; buffer != NULL; buffer = buffer->next )
+	{
+		const Size numEvents = buffer->getEventCount( generation );
+			
+		for ( Index i = 0; i < numEvents; i++ )
+			baseTime = math::min( baseTime, buffer->events[i].startTime );
+	}
+	
+	// Write the events, with a metadata event that names each thread.
+	char line[512];
+	Bool firstEvent = true;
+	
+	writer.writeASCII( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" );
+	
+	for ( ThreadBuffer* buffer = threadBuffers; buffer != NULL; buffer = buffer->next )
+	{
+		std::snprintf( line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GSound Thread %u\"}}",
+						firstEvent ? "" : ",", (unsigned int)buffer->threadIndex, (unsigned int)buffer->threadIndex );
+		writer.writeASCII( line );
+		firstEvent = false;
+		
+		const Size numEvents = buffer->getEventCount( generation );
+		
+		for ( Index i = 0; i < numEvents; i++ )
+		{
+			const ThreadBuffer::Event& event = buffer->events[i];
+			
+			// Chrome trace timestamps and durations are in microseconds.
+			std::snprintf( line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"gsound\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+							event.name, (unsigned int)buffer->threadIndex,
+							Double(event.startTime - baseTime)*Double(0.001), Double(event.duration)*Double(0.001) );
+			writer.writeASCII( line );
+		}
+	}
+	
+	threadBufferMutex.unlock();
+	
+	writer.writeASCII( "\n]}\n" );
+	writer.close();
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
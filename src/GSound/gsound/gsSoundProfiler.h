@@ -0,0 +1,251 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundProfiler.h
+ * Contents:    gsound::SoundProfiler class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_SOUND_PROFILER_H
+#define INCLUDE_GSOUND_SOUND_PROFILER_H
+
+
+#include "gsConfig.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that records scoped timing zones from all threads and exports them as a Chrome trace.
+/**
+  * Zones are declared with the GSOUND_PROFILE_ZONE() macro at the start of a scope.
+  * While the profiler is recording, each zone's start time and duration are appended
+  * to a buffer that belongs to the calling thread, so recording requires no locking.
+  * Each thread's buffer is allocated when the thread records its first zone and holds
+  * a fixed number of events, after which events are dropped rather than allocating
+  * more memory on a time-critical thread.
+  * The recorded events can be saved as Chrome trace event JSON and viewed in
+  * chrome://tracing or Perfetto.
+  *
+  * Zones are only compiled when GSOUND_ENABLE_PROFILING is set to 1. Otherwise,
+  * the macro expands to nothing and the profiler never records any events.
+  */
+class SoundProfiler
+{
+	public:
+		
+		//********************************************************************************
+		//******	Recording Methods
+			
+			
+			/// Start recording timing zones on all threads.
+			static void start();
+			
+			
+			/// Stop recording timing zones. Zones that are in progress are still recorded.
+			static void stop();
+			
+			
+			/// Return whether or not timing zones are currently being recorded.
+			GSOUND_FORCE_INLINE static Bool isRecording()
+			{
+				return recording != 0;
+			}
+			
+			
+			/// Discard all of the events that have been recorded.
+			/**
+			  * The method can be called while zones are being recorded. The events are
+			  * excluded immediately, and each thread reuses its buffer the next time it records a zone.
+			  */
+			static void clear();
+			
+			
+			/// Return the total number of events that have been recorded on all threads.
+			static Size getEventCount();
+			
+			
+			/// Return the total number of events that were dropped because a thread's buffer was full.
+			static Size getDroppedEventCount();
+			
+			
+		//********************************************************************************
+		//******	Export Methods
+			
+			
+			/// Save the recorded events to a file in the Chrome trace event JSON format.
+			/**
+			  * Each zone is written as a complete event ("ph":"X") with its thread's index
+			  * as the thread ID. The method returns whether or not the file was successfully written.
+			  * Events that are recorded during the export may or may not be included.
+			  */
+			static Bool saveChromeTrace( const UTF8String& filePath );
+			
+			
+		//********************************************************************************
+		//******	Zone Class Declaration
+			
+			
+			/// A class that records the time spent between its construction and destruction.
+			class Zone
+			{
+				public:
+					
+					/// Start a new zone with the specified name, which must be a string literal.
+					GSOUND_FORCE_INLINE Zone( const char* newName )
+						:	name( newName ),
+							startTime( isRecording() ? Time::getCurrent().getNanoseconds() : Int64(0) )
+					{
+					}
+					
+					
+					/// End the zone, recording it if the profiler was recording when it started.
+					GSOUND_FORCE_INLINE ~Zone()
+					{
+						if ( startTime != 0 )
+							SoundProfiler::record( name, startTime, Time::getCurrent().getNanoseconds() );
+					}
+					
+					
+				private:
+					
+					/// The name of the zone.
+					const char* name;
+					
+					
+					/// The time in nanoseconds when the zone started, or 0 if it is not recorded.
+					Int64 startTime;
+					
+					
+			};
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Class Declarations
+			
+			
+			/// A class that stores the events that were recorded on one thread.
+			class ThreadBuffer;
+			
+			
+		//********************************************************************************
+		//******	Private Static Helper Methods
+			
+			
+			/// Add an event for a zone to the calling thread's buffer.
+			static void record( const char* name, Int64 startTime, Int64 endTime );
+			
+			
+		//********************************************************************************
+		//******	Private Static Data Members
+			
+			
+			/// A non-zero value if timing zones are currently being recorded.
+			static Atomic<Size> recording;
+			
+			
+			/// A linked list of the buffers for every thread that has recorded an event.
+			static ThreadBuffer* threadBuffers;
+			
+			
+			/// The number of threads that have recorded an event.
+			static Atomic<Size> numThreadBuffers;
+			
+			
+			/// A counter that is incremented by clear(), so that each thread knows to discard its old events.
+			static Atomic<Size> generation;
+			
+			
+			/// The buffer for the calling thread, or NULL if the thread has not recorded an event yet.
+			static thread_local ThreadBuffer* localThreadBuffer;
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Profile Zone Macro
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+#define GSOUND_PROFILE_ZONE_CONCATENATE2( A, B ) A##B
+#define GSOUND_PROFILE_ZONE_CONCATENATE( A, B ) GSOUND_PROFILE_ZONE_CONCATENATE2( A, B )
+
+
+#if GSOUND_ENABLE_PROFILING
+	/// Record the time spent in the rest of the enclosing scope as a zone with the specified name.
+	#define GSOUND_PROFILE_ZONE( NAME ) \
+		gsound::SoundProfiler::Zone GSOUND_PROFILE_ZONE_CONCATENATE( gsoundProfileZone, __LINE__ )( NAME )
+#else
+	#define GSOUND_PROFILE_ZONE( NAME ) ((void)0)
+#endif
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SOUND_PROFILER_H
@@ -48,6 +48,7 @@
 
 
 #include "gsSoundPropagationSystem.h"
+#include "gsSoundProfiler.h"
 
 
 #define UPDATE_JOB_ID 0x1000
@@ -89,7 +90,8 @@ class SoundPropagationSystem:: ListenerRenderer : public SoundFilter, public Sou
 					renderer( *newRequest ),
 					system( newSystem ),
 					streamTime( newSystem->streamTime ),
-					streamPosition( 0 )/*,
+					streamPosition( 0 ),
+					irUpdateTime( 0 )/*,
 					updateTimestamp( 0 )*/
 			{
 			}
@@ -169,6 +171,10 @@ class SoundPropagationSystem:: ListenerRenderer : public SoundFilter, public Sou
 			Time streamTime;
 			
 			
+			/// The time that was spent updating this renderer's IR in the current renderer update stage.
+			Time irUpdateTime;
+			
+			
 	private:
 		
 		//********************************************************************************
@@ -228,6 +234,10 @@ class SoundPropagationSystem:: ListenerRenderer : public SoundFilter, public Sou
 				if ( request->statistics && request->flags.isSet( RenderFlags::STATISTICS ) )
 					request->statistics->bufferingLoad = Float(bufferTimer.getElapsedTime() / frameTime);
 				
+				// Record the render call if the system has a trace recorder.
+				if ( system->traceRecorder )
+					system->traceRecorder->recordRender( listener, *request, numSamples, outputBuffer.getSampleRate() );
+				
 				// Render the sound for this listener.
 				return renderer.render( system->sourceSoundBuffer, outputBuffer, frameTime );
 				
@@ -285,11 +295,20 @@ SoundPropagationSystem:: SoundPropagationSystem()
 		streamTime( 0 ),
 		bufferedTime( 0 ),
 		propagationRequest( NULL ),
-		currentIR( 0 ),
+		propagatingIR( NULL ),
+		queuedIR( NULL ),
+		updatingIR( NULL ),
+		renderedIR( NULL ),
+		latestIR( NULL ),
+		pipelineDepth( 3 ),
+		numPendingIRUpdates( 0 ),
+		raySliceIndex( 0 ),
 		numUpdateThreads( 2 ),
 		isPropagating( 0 ),
-		missingTime( 0 )
+		missingTime( 0 ),
+		traceRecorder( NULL )
 {
+	propagationThreadPool.setPriority( ThreadPriority::LOW );
 	updateThreadPool.setPriority( ThreadPriority::LOW );
 }
 
@@ -299,19 +318,28 @@ SoundPropagationSystem:: SoundPropagationSystem()
 SoundPropagationSystem:: SoundPropagationSystem( const SoundPropagationSystem& other )
 	:	isPropagating( 0 ),
 		streamTime( 0 ),
-		bufferedTime( 0 )
+		bufferedTime( 0 ),
+		propagatingIR( NULL ),
+		queuedIR( NULL ),
+		updatingIR( NULL ),
+		renderedIR( NULL ),
+		latestIR( NULL ),
+		numPendingIRUpdates( 0 ),
+		raySliceIndex( 0 )
 {
 	other.mutex.lock();
 	
 	// Get the data from the other system.
 	scene = other.scene;
 	propagationRequest = other.propagationRequest;
-	currentIR = other.currentIR;
+	pipelineDepth = other.pipelineDepth;
 	numUpdateThreads = other.numUpdateThreads;
-	isPropagating = other.isPropagating;
 	missingTime = other.missingTime;
 	propagationTime = other.propagationTime;
 	irUpdateTime = other.irUpdateTime;
+	traceRecorder = other.traceRecorder;
+	memoryBudgets = other.memoryBudgets;
+	propagationThreadPool.setPriority( ThreadPriority::LOW );
 	updateThreadPool.setPriority( ThreadPriority::LOW );
 	
 	// Copy the listener renderers in the other system.
@@ -342,7 +370,8 @@ SoundPropagationSystem:: ~SoundPropagationSystem()
 {
 	mutex.lock();
 
-	// Finish updates.
+	// Finish updates. The propagation stage must finish first because it can start renderer updates.
+	propagationThreadPool.finishJobs();
 	updateThreadPool.finishJobs();
 	
 	// Destroy the listener renderers.
@@ -353,6 +382,16 @@ SoundPropagationSystem:: ~SoundPropagationSystem()
 	
 	listenerRenderers.clear();
 	
+	const Size numRemovedRenderers = removedRenderers.getSize();
+	
+	for ( Index i = 0; i < numRemovedRenderers; i++ )
+		util::destruct( removedRenderers[i] );
+	
+	removedRenderers.clear();
+	
+	// Destroy the buffered IRs.
+	clearPipeline();
+	
 	mutex.unlock();
 }
 
@@ -378,6 +417,7 @@ SoundPropagationSystem& SoundPropagationSystem:: operator = ( const SoundPropaga
 		other.mutex.lock();
 		
 		// Finish updates.
+		propagationThreadPool.finishJobs();
 		updateThreadPool.finishJobs();
 		
 		// Clear the previous listeners from this system.
@@ -386,17 +426,27 @@ SoundPropagationSystem& SoundPropagationSystem:: operator = ( const SoundPropaga
 		
 		listenerRenderers.clear();
 		
+		for ( Index i = 0; i < removedRenderers.getSize(); i++ )
+			util::destruct( removedRenderers[i] );
+		
+		removedRenderers.clear();
+		
+		// Clear the previous IRs from this system.
+		clearPipeline();
+		
 		// Get the data from the other system.
 		bufferedTime = 0;
 		streamTime = 0;
 		scene = other.scene;
 		propagationRequest = other.propagationRequest;
-		currentIR = other.currentIR;
+		pipelineDepth = other.pipelineDepth;
 		numUpdateThreads = other.numUpdateThreads;
-		isPropagating = other.isPropagating;
 		missingTime = other.missingTime;
 		propagationTime = other.propagationTime;
 		irUpdateTime = other.irUpdateTime;
+		traceRecorder = other.traceRecorder;
+		memoryBudgets = other.memoryBudgets;
+		memoryUsage.clear();
 		
 		// Copy the listener renderers in the other system.
 		for ( Index i = 0; i < other.listenerRenderers.getSize(); i++ )
@@ -428,6 +478,8 @@ SoundPropagationSystem& SoundPropagationSystem:: operator = ( const SoundPropaga
 
 void SoundPropagationSystem:: update( Float dt, Bool synchronous )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagationSystem::update" );
+	
 	mutex.lock();
 	
 	if ( propagationRequest == NULL )
@@ -439,7 +491,10 @@ void SoundPropagationSystem:: update( Float dt, Bool synchronous )
 	//********************************************************************************
 	// Make sure the update thread pool is initialized.
 	
-	// Add or remove the necessary number of threads to the thread pool.
+	// Add or remove the necessary number of threads to the thread pools.
+	if ( propagationThreadPool.getThreadCount() != 1 )
+		propagationThreadPool.setThreadCount( 1 );
+	
 	if ( updateThreadPool.getThreadCount() != numUpdateThreads )
 		updateThreadPool.setThreadCount( numUpdateThreads );
 	
@@ -451,18 +506,40 @@ void SoundPropagationSystem:: update( Float dt, Bool synchronous )
 		// Accumulate the delta time for this update.
 		missingTime += dt;
 		
+		// Each target time step is divided into one propagation frame per ray slice,
+		// and only the last slice of a time step is passed to the renderers.
+		const Size numSlices = math::max( propagationRequest->raySliceCount, Size(1) );
+		const Float sliceDt = propagationRequest->targetDt / Float(numSlices);
+		
 		// Only spawn a new propagation job if the last job is finished.
-		if ( missingTime >= propagationRequest->targetDt )
+		if ( missingTime >= sliceDt )
 		{
-			// Add a new propagation job to the thread pool and start processing this frame.
-			if ( synchronous || !isPropagating )
+			if ( synchronous )
 			{
-				updateThreadPool.addJob( om::bindCall( &SoundPropagationSystem::doSoundPropagation, this,
-														propagationRequest->targetDt ),
-										PROPAGATION_JOB_ID );
+				// Synchronous updates propagate all of the slices for a time step using the current scene.
+				for ( Index i = 0; i < numSlices; i++ )
+				{
+					// Wait for the previous frame so that the snapshot can be updated.
+					propagationThreadPool.finishJobs();
+					startPropagation( sliceDt, i == numSlices - 1, true );
+				}
+				
+				raySliceIndex = 0;
+				missingTime = 0;
 			}
-			
-			missingTime = 0;
+			else if ( !isPropagating )
+			{
+				const Index nextSliceIndex = (raySliceIndex + 1) % numSlices;
+				
+				// Only start the frame if there is an IR to write to, otherwise try again on the next update.
+				if ( startPropagation( sliceDt, nextSliceIndex == 0, false ) )
+				{
+					raySliceIndex = nextSliceIndex;
+					missingTime = 0;
+				}
+			}
+			else
+				missingTime = 0;
 		}
 	}
 	else
@@ -478,8 +555,12 @@ void SoundPropagationSystem:: update( Float dt, Bool synchronous )
 	}
 	
 	// If the user wants synchronous operation, wait until the propagation and update are finished.
+	// The propagation stage must finish first because it starts the renderer updates.
 	if ( synchronous )
+	{
+		propagationThreadPool.finishJobs();
 		updateThreadPool.finishJobs();
+	}
 	
 	mutex.unlock();
 }
@@ -487,6 +568,94 @@ void SoundPropagationSystem:: update( Float dt, Bool synchronous )
 
 
 
+Bool SoundPropagationSystem:: startPropagation( Float dt, Bool updateRenderers, Bool synchronous )
+{
+	pipelineMutex.lock();
+	
+	SoundSceneIR* outputIR = acquireFreeIR();
+	
+	// Synchronous updates wait for the renderer updates to release an IR if they are all in use.
+	if ( outputIR == NULL && synchronous )
+	{
+		pipelineMutex.unlock();
+		updateThreadPool.finishJobs();
+		pipelineMutex.lock();
+		outputIR = acquireFreeIR();
+	}
+	
+	propagatingIR = outputIR;
+	
+	pipelineMutex.unlock();
+	
+	if ( outputIR == NULL )
+		return false;
+	
+	// Copy the current scene state while no job is reading the snapshot.
+	sceneSnapshot.update( *scene );
+	
+	// Determine the quality factor to use for the simulation based on the last frame time.
+	if ( propagationRequest->flags.isSet( PropagationFlags::ADAPTIVE_QUALITY ) )
+	{
+		Float lastFrameTime = (Float)propagationTime;
+		Float targetDt = dt;
+		
+		// Compute the desired quality factor based on the ratio needed to correct
+		// for the last frame's overage.
+		//Float lastRatio = (targetDt / lastFrameTime);
+		Float response = 0.25;
+		Float lastRatio = targetDt / (targetDt*(1 - response) + lastFrameTime*response);
+		
+		propagationRequest->quality = math::clamp( propagationRequest->quality*lastRatio,
+													propagationRequest->minQuality, propagationRequest->maxQuality );
+	}
+	else
+		propagationRequest->quality = Float(1);
+	
+	// Update the request with the current delta time.
+	propagationRequest->dt = dt;
+	
+	// Record the frame with the request that will be used to propagate it.
+	if ( traceRecorder )
+		traceRecorder->recordPropagation( *scene, *propagationRequest, updateRenderers );
+	
+	// Atomically signal that sound propagation is being performed before the job starts.
+	isPropagating++;
+	
+	propagationThreadPool.addJob( om::bindCall( &SoundPropagationSystem::doSoundPropagation, this,
+												dt, updateRenderers ),
+								PROPAGATION_JOB_ID );
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Pipeline Accessor Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundPropagationSystem:: setPipelineDepth( Size newPipelineDepth )
+{
+	mutex.lock();
+	pipelineMutex.lock();
+	
+	pipelineDepth = math::max( newPipelineDepth, Size(2) );
+	
+	pipelineMutex.unlock();
+	mutex.unlock();
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############
@@ -655,9 +824,11 @@ Bool SoundPropagationSystem:: addListener( const SoundListener* listener, const
 		return false;
 	
 	mutex.lock();
+	pipelineMutex.lock();
 	
 	listenerRenderers.add( util::construct<ListenerRenderer>( listener, request, this ) );
 	
+	pipelineMutex.unlock();
 	mutex.unlock();
 
 	return true;
@@ -669,15 +840,15 @@ Bool SoundPropagationSystem:: addListener( const SoundListener* listener, const
 Bool SoundPropagationSystem:: removeListener( const SoundListener* listener )
 {
 	mutex.lock();
+	pipelineMutex.lock();
 	
 	Bool success = false;
-	const Size numListenerRenderers = listenerRenderers.getSize();
 	
-	for ( Index i = 0; i < numListenerRenderers; )
+	for ( Index i = 0; i < listenerRenderers.getSize(); )
 	{
 		if ( listenerRenderers[i]->listener == listener )
 		{
-			util::destruct( listenerRenderers[i] );
+			destroyListenerRenderer( listenerRenderers[i] );
 			listenerRenderers.removeAtIndexUnordered( i );
 			success = true;
 			continue;
@@ -686,6 +857,7 @@ Bool SoundPropagationSystem:: removeListener( const SoundListener* listener )
 		i++;
 	}
 	
+	pipelineMutex.unlock();
 	mutex.unlock();
 
 	return success;
@@ -697,14 +869,16 @@ Bool SoundPropagationSystem:: removeListener( const SoundListener* listener )
 void SoundPropagationSystem:: clearListeners()
 {
 	mutex.lock();
+	pipelineMutex.lock();
 	
 	const Size numListenerRenderers = listenerRenderers.getSize();
 	
 	for ( Index i = 0; i < numListenerRenderers; i++ )
-		util::destruct( listenerRenderers[i] );
+		destroyListenerRenderer( listenerRenderers[i] );
 	
 	listenerRenderers.clear();
-
+	
+	pipelineMutex.unlock();
 	mutex.unlock();
 }
 
@@ -758,11 +932,80 @@ Size SoundPropagationSystem:: renderListener( const SoundListener* listener, Sou
 
 void SoundPropagationSystem:: getSceneIR( SoundSceneIR& ir ) const
 {
-	mutex.lock();
+	pipelineMutex.lock();
 	
-	ir = sceneIR[(currentIR + 1) % 2];
+	// The latest IR can't be overwritten while it is the newest propagation output.
+	if ( latestIR )
+		ir = *latestIR;
+	else
+		ir = SoundSceneIR();
 	
-	mutex.unlock();
+	pipelineMutex.unlock();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Memory Usage Accessor Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundPropagationSystem:: getMemoryUsage( SoundMemoryUsage& usage ) const
+{
+	pipelineMutex.lock();
+	
+	usage = memoryUsage;
+	
+	pipelineMutex.unlock();
+}
+
+
+
+
+Size SoundPropagationSystem:: getMemoryBudget( const UTF8String& path ) const
+{
+	pipelineMutex.lock();
+	
+	const Size* budget = memoryBudgets.get( path.getHashCode(), path );
+	const Size result = budget ? *budget : 0;
+	
+	pipelineMutex.unlock();
+	
+	return result;
+}
+
+
+
+
+void SoundPropagationSystem:: setMemoryBudget( const UTF8String& path, Size budget )
+{
+	pipelineMutex.lock();
+	
+	if ( budget > 0 )
+		memoryBudgets.set( path.getHashCode(), path, budget );
+	else
+		memoryBudgets.remove( path.getHashCode(), path );
+	
+	pipelineMutex.unlock();
+}
+
+
+
+
+void SoundPropagationSystem:: clearMemoryBudgets()
+{
+	pipelineMutex.lock();
+	
+	memoryBudgets.clear();
+	
+	pipelineMutex.unlock();
 }
 
 
@@ -801,31 +1044,9 @@ Bool SoundPropagationSystem:: processMesh( const SoundVertex* newVertices, Size
 
 
 
-void SoundPropagationSystem:: doSoundPropagation( Float dt )
+void SoundPropagationSystem:: doSoundPropagation( Float dt, Bool updateRenderers )
 {
-	// Atomically signal to the main thread that sound propagation is currently being performed.
-	isPropagating++;
-	
-	//********************************************************************************
-	// Determine the simulation quality based on the last frame time.
-	
-	// Determine the quality factor to use for the simulation based on the last frame time.
-	if ( propagationRequest->flags.isSet( PropagationFlags::ADAPTIVE_QUALITY ) )
-	{
-		Float lastFrameTime = (Float)propagationTime;
-		Float targetDt = propagationRequest->targetDt;
-		
-		// Compute the desired quality factor based on the ratio needed to correct
-		// for the last frame's overage.
-		//Float lastRatio = (targetDt / lastFrameTime);
-		Float response = 0.25;
-		Float lastRatio = targetDt / (targetDt*(1 - response) + lastFrameTime*response);
-		
-		propagationRequest->quality = math::clamp( propagationRequest->quality*lastRatio,
-													propagationRequest->minQuality, propagationRequest->maxQuality );
-	}
-	else
-		propagationRequest->quality = Float(1);
+	GSOUND_PROFILE_ZONE( "SoundPropagationSystem::doSoundPropagation" );
 	
 	//********************************************************************************
 	// Do sound propagation.
@@ -833,14 +1054,14 @@ void SoundPropagationSystem:: doSoundPropagation( Float dt )
 	// Create a timer that times how long sound propagation takes.
 	Timer propagationTimer;
 	
-	// Get the current output IR.
-	SoundSceneIR& outputIR = sceneIR[currentIR];
+	// Get the output IR that was reserved for this frame.
+	SoundSceneIR& outputIR = *propagatingIR;
 	
-	// Update the request with the current delta time.
-	propagationRequest->dt = dt;
+	// Do the sound propagation on the scene snapshot, storing the output in the current IR.
+	propagator.propagateSound( sceneSnapshot.getScene(), *propagationRequest, outputIR );
 	
-	// Do the sound propagation, storing the output in the current IR.
-	propagator.propagateSound( *scene, *propagationRequest, outputIR );
+	// Make the IR refer to the application's sources and listeners rather than the snapshot copies.
+	sceneSnapshot.remapIR( outputIR );
 	
 	// Update the total time that was taken on this frame.
 	propagationTime = propagationTimer.getElapsedTime();
@@ -852,66 +1073,271 @@ void SoundPropagationSystem:: doSoundPropagation( Float dt )
 	{
 		SoundStatistics* statistics = propagationRequest->statistics;
 		
-		statistics->irUpdateTime = irUpdateTime;
 		statistics->pathCount = outputIR.getPathCount();
-		statistics->irMemory = outputIR.getSizeInBytes() + sceneIR[(currentIR + 1) % 2].getSizeInBytes();
-		statistics->propagationMemory = propagationRequest->internalData.getSizeInBytes();
-		statistics->totalMemory = statistics->sceneMemory + statistics->propagationMemory +
-										statistics->renderingMemory + statistics->irMemory;
-		statistics->renderingMemory = 0;
+		
+		//********************************************************************************
+		// Compute the memory used by each part of the system.
+		
+		SoundMemoryUsage newMemoryUsage;
+		
+		// Count each mesh in the scene once, even if it is shared by many objects.
+		const SoundScene& snapshotScene = sceneSnapshot.getScene();
+		const Size numObjects = snapshotScene.getObjectCount();
+		SoundMemoryUsage& sceneUsage = newMemoryUsage.addChild( "scene" );
+		HashMap<const SoundMesh*,Index> meshes;
+		
+		for ( Index i = 0; i < numObjects; i++ )
+		{
+			const SoundMesh* mesh = snapshotScene.getObject(i)->getMesh();
+			const Hash meshHash = Hash(PointerInt(mesh) >> 4);
+			
+			if ( mesh == NULL || meshes.get( meshHash, mesh ) != NULL )
+				continue;
+			
+			mesh->getMemoryUsage( sceneUsage.addChild( UTF8String("mesh ") + UTF8String((UInt64)meshes.getSize()) ) );
+			meshes.add( meshHash, mesh, i );
+		}
+		
+		propagationRequest->internalData.getMemoryUsage( newMemoryUsage.addChild( "propagation" ) );
+		
+		// The IRs and renderers can only be accessed while the pipeline mutex is locked.
+		pipelineMutex.lock();
+		
+		statistics->irUpdateTime = irUpdateTime;
+		
+		SoundMemoryUsage& irUsage = newMemoryUsage.addChild( "ir" );
+		const Size numIRs = sceneIRs.getSize();
+		
+		for ( Index i = 0; i < numIRs; i++ )
+			irUsage.addChild( UTF8String("buffer ") + UTF8String((UInt64)i), sceneIRs[i]->getSizeInBytes() );
+		
+		SoundMemoryUsage& renderingUsage = newMemoryUsage.addChild( "rendering" );
+		const Size numListeners = listenerRenderers.getSize();
+		
+		for ( Index i = 0; i < numListeners; i++ )
+			listenerRenderers[i]->renderer.getMemoryUsage( renderingUsage.addChild( UTF8String("listener ") + UTF8String((UInt64)i) ) );
+		
+		// Apply the budgets and check whether they were exceeded.
+		HashMap<UTF8String,Size>::Iterator budget = memoryBudgets.getIterator();
+		
+		while ( budget )
+		{
+			newMemoryUsage.setBudget( budget.getKey(), *budget );
+			budget++;
+		}
+		
+		ArrayList<UTF8String> memoryWarnings;
+		statistics->memoryWarningCount = newMemoryUsage.getWarnings( memoryWarnings );
+		
+		memoryUsage = newMemoryUsage;
+		
+		pipelineMutex.unlock();
+		
+		statistics->sceneMemory = newMemoryUsage.getChild(0).getSize();
+		statistics->propagationMemory = newMemoryUsage.getChild(1).getSize();
+		statistics->irMemory = newMemoryUsage.getChild(2).getSize();
+		statistics->renderingMemory = newMemoryUsage.getChild(3).getSize();
+		statistics->totalMemory = newMemoryUsage.getSize();
 	}
 	
 	//********************************************************************************
-	// Spawn IR update jobs.
+	// Pass the IR to the renderer update stage.
 	
-	// Wait for previous update jobs to finish before swapping the IRs.
-	updateThreadPool.finishJob( UPDATE_JOB_ID );
+	pipelineMutex.lock();
 	
-	irUpdateTime = 0;
+	latestIR = propagatingIR;
+	
+	// Replace any older IR that the renderer update stage has not started yet,
+	// so that the renderers are always updated with the newest IR.
+	// Intermediate ray slices only accumulate into the propagation caches.
+	if ( updateRenderers )
+	{
+		queuedIR = propagatingIR;
+		dispatchIRUpdate();
+	}
 	
-	// Swap the IRs.
-	currentIR = (currentIR + 1) % 2;
+	propagatingIR = NULL;
 	
-	// For each valid listener renderer, update the IR concurrently using the update thread pool.
+	pipelineMutex.unlock();
+	
+	//********************************************************************************
+	
+	// Atomically signal to the main thread that sound propagation is no longer being performed.
+	isPropagating--;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Pipeline Stage Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundSceneIR* SoundPropagationSystem:: acquireFreeIR()
+{
+	// Destroy unused IRs if the pipeline depth was reduced.
+	for ( Index i = 0; i < sceneIRs.getSize() && sceneIRs.getSize() > pipelineDepth; )
+	{
+		SoundSceneIR* ir = sceneIRs[i];
+		
+		if ( ir != queuedIR && ir != updatingIR && ir != renderedIR && ir != latestIR )
+		{
+			util::destruct( ir );
+			sceneIRs.removeAtIndexUnordered( i );
+			continue;
+		}
+		
+		i++;
+	}
+	
+	// Find an IR that is not used by any stage.
+	const Size numIRs = sceneIRs.getSize();
+	
+	for ( Index i = 0; i < numIRs; i++ )
+	{
+		SoundSceneIR* ir = sceneIRs[i];
+		
+		if ( ir != queuedIR && ir != updatingIR && ir != renderedIR && ir != latestIR )
+			return ir;
+	}
+	
+	// Create a new IR if the pipeline is not full.
+	if ( numIRs < pipelineDepth )
+	{
+		SoundSceneIR* ir = util::construct<SoundSceneIR>();
+		sceneIRs.add( ir );
+		return ir;
+	}
+	
+	// If the latest IR was an intermediate ray slice, it is only kept for getSceneIR().
+	// Reuse it and fall back to the newest IR that the renderer update stage knows about.
+	if ( latestIR != NULL && latestIR != queuedIR && latestIR != updatingIR && latestIR != renderedIR )
+	{
+		SoundSceneIR* ir = latestIR;
+		latestIR = queuedIR ? queuedIR : updatingIR ? updatingIR : renderedIR;
+		return ir;
+	}
+	
+	return NULL;
+}
+
+
+
+
+void SoundPropagationSystem:: dispatchIRUpdate()
+{
+	// The renderer update stage handles one IR at a time.
+	if ( updatingIR != NULL || queuedIR == NULL )
+		return;
+	
+	updatingIR = queuedIR;
+	queuedIR = NULL;
+	
+	// Count the renderers that have an IR on this frame, so that the last update job can finish the stage.
 	const Size numListeners = listenerRenderers.getSize();
+	Size numUpdates = 0;
 	
+	for ( Index i = 0; i < numListeners; i++ )
+	{
+		if ( updatingIR->findListenerIR( listenerRenderers[i]->listener ) )
+			numUpdates++;
+	}
+	
+	numPendingIRUpdates = numUpdates;
+	
+	// For each valid listener renderer, update the IR concurrently using the update thread pool.
 	for ( Index i = 0; i < numListeners; i++ )
 	{
 		ListenerRenderer* listenerRenderer = listenerRenderers[i];
-		const SoundListener* listener = listenerRenderer->listener;
-		const SoundListenerIR* listenerIR = outputIR.findListenerIR( listener );
+		const SoundListenerIR* listenerIR = updatingIR->findListenerIR( listenerRenderer->listener );
+		
+		// Each update job writes only its own renderer's time, which is combined when the stage finishes.
+		listenerRenderer->irUpdateTime = 0;
 		
 		if ( listenerIR )
 		{
 			// Update the renderer with the current IR on another thread.
-			updateThreadPool.addJob( FunctionCall<void (SoundListenerRenderer&, const SoundListenerIR&, const RenderRequest&)>( 
+			updateThreadPool.addJob( FunctionCall<void (ListenerRenderer*, const SoundListenerIR&)>( 
 											om::bind( &SoundPropagationSystem::updateListenerIR, this ),
-											listenerRenderer->renderer, *listenerIR, *listenerRenderer->request ), UPDATE_JOB_ID );
+											listenerRenderer, *listenerIR ), UPDATE_JOB_ID );
 		}
 		else
 		{
 			// Clear this renderer's state because there is no IR update for it.
 			listenerRenderer->renderer.clearIR();
 		}
-		
-		/*
-		if ( !listenerIR )
-			continue;
-		
-		const Size numSources = listenerIR->getSourceCount();
-		
-		for ( Index s = 0; s < numSources; s++ )
-		{
-			const SoundSourceIR& sourceIR = listenerIR->getSourceIR(s);
-			SoundSource* source = (SoundSource*)sourceIR.getSource(0);
-			listenerRenderer->updateSourceIR( source, sourceIR );
-		}*/
 	}
 	
-	//********************************************************************************
+	// If there were no renderers to update, the stage is already finished.
+	if ( numUpdates == 0 )
+		finishIRUpdate();
+}
+
+
+
+
+void SoundPropagationSystem:: finishIRUpdate()
+{
+	// The renderers now refer to the updated IR, so the previously rendered IR can be reused.
+	renderedIR = updatingIR;
+	updatingIR = NULL;
 	
-	// Atomically signal to the main thread that sound propagation is no longer being performed.
-	isPropagating--;
+	// All update jobs for the stage are done, so report the slowest renderer update.
+	const Size numListeners = listenerRenderers.getSize();
+	irUpdateTime = 0;
+	
+	for ( Index i = 0; i < numListeners; i++ )
+		irUpdateTime = math::max( irUpdateTime, listenerRenderers[i]->irUpdateTime );
+	
+	// Destroy the renderers that were removed while they could have been updating.
+	const Size numRemovedRenderers = removedRenderers.getSize();
+	
+	for ( Index i = 0; i < numRemovedRenderers; i++ )
+	{
+		irUpdateTime = math::max( irUpdateTime, removedRenderers[i]->irUpdateTime );
+		util::destruct( removedRenderers[i] );
+	}
+	
+	removedRenderers.clear();
+	
+	// Start updating the renderers with the next IR, if one was propagated in the meantime.
+	dispatchIRUpdate();
+}
+
+
+
+
+void SoundPropagationSystem:: destroyListenerRenderer( ListenerRenderer* listenerRenderer )
+{
+	if ( updatingIR != NULL )
+		removedRenderers.add( listenerRenderer );
+	else
+		util::destruct( listenerRenderer );
+}
+
+
+
+
+void SoundPropagationSystem:: clearPipeline()
+{
+	const Size numIRs = sceneIRs.getSize();
+	
+	for ( Index i = 0; i < numIRs; i++ )
+		util::destruct( sceneIRs[i] );
+	
+	sceneIRs.clear();
+	propagatingIR = NULL;
+	queuedIR = NULL;
+	updatingIR = NULL;
+	renderedIR = NULL;
+	latestIR = NULL;
 }
 
 
@@ -928,14 +1354,24 @@ void SoundPropagationSystem:: doSoundPropagation( Float dt )
 
 
 
-void SoundPropagationSystem:: updateListenerIR( SoundListenerRenderer& renderer, const SoundListenerIR& ir,
-												const RenderRequest& request )
+void SoundPropagationSystem:: updateListenerIR( ListenerRenderer* listenerRenderer, const SoundListenerIR& ir )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagationSystem::updateListenerIR" );
+	
 	Timer updateTimer;
 	
-	renderer.updateIR( ir, request );
+	listenerRenderer->renderer.updateIR( ir, *listenerRenderer->request );
 	
-	irUpdateTime = math::max( irUpdateTime, updateTimer.getElapsedTime() );
+	// Only this job writes the renderer's time, and it is read after the decrement below.
+	listenerRenderer->irUpdateTime = updateTimer.getElapsedTime();
+	
+	// The last renderer update for the IR finishes the stage.
+	if ( --numPendingIRUpdates == 0 )
+	{
+		pipelineMutex.lock();
+		finishIRUpdate();
+		pipelineMutex.unlock();
+	}
 }
 
 
@@ -954,6 +1390,8 @@ void SoundPropagationSystem:: updateListenerIR( SoundListenerRenderer& renderer,
 
 Bool SoundPropagationSystem:: bufferSourceSound( const Time& newStreamTime )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagationSystem::bufferSourceSound" );
+	
 	// Don't buffer anything if the stream is up to date.
 	if ( newStreamTime == streamTime )
 		return true;
@@ -60,9 +60,12 @@
 #include "gsSourceSoundBuffer.h"
 #include "gsSoundListenerRenderer.h"
 #include "gsSoundMeshPreprocessor.h"
+#include "gsSoundTraceRecorder.h"
 
 
 #include "gsImpulseResponse.h"
+#include "gsSoundMemoryUsage.h"
+#include "internal/gsSceneSnapshot.h"
 
 
 //##########################################################################################
@@ -134,9 +137,11 @@ class SoundPropagationSystem
 			/// Update this propagation system for the specified time interval in seconds.
 			/**
 			  * This method starts the computation of a frame of sound propagation on
-			  * another thread. If a previous frame update is still being processed,
-			  * the method saves the delta time and returns without starting any propagation,
-			  * so that it does not block the calling thread for any significant time.
+			  * another thread. If the previous frame is still being propagated, or if all of the
+			  * pipeline's IR buffers are in use, the method saves the delta time and returns without
+			  * starting any propagation, so that it does not block the calling thread for any significant time.
+			  * The renderers are updated with each propagated frame on a separate set of threads,
+			  * while the next frame is propagated.
 			  *
 			  * The user should call this method at least as often as the target frame rate
 			  * of the simulation. It is better to call the method at a higher rate (e.g. 60Hz),
@@ -151,6 +156,30 @@ class SoundPropagationSystem
 			virtual void update( Float dt, Bool synchronous = false );
 			
 			
+		//********************************************************************************
+		//******	Pipeline Accessor Methods
+			
+			
+			/// Return the maximum number of IR frames that can be buffered in the propagation pipeline.
+			GSOUND_INLINE Size getPipelineDepth() const
+			{
+				return pipelineDepth;
+			}
+			
+			
+			/// Set the maximum number of IR frames that can be buffered in the propagation pipeline.
+			/**
+			  * Sound propagation and the renderer IR updates run as separate pipeline stages
+			  * on their own threads, so that a new frame can be propagated while the previous
+			  * frame is handed to the renderers. Each frame in flight needs its own scene IR,
+			  * and the pipeline depth bounds how many of them can exist at once.
+			  * If no IR buffer is available, update() skips starting a new frame until one is freed.
+			  *
+			  * The depth is clamped to be at least 2. The default depth is 3.
+			  */
+			void setPipelineDepth( Size newPipelineDepth );
+			
+			
 		//********************************************************************************
 		//******	Scene Accessor Methods
 			
@@ -203,6 +232,31 @@ class SoundPropagationSystem
 			}
 			
 			
+		//********************************************************************************
+		//******	Trace Recorder Accessor Methods
+			
+			
+			/// Return a pointer to the recorder that records the propagation and rendering done by this system.
+			GSOUND_INLINE SoundTraceRecorder* getTraceRecorder() const
+			{
+				return traceRecorder;
+			}
+			
+			
+			/// Set a pointer to a recorder that should record the propagation and rendering done by this system.
+			/**
+			  * Each propagation frame is recorded when it is started, and each listener
+			  * render call is recorded when it occurs. If the specified pointer is NULL,
+			  * recording is disabled.
+			  *
+			  * The system does not own the recorder. The user is responsible for managing the recorder's memory.
+			  */
+			GSOUND_INLINE void setTraceRecorder( SoundTraceRecorder* newTraceRecorder )
+			{
+				traceRecorder = newTraceRecorder;
+			}
+			
+			
 		//********************************************************************************
 		//******	Listener Accessor Methods
 			
@@ -327,6 +381,40 @@ class SoundPropagationSystem
 			 void getSceneIR( SoundSceneIR& ir ) const;
 			
 			
+		//********************************************************************************
+		//******	Memory Usage Accessor Methods
+			
+			
+			/// Copy a hierarchical breakdown of the memory used by this system into the output parameter.
+			/**
+			  * The memory usage has children for the "scene" meshes, the "propagation" caches for
+			  * each listener and source, the "ir" buffers in the pipeline, and the "rendering"
+			  * state for each listener renderer. It is updated at the end of each propagation
+			  * frame for which statistics are enabled in the propagation request, and is empty
+			  * before then.
+			  */
+			void getMemoryUsage( SoundMemoryUsage& usage ) const;
+			
+			
+			/// Return the memory budget in bytes for the memory usage object with the specified path, or 0 if there is none.
+			Size getMemoryBudget( const UTF8String& path ) const;
+			
+			
+			/// Set the memory budget in bytes for the memory usage object with the specified path.
+			/**
+			  * The path is a list of memory usage names separated by '/', e.g. "rendering" or
+			  * "scene/mesh 0". An empty path sets the budget for the total memory usage.
+			  * A budget of 0 removes the budget for that path. When the memory used by an object
+			  * exceeds its budget, the number of exceeded budgets is reported in the
+			  * memoryWarningCount statistic, and SoundMemoryUsage::getWarnings() describes them.
+			  */
+			void setMemoryBudget( const UTF8String& path, Size budget );
+			
+			
+			/// Remove all memory budgets from this system.
+			void clearMemoryBudgets();
+			
+			
 		//********************************************************************************
 		//******	Mesh Processing Methods
 			
@@ -356,13 +444,52 @@ class SoundPropagationSystem
 		//******	Private Helper Methods
 			
 			
-			/// Compute one frame of sound propagation and then spawn IR update job(s).
-			void doSoundPropagation( Float dt );
+			/// Reserve an output IR, snapshot the scene, and queue a frame of sound propagation.
+			/**
+			  * The method returns whether or not the frame was started. It fails if there
+			  * is no free IR and the update is not synchronous.
+			  */
+			Bool startPropagation( Float dt, Bool updateRenderers, Bool synchronous );
+			
+			
+			/// Compute one frame of sound propagation and then pass the IR to the renderer update stage if requested.
+			void doSoundPropagation( Float dt, Bool updateRenderers );
 			
 			
-			/// Update a listener renderer with the specified listener IR and render request.
-			void updateListenerIR( SoundListenerRenderer& renderer, const SoundListenerIR& ir,
-									const RenderRequest& request );
+			/// Update a listener renderer with the specified listener IR and its render request.
+			void updateListenerIR( ListenerRenderer* listenerRenderer, const SoundListenerIR& ir );
+			
+			
+			/// Return a scene IR that is not used by any pipeline stage, or NULL if there is none.
+			/**
+			  * The pipeline mutex must be locked when calling this method.
+			  */
+			SoundSceneIR* acquireFreeIR();
+			
+			
+			/// Start the renderer update stage for the queued IR if the stage is idle.
+			/**
+			  * The pipeline mutex must be locked when calling this method.
+			  */
+			void dispatchIRUpdate();
+			
+			
+			/// Finish the renderer update stage for the IR that was being updated.
+			/**
+			  * The pipeline mutex must be locked when calling this method.
+			  */
+			void finishIRUpdate();
+			
+			
+			/// Destroy a listener renderer, deferring it until the renderer update stage is idle if necessary.
+			/**
+			  * The pipeline mutex must be locked when calling this method.
+			  */
+			void destroyListenerRenderer( ListenerRenderer* listenerRenderer );
+			
+			
+			/// Destroy all of the scene IRs that are buffered in the pipeline.
+			void clearPipeline();
 			
 			
 			/// Buffer the input sound for all sources up to the given offset from this system's stream start.
@@ -384,17 +511,64 @@ class SoundPropagationSystem
 			SoundMeshPreprocessor preprocessor;
 			
 			
-			/// An array of two scene IR objects that are used to double-buffer the propagation IR data.
-			SoundSceneIR sceneIR[2];
+			/// A list of the scene IRs that are buffered in the propagation pipeline.
+			ArrayList<SoundSceneIR*> sceneIRs;
+			
+			
+			/// The scene IR that the propagation stage is writing to, or NULL if it is idle.
+			SoundSceneIR* propagatingIR;
+			
 			
+			/// The newest propagated scene IR that is waiting for the renderer update stage, or NULL if there is none.
+			SoundSceneIR* queuedIR;
+			
+			
+			/// The scene IR that is being passed to the listener renderers, or NULL if the update stage is idle.
+			SoundSceneIR* updatingIR;
+			
+			
+			/// The scene IR that was most recently passed to the listener renderers.
+			/**
+			  * The renderers may still refer to this IR, so it is kept until the next update finishes.
+			  */
+			SoundSceneIR* renderedIR;
 			
-			/// The index of the current scene IR that is being used for propagation output.
-			Index currentIR;
+			
+			/// The scene IR that was most recently output by the propagation stage.
+			SoundSceneIR* latestIR;
+			
+			
+			/// The maximum number of scene IRs that can be buffered in the propagation pipeline.
+			Size pipelineDepth;
+			
+			
+			/// The number of listener renderer updates that are not finished for the updating IR.
+			Atomic<Size> numPendingIRUpdates;
+			
+			
+			/// The index of the last ray slice that was started within the current target time step.
+			Index raySliceIndex;
+			
+			
+			/// A mutex that synchronizes the hand-off of IRs between the pipeline stages.
+			mutable Mutex pipelineMutex;
 			
 			
 			/// A list of objects that describe the listeners that should be auralized by this propagation system.
 			ArrayList<ListenerRenderer*> listenerRenderers;
 			
+			
+			/// A list of removed listener renderers that are destroyed when the renderer update stage is idle.
+			ArrayList<ListenerRenderer*> removedRenderers;
+			
+			
+			/// The memory used by this system on the last propagation frame that reported statistics.
+			SoundMemoryUsage memoryUsage;
+			
+			
+			/// A map from memory usage path to the memory budget in bytes for that path.
+			HashMap<UTF8String,Size> memoryBudgets;
+			
 
 
 
@@ -414,11 +588,23 @@ class SoundPropagationSystem
 			const SoundScene* scene;
 			
 			
+			/// A private copy of the scene's state that is read by asynchronous sound propagation.
+			/**
+			  * The snapshot copies the state of every scene object on the thread that calls update(),
+			  * so that the application can modify the scene while propagation is in progress.
+			  */
+			internal::SceneSnapshot sceneSnapshot;
+			
+			
 			/// An object that describes how sound propagation should be performed by this system.
 			PropagationRequest* propagationRequest;
 			
 			
-			/// A thread pool that handles the computation of frame update jobs.
+			/// A thread pool that runs the sound propagation stage of the pipeline.
+			ThreadPool propagationThreadPool;
+			
+			
+			/// A thread pool that runs the listener renderer IR update stage of the pipeline.
 			ThreadPool updateThreadPool;
 			
 			
@@ -426,11 +612,11 @@ class SoundPropagationSystem
 			mutable Mutex mutex;
 			
 			
-			/// The number of threads that are in the update thread pool.
+			/// The number of threads that are in the renderer IR update thread pool.
 			Size numUpdateThreads;
 			
 			
-			/// An atomically modified flag that indicates whether or not sound propagation is being computed currently.
+			/// An atomically modified flag that indicates whether or not a sound propagation job is queued or running.
 			Atomic<Size> isPropagating;
 			
 			
@@ -442,10 +628,14 @@ class SoundPropagationSystem
 			Time propagationTime;
 			
 			
-			/// The time that was spent updating the rendering IRs on the last frame.
+			/// The time that was spent updating the rendering IRs on the last frame, accessed with the pipeline mutex locked.
 			Time irUpdateTime;
 			
 			
+			/// A pointer to a recorder that records the propagation and rendering done by this system, or NULL.
+			SoundTraceRecorder* traceRecorder;
+			
+			
 			
 };
 
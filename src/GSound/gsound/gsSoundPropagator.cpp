@@ -53,6 +53,7 @@
 #include <algorithm>
 #include "internal/gsSoundPathCache.h"
 #include "internal/gsUTDFrequencyResponse.h"
+#include "gsSoundProfiler.h"
 
 #define EDGE_CLAMP 0
 
@@ -70,6 +71,93 @@ GSOUND_NAMESPACE_START
 using namespace internal;
 
 
+typedef math::SIMDScalar<Real,4> SIMDReal4;
+typedef math::SIMDScalar<Int32,4> SIMDInt4;
+typedef math::SIMDVector3D<Real,4> SIMDVector3;
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		SIMD Ray Intersection Helper Functions
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// Pack 4 vectors into a SIMD vector.
+GSOUND_FORCE_INLINE static SIMDVector3 packVectors( const Vector3f& v1, const Vector3f& v2, const Vector3f& v3, const Vector3f& v4 )
+{
+	return SIMDVector3( SIMDReal4( v1.x, v2.x, v3.x, v4.x ),
+						SIMDReal4( v1.y, v2.y, v3.y, v4.y ),
+						SIMDReal4( v1.z, v2.z, v3.z, v4.z ) );
+}
+
+
+
+
+/// Intersect 4 rays with a triangle, returning a mask of the rays that hit it in front of their origins.
+/**
+  * This computes the same result as Ray3f::intersectsTriangle() for each ray.
+  */
+GSOUND_FORCE_INLINE static SIMDInt4 intersectRaysTriangle( const SIMDVector3& origin, const SIMDVector3& direction,
+															const WorldSpaceTriangle& triangle, SIMDReal4& distance )
+{
+	// Find the edge vectors of the triangle.
+	const SIMDVector3 v1( triangle.v1 );
+	const SIMDVector3 v1ToV2( triangle.v2 - triangle.v1 );
+	const SIMDVector3 v1ToV3( triangle.v3 - triangle.v1 );
+	
+	// The vector perpendicular to edge 2 and the ray's direction.
+	const SIMDVector3 pvec = math::cross( direction, v1ToV3 );
+	const SIMDReal4 det = math::dot( v1ToV2, pvec );
+	const SIMDReal4 inverseDet = SIMDReal4(Real(1)) / det;
+	
+	const SIMDVector3 v1ToOrigin = origin - v1;
+	const SIMDReal4 u = math::dot( v1ToOrigin, pvec )*inverseDet;
+	
+	const SIMDVector3 qvec = math::cross( v1ToOrigin, v1ToV2 );
+	const SIMDReal4 v = math::dot( direction, qvec )*inverseDet;
+	
+	distance = math::dot( v1ToV3, qvec )*inverseDet;
+	
+	return (math::abs(det) >= math::epsilon<Real>()) & (u >= Real(0)) & (u <= Real(1)) &
+			(v >= Real(0)) & (u + v <= Real(1)) & (distance > Real(0));
+}
+
+
+
+
+/// Intersect 4 rays with a sphere, returning a mask of the rays that hit it.
+/**
+  * This computes the same result as Ray3f::intersectsSphere() for each ray.
+  */
+GSOUND_FORCE_INLINE static SIMDInt4 intersectRaysSphere( const SIMDVector3& origin, const SIMDVector3& direction,
+														const Sphere3f& sphere, SIMDReal4& distance )
+{
+	const SIMDVector3 d = SIMDVector3( sphere.position ) - origin;
+	const SIMDReal4 dSquared = math::dot( d, d );
+	const SIMDReal4 rSquared( sphere.radius*sphere.radius );
+	
+	// Find the closest point on the rays to the sphere's center.
+	const SIMDReal4 t1 = math::dot( d, direction );
+	
+	// Find the distance from the closest point to the sphere's surface.
+	const SIMDReal4 t2Squared = rSquared - dSquared + t1*t1;
+	const SIMDReal4 t2 = math::sqrt( math::max( t2Squared, SIMDReal4(Real(0)) ) );
+	
+	// Rays that start inside the sphere hit the far side, all others hit the near side.
+	const SIMDInt4 inside = dSquared < rSquared;
+	distance = math::select( inside, t1 + t2, t1 - t2 );
+	
+	return inside | ((t1 >= Real(0)) & (t2Squared >= Real(0)));
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -530,6 +618,56 @@ class SoundPropagator:: DiffusePathData
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Cached Specular Path Class Definition
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+class SoundPropagator:: CachedSpecularPath
+{
+	public:
+		
+		GSOUND_INLINE CachedSpecularPath( SoundPathCache::Entry* newEntry, const FrequencyBandResponse& newAttenuation,
+										Index newImageStartIndex, Size newNumImages, Index newSourceIndex )
+			:	entry( newEntry ),
+				attenuation( newAttenuation ),
+				imageStartIndex( newImageStartIndex ),
+				numImages( newNumImages ),
+				sourceIndex( newSourceIndex ),
+				valid( true )
+		{
+		}
+		
+		
+		/// A pointer to the path cache entry for this path.
+		SoundPathCache::Entry* entry;
+		
+		/// The frequency-dependent attenuation of the reflections along this path.
+		FrequencyBandResponse attenuation;
+		
+		/// The index of this path's first listener image position in the thread's list of gathered image positions.
+		Index imageStartIndex;
+		
+		/// The number of listener image positions (reflections) along this path.
+		Size numImages;
+		
+		/// The sound source index.
+		Index sourceIndex;
+		
+		/// Whether or not this path passed the batched pre-checks and still needs full validation.
+		Bool valid;
+		
+};
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -603,6 +741,14 @@ class SoundPropagator:: ThreadData
 		Array<Ray3f> validationRays;
 		
 		
+		/// A list of the cached specular paths that are being revalidated by this thread.
+		ArrayList<CachedSpecularPath> cachedPaths;
+		
+		
+		/// A list of the listener image positions for all of the cached paths that are being revalidated.
+		ArrayList<ImagePosition> cachedImagePositions;
+		
+		
 		/// An object which stores information needed when doing a diffraction query.
 		DiffractionQuery diffractionQuery;
 		
@@ -639,6 +785,18 @@ class SoundPropagator:: ThreadData
 		Size totalRayDepth;
 		
 		
+#if OM_BVH_TRAVERSAL_STATISTICS
+		/// The BVH traversal statistics for the rays that were traced by this thread's last ray tracing job.
+		om::bvh::BVHTraversalStatistics traversalStatistics;
+#endif
+		
+		
+#if GSOUND_ENABLE_HEAT_MAP
+		/// The ray hits that were counted by this thread and not yet added to the request's heat map.
+		SoundHeatMap heatMap;
+#endif
+		
+		
 };
 
 
@@ -735,6 +893,8 @@ SoundPropagator& SoundPropagator:: operator = ( const SoundPropagator& other )
 
 void SoundPropagator:: propagateSound( const SoundScene& newScene, PropagationRequest& newRequest, SoundSceneIR& sceneIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::propagateSound" );
+	
 	//***************************************************************************
 	
 	// Sanitize the sound propagation request and store a temporary pointer to it.
@@ -745,6 +905,7 @@ void SoundPropagator:: propagateSound( const SoundScene& newScene, PropagationRe
 	request->numSpecularSamples = math::clamp( request->numSpecularSamples, Size(1), Size(10000) );
 	request->maxDiffuseDepth = math::min( request->maxDiffuseDepth, Size(1000) );
 	request->numDiffuseRays = math::min( request->numDiffuseRays, Size(1000000000) );
+	request->raySliceCount = math::clamp( request->raySliceCount, Size(1), Size(1000) );
 	request->numDiffuseSamples = math::clamp( request->numDiffuseSamples, Size(1), Size(10000) );
 	request->maxDiffractionDepth = math::min( request->maxDiffractionDepth, Size(1000) );
 	request->maxDiffractionOrder = math::min( request->maxDiffractionOrder, Size(10) );
@@ -831,61 +992,23 @@ void SoundPropagator:: propagateSound( const SoundScene& newScene, PropagationRe
 				doSourcesPropagation( listener, listenerIR );
 		}
 		
-		addDirectPaths( listener, listenerIR, threadDataList[0] );
+		addDirectPaths( listener, listenerIR );
 		
 		//***************************************************************************
 		// Post-process the IRs for the listener.
 		
-		// Convert the threshold in dB SPL to threshold in sound power.
-		const FrequencyBandResponse thresholdPower = listener.getThresholdPower( request->frequencies );
+		postProcessSourceIRs( listener, listenerIR );
+		
+		// Compute the average and maximum source IR length for the listener.
 		const Size numSources = listenerIR.getSourceCount();
 		Float listenerIRLength = 0;
 		numAverageIRSources += numSources;
 		
 		for ( Index s = 0; s < numSources; s++ )
 		{
-			SourceData& sourceData = sourceDataList[s];
-			SoundSourceIR& sourceIR = listenerIR.getSourceIR(s);
-			Float sourceIRLength = 0;
-			
-			// Trim the length of the IR based on the listener's threshold of hearing.
-			if ( request->flags.isSet( PropagationFlags::IR_THRESHOLD ) )
-				sourceIRLength = sourceIR.trim( thresholdPower );
-			else
-				sourceIRLength = sourceIR.getLength();
-			
-			// Determine the max IR length for the source on the next frame based on the current IR length.
-			if ( request->flags.isSet( PropagationFlags::IR_THRESHOLD ) &&
-				request->flags.isSet( PropagationFlags::ADAPTIVE_IR_LENGTH ) )
-			{
-				const Float baseGrowth = request->irGrowthRate*request->dt;
-				Float previousMaxLength = sourceData.sourceData->maxIRLength;
-				Float growth;
-				
-				if ( sourceIRLength + baseGrowth < previousMaxLength )
-				{
-					// Shrink the IR if the trimmed IR was significantly shorter than the prevous max length.
-					growth = -math::min( baseGrowth, previousMaxLength - sourceIRLength );
-				}
-				else
-				{
-					// Grow the IR by at least the base growth.
-					growth = math::max( baseGrowth, sourceIRLength - previousMaxLength );
-				}
-				
-				Float maxIRLength = math::clamp( previousMaxLength + growth, request->minIRLength, request->maxIRLength );
-				
-				// Save the max IR length for later.
-				sourceData.sourceData->maxIRLength = maxIRLength;
-			}
-			
-			// Save the source IR length in the data for the source.
-			sourceData.sourceData->irLength = sourceIRLength;
-			sourceData.irCache->setLengthInSamples( sourceIR.getLengthInSamples() );
+			const Float sourceIRLength = sourceDataList[s].sourceData->irLength;
 			
 			averageIRLength += sourceIRLength;
-			
-			// Compute the maximum source IR length for the listener.
 			listenerIRLength = math::max( listenerIRLength, sourceIRLength );
 		}
 		
@@ -955,15 +1078,17 @@ void SoundPropagator:: propagateSound( const SoundScene& newScene, PropagationRe
 
 void SoundPropagator:: doListenerPropagation( const ListenerData& listenerData, SoundListenerIR& listenerIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::doListenerPropagation" );
+	
 	const Bool specularEnabled = request->flags.isSet( PropagationFlags::SPECULAR );
 	const Bool diffuseEnabled = request->flags.isSet( PropagationFlags::DIFFUSE );
 	const Bool diffractionEnabled = request->flags.isSet( PropagationFlags::DIFFRACTION );
 	const Bool diffuseCacheEnabled = request->flags.isSet( PropagationFlags::DIFFUSE_CACHE );
 	const Bool irCacheEnabled = request->flags.isSet( PropagationFlags::IR_CACHE ) && request->flags.isSet( PropagationFlags::SAMPLED_IR );
 	const Size maxSpecularDepth = (Size)(request->maxSpecularDepth/**request->quality*/);
-	const Size numSpecularRays = (Size)(request->numSpecularRays*request->quality);
+	const Size numSpecularRays = getSliceRayCount( request->numSpecularRays*request->quality );
 	const Size maxDiffuseDepth = (Size)(request->maxDiffuseDepth/*request->quality*/);
-	const Size numDiffuseRays = (Size)(request->numDiffuseRays*request->quality);
+	const Size numDiffuseRays = getSliceRayCount( request->numDiffuseRays*request->quality );
 	const Size numThreads = request->numThreads;
 	const Size numSources = sourceDataList.getSize();
 	
@@ -1071,6 +1196,10 @@ void SoundPropagator:: doListenerPropagation( const ListenerData& listenerData,
 	Size numSpecularRaysCast = 0;
 	Size totalRayDepth = 0;
 	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	om::bvh::BVHTraversalStatistics traversalStatistics;
+#endif
+	
 	for ( Index i = 0; i < numThreads; i++ )
 	{
 		ThreadData& threadData = threadDataList[i];
@@ -1106,6 +1235,18 @@ void SoundPropagator:: doListenerPropagation( const ListenerData& listenerData,
 		numDiffuseRaysCast += threadDataList[i].numDiffuseRaysCast;
 		numSpecularRaysCast += threadDataList[i].numSpecularRaysCast;
 		totalRayDepth += threadDataList[i].totalRayDepth;
+		
+#if OM_BVH_TRAVERSAL_STATISTICS
+		traversalStatistics += threadData.traversalStatistics;
+#endif
+		
+#if GSOUND_ENABLE_HEAT_MAP
+		// Add the hits that were counted by the thread to the heat map.
+		if ( request->heatMap != NULL )
+			request->heatMap->addHits( threadData.heatMap );
+		
+		threadData.heatMap.clear();
+#endif
 	}
 	
 	timer.update();
@@ -1116,6 +1257,13 @@ void SoundPropagator:: doListenerPropagation( const ListenerData& listenerData,
 		statistics->diffuseRayCount = numDiffuseRaysCast;
 		statistics->specularRayCount = numSpecularRaysCast;
 		statistics->diffuseRayDepth = Size(Float(totalRayDepth) / numDiffuseRaysCast);
+		
+#if OM_BVH_TRAVERSAL_STATISTICS
+		statistics->bvhTraversalCount = traversalStatistics.rayCount;
+		statistics->averageBVHNodeCount = traversalStatistics.getAverageNodeCount();
+		statistics->averageBVHTriangleCount = traversalStatistics.getAveragePrimitiveCount();
+		statistics->maxBVHNodeCount = traversalStatistics.maxRayNodeCount;
+#endif
 	}
 	
 	//************************************************************************
@@ -1247,6 +1395,12 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 												Size maxDiffuseDepth, Size numDiffuseRays,
 												Float maxIRLength, ThreadData& threadData )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::propagateListenerRays" );
+	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	om::bvh::BVHTraversalStatistics::getLocal().reset();
+#endif
+	
 	const Bool specularEnabled = request->flags.isSet( PropagationFlags::SPECULAR );
 	const Bool diffuseEnabled = request->flags.isSet( PropagationFlags::DIFFUSE );
 	const Bool diffractionEnabled = request->flags.isSet( PropagationFlags::DIFFRACTION );
@@ -1262,6 +1416,9 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 	
 	if ( (specularEnabled || diffractionEnabled) && specularDepth > 0 )
 	{
+		// Select the ray kernel that is specialized for the current flags.
+		const SpecularRayFunction propagateSpecularRay = getSpecularRayFunction();
+		
 		// Cast as many rays as there is room in the ray budget.
 		Size rayCastsRemaining = numSpecularRays*specularDepth;
 		threadData.numSpecularRaysCast = 0;
@@ -1271,7 +1428,7 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 			// Create the starting ray for this probe sequence.
 			Ray3f ray( listener.getPosition(), getRandomDirection( threadData.randomVariable ) );
 			
-			Size raysCast = propagateListenerSpecularRay( listener, soundPathCache, ray,
+			Size raysCast = (this->*propagateSpecularRay)( listener, soundPathCache, ray,
 													math::min( specularDepth, rayCastsRemaining ), maxIRLength, threadData );
 			
 			rayCastsRemaining -= math::min( math::min( math::max( raysCast, minRayCost ), specularDepth ), rayCastsRemaining );
@@ -1286,6 +1443,9 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 	
 	if ( diffuseEnabled && !request->flags.isSet( PropagationFlags::SOURCE_DIFFUSE ) )
 	{
+		// Select the ray kernel that is specialized for the current flags.
+		const DiffuseRayFunction propagateDiffuseRay = getDiffuseRayFunction();
+		
 		// Cast as many rays as there is room in the ray budget.
 		Size rayCastsRemaining = numDiffuseRays*maxDiffuseDepth;
 		threadData.numDiffuseRaysCast = 0;
@@ -1299,7 +1459,7 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 			ray.origin += ray.direction*listener.getRadius();
 			
 			// Propagate this ray and count the number of rays that were cast.
-			Size raysCast = propagateListenerDiffuseRay( listener, ray, math::min( maxDiffuseDepth, rayCastsRemaining ),
+			Size raysCast = (this->*propagateDiffuseRay)( listener, ray, math::min( maxDiffuseDepth, rayCastsRemaining ),
 													maxIRLength, ray.direction, threadData );
 			
 			threadData.totalRayDepth += raysCast;
@@ -1309,6 +1469,10 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 		}
 	}
 	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	threadData.traversalStatistics = om::bvh::BVHTraversalStatistics::getLocal();
+#endif
+	
 	// Signal that we are done processing.
 	threadData.threadDone++;
 	mainThreadSignal.signal();
@@ -1328,13 +1492,10 @@ void SoundPropagator:: propagateListenerRays( const SoundDetector& listener, con
 
 
 
+template < Bool specularEnabled, Bool diffractionEnabled, Bool visibilityCacheEnabled, Bool specularCacheEnabled >
 Size SoundPropagator:: propagateListenerSpecularRay( const SoundDetector& listener, const SoundPathCache& soundPathCache,
 													Ray3f ray, Size numBounces, Float maxIRLength, ThreadData& threadData )
 {
-	const Bool specularEnabled = request->flags.isSet( PropagationFlags::SPECULAR );
-	const Bool diffractionEnabled = request->flags.isSet( PropagationFlags::DIFFRACTION );
-	const Bool visibilityCacheEnabled = request->flags.isSet( PropagationFlags::VISIBILITY_CACHE );
-	const Bool specularCacheEnabled = request->flags.isSet( PropagationFlags::SPECULAR_CACHE );
 	const Size maxDiffractionDepth = request->maxDiffractionDepth;
 	const Size numSpecularSamples = request->numSpecularSamples;
 	const Real rayOffset = request->rayOffset;
@@ -1364,8 +1525,13 @@ Size SoundPropagator:: propagateListenerSpecularRay( const SoundDetector& listen
 		// Trace the ray through the scene.
 		if ( scene->intersectRay( ray, math::max<Real>(), closestIntersection, closestTriangle ) )
 		{
+#if GSOUND_ENABLE_HEAT_MAP
+			if ( request->heatMap != NULL )
+				threadData.heatMap.addHit( closestTriangle.object, closestTriangle.object->getMesh()->getTriangleIndex( closestTriangle.triangle ) );
+#endif
+			
 			// Transform the closest triangle into world space.
-			const WorldSpaceTriangle worldSpaceTriangle( closestTriangle );
+			const WorldSpaceTriangle worldSpaceTriangle = getWorldSpaceTriangle( closestTriangle );
 			Vector3f normal = worldSpaceTriangle.plane.normal;
 			
 			// Calculate the intersection point of the ray with the triangle in world space.
@@ -1461,6 +1627,7 @@ Size SoundPropagator:: propagateListenerSpecularRay( const SoundDetector& listen
 					
 					if ( validateSpecularPath( Sphere3f( source.getPosition(), source.getRadius() ),
 												listener.getPosition(), numSpecularSamples,
+												imagePositions.getPointer(), imagePositions.getSize(),
 												specularDistance, directionFromListener, directionToSource, 
 												visibility, threadData ) )
 					{
@@ -1505,11 +1672,11 @@ Size SoundPropagator:: propagateListenerSpecularRay( const SoundDetector& listen
 
 
 
+template < Bool visibilityCacheEnabled >
 Size SoundPropagator:: propagateListenerDiffuseRay( const SoundDetector& listener, Ray3f ray, Size numBounces,
 													Float maxIRLength,
 													const Vector3f& listenerDirection, ThreadData& threadData )
 {
-	const Bool visibilityCacheEnabled = request->flags.isSet( PropagationFlags::VISIBILITY_CACHE );
 	const Size numDiffuseSamples = request->numDiffuseSamples;
 	const Real rayOffset = request->rayOffset;
 	const Size numSources = sourceDataList.getSize();
@@ -1539,8 +1706,13 @@ Size SoundPropagator:: propagateListenerDiffuseRay( const SoundDetector& listene
 		// Trace the ray through the scene.
 		if ( scene->intersectRay( ray, remainingDistance, intersectionDistance, closestTriangle ) )
 		{
+#if GSOUND_ENABLE_HEAT_MAP
+			if ( request->heatMap != NULL )
+				threadData.heatMap.addHit( closestTriangle.object, closestTriangle.object->getMesh()->getTriangleIndex( closestTriangle.triangle ) );
+#endif
+			
 			// Transform the closest triangle's normal into world space.
-			Vector3f normal = closestTriangle.object->getTransform().transformToWorld( closestTriangle.triangle->getPlane() ).normal;
+			Vector3f normal = getWorldSpacePlane( closestTriangle ).normal;
 			
 			// Flip the normal if it points in the same direction as the ray.
 			if ( math::dot( ray.direction, normal ) > Real(0) )
@@ -1552,7 +1724,7 @@ Size SoundPropagator:: propagateListenerDiffuseRay( const SoundDetector& listene
 			//****************************************************************************************
 			
 #if DIFFUSE_CACHE_ENABLED
-			const WorldSpaceTriangle worldSpaceTriangle( closestTriangle );
+			const WorldSpaceTriangle worldSpaceTriangle = getWorldSpaceTriangle( closestTriangle );
 			// Compute the barycentric coordinates of this intersection point with respect to the triangle.
 			Vector3f barycentric = math::barycentric( worldSpaceTriangle.v1, worldSpaceTriangle.v2,
 														worldSpaceTriangle.v3, ray.origin );
@@ -1667,6 +1839,62 @@ Size SoundPropagator:: propagateListenerDiffuseRay( const SoundDetector& listene
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Ray Kernel Selection Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundPropagator::SpecularRayFunction SoundPropagator:: getSpecularRayFunction() const
+{
+	// A table of the kernel specializations, indexed by the flag bits below.
+	static const SpecularRayFunction functions[16] =
+	{
+		&SoundPropagator::propagateListenerSpecularRay<false,false,false,false>,
+		&SoundPropagator::propagateListenerSpecularRay<false,false,false,true>,
+		&SoundPropagator::propagateListenerSpecularRay<false,false,true,false>,
+		&SoundPropagator::propagateListenerSpecularRay<false,false,true,true>,
+		&SoundPropagator::propagateListenerSpecularRay<false,true,false,false>,
+		&SoundPropagator::propagateListenerSpecularRay<false,true,false,true>,
+		&SoundPropagator::propagateListenerSpecularRay<false,true,true,false>,
+		&SoundPropagator::propagateListenerSpecularRay<false,true,true,true>,
+		&SoundPropagator::propagateListenerSpecularRay<true,false,false,false>,
+		&SoundPropagator::propagateListenerSpecularRay<true,false,false,true>,
+		&SoundPropagator::propagateListenerSpecularRay<true,false,true,false>,
+		&SoundPropagator::propagateListenerSpecularRay<true,false,true,true>,
+		&SoundPropagator::propagateListenerSpecularRay<true,true,false,false>,
+		&SoundPropagator::propagateListenerSpecularRay<true,true,false,true>,
+		&SoundPropagator::propagateListenerSpecularRay<true,true,true,false>,
+		&SoundPropagator::propagateListenerSpecularRay<true,true,true,true>
+	};
+	
+	const Index functionIndex = (request->flags.isSet( PropagationFlags::SPECULAR ) ? 8 : 0) |
+								(request->flags.isSet( PropagationFlags::DIFFRACTION ) ? 4 : 0) |
+								(request->flags.isSet( PropagationFlags::VISIBILITY_CACHE ) ? 2 : 0) |
+								(request->flags.isSet( PropagationFlags::SPECULAR_CACHE ) ? 1 : 0);
+	
+	return functions[functionIndex];
+}
+
+
+
+
+SoundPropagator::DiffuseRayFunction SoundPropagator:: getDiffuseRayFunction() const
+{
+	if ( request->flags.isSet( PropagationFlags::VISIBILITY_CACHE ) )
+		return &SoundPropagator::propagateListenerDiffuseRay<true>;
+	else
+		return &SoundPropagator::propagateListenerDiffuseRay<false>;
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -1734,6 +1962,8 @@ void SoundPropagator:: outputSpecularPath( const SpecularPathData& path, Float d
 
 void SoundPropagator:: updateSpecularCache( SoundPathCache& specularCache, const ArrayList<SpecularPathData>& newPaths, SoundListenerIR& listenerIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::updateSpecularCache" );
+	
 	const Bool sampledIREnabled = request->flags.isSet( PropagationFlags::SAMPLED_IR );
 	const Bool dopplerSortingEnabled = request->flags.isSet( PropagationFlags::DOPPLER_SORTING );
 	const Float dopplerThreshold = request->dopplerThreshold;
@@ -1833,11 +2063,23 @@ void SoundPropagator:: updateSpecularCache( SoundPathCache& specularCache, const
 
 void SoundPropagator:: validateSpecularCache( const ListenerData& listenerData, SoundListenerIR& listenerIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::validateSpecularCache" );
+	
 	SoundPathCache& soundPathCache = *listenerData.soundPathCache;
 	
 	// Make sure the load factor for hash table is ok.
 	soundPathCache.checkLoadFactor();
 	
+	// Map each source detector to its index so that cached paths can find their source quickly.
+	const Size numSources = sourceDataList.getSize();
+	sourceIndexMap.clear();
+	
+	for ( Index s = 0; s < numSources; s++ )
+	{
+		const SoundDetector* source = sourceDataList[s].detector;
+		sourceIndexMap.add( getSourceHash( source ), source, s );
+	}
+	
 	//****************************************************************************************
 	// Validate the previously cached paths in parallel.
 	
@@ -1846,8 +2088,8 @@ void SoundPropagator:: validateSpecularCache( const ListenerData& listenerData,
 	
 	if ( numThreads > 1 )
 	{
-		// Compute the total number of buckets that should be updated for each thread.
-		const Size bucketsPerThread = (Size)math::ceiling( Real(bucketCount) / Real(numThreads) );
+		// Compute the number of paths that should be validated by each thread.
+		const Size pathsPerThread = (Size)math::ceiling( Real(soundPathCache.getPathCount()) / Real(numThreads) );
 		Index bucketStart = 0;
 		
 		// Update the cache in parallel for each range of buckets in the cache.
@@ -1855,8 +2097,18 @@ void SoundPropagator:: validateSpecularCache( const ListenerData& listenerData,
 		{
 			ThreadData& threadData = threadDataList[i];
 			
-			// Compute the number of buckets that this thread should have.
-			Size numThreadBuckets = math::min( bucketCount - bucketStart, bucketsPerThread );
+			// Choose a range of buckets that contains about the same number of paths as the other threads.
+			Index bucketEnd = bucketStart;
+			
+			if ( i == numThreads - 1 )
+				bucketEnd = bucketCount;
+			else
+			{
+				for ( Size numThreadPaths = 0; bucketEnd < bucketCount && numThreadPaths < pathsPerThread; bucketEnd++ )
+					numThreadPaths += soundPathCache.getBucket( bucketEnd ).getSize();
+			}
+			
+			Size numThreadBuckets = bucketEnd - bucketStart;
 			
 			threadPool.addJob( FunctionCall< void ( SoundPathCache&, Index, Size, ThreadData& )>(
 										bind( &SoundPropagator::validateSpecularCacheRange, this ),
@@ -1926,23 +2178,24 @@ void SoundPropagator:: validateSpecularCache( const ListenerData& listenerData,
 void SoundPropagator:: validateSpecularCacheRange( internal::SoundPathCache& specularCache, Index bucketStartIndex, Size numBuckets,
 													ThreadData& threadData )
 {
-	//****************************************************************************************
-	// Validate previous entries in the cache and output final paths for those entries.
+	GSOUND_PROFILE_ZONE( "SoundPropagator::validateSpecularCacheRange" );
 	
 	const Size maxPathAge = 0;
 	const Index timeStamp = request->internalData.timeStamp;
-	const Size numSources = sourceDataList.getSize();
 	const Size numSpecularSamples = request->numSpecularSamples;
 	const Bool specularEnabled = request->flags.isSet( PropagationFlags::SPECULAR );
 	const Bool diffractionEnabled = request->flags.isSet( PropagationFlags::DIFFRACTION );
 	
-	Vector3f directionFromListener;
-	Vector3f directionToSource;
-	Real specularDistance;
-	ArrayList<ImagePosition>& imagePositions = threadData.imagePositions;
+	ArrayList<CachedSpecularPath>& cachedPaths = threadData.cachedPaths;
+	ArrayList<ImagePosition>& cachedImagePositions = threadData.cachedImagePositions;
 	
 	const Index lastBucketIndex = bucketStartIndex + numBuckets;
 	
+	//****************************************************************************************
+	// Gather the cached specular paths and their image positions so that they can be checked in batches.
+	// Entries are only removed at or after the current index of a bucket, so the gathered
+	// entry pointers stay valid.
+	
 	for ( Index b = bucketStartIndex; b < lastBucketIndex; b++ )
 	{
 		SoundPathCache::BucketType& bucket = specularCache.getBucket(b);
@@ -1953,20 +2206,10 @@ void SoundPropagator:: validateSpecularCacheRange( internal::SoundPathCache& spe
 			const SoundPathID& pathID = entry.pathID;
 			const SoundDetector* source = pathID.getSource();
 			const SoundDetector* listener = pathID.getListener();
-			Index sourceIndex = math::max<Index>();
-			
-			// Determine the current index of the source in the output buffer.
-			for ( Index s = 0; s < numSources; s++ )
-			{
-				if ( source == sourceDataList[s].detector )
-				{
-					sourceIndex = s;
-					break;
-				}
-			}
+			const Index* sourceIndex;
 			
 			// Source no longer exists, remove this cache entry.
-			if ( sourceIndex == math::max<Index>() )
+			if ( !sourceIndexMap.find( getSourceHash( source ), source, sourceIndex ) )
 			{
 				bucket.removeAtIndexUnordered(i);
 				continue;
@@ -1974,17 +2217,12 @@ void SoundPropagator:: validateSpecularCacheRange( internal::SoundPathCache& spe
 			
 			// Handle diffraction as a special case.
 			if ( pathID.getPoint(0).getType() == SoundPathPoint::EDGE_DIFFRACTION )
-			{/*
-				if ( validateDiffractionPath( pathID, sourceIndex, threadData ) )
-				{
-					// Update the time stamp for this entry.
-					entry.timeStamp = timeStamp;
-				}*/
+			{
 				if ( diffractionEnabled && addDiffractionPaths( threadData, *listener,
 											NULL, *source,
 											listener->getPosition(),
-											WorldSpaceTriangle( pathID.getPoint(0).getTriangle() ),
-											sourceIndex ) )
+											getWorldSpaceTriangle( pathID.getPoint(0).getTriangle() ),
+											*sourceIndex ) )
 				{
 					// Update the time stamp for this entry.
 					entry.timeStamp = timeStamp;
@@ -1998,81 +2236,151 @@ void SoundPropagator:: validateSpecularCacheRange( internal::SoundPathCache& spe
 			}
 			else if ( specularEnabled )
 			{
-				//****************************************************************************************
-				// Generate a fake probe path so that we can call the path validation functions.
-				
-				imagePositions.clear();
+				// Compute the listener image position at each reflection and the total reflection attenuation.
+				const Index imageStartIndex = cachedImagePositions.getSize();
+				const Size numPoints = pathID.getPointCount();
 				Vector3f listenerImagePosition = listener->getPosition();
 				FrequencyBandResponse specularAttenuation;
 				
-				for ( Index j = 0; j < pathID.getPointCount(); j++ )
+				for ( Index j = 0; j < numPoints; j++ )
 				{
 					const SoundPathPoint& pathPoint = pathID.getPoint(j);
 					
 					// Get the reflecting triangle in world space and reflect the listener image position over it.
-					WorldSpaceTriangle worldSpaceTriangle( pathPoint.getTriangle() );
+					const WorldSpaceTriangle worldSpaceTriangle = getWorldSpaceTriangle( pathPoint.getTriangle() );
 					listenerImagePosition = worldSpaceTriangle.plane.getReflection( listenerImagePosition );
-					imagePositions.add( ImagePosition( worldSpaceTriangle, listenerImagePosition ) );
+					cachedImagePositions.add( ImagePosition( worldSpaceTriangle, listenerImagePosition ) );
 					
 					// Apply the material attenuation.
 					const SoundMaterial* material = worldSpaceTriangle.objectSpaceTriangle.triangle->getMaterial();
 					specularAttenuation *= material->getReflectivityBands()*(Real(1) - material->getScatteringBands());
 				}
 				
-				//****************************************************************************************
-				// Validate the path.
-				
-				Bool pathValid = false;
-				Real visibility;
-				
-				if ( validateSpecularPath( Sphere3f( source->getPosition(), source->getRadius() ),
-												listener->getPosition(), numSpecularSamples,
-												specularDistance, directionFromListener, directionToSource, 
-												visibility, threadData ) )
-				{
-					// A path was found for this sound source.
-					// Update the time stamp for this entry.
-					entry.timeStamp = timeStamp;
-					
-					Real relativeSpeed = getRelativeSpeed( *listener, directionFromListener, *source, directionToSource );
-					FrequencyBandResponse energy = visibility*getDistanceAttenuation(specularDistance)*specularAttenuation;
-					
-					if ( sourceDataList[sourceIndex].directivity )
-						energy *= sourceDataList[sourceIndex].directivity->getResponse( (-directionToSource)*source->getOrientation() );
-					
-					threadData.specularPaths.add(
-									SpecularPathData( pathID.getHashCode(), SoundPathFlags::SPECULAR,
-												energy, directionFromListener, -directionToSource, specularDistance,
-												relativeSpeed, scene->getMedium().getSpeed(), sourceIndex ) );
-					pathValid = true;
-				}
-				else
-				{
-					// Path no longer exists.
-					// If the path is older than the threshold amount, remove it.
-					if ( timeStamp - entry.timeStamp > maxPathAge )
-					{
-						bucket.removeAtIndexUnordered(i);
-						continue;
-					}
-				}
-			}
-			else
-			{
-				// Path no longer exists.
-				// If the path is older than the threshold amount, remove it.
-				if ( timeStamp - entry.timeStamp > maxPathAge )
-				{
-					bucket.removeAtIndexUnordered(i);
-					continue;
-				}
+				cachedPaths.add( CachedSpecularPath( &entry, specularAttenuation, imageStartIndex, numPoints, *sourceIndex ) );
 			}
 			
 			i++;
 		}
 	}
 	
-	imagePositions.clear();
+	//****************************************************************************************
+	// Reject point-source paths that fail the cheap geometric tests in SIMD batches.
+	
+	rejectCachedPointPaths( cachedPaths, cachedImagePositions );
+	
+	//****************************************************************************************
+	// Validate the remaining paths and output final paths for those that are valid.
+	
+	const Size numCachedPaths = cachedPaths.getSize();
+	Vector3f directionFromListener;
+	Vector3f directionToSource;
+	Real specularDistance;
+	Real visibility;
+	
+	for ( Index p = 0; p < numCachedPaths; p++ )
+	{
+		const CachedSpecularPath& path = cachedPaths[p];
+		
+		if ( !path.valid )
+			continue;
+		
+		SoundPathCache::Entry& entry = *path.entry;
+		const SoundDetector* source = entry.pathID.getSource();
+		const SoundDetector* listener = entry.pathID.getListener();
+		
+		if ( validateSpecularPath( Sphere3f( source->getPosition(), source->getRadius() ),
+										listener->getPosition(), numSpecularSamples,
+										cachedImagePositions.getPointer() + path.imageStartIndex, path.numImages,
+										specularDistance, directionFromListener, directionToSource, 
+										visibility, threadData ) )
+		{
+			// A path was found for this sound source.
+			// Update the time stamp for this entry.
+			entry.timeStamp = timeStamp;
+			
+			Real relativeSpeed = getRelativeSpeed( *listener, directionFromListener, *source, directionToSource );
+			FrequencyBandResponse energy = visibility*getDistanceAttenuation(specularDistance)*path.attenuation;
+			
+			if ( sourceDataList[path.sourceIndex].directivity )
+				energy *= sourceDataList[path.sourceIndex].directivity->getResponse( (-directionToSource)*source->getOrientation() );
+			
+			threadData.specularPaths.add(
+							SpecularPathData( entry.pathID.getHashCode(), SoundPathFlags::SPECULAR,
+										energy, directionFromListener, -directionToSource, specularDistance,
+										relativeSpeed, scene->getMedium().getSpeed(), path.sourceIndex ) );
+		}
+	}
+	
+	cachedPaths.clear();
+	cachedImagePositions.clear();
+	
+	//****************************************************************************************
+	// Remove the paths that no longer exist and are older than the threshold age.
+	
+	for ( Index b = bucketStartIndex; b < lastBucketIndex; b++ )
+	{
+		SoundPathCache::BucketType& bucket = specularCache.getBucket(b);
+		
+		for ( Index i = 0; i < bucket.getSize(); )
+		{
+			if ( timeStamp - bucket[i].timeStamp > maxPathAge )
+				bucket.removeAtIndexUnordered(i);
+			else
+				i++;
+		}
+	}
+}
+
+
+
+
+void SoundPropagator:: rejectCachedPointPaths( ArrayList<CachedSpecularPath>& cachedPaths,
+												const ArrayList<ImagePosition>& cachedImagePositions ) const
+{
+	const Size numSpecularSamples = request->numSpecularSamples;
+	const Size numCachedPaths = cachedPaths.getSize();
+	
+	for ( Index p = 0; p < numCachedPaths; p += 4 )
+	{
+		const Size numBatchPaths = math::min( numCachedPaths - p, Size(4) );
+		Vector3f normals[4];
+		Real offsets[4];
+		Vector3f imagePositions[4];
+		Vector3f sourcePositions[4];
+		
+		// Get the last reflector and listener image position for each path in the batch.
+		for ( Index k = 0; k < 4; k++ )
+		{
+			const CachedSpecularPath& path = cachedPaths[p + math::min( k, numBatchPaths - 1 )];
+			const ImagePosition& lastImage = cachedImagePositions[path.imageStartIndex + path.numImages - 1];
+			
+			normals[k] = lastImage.triangle.plane.normal;
+			offsets[k] = lastImage.triangle.plane.offset;
+			imagePositions[k] = lastImage.imagePosition;
+			sourcePositions[k] = path.entry->pathID.getSource()->getPosition();
+		}
+		
+		// The listener image position and source must be on opposite sides of the last reflector.
+		const SIMDVector3 planeNormals = packVectors( normals[0], normals[1], normals[2], normals[3] );
+		const SIMDReal4 planeOffsets( offsets[0], offsets[1], offsets[2], offsets[3] );
+		const SIMDReal4 imageDistances = math::dot( planeNormals,
+									packVectors( imagePositions[0], imagePositions[1], imagePositions[2], imagePositions[3] ) ) + planeOffsets;
+		const SIMDReal4 sourceDistances = math::dot( planeNormals,
+									packVectors( sourcePositions[0], sourcePositions[1], sourcePositions[2], sourcePositions[3] ) ) + planeOffsets;
+		const SIMDInt4 separated = (imageDistances*sourceDistances) < Real(0);
+		
+		for ( Index k = 0; k < numBatchPaths; k++ )
+		{
+			CachedSpecularPath& path = cachedPaths[p + k];
+			
+			// Only point-source paths are validated with this test, area sources are sampled.
+			const Bool pointSource = numSpecularSamples <= Size(1) ||
+									path.entry->pathID.getSource()->getRadius() < math::epsilon<Real>();
+			
+			if ( pointSource && !separated[k] )
+				path.valid = false;
+		}
+	}
 }
 
 
@@ -2091,12 +2399,14 @@ void SoundPropagator:: validateSpecularCacheRange( internal::SoundPathCache& spe
 
 
 Bool SoundPropagator:: validateSpecularPath( const Sphere3f& sourceSphere, const Vector3f& listenerPosition, Size numSamples,
+											const ImagePosition* imagePositions, Size numImagePositions,
 											Real& totalDistance, Vector3f& directionFromListener, Vector3f& directionToSource,
 											Real& visibility, ThreadData& threadData )
 {
 	if ( numSamples <= Size(1) || sourceSphere.radius < math::epsilon<Real>() )
 	{
 		if ( validatePointSpecularPath( sourceSphere, listenerPosition,
+										imagePositions, numImagePositions,
 										totalDistance, directionFromListener,
 										directionToSource, threadData ) )
 		{
@@ -2109,6 +2419,7 @@ Bool SoundPropagator:: validateSpecularPath( const Sphere3f& sourceSphere, const
 	else
 	{
 		return sampleSpecularPath( sourceSphere, listenerPosition, numSamples,
+									imagePositions, numImagePositions,
 									totalDistance, directionFromListener, directionToSource,
 									visibility, threadData );
 	}
@@ -2129,11 +2440,11 @@ Bool SoundPropagator:: validateSpecularPath( const Sphere3f& sourceSphere, const
 
 
 Bool SoundPropagator:: validatePointSpecularPath( const Sphere3f& sourceSphere, const Vector3f& listenerPosition,
+												const ImagePosition* imagePositions, Size numImagePositions,
 												Real& totalDistance, Vector3f& directionFromListener, Vector3f& directionToSource,
 												ThreadData& threadData )
 {
 	const Real rayOffset = request->rayOffset;
-	const ArrayList<ImagePosition>& imagePositions = threadData.imagePositions;
 	
 	totalDistance = Real(0);
 	
@@ -2142,7 +2453,7 @@ Bool SoundPropagator:: validatePointSpecularPath( const Sphere3f& sourceSphere,
 	
 	// Make sure that the vector from the listener image position to the source passes
 	// through the given triangle at each depth.
-	for ( Index i = imagePositions.getSize(); i > 0; i-- )
+	for ( Index i = numImagePositions; i > 0; i-- )
 	{
 		const WorldSpaceTriangle& triangle = imagePositions[i-1].triangle;
 		const Vector3f& listenerImagePosition = imagePositions[i-1].imagePosition;
@@ -2190,7 +2501,7 @@ Bool SoundPropagator:: validatePointSpecularPath( const Sphere3f& sourceSphere,
 		// Accumulate the total distance along the path so far.
 		totalDistance += sourceToTriangleDistance;
 		
-		if ( i == imagePositions.getSize() )
+		if ( i == numImagePositions )
 		{
 			// After the first reflection, set the virtual source's radius to zero because virtual sources have no radius.
 			virtualSourceRadius = 0;
@@ -2227,15 +2538,15 @@ Bool SoundPropagator:: validatePointSpecularPath( const Sphere3f& sourceSphere,
 
 
 Bool SoundPropagator:: sampleSpecularPath( const Sphere3f& sourceSphere, const Vector3f& listenerPosition, Size numSamples,
+											const ImagePosition* imagePositions, Size numImagePositions,
 											Real& totalDistance, Vector3f& directionFromListener, Vector3f& directionToSource,
 											Real& visibility, ThreadData& threadData )
 {
 	const Real rayOffset = request->rayOffset;
 	const Size numSpecularSamples = request->numSpecularSamples;
 	const Size minNumValidRays = 1;
-	const ArrayList<ImagePosition>& imagePositions = threadData.imagePositions;
 	
-	const Size numPoints = imagePositions.getSize();
+	const Size numPoints = numImagePositions;
 	
 	//*********************************************************************
 	// Generate the validation rays from the source in the direction of the listener image.
@@ -2247,8 +2558,8 @@ Bool SoundPropagator:: sampleSpecularPath( const Sphere3f& sourceSphere, const V
 	if ( validationRays.getSize() < numSpecularSamples )
 		validationRays.setSize( numSpecularSamples );
 	
-	const WorldSpaceTriangle& lastTriangle = imagePositions.getLast().triangle;
-	const Vector3f& lastListenerImagePosition = imagePositions.getLast().imagePosition;
+	const WorldSpaceTriangle& lastTriangle = imagePositions[numPoints - 1].triangle;
+	const Vector3f& lastListenerImagePosition = imagePositions[numPoints - 1].imagePosition;
 	Vector3f sourceDirection = sourceSphere.position - lastListenerImagePosition;
 	const Real sourceDistance = sourceDirection.getMagnitude();
 	
@@ -2262,47 +2573,61 @@ Bool SoundPropagator:: sampleSpecularPath( const Sphere3f& sourceSphere, const V
 	// Compute the rotation matrix for the direction samples.
 	Matrix3f sourceRotation = Matrix3f::planeBasis( sourceDirection );
 	Real averageDistance = 0;
+	const SIMDVector3 lastImageOrigin( lastListenerImagePosition );
 	
-	// Generate the specular sampling rays from the source.
-	for ( Index i = 0; i < numSpecularSamples; i++ )
+	// Generate the specular sampling rays from the source, 4 at a time.
+	for ( Index i = 0; i < numSpecularSamples; i += 4 )
 	{
-		// Generate a ray that samples the detectors's visibility.
-		Ray3f ray( lastListenerImagePosition,
-					(sourceRotation*getRandomDirectionInZCone( threadData.randomVariable, cosHalfAngle )).normalize() );
-		
-		// Make sure the ray intersects the last triangle reflector.
-		Real triangleDistance;
-		if ( !ray.intersectsTriangle( lastTriangle.v1, lastTriangle.v2, lastTriangle.v3, triangleDistance ) )
-			continue;
-		
-		// Find the intersection with the source.
-		Real sphereDistance;
-		if ( !ray.intersectsSphere( sourceSphere, sphereDistance ) )
-			continue;
+		const Size numBatchRays = math::min( numSpecularSamples - i, Size(4) );
+		Vector3f directions[4];
 		
-		// Reverse the ray from the source.
-		ray.origin += ray.direction*sphereDistance;
-		ray.direction = -ray.direction;
-		
-		// Trace a ray through the scene to make sure there is no occluder.
-		Real rayDistance = sphereDistance - triangleDistance;
-		if ( scene->intersectRay( ray, rayDistance - 2*rayOffset ) )
-			continue;
-		
-		// Compute the reflected ray.
-		// Only update the origin because we can compute the direction later with better accuracy.
-		ray.origin = ray.origin + ray.direction*rayDistance;
-		
-		if ( math::dot( ray.direction, lastTriangle.plane.normal ) > Real(0) )
-			ray.origin -= rayOffset*lastTriangle.plane.normal;
-		else
-			ray.origin += rayOffset*lastTriangle.plane.normal;
+		// Generate rays that sample the detectors's visibility.
+		for ( Index k = 0; k < 4; k++ )
+		{
+			if ( k < numBatchRays )
+				directions[k] = (sourceRotation*getRandomDirectionInZCone( threadData.randomVariable, cosHalfAngle )).normalize();
+			else
+				directions[k] = directions[0];
+		}
 		
-		averageDistance += rayDistance;
+		// Make sure the rays intersect the last triangle reflector and find their intersections with the source.
+		const SIMDVector3 batchDirections = packVectors( directions[0], directions[1], directions[2], directions[3] );
+		SIMDReal4 triangleDistances;
+		SIMDReal4 sphereDistances;
+		const SIMDInt4 hits = intersectRaysTriangle( lastImageOrigin, batchDirections, lastTriangle, triangleDistances ) &
+								intersectRaysSphere( lastImageOrigin, batchDirections, sourceSphere, sphereDistances );
 		
-		// Store the reflected ray in the list of validation rays.
-		validationRays[numValidRays] = ray;
-		numValidRays++;
+		for ( Index k = 0; k < numBatchRays; k++ )
+		{
+			if ( !hits[k] )
+				continue;
+			
+			const Real triangleDistance = triangleDistances[k];
+			const Real sphereDistance = sphereDistances[k];
+			
+			// Reverse the ray from the source.
+			Ray3f ray( lastListenerImagePosition + directions[k]*sphereDistance, -directions[k] );
+			
+			// Trace a ray through the scene to make sure there is no occluder.
+			Real rayDistance = sphereDistance - triangleDistance;
+			if ( scene->intersectRay( ray, rayDistance - 2*rayOffset ) )
+				continue;
+			
+			// Compute the reflected ray.
+			// Only update the origin because we can compute the direction later with better accuracy.
+			ray.origin = ray.origin + ray.direction*rayDistance;
+			
+			if ( math::dot( ray.direction, lastTriangle.plane.normal ) > Real(0) )
+				ray.origin -= rayOffset*lastTriangle.plane.normal;
+			else
+				ray.origin += rayOffset*lastTriangle.plane.normal;
+			
+			averageDistance += rayDistance;
+			
+			// Store the reflected ray in the list of validation rays.
+			validationRays[numValidRays] = ray;
+			numValidRays++;
+		}
 	}
 	
 	// Make sure there are enough valid rays after the first sampling.
@@ -2331,44 +2656,63 @@ Bool SoundPropagator:: sampleSpecularPath( const Sphere3f& sourceSphere, const V
 		sourceImagePosition = triangle.plane.getReflection( sourceImagePosition );
 		
 		Real averageDistance = 0;
+		Size numRemainingRays = 0;
 		
-		// For each validation ray, update its direction and check the visiblity of the next path segment.
-		for ( Index j = 0; j < numValidRays; )
+		// For each batch of 4 validation rays, update their directions and check the visiblity of the next path segment.
+		// The rays that are still valid are compacted at the front of the array.
+		for ( Index j = 0; j < numValidRays; j += 4 )
 		{
-			Ray3f& ray = validationRays[j];
-			ray.direction = (listenerImagePosition - ray.origin).normalize();
-			Real rayDistance;
-			
-			// Make sure the ray intersects the triangle at this depth.
-			// Make sure the path along the ray to the triangle is clear.
-			if ( !ray.intersectsTriangle( triangle.v1, triangle.v2, triangle.v3, rayDistance ) ||
-				scene->intersectRay( ray, rayDistance - 2*rayOffset ) )
+			const Size numBatchRays = math::min( numValidRays - j, Size(4) );
+			Ray3f rays[4];
+			
+			for ( Index k = 0; k < 4; k++ )
 			{
-				// Swap this ray with the last and reduce the number of valid rays.
-				numValidRays--;
-				
-				// If no rays are valid, this path is not valid.
-				if ( numValidRays < minNumValidRays )
-					return false;
-				
-				ray = validationRays[numValidRays];
-				continue;
+				if ( k < numBatchRays )
+				{
+					rays[k] = validationRays[j + k];
+					rays[k].direction = (listenerImagePosition - rays[k].origin).normalize();
+				}
+				else
+					rays[k] = rays[0];
 			}
 			
-			// Compute the next ray origin.
-			ray.origin += ray.direction*rayDistance;
-			
-			// Bias the intersection point to avoid precision errors
-			// and update the new starting location of the occlusion test ray.
-			if ( math::dot( ray.direction, triangle.plane.normal ) > Real(0) )
-				ray.origin -= rayOffset*triangle.plane.normal;
-			else
-				ray.origin += rayOffset*triangle.plane.normal;
+			// Make sure the rays intersect the triangle at this depth.
+			SIMDReal4 triangleDistances;
+			const SIMDInt4 hits = intersectRaysTriangle( packVectors( rays[0].origin, rays[1].origin, rays[2].origin, rays[3].origin ),
+														packVectors( rays[0].direction, rays[1].direction, rays[2].direction, rays[3].direction ),
+														triangle, triangleDistances );
 			
-			averageDistance += rayDistance;
-			j++;
+			for ( Index k = 0; k < numBatchRays; k++ )
+			{
+				Ray3f& ray = rays[k];
+				const Real rayDistance = triangleDistances[k];
+				
+				// Make sure the path along the ray to the triangle is clear.
+				if ( !hits[k] || scene->intersectRay( ray, rayDistance - 2*rayOffset ) )
+					continue;
+				
+				// Compute the next ray origin.
+				ray.origin += ray.direction*rayDistance;
+				
+				// Bias the intersection point to avoid precision errors
+				// and update the new starting location of the occlusion test ray.
+				if ( math::dot( ray.direction, triangle.plane.normal ) > Real(0) )
+					ray.origin -= rayOffset*triangle.plane.normal;
+				else
+					ray.origin += rayOffset*triangle.plane.normal;
+				
+				averageDistance += rayDistance;
+				validationRays[numRemainingRays] = ray;
+				numRemainingRays++;
+			}
 		}
 		
+		numValidRays = numRemainingRays;
+		
+		// If no rays are valid, this path is not valid.
+		if ( numValidRays < minNumValidRays )
+			return false;
+		
 		// Accumulate the total average distance along the path.
 		totalDistance += (averageDistance / Real(numValidRays));
 	}
@@ -2531,6 +2875,8 @@ void SoundPropagator:: updateDiffuseCache( internal::DiffusePathCache& diffuseCa
 
 void SoundPropagator:: updateDiffuseCaches( const ArrayList<DiffusePathData>& newPaths )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::updateDiffuseCaches" );
+	
 	const Size numNewPaths = newPaths.getSize();
 	const Index timeStamp = request->internalData.timeStamp;
 	
@@ -2562,6 +2908,8 @@ void SoundPropagator:: updateDiffuseCaches( const ArrayList<DiffusePathData>& ne
 
 void SoundPropagator:: outputDiffuseCache( internal::DiffusePathCache& diffuseCache, Size numDiffuseRaysCast, SoundSourceIR& sourceIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::outputDiffuseCache" );
+	
 	const Bool sampledIREnabled = request->flags.isSet( PropagationFlags::SAMPLED_IR );
 	const Bool dopplerSortingEnabled = request->flags.isSet( PropagationFlags::DOPPLER_SORTING );
 	const Index timeStamp = request->internalData.timeStamp;
@@ -2771,6 +3119,8 @@ void SoundPropagator:: updateIRCache( SoundSourceIR& sourceIR, const ArrayList<D
 
 void SoundPropagator:: updateIRCaches( const ArrayList<DiffusePathData>& newPaths )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::updateIRCaches" );
+	
 	// Get the propagation medium for the scene.
 	const SoundMedium& medium = scene->getMedium();
 	const Real speedOfSound = medium.getSpeed();
@@ -2805,6 +3155,8 @@ void SoundPropagator:: updateIRCaches( const ArrayList<DiffusePathData>& newPath
 
 void SoundPropagator:: outputIRCache( internal::IRCache& irCache, Size numDiffuseRaysCast, SoundSourceIR& sourceIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::outputIRCache" );
+	
 	// The threshold where a path is considered no longer contributing.
 	const Real threshold = Real(0.0001);
 	
@@ -2840,9 +3192,11 @@ void SoundPropagator:: outputIRCache( internal::IRCache& irCache, Size numDiffus
 
 void SoundPropagator:: doSourcesPropagation( const SoundDetector& listener, SoundListenerIR& listenerIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::doSourcesPropagation" );
+	
 	const Bool diffuseEnabled = request->flags.isSet( PropagationFlags::DIFFUSE );
 	const Size maxDiffuseDepth = request->maxDiffuseDepth;
-	const Size numDiffuseRays = request->numDiffuseRays;
+	const Size numDiffuseRays = getSliceRayCount( Float(request->numDiffuseRays) );
 	const Size numThreads = request->numThreads;
 	const Size numSources = sourceDataList.getSize();
 	
@@ -2891,6 +3245,8 @@ void SoundPropagator:: doSourcesPropagation( const SoundDetector& listener, Soun
 void SoundPropagator:: doSourcePropagation( const SoundDetector& listener, Index sourceIndex,
 											Size maxDiffuseDepth, Size numDiffuseRays )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::doSourcePropagation" );
+	
 	const Size numThreads = request->numThreads;
 	
 	SourceData& sourceData = sourceDataList[sourceIndex];
@@ -3018,6 +3374,14 @@ void SoundPropagator:: doSourcePropagation( const SoundDetector& listener, Index
 		
 		// Count the number of diffuse rays that were cast this frame.
 		sourceData.numDiffuseRaysCast += threadDataList[i].numDiffuseRaysCast;
+		
+#if GSOUND_ENABLE_HEAT_MAP
+		// Add the hits that were counted by the thread to the heat map.
+		if ( request->heatMap != NULL )
+			request->heatMap->addHits( threadData.heatMap );
+		
+		threadData.heatMap.clear();
+#endif
 	}
 }
 
@@ -3079,8 +3443,13 @@ Size SoundPropagator:: propagateSourceDiffuseRay( const SoundDetector& detector,
 		// Trace the ray through the scene.
 		if ( scene->intersectRay( ray, remainingDistance, instersectionDistance, closestTriangle ) )
 		{
+#if GSOUND_ENABLE_HEAT_MAP
+			if ( request->heatMap != NULL )
+				threadData.heatMap.addHit( closestTriangle.object, closestTriangle.object->getMesh()->getTriangleIndex( closestTriangle.triangle ) );
+#endif
+			
 			// Transform the closest triangle into world space.
-			const WorldSpaceTriangle worldSpaceTriangle( closestTriangle );
+			const WorldSpaceTriangle worldSpaceTriangle = getWorldSpaceTriangle( closestTriangle );
 			Vector3f normal = worldSpaceTriangle.plane.normal;
 			
 			// Calculate the intersection point of the ray with the triangle in world space.
@@ -3190,6 +3559,8 @@ Size SoundPropagator:: propagateSourceDiffuseRay( const SoundDetector& detector,
 
 void SoundPropagator:: updateSourcesVisibility()
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::updateSourcesVisibility" );
+	
 	Timer visibilityTimer;
 	
 	const Size numVisibilityRays = request->numVisibilityRays;
@@ -3286,8 +3657,45 @@ void SoundPropagator:: updateVisibility( const Vector3f& position, Real radius,
 
 
 
-void SoundPropagator:: addDirectPaths( const SoundListener& listener, SoundListenerIR& listenerIR, ThreadData& threadData )
+void SoundPropagator:: addDirectPaths( const SoundListener& listener, SoundListenerIR& listenerIR )
+{
+	GSOUND_PROFILE_ZONE( "SoundPropagator::addDirectPaths" );
+	
+	const Size numThreads = request->numThreads;
+	const Size numSources = sourceDataList.getSize();
+	
+	if ( numThreads > 1 && numSources > 1 )
+	{
+		// Compute the number of sources that should be handled by each thread.
+		const Size sourcesPerThread = (Size)math::ceiling( Real(numSources) / Real(numThreads) );
+		Index sourceStart = 0;
+		
+		for ( Index i = 0; i < numThreads && sourceStart < numSources; i++ )
+		{
+			const Size numThreadSources = math::min( numSources - sourceStart, sourcesPerThread );
+			
+			threadPool.addJob( FunctionCall< void ( const SoundListener&, SoundListenerIR&, Index, Size, ThreadData& )>(
+										bind( &SoundPropagator::addDirectPathsRange, this ),
+										listener, listenerIR, sourceStart, numThreadSources, threadDataList[i] ) );
+			
+			sourceStart += numThreadSources;
+		}
+		
+		// Wait for the jobs to finish.
+		threadPool.finishJobs();
+	}
+	else
+		addDirectPathsRange( listener, listenerIR, 0, numSources, threadDataList[0] );
+}
+
+
+
+
+void SoundPropagator:: addDirectPathsRange( const SoundListener& listener, SoundListenerIR& listenerIR,
+											Index sourceStartIndex, Size numSources, ThreadData& threadData )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::addDirectPathsRange" );
+	
 	const Bool directEnabled = request->flags.isSet( PropagationFlags::DIRECT );
 	const Bool sampledIREnabled = request->flags.isSet( PropagationFlags::SAMPLED_IR );
 	const Bool dopplerSortingEnabled = request->flags.isSet( PropagationFlags::DOPPLER_SORTING );
@@ -3295,12 +3703,12 @@ void SoundPropagator:: addDirectPaths( const SoundListener& listener, SoundListe
 	
 	const Vector3f& listenerPosition = listener.getPosition();
 	Ray3f validationRay( listenerPosition, Vector3f() );
-	const Size numSources = sourceDataList.getSize();
+	const Index sourceEndIndex = sourceStartIndex + numSources;
 	SoundPathID& pathID = threadData.specularPathID;
 	Vector3f averageDirection;
 	
 	// Shoot out direct rays from the listener to each source.
-	for ( Index s = 0; s < numSources; s++ )
+	for ( Index s = sourceStartIndex; s < sourceEndIndex; s++ )
 	{
 		const SoundDetector& source = *sourceDataList[s].detector;
 		const Vector3f& sourcePosition = source.getPosition();
@@ -3382,6 +3790,109 @@ void SoundPropagator:: addDirectPaths( const SoundListener& listener, SoundListe
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		IR Post-Processing Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundPropagator:: postProcessSourceIRs( const SoundListener& listener, SoundListenerIR& listenerIR )
+{
+	GSOUND_PROFILE_ZONE( "SoundPropagator::postProcessSourceIRs" );
+	
+	// Convert the threshold in dB SPL to threshold in sound power.
+	const FrequencyBandResponse thresholdPower = listener.getThresholdPower( request->frequencies );
+	const Size numSources = listenerIR.getSourceCount();
+	
+	// Don't use more threads than there is work for, since trimming each IR is relatively cheap.
+	const Size numThreads = math::min( request->numThreads, numSources / MIN_POST_PROCESS_SOURCES_PER_THREAD );
+	
+	if ( numThreads > 1 )
+	{
+		// Compute the number of sources that should be handled by each thread.
+		const Size sourcesPerThread = (Size)math::ceiling( Real(numSources) / Real(numThreads) );
+		Index sourceStart = 0;
+		
+		for ( Index i = 0; i < numThreads && sourceStart < numSources; i++ )
+		{
+			const Size numThreadSources = math::min( numSources - sourceStart, sourcesPerThread );
+			
+			threadPool.addJob( FunctionCall< void ( const FrequencyBandResponse&, SoundListenerIR&, Index, Size )>(
+										bind( &SoundPropagator::postProcessSourceIRRange, this ),
+										thresholdPower, listenerIR, sourceStart, numThreadSources ) );
+			
+			sourceStart += numThreadSources;
+		}
+		
+		// Wait for the jobs to finish.
+		threadPool.finishJobs();
+	}
+	else
+		postProcessSourceIRRange( thresholdPower, listenerIR, 0, numSources );
+}
+
+
+
+
+void SoundPropagator:: postProcessSourceIRRange( const FrequencyBandResponse& thresholdPower, SoundListenerIR& listenerIR,
+												Index sourceStartIndex, Size numSources )
+{
+	GSOUND_PROFILE_ZONE( "SoundPropagator::postProcessSourceIRRange" );
+	
+	const Bool irThresholdEnabled = request->flags.isSet( PropagationFlags::IR_THRESHOLD );
+	const Bool adaptiveIRLengthEnabled = irThresholdEnabled && request->flags.isSet( PropagationFlags::ADAPTIVE_IR_LENGTH );
+	const Index sourceEndIndex = sourceStartIndex + numSources;
+	
+	for ( Index s = sourceStartIndex; s < sourceEndIndex; s++ )
+	{
+		SourceData& sourceData = sourceDataList[s];
+		SoundSourceIR& sourceIR = listenerIR.getSourceIR(s);
+		Float sourceIRLength = 0;
+		
+		// Trim the length of the IR based on the listener's threshold of hearing.
+		if ( irThresholdEnabled )
+			sourceIRLength = sourceIR.trim( thresholdPower );
+		else
+			sourceIRLength = sourceIR.getLength();
+		
+		// Determine the max IR length for the source on the next frame based on the current IR length.
+		if ( adaptiveIRLengthEnabled )
+		{
+			const Float baseGrowth = request->irGrowthRate*request->dt;
+			Float previousMaxLength = sourceData.sourceData->maxIRLength;
+			Float growth;
+			
+			if ( sourceIRLength + baseGrowth < previousMaxLength )
+			{
+				// Shrink the IR if the trimmed IR was significantly shorter than the prevous max length.
+				growth = -math::min( baseGrowth, previousMaxLength - sourceIRLength );
+			}
+			else
+			{
+				// Grow the IR by at least the base growth.
+				growth = math::max( baseGrowth, sourceIRLength - previousMaxLength );
+			}
+			
+			Float maxIRLength = math::clamp( previousMaxLength + growth, request->minIRLength, request->maxIRLength );
+			
+			// Save the max IR length for later.
+			sourceData.sourceData->maxIRLength = maxIRLength;
+		}
+		
+		// Save the source IR length in the data for the source.
+		sourceData.sourceData->irLength = sourceIRLength;
+		sourceData.irCache->setLengthInSamples( sourceIR.getLengthInSamples() );
+	}
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -3880,6 +4391,8 @@ Bool SoundPropagator:: validateDiffractionPath( const SoundPathID& pathID, Index
 
 void SoundPropagator:: prepareSceneData( const SoundScene& newScene, SoundSceneIR& sceneIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::prepareSceneData" );
+	
 	// Store a temporary pointer to the scene.
 	scene = &newScene;
 	
@@ -3906,7 +4419,8 @@ void SoundPropagator:: prepareSceneData( const SoundScene& newScene, SoundSceneI
 	
 	for ( Index i = 0; i < numObjects; i++ )
 	{
-		const SoundMesh& mesh = *scene->getObject(i)->getMesh();
+		const SoundObject& object = *scene->getObject(i);
+		const SoundMesh& mesh = *object.getMesh();
 		const Size numMaterials = mesh.getMaterialCount();
 		numTriangles += mesh.getTriangleCount();
 		numVertices += mesh.getVertexCount();
@@ -3918,6 +4432,9 @@ void SoundPropagator:: prepareSceneData( const SoundScene& newScene, SoundSceneI
 		
 		for ( Index j = 0; j < numMaterials; j++ )
 			mesh.getMaterial(j).setFrequencyBands( request->frequencies );
+		
+		// Cache the world-space triangles for static objects.
+		prepareObjectData( object );
 	}
 	
 	// Report the final object and mesh attribute count if statistics are enabled,
@@ -3970,8 +4487,9 @@ void SoundPropagator:: prepareSceneData( const SoundScene& newScene, SoundSceneI
 		
 		SoundListenerIR& listenerIR = sceneIR.getListenerIR(outputIndex);
 		
-		// Make sure the IR has the right listener pointer and frequency bands.
+		// Make sure the IR has the right listener pointer, listener state, and frequency bands.
 		listenerIR.setListener( listener );
+		listenerIR.setListenerState( *listener );
 		listenerIR.setFrequencies( request->frequencies );
 		
 		// Get the listener data for this listener.
@@ -4009,6 +4527,50 @@ void SoundPropagator:: prepareSceneData( const SoundScene& newScene, SoundSceneI
 
 
 
+void SoundPropagator:: prepareObjectData( const SoundObject& object )
+{
+	PropagationData& propagationData = request->internalData;
+	const Hash objectHash = PropagationData::getObjectHash( &object );
+	Shared<PropagationData::ObjectData>* objectDataPointer;
+	Bool isNew = false;
+	
+	if ( !propagationData.objects.find( objectHash, &object, objectDataPointer ) )
+	{
+		objectDataPointer = propagationData.objects.add( objectHash, &object, Shared<PropagationData::ObjectData>::construct() );
+		isNew = true;
+	}
+	
+	PropagationData::ObjectData& objectData = **objectDataPointer;
+	objectData.timeStamp = propagationData.timeStamp;
+	
+	const SoundMesh* mesh = object.getMesh();
+	const Transform3f& transform = object.getTransform();
+	const Bool changed = mesh != objectData.mesh ||
+						transform.position != objectData.transform.position ||
+						transform.orientation != objectData.transform.orientation ||
+						transform.scale != objectData.transform.scale;
+	
+	objectData.mesh = mesh;
+	objectData.transform = transform;
+	
+	if ( changed && !isNew )
+	{
+		// The object is moving, don't cache its triangles until it stops.
+		objectData.triangles.clear();
+	}
+	else if ( objectData.triangles.getSize() == 0 && mesh != NULL )
+	{
+		// Transform all of the object's triangles into world space.
+		const Size numTriangles = mesh->getTriangleCount();
+		
+		for ( Index t = 0; t < numTriangles; t++ )
+			objectData.triangles.add( WorldSpaceTriangle( mesh->getInternalTriangle(t), &object ) );
+	}
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -4022,6 +4584,8 @@ void SoundPropagator:: prepareSceneData( const SoundScene& newScene, SoundSceneI
 
 void SoundPropagator:: prepareListenerSourceData( const SoundListener& listener, SoundListenerIR& listenerIR )
 {
+	GSOUND_PROFILE_ZONE( "SoundPropagator::prepareListenerSourceData" );
+	
 	// Get a pointer to the internal sound propagation data.
 	PropagationData& propagationData = request->internalData;
 	
@@ -4042,7 +4606,8 @@ void SoundPropagator:: prepareListenerSourceData( const SoundListener& listener,
 		
 		Timer time;
 		
-		scene->updateSourceClusters( listener, request->innerClusteringAngle, request->outerClusteringAngle );
+		scene->updateSourceClusters( listener, request->innerClusteringAngle, request->outerClusteringAngle,
+									request->numThreads > 1 ? &threadPool : NULL );
 		
 		Time clusteringTime = time.getElapsedTime();
 		
@@ -4382,6 +4947,50 @@ Vector3f SoundPropagator:: computeCellCenter( const internal::ObjectSpaceTriangl
 
 
 
+WorldSpaceTriangle SoundPropagator:: getWorldSpaceTriangle( const ObjectSpaceTriangle& triangle ) const
+{
+	const Shared<PropagationData::ObjectData>* objectData;
+	
+	if ( request->internalData.objects.find( PropagationData::getObjectHash( triangle.object ), triangle.object, objectData ) )
+	{
+		const WorldSpaceTriangle* cachedTriangle = (*objectData)->getTriangle( triangle.triangle );
+		
+		if ( cachedTriangle != NULL )
+			return *cachedTriangle;
+	}
+	
+	return WorldSpaceTriangle( triangle );
+}
+
+
+
+
+Plane3f SoundPropagator:: getWorldSpacePlane( const ObjectSpaceTriangle& triangle ) const
+{
+	const Shared<PropagationData::ObjectData>* objectData;
+	
+	if ( request->internalData.objects.find( PropagationData::getObjectHash( triangle.object ), triangle.object, objectData ) )
+	{
+		const WorldSpaceTriangle* cachedTriangle = (*objectData)->getTriangle( triangle.triangle );
+		
+		if ( cachedTriangle != NULL )
+			return cachedTriangle->plane;
+	}
+	
+	return triangle.object->getTransform().transformToWorld( triangle.triangle->getPlane() );
+}
+
+
+
+
+Hash SoundPropagator:: getSourceHash( const SoundDetector* source )
+{
+	return Hash(PointerInt(source) >> 4);
+}
+
+
+
+
 void SoundPropagator:: computePointOfClosestApproach( const Vector3f& p1, const Vector3f& v1,
 														const Vector3f& p2, const Vector3f& v2,
 														Real& v1t )
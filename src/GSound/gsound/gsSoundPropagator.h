@@ -166,6 +166,10 @@ class SoundPropagator
 			class DiffusePathData;
 			
 			
+			/// A class that stores a cached specular path that has been gathered for revalidation.
+			class CachedSpecularPath;
+			
+			
 			/// A class that stores propagation data for an enabled listener in the current scene.
 			class ListenerData;
 			
@@ -190,15 +194,35 @@ class SoundPropagator
 										Float maxIRLength, ThreadData& threadData );
 			
 			
+			template < Bool specularEnabled, Bool diffractionEnabled, Bool visibilityCacheEnabled, Bool specularCacheEnabled >
 			Size propagateListenerSpecularRay( const SoundDetector& listener, const internal::SoundPathCache& soundPathCache,
 												Ray3f ray, Size numBounces, Float maxIRLength, ThreadData& threadData );
 			
 			
+			template < Bool visibilityCacheEnabled >
 			Size propagateListenerDiffuseRay( const SoundDetector& listener,
 												Ray3f ray, Size numBounces, Float maxIRLength,
 												const Vector3f& listenerDirection, ThreadData& threadData );
 			
 			
+			/// A pointer to a specialization of the listener specular ray propagation method.
+			typedef Size (SoundPropagator::*SpecularRayFunction)( const SoundDetector&, const internal::SoundPathCache&,
+																Ray3f, Size, Float, ThreadData& );
+			
+			
+			/// A pointer to a specialization of the listener diffuse ray propagation method.
+			typedef Size (SoundPropagator::*DiffuseRayFunction)( const SoundDetector&, Ray3f, Size, Float,
+																const Vector3f&, ThreadData& );
+			
+			
+			/// Return the specialization of the listener specular ray method for the current request flags.
+			SpecularRayFunction getSpecularRayFunction() const;
+			
+			
+			/// Return the specialization of the listener diffuse ray method for the current request flags.
+			DiffuseRayFunction getDiffuseRayFunction() const;
+			
+			
 		//********************************************************************************
 		//******	Source Sound Propagation Methods
 			
@@ -281,17 +305,25 @@ class SoundPropagator
 											ThreadData& threadData );
 			
 			
+			/// Check the gathered cached point-source paths against the separating planes of their last reflectors, 4 at a time.
+			GSOUND_FORCE_INLINE void rejectCachedPointPaths( ArrayList<CachedSpecularPath>& cachedPaths,
+															const ArrayList<ImagePosition>& cachedImagePositions ) const;
+			
+			
 			GSOUND_NO_INLINE Bool validateSpecularPath( const Sphere3f& sourceSphere, const Vector3f& listenerPosition, Size numSamples,
+														const ImagePosition* imagePositions, Size numImagePositions,
 														Real& totalDistance, Vector3f& directionFromListener, Vector3f& directionToSource,
 														Real& visibility, ThreadData& threadData );
 			
 			
 			GSOUND_FORCE_INLINE Bool validatePointSpecularPath( const Sphere3f& sourceSphere, const Vector3f& listenerPosition,
+																const ImagePosition* imagePositions, Size numImagePositions,
 																Real& totalDistance, Vector3f& directionFromListener, Vector3f& directionToSource,
 																ThreadData& threadData );
 			
 			
 			GSOUND_FORCE_INLINE Bool sampleSpecularPath( const Sphere3f& sourceSphere, const Vector3f& listenerPosition, Size numSamples,
+														const ImagePosition* imagePositions, Size numImagePositions,
 														Real& totalDistance, Vector3f& directionFromListener, Vector3f& directionToSource,
 														Real& visibility, ThreadData& threadData );
 			
@@ -306,8 +338,26 @@ class SoundPropagator
 		//******	Direct Sound Propagation Method
 			
 			
-			/// Add all direct/transmitted propagation paths to the propagation path buffer.
-			void addDirectPaths( const SoundListener& listener, SoundListenerIR& pathBuffer, ThreadData& threadData );
+			/// Add all direct/transmitted propagation paths to the propagation path buffer, in parallel if possible.
+			void addDirectPaths( const SoundListener& listener, SoundListenerIR& listenerIR );
+			
+			
+			/// Add the direct/transmitted propagation paths for the specified range of sources.
+			void addDirectPathsRange( const SoundListener& listener, SoundListenerIR& listenerIR,
+									Index sourceStartIndex, Size numSources, ThreadData& threadData );
+			
+			
+		//********************************************************************************
+		//******	IR Post-Processing Methods
+			
+			
+			/// Trim the IR for each source and update the adaptive IR lengths, in parallel if possible.
+			void postProcessSourceIRs( const SoundListener& listener, SoundListenerIR& listenerIR );
+			
+			
+			/// Trim the IRs and update the adaptive IR lengths for the specified range of sources.
+			void postProcessSourceIRRange( const FrequencyBandResponse& thresholdPower, SoundListenerIR& listenerIR,
+											Index sourceStartIndex, Size numSources );
 			
 			
 		//********************************************************************************
@@ -340,6 +390,15 @@ class SoundPropagator
 			void prepareSceneData( const SoundScene& newScene, SoundSceneIR& sceneIR );
 			
 			
+			/// Update the cached world-space triangles for the specified object.
+			/**
+			  * The triangles are cached when an object is first seen and whenever its
+			  * transform and mesh have not changed since the previous frame. Moving
+			  * objects are not cached and are transformed on demand instead.
+			  */
+			void prepareObjectData( const SoundObject& object );
+			
+			
 			/// Prepare the internal source data and listener IR for sound propagation for the specified listener.
 			void prepareListenerSourceData( const SoundListener& listener, SoundListenerIR& listenerIR );
 			
@@ -358,6 +417,19 @@ class SoundPropagator
 												const SoundDetector& source, const Vector3f& directionToSource );
 			
 			
+			/// Return the number of rays to trace on this frame for the given per-time-step ray budget.
+			/**
+			  * The budget is divided by the request's ray slice count, but a budget of
+			  * at least one ray always traces at least one ray per frame.
+			  */
+			GSOUND_INLINE Size getSliceRayCount( Float numRays ) const
+			{
+				const Size numSliceRays = (Size)(numRays / Float(request->raySliceCount));
+				
+				return numRays >= Float(1) ? math::max( numSliceRays, Size(1) ) : numSliceRays;
+			}
+			
+			
 		//********************************************************************************
 		//******	Private Geometry Helper Methods
 			
@@ -372,6 +444,18 @@ class SoundPropagator
 																internal::SoundPathPoint::IDType cellID );
 			
 			
+			/// Return the specified triangle in world space, using the cached triangles of static objects if possible.
+			GSOUND_FORCE_INLINE internal::WorldSpaceTriangle getWorldSpaceTriangle( const internal::ObjectSpaceTriangle& triangle ) const;
+			
+			
+			/// Return the plane of the specified triangle in world space, using the cached triangles of static objects if possible.
+			GSOUND_FORCE_INLINE Plane3f getWorldSpacePlane( const internal::ObjectSpaceTriangle& triangle ) const;
+			
+			
+			/// Return a hash code for the specified source detector pointer.
+			GSOUND_FORCE_INLINE static Hash getSourceHash( const SoundDetector* source );
+			
+			
 			/// Find the points of closest approach on two lines, only computing the point on the first line.
 			GSOUND_FORCE_INLINE static void computePointOfClosestApproach( const Vector3f& p1, const Vector3f& v1,
 																			const Vector3f& p2, const Vector3f& v2,
@@ -455,6 +539,10 @@ class SoundPropagator
 			static const Size PATH_BUFFER_SIZE = 128;
 			
 			
+			/// The minimum number of sources that are post-processed by each thread when post-processing in parallel.
+			static const Size MIN_POST_PROCESS_SOURCES_PER_THREAD = 32;
+			
+			
 		//********************************************************************************
 		//******	Private Data Members
 			
@@ -463,6 +551,10 @@ class SoundPropagator
 			ArrayList<SourceData> sourceDataList;
 			
 			
+			/// A map from the source detectors to their indices in the source data list, used when validating cached paths.
+			HashMap<const SoundDetector*,Index> sourceIndexMap;
+			
+			
 			/// A list of the current sound listeners in the scene.
 			ArrayList<ListenerData> listenerDataList;
 			
@@ -152,10 +152,12 @@ Bool SoundScene:: addSource( SoundSource* newSource )
 
 Bool SoundScene:: removeSource( SoundSource* source )
 {
-	if ( source == NULL )
+	if ( source == NULL || !sources.remove( source ) )
 		return false;
 	
-	return sources.remove( source );
+	sourceClusterer.removeSource( source );
+	
+	return true;
 }
 
 
@@ -164,6 +166,7 @@ Bool SoundScene:: removeSource( SoundSource* source )
 void SoundScene:: clearSources()
 {
 	sources.clear();
+	sourceClusterer.clearSources();
 }
 
 
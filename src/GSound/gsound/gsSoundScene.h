@@ -70,6 +70,11 @@ GSOUND_NAMESPACE_START
 //##########################################################################################
 
 
+namespace internal
+{
+	class SceneSnapshot;
+};
+
 
 
 //********************************************************************************
@@ -246,9 +251,13 @@ class SoundScene
 			
 			
 			/// Update the sound source clusters in this scene for the specified listener and clustering parameters.
-			GSOUND_INLINE void updateSourceClusters( const SoundListener& listener, Real innerClusteringAngle, Real outerClusteringAngle ) const
+			/**
+			  * If a thread pool is given, it may be used to cluster the sources in parallel.
+			  */
+			GSOUND_INLINE void updateSourceClusters( const SoundListener& listener, Real innerClusteringAngle, Real outerClusteringAngle,
+													ThreadPool* threadPool = NULL ) const
 			{
-				sourceClusterer.updateClusters( listener, *this, innerClusteringAngle, outerClusteringAngle );
+				sourceClusterer.updateClusters( listener, *this, innerClusteringAngle, outerClusteringAngle, threadPool );
 			}
 			
 			
@@ -457,6 +466,10 @@ class SoundScene
 			friend class SoundPropagator;
 			
 			
+			/// Make the scene snapshot class a friend so that it can mirror the scene's contents.
+			friend class internal::SceneSnapshot;
+			
+			
 			/// The number of objects at which the scene will use a BVH for ray tracing among objects.
 			static const Size OBJECT_COUNT_THRESHOLD = 8;
 			
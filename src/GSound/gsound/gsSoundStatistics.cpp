@@ -72,6 +72,10 @@ SoundStatistics:: SoundStatistics()
 		diffuseRayDepth( 0 ),
 		specularRayCount( 0 ),
 		rayCastCount( 0 ),
+		bvhTraversalCount( 0 ),
+		averageBVHNodeCount( 0 ),
+		averageBVHTriangleCount( 0 ),
+		maxBVHNodeCount( 0 ),
 		renderedPathCount( 0 ),
 		maxIRLength( 0 ),
 		
@@ -95,7 +99,8 @@ SoundStatistics:: SoundStatistics()
 		propagationMemory( 0 ),
 		irMemory( 0 ),
 		renderingMemory( 0 ),
-		totalMemory( 0 )
+		totalMemory( 0 ),
+		memoryWarningCount( 0 )
 {
 }
 
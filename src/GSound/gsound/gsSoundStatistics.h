@@ -145,6 +145,27 @@ class SoundStatistics
 			Size rayCastCount;
 			
 			
+			/// The total number of BVH traversals that were performed while tracing rays on the last frame.
+			/**
+			  * This value and the other BVH traversal statistics are only computed if
+			  * OM_BVH_TRAVERSAL_STATISTICS is enabled. A ray that is traced through
+			  * the scene BVH and then through an object's BVH counts as two traversals.
+			  */
+			Size bvhTraversalCount;
+			
+			
+			/// The average number of BVH nodes that were visited per traversal on the last frame.
+			Float averageBVHNodeCount;
+			
+			
+			/// The average number of triangles that were tested per traversal on the last frame.
+			Float averageBVHTriangleCount;
+			
+			
+			/// The largest number of BVH nodes that were visited by a single traversal on the last frame.
+			Size maxBVHNodeCount;
+			
+			
 			/// The total number of discrete sound paths that are currently being rendered.
 			Size renderedPathCount;
 			
@@ -255,6 +276,14 @@ class SoundStatistics
 			Size totalMemory;
 			
 			
+			/// The number of memory budgets that were exceeded on the last frame.
+			/**
+			  * Memory budgets are set with SoundPropagationSystem::setMemoryBudget(),
+			  * and the exceeded budgets are described by the system's memory usage.
+			  */
+			Size memoryWarningCount;
+			
+			
 			
 };
 
@@ -0,0 +1,675 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundTracePlayer.cpp
+ * Contents:    gsound::SoundTracePlayer class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "gsSoundTracePlayer.h"
+
+
+#include "internal/gsSoundTraceFormat.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+using internal::SoundTraceFormat;
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Listener Renderer Class Definition
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+class SoundTracePlayer:: ListenerRenderer
+{
+	public:
+		
+		/// Create a new listener renderer that renders with the specified request.
+		GSOUND_INLINE ListenerRenderer( const RenderRequest& newRequest )
+			:	request( newRequest ),
+				renderer( newRequest )
+		{
+		}
+		
+		
+		/// The request that was last recorded for the listener.
+		RenderRequest request;
+		
+		
+		/// The renderer for the listener.
+		SoundListenerRenderer renderer;
+		
+		
+};
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Constructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundTracePlayer:: SoundTracePlayer()
+	:	reader( NULL ),
+		lastIRIndex( 0 ),
+		frameIndex( 0 ),
+		numThreads( 0 ),
+		renderingEnabled( true )
+{
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Destructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundTracePlayer:: ~SoundTracePlayer()
+{
+	close();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Trace File Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundTracePlayer:: open( const UTF8String& filePath )
+{
+	close();
+	
+	reader = util::construct<om::FileReader>( filePath );
+	
+	if ( !reader->open() || !SoundTraceFormat::readHeader( *reader ) )
+	{
+		close();
+		return false;
+	}
+	
+	propagationTimes.clear();
+	irUpdateTimes.clear();
+	renderTimes.clear();
+	
+	return true;
+}
+
+
+
+
+void SoundTracePlayer:: close()
+{
+	if ( reader )
+	{
+		reader->close();
+		util::destruct( reader );
+		reader = NULL;
+	}
+	
+	clearScene();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Replay Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundTracePlayer:: step()
+{
+	if ( reader == NULL )
+		return false;
+	
+	UInt32 type = 0;
+	Size payloadSize = 0;
+	
+	if ( !SoundTraceFormat::readRecordHeader( *reader, type, payloadSize ) )
+		return false;
+	
+	// Read the whole record so that it can be decoded from memory.
+	if ( payload.getSize() < payloadSize )
+		payload.setSize( payloadSize );
+	
+	om::DataInputStream& stream = *reader;
+	
+	if ( stream.readData( payload.getPointer(), payloadSize ) < payloadSize )
+		return false;
+	
+	decoder.setData( payload.getPointer(), payloadSize );
+	
+	switch ( type )
+	{
+		case SoundTraceFormat::MESH:			return replayMesh();
+		case SoundTraceFormat::DIRECTIVITY:		return replayDirectivity();
+		case SoundTraceFormat::PROPAGATION:		return replayPropagation();
+		case SoundTraceFormat::RENDER:			return replayRender();
+	}
+	
+	// Skip records of unknown types.
+	return true;
+}
+
+
+
+
+Bool SoundTracePlayer:: play()
+{
+	if ( reader == NULL )
+		return false;
+	
+	while ( reader->getBytesRemaining() > 0 )
+	{
+		if ( !step() )
+			return false;
+	}
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Private Replay Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundTracePlayer:: replayMesh()
+{
+	UInt32 id = 0;
+	
+	if ( !decoder.read( id ) || id == SoundTraceFormat::INVALID_ID )
+		return false;
+	
+	SoundMesh* mesh = util::construct<SoundMesh>();
+	
+	if ( !SoundMesh::load( decoder, *mesh ) )
+	{
+		util::destruct( mesh );
+		return false;
+	}
+	
+	while ( meshes.getSize() <= id )
+		meshes.add( NULL );
+	
+	if ( meshes[id] )
+		util::destruct( meshes[id] );
+	
+	meshes[id] = mesh;
+	
+	return true;
+}
+
+
+
+
+Bool SoundTracePlayer:: replayDirectivity()
+{
+	UInt32 id = 0;
+	
+	if ( !decoder.read( id ) || id == SoundTraceFormat::INVALID_ID )
+		return false;
+	
+	SoundDirectivity* directivity = util::construct<SoundDirectivity>();
+	
+	if ( !SoundTraceFormat::readDirectivity( decoder, *directivity ) )
+	{
+		util::destruct( directivity );
+		return false;
+	}
+	
+	while ( directivities.getSize() <= id )
+		directivities.add( NULL );
+	
+	if ( directivities[id] )
+		util::destruct( directivities[id] );
+	
+	directivities[id] = directivity;
+	
+	return true;
+}
+
+
+
+
+Bool SoundTracePlayer:: replayPropagation()
+{
+	//********************************************************************************
+	// Read the request and update the scene to match the recorded frame.
+	
+	UInt8 updateRenderers = 0;
+	Bool result = true;
+	
+	frameIndex++;
+	
+	result &= decoder.read( updateRenderers );
+	result &= SoundTraceFormat::readRequest( decoder, request );
+	result &= SoundTraceFormat::readSceneState( decoder, scene );
+	result &= readEntities( objects, &SoundScene::addObject, &SoundScene::removeObject );
+	result &= readEntities( sources, &SoundScene::addSource, &SoundScene::removeSource );
+	result &= readEntities( listeners, &SoundScene::addListener, &SoundScene::removeListener );
+	
+	if ( !result )
+		return false;
+	
+	if ( numThreads > 0 )
+		request.numThreads = numThreads;
+	
+	//********************************************************************************
+	// Propagate sound into the IR that the renderers are not using.
+	
+	const Index irIndex = (lastIRIndex + 1) % 2;
+	SoundSceneIR& sceneIR = sceneIRs[irIndex];
+	
+	Timer propagationTimer;
+	
+	propagator.propagateSound( scene, request, sceneIR );
+	
+	propagationTimes.add( propagationTimer.getElapsedTime() );
+	lastIRIndex = irIndex;
+	
+	//********************************************************************************
+	// Update the renderers with the new IR.
+	
+	if ( updateRenderers && renderingEnabled && listenerRenderers.getSize() > 0 )
+	{
+		Timer updateTimer;
+		
+		const Size numRenderers = listenerRenderers.getSize();
+		
+		for ( Index i = 0; i < numRenderers; i++ )
+		{
+			ListenerRenderer* listenerRenderer = listenerRenderers[i];
+			
+			if ( listenerRenderer == NULL )
+				continue;
+			
+			const SoundListenerIR* listenerIR = sceneIR.findListenerIR( listeners[i].object );
+			
+			if ( listenerIR )
+				listenerRenderer->renderer.updateIR( *listenerIR, listenerRenderer->request );
+			else
+				listenerRenderer->renderer.clearIR();
+		}
+		
+		irUpdateTimes.add( updateTimer.getElapsedTime() );
+	}
+	
+	return true;
+}
+
+
+
+
+Bool SoundTracePlayer:: replayRender()
+{
+	UInt32 listenerID = 0;
+	UInt8 hasRequest = 0;
+	RenderRequest renderRequest;
+	UInt64 numSamples = 0;
+	Float64 sampleRate = 0;
+	Bool result = true;
+	
+	result &= decoder.read( listenerID );
+	result &= decoder.read( hasRequest );
+	
+	if ( hasRequest )
+		result &= SoundTraceFormat::readRenderRequest( decoder, renderRequest );
+	
+	result &= decoder.read( numSamples );
+	result &= decoder.read( sampleRate );
+	
+	if ( !result || listenerID == SoundTraceFormat::INVALID_ID || sampleRate <= 0 )
+		return false;
+	
+	if ( !renderingEnabled )
+		return true;
+	
+	//********************************************************************************
+	// Get the renderer for the listener, creating it on the listener's first render call.
+	
+	// Make sure the listener exists so that its renderer has a matching entry.
+	getEntity( listeners, listenerID );
+	
+	while ( listenerRenderers.getSize() <= listenerID )
+		listenerRenderers.add( NULL );
+	
+	ListenerRenderer*& listenerRenderer = listenerRenderers[listenerID];
+	
+	if ( hasRequest )
+	{
+		if ( listenerRenderer == NULL )
+			listenerRenderer = util::construct<ListenerRenderer>( renderRequest );
+		else
+			listenerRenderer->request = renderRequest;
+	}
+	
+	// The first render call for a listener always includes its request.
+	if ( listenerRenderer == NULL )
+		return false;
+	
+	//********************************************************************************
+	// Buffer the input audio for the sources and render the listener.
+	
+	const Time frameTime = Time( Double(numSamples) / sampleRate );
+	
+	Timer renderTimer;
+	
+	sourceSoundBuffer.clearSources();
+	
+	const Size numSources = scene.getSourceCount();
+	
+	for ( Index s = 0; s < numSources; s++ )
+	{
+		SoundSource* source = scene.getSource(s);
+		SoundBuffer* sourceBuffer = sourceSoundBuffer.addSource( source );
+		
+		if ( sourceBuffer )
+			source->readSamples( *sourceBuffer, frameTime );
+	}
+	
+	outputBuffer.setLayout( listenerRenderer->renderer.getChannelLayout() );
+	outputBuffer.setSampleRate( sampleRate );
+	outputBuffer.setSize( (Size)numSamples );
+	
+	listenerRenderer->renderer.render( sourceSoundBuffer, outputBuffer, frameTime );
+	
+	renderTimes.add( renderTimer.getElapsedTime() );
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Private Scene Update Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+template < typename EntityType >
+Bool SoundTracePlayer:: readEntities( ArrayList<Entity<EntityType> >& entities,
+									Bool (SoundScene::*addEntity)( EntityType* ),
+									Bool (SoundScene::*removeEntity)( EntityType* ) )
+{
+	Size numEntities = 0;
+	
+	{
+		UInt64 numEntities64 = 0;
+		
+		if ( !decoder.read( numEntities64 ) )
+			return false;
+		
+		numEntities = (Size)numEntities64;
+	}
+	
+	// Read the IDs of the entities in this frame and update the state of those that changed.
+	ShortArrayList<UInt32,64> frameIDs;
+	
+	for ( Index i = 0; i < numEntities; i++ )
+	{
+		UInt32 id = 0;
+		UInt8 hasState = 0;
+		
+		if ( !decoder.read( id ) || !decoder.read( hasState ) || id == SoundTraceFormat::INVALID_ID )
+			return false;
+		
+		Entity<EntityType>& entity = getEntity( entities, id );
+		
+		if ( hasState && !readEntityState( *entity.object ) )
+			return false;
+		
+		entity.frameIndex = frameIndex;
+		frameIDs.add( id );
+	}
+	
+	// Remove the entities that are no longer in the scene, then add the new ones in the recorded order.
+	const Size numTotalEntities = entities.getSize();
+	
+	for ( Index i = 0; i < numTotalEntities; i++ )
+	{
+		Entity<EntityType>& entity = entities[i];
+		
+		if ( entity.inScene && entity.frameIndex != frameIndex )
+		{
+			(scene.*removeEntity)( entity.object );
+			entity.inScene = false;
+		}
+	}
+	
+	for ( Index i = 0; i < numEntities; i++ )
+	{
+		Entity<EntityType>& entity = entities[frameIDs[i]];
+		
+		if ( !entity.inScene )
+		{
+			(scene.*addEntity)( entity.object );
+			entity.inScene = true;
+		}
+	}
+	
+	return true;
+}
+
+
+
+
+template < typename EntityType >
+SoundTracePlayer::Entity<EntityType>& SoundTracePlayer:: getEntity( ArrayList<Entity<EntityType> >& entities, UInt32 id )
+{
+	while ( entities.getSize() <= id )
+		entities.add( Entity<EntityType>() );
+	
+	Entity<EntityType>& entity = entities[id];
+	
+	if ( entity.object == NULL )
+		entity.object = util::construct<EntityType>();
+	
+	return entity;
+}
+
+
+
+
+Bool SoundTracePlayer:: readEntityState( SoundObject& object )
+{
+	UInt32 meshID = SoundTraceFormat::INVALID_ID;
+	
+	if ( !SoundTraceFormat::readObject( decoder, object, meshID ) )
+		return false;
+	
+	if ( meshID == SoundTraceFormat::INVALID_ID )
+		object.setMesh( NULL );
+	else if ( meshID < meshes.getSize() && meshes[meshID] )
+		object.setMesh( meshes[meshID] );
+	else
+		return false;
+	
+	return true;
+}
+
+
+
+
+Bool SoundTracePlayer:: readEntityState( SoundSource& source )
+{
+	UInt32 directivityID = SoundTraceFormat::INVALID_ID;
+	
+	if ( !SoundTraceFormat::readSource( decoder, source, directivityID ) )
+		return false;
+	
+	if ( directivityID == SoundTraceFormat::INVALID_ID )
+		source.setDirectivity( NULL );
+	else if ( directivityID < directivities.getSize() && directivities[directivityID] )
+		source.setDirectivity( directivities[directivityID] );
+	else
+		return false;
+	
+	return true;
+}
+
+
+
+
+Bool SoundTracePlayer:: readEntityState( SoundListener& listener )
+{
+	return SoundTraceFormat::readListener( decoder, listener );
+}
+
+
+
+
+void SoundTracePlayer:: clearScene()
+{
+	scene.clearObjects();
+	scene.clearSources();
+	scene.clearListeners();
+	
+	// The renderers and IRs refer to the listeners and sources, so destroy them first.
+	for ( Index i = 0; i < listenerRenderers.getSize(); i++ )
+	{
+		if ( listenerRenderers[i] )
+			util::destruct( listenerRenderers[i] );
+	}
+	
+	listenerRenderers.clear();
+	sourceSoundBuffer.clearSources();
+	sceneIRs[0].clear();
+	sceneIRs[1].clear();
+	
+	for ( Index i = 0; i < objects.getSize(); i++ )
+		util::destruct( objects[i].object );
+	
+	for ( Index i = 0; i < sources.getSize(); i++ )
+		util::destruct( sources[i].object );
+	
+	for ( Index i = 0; i < listeners.getSize(); i++ )
+		util::destruct( listeners[i].object );
+	
+	for ( Index i = 0; i < meshes.getSize(); i++ )
+	{
+		if ( meshes[i] )
+			util::destruct( meshes[i] );
+	}
+	
+	for ( Index i = 0; i < directivities.getSize(); i++ )
+	{
+		if ( directivities[i] )
+			util::destruct( directivities[i] );
+	}
+	
+	objects.clear();
+	sources.clear();
+	listeners.clear();
+	meshes.clear();
+	directivities.clear();
+	
+	lastIRIndex = 0;
+	frameIndex = 0;
+}
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,433 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundTracePlayer.h
+ * Contents:    gsound::SoundTracePlayer class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_SOUND_TRACE_PLAYER_H
+#define INCLUDE_GSOUND_SOUND_TRACE_PLAYER_H
+
+
+#include "gsConfig.h"
+
+
+#include "gsSoundScene.h"
+#include "gsSoundSceneIR.h"
+#include "gsSoundPropagator.h"
+#include "gsSourceSoundBuffer.h"
+#include "gsSoundListenerRenderer.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that replays a trace recorded by a SoundTraceRecorder and times each call.
+/**
+  * The player reconstructs the recorded scene and re-executes each frame of sound
+  * propagation with the recorded request, including the quality that was chosen by
+  * adaptive quality when the trace was recorded, so that each replay performs the same work.
+  * Frames that updated the renderers when recorded update a listener renderer for each
+  * rendered listener, and each recorded render call renders the same number of samples.
+  *
+  * The stages are executed synchronously on the calling thread (plus the propagator's
+  * and renderers' own worker threads), so that the time spent in each call can be measured
+  * without interference from the pipelining in SoundPropagationSystem.
+  */
+class SoundTracePlayer
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new sound trace player that has no trace open.
+			SoundTracePlayer();
+			
+			
+		//********************************************************************************
+		//******	Destructor
+			
+			
+			/// Destroy a sound trace player, closing its trace and releasing the replayed scene.
+			~SoundTracePlayer();
+			
+			
+		//********************************************************************************
+		//******	Trace File Methods
+			
+			
+			/// Open the trace file at the specified path for replay, replacing any open trace.
+			/**
+			  * The method returns whether or not the file was opened and has a valid trace header.
+			  */
+			Bool open( const UTF8String& filePath );
+			
+			
+			/// Close the current trace and release the scene that was reconstructed from it.
+			void close();
+			
+			
+			/// Return whether or not this player has a trace open.
+			GSOUND_INLINE Bool isOpen() const
+			{
+				return reader != NULL;
+			}
+			
+			
+		//********************************************************************************
+		//******	Replay Methods
+			
+			
+			/// Replay the next record in the trace.
+			/**
+			  * The method returns FALSE when the end of the trace is reached or
+			  * if the trace is invalid.
+			  */
+			Bool step();
+			
+			
+			/// Replay all of the remaining records in the trace.
+			/**
+			  * The method returns whether or not the end of the trace was reached
+			  * without encountering an invalid record.
+			  */
+			Bool play();
+			
+			
+		//********************************************************************************
+		//******	Replay Parameter Accessor Methods
+			
+			
+			/// Return the number of propagation threads that is used instead of the recorded number, or 0 if not overridden.
+			GSOUND_INLINE Size getThreadCount() const
+			{
+				return numThreads;
+			}
+			
+			
+			/// Set the number of propagation threads that is used instead of the recorded number.
+			/**
+			  * A value of 0 causes the recorded number of threads to be used.
+			  */
+			GSOUND_INLINE void setThreadCount( Size newNumThreads )
+			{
+				numThreads = newNumThreads;
+			}
+			
+			
+			/// Return whether or not renderer updates and render calls are replayed.
+			GSOUND_INLINE Bool getRenderingIsEnabled() const
+			{
+				return renderingEnabled;
+			}
+			
+			
+			/// Set whether or not renderer updates and render calls are replayed.
+			/**
+			  * If rendering is disabled, only sound propagation is replayed. Rendering is enabled by default.
+			  */
+			GSOUND_INLINE void setRenderingIsEnabled( Bool newRenderingEnabled )
+			{
+				renderingEnabled = newRenderingEnabled;
+			}
+			
+			
+		//********************************************************************************
+		//******	Timing Accessor Methods
+			
+			
+			/// Return a list of the time taken by each propagation frame that has been replayed.
+			GSOUND_INLINE const ArrayList<Time>& getPropagationTimes() const
+			{
+				return propagationTimes;
+			}
+			
+			
+			/// Return a list of the time taken to update the renderers for each replayed frame that updated them.
+			GSOUND_INLINE const ArrayList<Time>& getIRUpdateTimes() const
+			{
+				return irUpdateTimes;
+			}
+			
+			
+			/// Return a list of the time taken by each render call that has been replayed.
+			GSOUND_INLINE const ArrayList<Time>& getRenderTimes() const
+			{
+				return renderTimes;
+			}
+			
+			
+		//********************************************************************************
+		//******	Replay State Accessor Methods
+			
+			
+			/// Return a reference to the scene that has been reconstructed from the trace.
+			GSOUND_INLINE const SoundScene& getScene() const
+			{
+				return scene;
+			}
+			
+			
+			/// Return a reference to the IR that was output by the last replayed propagation frame.
+			GSOUND_INLINE const SoundSceneIR& getSceneIR() const
+			{
+				return sceneIRs[lastIRIndex];
+			}
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Copy Operations
+			
+			
+			/// Declared private so that a player, which owns its replayed scene, cannot be copied.
+			SoundTracePlayer( const SoundTracePlayer& other );
+			
+			
+			/// Declared private so that a player, which owns its replayed scene, cannot be copied.
+			SoundTracePlayer& operator = ( const SoundTracePlayer& other );
+			
+			
+		//********************************************************************************
+		//******	Private Class Declarations
+			
+			
+			/// A class that stores a replayed scene entity and the last frame where it was in the scene.
+			template < typename EntityType >
+			class Entity
+			{
+				public:
+					
+					GSOUND_INLINE Entity()
+						:	object( NULL ),
+							frameIndex( 0 ),
+							inScene( false )
+					{
+					}
+					
+					/// The replayed copy of the entity.
+					EntityType* object;
+					
+					/// The index of the last propagation frame that included the entity.
+					Index frameIndex;
+					
+					/// Whether or not the entity is currently in the replayed scene.
+					Bool inScene;
+					
+			};
+			
+			
+			/// A class that stores the renderer for a listener that is rendered in the trace.
+			class ListenerRenderer;
+			
+			
+		//********************************************************************************
+		//******	Private Replay Methods
+			
+			
+			/// Replay a record that defines a mesh.
+			Bool replayMesh();
+			
+			
+			/// Replay a record that defines a source directivity.
+			Bool replayDirectivity();
+			
+			
+			/// Replay a frame of sound propagation and update the renderers if the frame did so when recorded.
+			Bool replayPropagation();
+			
+			
+			/// Replay a call to render a listener's audio.
+			Bool replayRender();
+			
+			
+		//********************************************************************************
+		//******	Private Scene Update Methods
+			
+			
+			/// Read the list of entities for a frame, update the state of those that changed, and update the scene's membership.
+			template < typename EntityType >
+			Bool readEntities( ArrayList<Entity<EntityType> >& entities,
+								Bool (SoundScene::*addEntity)( EntityType* ),
+								Bool (SoundScene::*removeEntity)( EntityType* ) );
+			
+			
+			/// Return the replayed entity with the specified ID, creating it if necessary.
+			template < typename EntityType >
+			static Entity<EntityType>& getEntity( ArrayList<Entity<EntityType> >& entities, UInt32 id );
+			
+			
+			/// Read the state of a replayed object.
+			Bool readEntityState( SoundObject& object );
+			
+			
+			/// Read the state of a replayed source.
+			Bool readEntityState( SoundSource& source );
+			
+			
+			/// Read the state of a replayed listener.
+			Bool readEntityState( SoundListener& listener );
+			
+			
+			/// Destroy all of the replayed scene state.
+			void clearScene();
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// The reader for the current trace file, or NULL if there is no trace open.
+			om::FileReader* reader;
+			
+			
+			/// A buffer that holds the payload of the current record.
+			Array<UByte> payload;
+			
+			
+			/// A decoder that reads the payload of the current record.
+			om::BinaryDecoder decoder;
+			
+			
+			/// The scene that is reconstructed from the trace.
+			SoundScene scene;
+			
+			
+			/// The meshes that have been defined by the trace, indexed by their IDs.
+			ArrayList<SoundMesh*> meshes;
+			
+			
+			/// The directivities that have been defined by the trace, indexed by their IDs.
+			ArrayList<SoundDirectivity*> directivities;
+			
+			
+			/// The replayed objects, indexed by their IDs.
+			ArrayList<Entity<SoundObject> > objects;
+			
+			
+			/// The replayed sources, indexed by their IDs.
+			ArrayList<Entity<SoundSource> > sources;
+			
+			
+			/// The replayed listeners, indexed by their IDs.
+			ArrayList<Entity<SoundListener> > listeners;
+			
+			
+			/// The renderers for the replayed listeners, indexed by listener ID, or NULL if a listener is not rendered.
+			ArrayList<ListenerRenderer*> listenerRenderers;
+			
+			
+			/// The propagator that replays the propagation frames.
+			SoundPropagator propagator;
+			
+			
+			/// The request that is used for the current propagation frame.
+			PropagationRequest request;
+			
+			
+			/// Two scene IRs that are alternated between frames, since the renderers may refer to the previous IR.
+			SoundSceneIR sceneIRs[2];
+			
+			
+			/// The index of the scene IR that was output by the last propagation frame.
+			Index lastIRIndex;
+			
+			
+			/// A buffer that holds the input audio for the sources on each render call.
+			SourceSoundBuffer sourceSoundBuffer;
+			
+			
+			/// A buffer that holds the output audio of each render call.
+			SoundBuffer outputBuffer;
+			
+			
+			/// The number of propagation frames that have been replayed.
+			Index frameIndex;
+			
+			
+			/// The number of propagation threads that is used instead of the recorded number, or 0 if not overridden.
+			Size numThreads;
+			
+			
+			/// Whether or not renderer updates and render calls are replayed.
+			Bool renderingEnabled;
+			
+			
+			/// The time taken by each replayed propagation frame.
+			ArrayList<Time> propagationTimes;
+			
+			
+			/// The time taken to update the renderers on each replayed frame that updated them.
+			ArrayList<Time> irUpdateTimes;
+			
+			
+			/// The time taken by each replayed render call.
+			ArrayList<Time> renderTimes;
+			
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SOUND_TRACE_PLAYER_H
@@ -0,0 +1,538 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundTraceRecorder.cpp
+ * Contents:    gsound::SoundTraceRecorder class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "gsSoundTraceRecorder.h"
+
+
+#include "internal/gsSoundTraceFormat.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+using internal::SoundTraceFormat;
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Constructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundTraceRecorder:: SoundTraceRecorder()
+	:	writer( NULL ),
+		numPropagations( 0 ),
+		numRenders( 0 ),
+		numDroppedRenders( 0 ),
+		recordingTrace( 0 ),
+		traceIndex( 0 ),
+		renderQueue( RENDER_QUEUE_SIZE ),
+		renderQueueEnd( 0 ),
+		renderQueueStart( 0 )
+{
+	// Each queue entry is initially free to be written at its own position.
+	for ( Index i = 0; i < RENDER_QUEUE_SIZE; i++ )
+		renderQueue[i].sequence = Atomic<UInt32>( UInt32(i) );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Destructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundTraceRecorder:: ~SoundTraceRecorder()
+{
+	closeFile();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Trace File Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundTraceRecorder:: open( const UTF8String& filePath )
+{
+	ScopedMutex scopedMutex( mutex );
+	
+	closeFile();
+	
+	om::File file( filePath );
+	
+	// Erase the file if it exists.
+	if ( !file.erase() )
+		return false;
+	
+	writer = util::construct<om::FileWriter>( file );
+	
+	if ( !writer->open() || !SoundTraceFormat::writeHeader( *writer ) )
+	{
+		closeFile();
+		return false;
+	}
+	
+	// Number each trace so that render calls queued for an earlier file are never written to this one.
+	traceIndex = traceIndex == math::max<UInt32>() ? 1 : traceIndex + 1;
+	recordingTrace = Atomic<UInt32>( traceIndex );
+	
+	return true;
+}
+
+
+
+
+void SoundTraceRecorder:: close()
+{
+	ScopedMutex scopedMutex( mutex );
+	
+	closeFile();
+}
+
+
+
+
+Bool SoundTraceRecorder:: isOpen() const
+{
+	ScopedMutex scopedMutex( mutex );
+	
+	return writer != NULL;
+}
+
+
+
+
+void SoundTraceRecorder:: closeFile()
+{
+	// Stop queueing render calls, then write those that were queued before the file is closed.
+	// Calls that are published after this are discarded by the next drain, since they belong to an old trace.
+	recordingTrace = Atomic<UInt32>( 0 );
+	writePendingRenders();
+	
+	if ( writer )
+	{
+		writer->close();
+		util::destruct( writer );
+		writer = NULL;
+	}
+	
+	// Entity IDs and states are local to a trace, so start over for the next one.
+	meshes.clear();
+	directivities.clear();
+	objects.clear();
+	sources.clear();
+	listeners.clear();
+	renderRequests.clear();
+	resetEncoder( recordEncoder );
+	numPropagations = 0;
+	numRenders = 0;
+	numDroppedRenders = Atomic<Size>( 0 );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Recording Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundTraceRecorder:: recordPropagation( const SoundScene& scene, const PropagationRequest& request, Bool updateRenderers )
+{
+	ScopedMutex scopedMutex( mutex );
+	
+	if ( writer == NULL )
+		return false;
+	
+	// Write the render calls since the last frame first, so that the trace stays in order.
+	writePendingRenders();
+	
+	const Size numObjects = scene.getObjectCount();
+	const Size numSources = scene.getSourceCount();
+	const Size numListeners = scene.getListenerCount();
+	
+	//********************************************************************************
+	// Write the meshes and directivities that are new on this frame before the frame record.
+	
+	for ( Index i = 0; i < numObjects; i++ )
+		getMeshID( scene.getObject(i)->getMesh() );
+	
+	for ( Index i = 0; i < numSources; i++ )
+		getDirectivityID( scene.getSource(i)->getDirectivity() );
+	
+	//********************************************************************************
+	// Write the request and the global scene state.
+	
+	recordEncoder.write( UInt8(updateRenderers) );
+	SoundTraceFormat::writeRequest( recordEncoder, request );
+	SoundTraceFormat::writeSceneState( recordEncoder, scene );
+	
+	//********************************************************************************
+	// Write the IDs of the entities in the scene, along with the state of those that changed.
+	
+	recordEncoder.write( UInt64(numObjects) );
+	
+	for ( Index i = 0; i < numObjects; i++ )
+	{
+		const SoundObject* object = scene.getObject(i);
+		EntityState& entity = getEntity( objects, object );
+		
+		resetEncoder( stateEncoder );
+		SoundTraceFormat::writeObject( stateEncoder, *object, getMeshID( object->getMesh() ) );
+		
+		recordEncoder.write( entity.id );
+		writeEntityState( entity );
+	}
+	
+	recordEncoder.write( UInt64(numSources) );
+	
+	for ( Index i = 0; i < numSources; i++ )
+	{
+		const SoundSource* source = scene.getSource(i);
+		EntityState& entity = getEntity( sources, source );
+		
+		resetEncoder( stateEncoder );
+		SoundTraceFormat::writeSource( stateEncoder, *source, getDirectivityID( source->getDirectivity() ) );
+		
+		recordEncoder.write( entity.id );
+		writeEntityState( entity );
+	}
+	
+	recordEncoder.write( UInt64(numListeners) );
+	
+	for ( Index i = 0; i < numListeners; i++ )
+	{
+		const SoundListener* listener = scene.getListener(i);
+		EntityState& entity = getEntity( listeners, listener );
+		
+		resetEncoder( stateEncoder );
+		SoundTraceFormat::writeListener( stateEncoder, *listener );
+		
+		recordEncoder.write( entity.id );
+		writeEntityState( entity );
+	}
+	
+	if ( !writeRecord( SoundTraceFormat::PROPAGATION ) )
+		return false;
+	
+	numPropagations++;
+	
+	return true;
+}
+
+
+
+
+Bool SoundTraceRecorder:: recordRender( const SoundListener* listener, const RenderRequest& request,
+										Size numSamples, SampleRate sampleRate )
+{
+	const UInt32 trace = readAtomic( recordingTrace );
+	
+	if ( listener == NULL || trace == 0 )
+		return false;
+	
+	//********************************************************************************
+	// Claim the queue entry at the end of the queue, if it has been written to the trace.
+	
+	const UInt32 queueMask = UInt32(RENDER_QUEUE_SIZE - 1);
+	PendingRender* pending;
+	UInt32 position = readAtomic( renderQueueEnd );
+	
+	while ( true )
+	{
+		pending = &renderQueue[position & queueMask];
+		const Int32 difference = Int32(readAtomic( pending->sequence ) - position);
+	
+		if ( difference == 0 )
+		{
+			// The entry is free, try to advance the end of the queue past it.
+			if ( renderQueueEnd.testAndSet( position, position + 1 ) )
+				break;
+		}
+		else if ( difference < 0 )
+		{
+			// The queue is full, drop the render call.
+			numDroppedRenders++;
+			return false;
+		}
+	
+		// Another thread claimed the entry first, try again at the new end of the queue.
+		position = readAtomic( renderQueueEnd );
+	}
+	
+	pending->traceIndex = trace;
+	pending->listener = listener;
+	copyRenderRequest( request, pending->request );
+	pending->channelLayoutType = request.channelLayout.getType();
+	pending->numChannels = request.channelLayout.getChannelCount();
+	pending->numSamples = numSamples;
+	pending->sampleRate = sampleRate;
+	
+	// Publish the entry to the thread that writes the trace.
+	pending->sequence++;
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Private Helper Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundTraceRecorder:: writePendingRenders()
+{
+	const UInt32 queueMask = UInt32(RENDER_QUEUE_SIZE - 1);
+	
+	while ( true )
+	{
+		PendingRender& pending = renderQueue[renderQueueStart & queueMask];
+		
+		// Stop at the first entry that has not been published yet.
+		if ( Int32(readAtomic( pending.sequence ) - (renderQueueStart + 1)) < 0 )
+			break;
+		
+		if ( writer && pending.traceIndex == traceIndex )
+		{
+			// Rebuild the request's channel layout if it changed since the entry was last used.
+			ChannelLayout& channelLayout = pending.request.channelLayout;
+			
+			if ( channelLayout.getType() != pending.channelLayoutType ||
+				channelLayout.getChannelCount() != pending.numChannels )
+			{
+				if ( pending.channelLayoutType == ChannelLayout::CUSTOM )
+					channelLayout = ChannelLayout( pending.numChannels );
+				else
+					channelLayout = ChannelLayout( pending.channelLayoutType );
+			}
+			
+			// Render calls refer to the listener by the same ID that is used in the propagation records.
+			recordEncoder.write( getEntity( listeners, pending.listener ).id );
+			
+			// Only write the render request when it changes.
+			resetEncoder( stateEncoder );
+			SoundTraceFormat::writeRenderRequest( stateEncoder, pending.request );
+			writeEntityState( getEntity( renderRequests, pending.listener ) );
+			
+			recordEncoder.write( UInt64(pending.numSamples) );
+			recordEncoder.write( Float64(pending.sampleRate) );
+			
+			if ( writeRecord( SoundTraceFormat::RENDER ) )
+				numRenders++;
+		}
+		
+		// Free the entry to be written again when the queue wraps around.
+		pending.sequence += UInt32(RENDER_QUEUE_SIZE - 1);
+		renderQueueStart++;
+	}
+}
+
+
+
+
+void SoundTraceRecorder:: copyRenderRequest( const RenderRequest& request, RenderRequest& copy )
+{
+	copy.flags = request.flags;
+	copy.maxHRTFOrder = request.maxHRTFOrder;
+	
+	// Strings are reference counted, so this doesn't copy the characters.
+	copy.hrtfCachePath = request.hrtfCachePath;
+	
+	copy.sampleRate = request.sampleRate;
+	copy.frequencies = request.frequencies;
+	copy.numThreads = request.numThreads;
+	copy.numUpdateThreads = request.numUpdateThreads;
+	copy.maxIRLength = request.maxIRLength;
+	copy.earlyIRLength = request.earlyIRLength;
+	copy.maxLatency = request.maxLatency;
+	copy.maxSourcePathCount = request.maxSourcePathCount;
+	copy.renderingLoadBudget = request.renderingLoadBudget;
+	copy.minClusterQuality = request.minClusterQuality;
+	copy.maxPathDelay = request.maxPathDelay;
+	copy.maxDelayRate = request.maxDelayRate;
+	copy.irFadeTime = request.irFadeTime;
+	copy.pathFadeTime = request.pathFadeTime;
+	copy.hrtfFadeTime = request.hrtfFadeTime;
+	copy.sourceFadeTime = request.sourceFadeTime;
+	copy.clusterFadeInTime = request.clusterFadeInTime;
+	copy.clusterFadeOutTime = request.clusterFadeOutTime;
+	copy.volume = request.volume;
+}
+
+
+
+
+UInt32 SoundTraceRecorder:: getMeshID( const SoundMesh* mesh )
+{
+	if ( mesh == NULL )
+		return SoundTraceFormat::INVALID_ID;
+	
+	const Hash hash = getPointerHash( mesh );
+	UInt32* id;
+	
+	if ( meshes.find( hash, mesh, id ) )
+		return *id;
+	
+	const UInt32 newID = (UInt32)meshes.getSize();
+	meshes.add( hash, mesh, newID );
+	
+	// The mesh is written in the same format as a saved mesh file.
+	recordEncoder.write( newID );
+	mesh->save( recordEncoder );
+	writeRecord( SoundTraceFormat::MESH );
+	
+	return newID;
+}
+
+
+
+
+UInt32 SoundTraceRecorder:: getDirectivityID( const SoundDirectivity* directivity )
+{
+	if ( directivity == NULL )
+		return SoundTraceFormat::INVALID_ID;
+	
+	const Hash hash = getPointerHash( directivity );
+	UInt32* id;
+	
+	if ( directivities.find( hash, directivity, id ) )
+		return *id;
+	
+	const UInt32 newID = (UInt32)directivities.getSize();
+	directivities.add( hash, directivity, newID );
+	
+	recordEncoder.write( newID );
+	SoundTraceFormat::writeDirectivity( recordEncoder, *directivity );
+	writeRecord( SoundTraceFormat::DIRECTIVITY );
+	
+	return newID;
+}
+
+
+
+
+void SoundTraceRecorder:: writeEntityState( EntityState& entity )
+{
+	const UByte* const state = stateEncoder.getBufferData();
+	const Size stateSize = stateEncoder.getBufferSize();
+	
+	// Compare the new state with the last state that was written for the entity.
+	if ( entity.state.getSize() == stateSize &&
+		std::memcmp( entity.state.getPointer(), state, stateSize ) == 0 )
+	{
+		recordEncoder.write( UInt8(0) );
+		return;
+	}
+	
+	recordEncoder.write( UInt8(1) );
+	recordEncoder.write( state, stateSize );
+	
+	entity.state.clear();
+	entity.state.addAll( state, stateSize );
+}
+
+
+
+
+Bool SoundTraceRecorder:: writeRecord( UInt32 type )
+{
+	const Bool result = SoundTraceFormat::writeRecord( *writer, SoundTraceFormat::RecordType(type),
+														recordEncoder.getBufferData(), recordEncoder.getBufferSize() );
+	resetEncoder( recordEncoder );
+	
+	return result;
+}
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
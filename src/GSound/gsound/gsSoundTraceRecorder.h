@@ -0,0 +1,426 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/gsSoundTraceRecorder.h
+ * Contents:    gsound::SoundTraceRecorder class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_SOUND_TRACE_RECORDER_H
+#define INCLUDE_GSOUND_SOUND_TRACE_RECORDER_H
+
+
+#include "gsConfig.h"
+
+
+#include "gsSoundScene.h"
+#include "gsPropagationRequest.h"
+#include "gsRenderRequest.h"
+
+
+//##########################################################################################
+//******************************  Start GSound Namespace  **********************************
+GSOUND_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that records the inputs to sound propagation and rendering into a binary trace file.
+/**
+  * A trace captures the scene state and request that was used for each frame of
+  * sound propagation, as well as each call to render a listener's audio, so that
+  * a workload from an application can be replayed offline with a SoundTracePlayer
+  * to measure performance.
+  *
+  * Meshes and source directivities are written to the trace the first time they are
+  * referenced, and are assumed not to change while recording. Objects, sources, and listeners
+  * are identified by pointer and only have their state written when it changes,
+  * so that a trace of a mostly static scene stays compact.
+  *
+  * All recording methods are thread-safe, so that propagation and rendering can
+  * be recorded from different threads. Render calls are made from the audio thread,
+  * so they are queued without locking and are written to the trace by the next
+  * call to recordPropagation() or close().
+  */
+class SoundTraceRecorder
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new sound trace recorder that is not recording to a file.
+			SoundTraceRecorder();
+			
+			
+		//********************************************************************************
+		//******	Destructor
+			
+			
+			/// Destroy a sound trace recorder, closing its trace file.
+			~SoundTraceRecorder();
+			
+			
+		//********************************************************************************
+		//******	Trace File Methods
+			
+			
+			/// Start recording a new trace to the file at the specified path, replacing any existing file.
+			/**
+			  * If the recorder is already recording to a file, that file is closed first.
+			  * The method returns whether or not the file was successfully opened.
+			  */
+			Bool open( const UTF8String& filePath );
+			
+			
+			/// Finish recording the current trace and close its file.
+			void close();
+			
+			
+			/// Return whether or not this recorder is currently recording to a trace file.
+			Bool isOpen() const;
+			
+			
+		//********************************************************************************
+		//******	Recording Methods
+			
+			
+			/// Record a frame of sound propagation for the specified scene and request.
+			/**
+			  * The method should be called with the scene state that is passed to the
+			  * propagator, after the request's time step and quality have been determined.
+			  * The update flag indicates whether the frame's IR is passed to the listener renderers.
+			  *
+			  * The method returns whether or not the frame was recorded.
+			  */
+			Bool recordPropagation( const SoundScene& scene, const PropagationRequest& request, Bool updateRenderers = true );
+			
+			
+			/// Record a call to render the specified number of samples of a listener's audio.
+			/**
+			  * The sample rate is that of the output buffer that the audio is rendered into.
+			  * The call and a copy of the request's state are added to a lock-free queue
+			  * without allocating memory, and are written to the trace on the next propagation frame.
+			  *
+			  * The method returns whether or not the render call was queued. Calls are dropped
+			  * if the queue is full because no propagation frame has been recorded for a while.
+			  */
+			Bool recordRender( const SoundListener* listener, const RenderRequest& request,
+								Size numSamples, SampleRate sampleRate );
+								
+								
+		//********************************************************************************
+		//******	Record Count Accessor Methods
+			
+			
+			/// Return the number of propagation frames that have been recorded in the current trace.
+			GSOUND_INLINE Size getPropagationCount() const
+			{
+				return numPropagations;
+			}
+			
+			
+			/// Return the number of render calls that have been recorded in the current trace.
+			GSOUND_INLINE Size getRenderCount() const
+			{
+				return numRenders;
+			}
+			
+			
+			/// Return the number of render calls that were dropped from the current trace because the queue was full.
+			GSOUND_INLINE Size getDroppedRenderCount() const
+			{
+				return numDroppedRenders;
+			}
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Copy Operations
+			
+			
+			/// Declared private so that a recorder, which owns its file, cannot be copied.
+			SoundTraceRecorder( const SoundTraceRecorder& other );
+			
+			
+			/// Declared private so that a recorder, which owns its file, cannot be copied.
+			SoundTraceRecorder& operator = ( const SoundTraceRecorder& other );
+			
+			
+		//********************************************************************************
+		//******	Private Class Declaration
+			
+			
+			/// A class that stores the trace ID of a scene entity and the last state that was written for it.
+			class EntityState
+			{
+				public:
+					
+					GSOUND_INLINE EntityState()
+						:	id( 0 )
+					{
+					}
+					
+					GSOUND_INLINE EntityState( UInt32 newID )
+						:	id( newID )
+					{
+					}
+					
+					/// The ID of the entity in the trace.
+					UInt32 id;
+					
+					/// The encoded state that was last written for the entity.
+					ArrayList<UByte> state;
+					
+			};
+			
+			
+			/// A class that stores a render call that is waiting to be written to the trace.
+			class PendingRender
+			{
+				public:
+					
+					/// The position in the render queue for which this entry can next be written or read.
+					Atomic<UInt32> sequence;
+					
+					/// The number of the trace that the render call was queued for.
+					UInt32 traceIndex;
+					
+					/// The listener that was rendered.
+					const SoundListener* listener;
+					
+					/// A copy of the request that the listener was rendered with, except for its channel layout.
+					/**
+					  * Copying a channel layout allocates memory, so only its type and channel
+					  * count are copied when the call is queued, and the layout is rebuilt when
+					  * the call is written.
+					  */
+					RenderRequest request;
+					
+					/// The type of the request's channel layout.
+					ChannelLayout::Type channelLayoutType;
+					
+					/// The number of channels in the request's channel layout.
+					Size numChannels;
+					
+					/// The number of samples that were rendered.
+					Size numSamples;
+					
+					/// The sample rate of the output buffer.
+					SampleRate sampleRate;
+					
+			};
+			
+			
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Close the current trace file if there is one. The mutex must be locked when calling this method.
+			void closeFile();
+			
+			
+			/// Write the queued render calls to the trace, discarding those that were queued for an earlier file. The mutex must be locked.
+			void writePendingRenders();
+			
+			
+			/// Copy the state of a render request that is written to a trace, except for the channel layout, without allocating memory.
+			static void copyRenderRequest( const RenderRequest& request, RenderRequest& copy );
+			
+			
+			/// Return the trace ID of a mesh, writing a mesh record if it has not been recorded yet.
+			UInt32 getMeshID( const SoundMesh* mesh );
+			
+			
+			/// Return the trace ID of a directivity, writing a directivity record if it has not been recorded yet.
+			UInt32 getDirectivityID( const SoundDirectivity* directivity );
+			
+			
+			/// Return the state for the specified entity, assigning it the next ID if it is new.
+			template < typename EntityType >
+			GSOUND_INLINE static EntityState& getEntity( HashMap<const EntityType*,EntityState>& entities,
+														const EntityType* entity )
+			{
+				const Hash hash = getPointerHash( entity );
+				EntityState* state;
+				
+				if ( !entities.find( hash, entity, state ) )
+					state = entities.add( hash, entity, EntityState( (UInt32)entities.getSize() ) );
+				
+				return *state;
+			}
+			
+			
+			/// Write whether or not the state in the state encoder differs from an entity's last state, followed by the new state if it does.
+			void writeEntityState( EntityState& entity );
+			
+			
+			/// Write the contents of the record encoder as a record with the specified type, then reset the encoder.
+			Bool writeRecord( UInt32 type );
+			
+			
+			/// Return a hash code for the specified pointer.
+			GSOUND_FORCE_INLINE static Hash getPointerHash( const void* pointer )
+			{
+				return Hash(PointerInt(pointer) >> 4);
+			}
+			
+			
+			/// Return the value of an atomic variable, with a full memory barrier.
+			GSOUND_FORCE_INLINE static UInt32 readAtomic( Atomic<UInt32>& value )
+			{
+				return value += 0;
+			}
+			
+			
+			/// Move the write position of an encoder back to the start of its buffer.
+			GSOUND_FORCE_INLINE static void resetEncoder( om::BinaryEncoder& encoder )
+			{
+				encoder.seek( -Int64(encoder.getBufferSize()) );
+			}
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// The file writer for the current trace, or NULL if the recorder is not recording.
+			om::FileWriter* writer;
+			
+			
+			/// An encoder that accumulates the payload of the record that is being written.
+			om::BinaryEncoder recordEncoder;
+			
+			
+			/// An encoder that holds the state of the entity that is being compared to its last state.
+			om::BinaryEncoder stateEncoder;
+			
+			
+			/// A map from the meshes that have been recorded to their trace IDs.
+			HashMap<const SoundMesh*,UInt32> meshes;
+			
+			
+			/// A map from the directivities that have been recorded to their trace IDs.
+			HashMap<const SoundDirectivity*,UInt32> directivities;
+			
+			
+			/// A map from the objects that have been recorded to their trace state.
+			HashMap<const SoundObject*,EntityState> objects;
+			
+			
+			/// A map from the sources that have been recorded to their trace state.
+			HashMap<const SoundSource*,EntityState> sources;
+			
+			
+			/// A map from the listeners that have been recorded to their trace state.
+			HashMap<const SoundListener*,EntityState> listeners;
+			
+			
+			/// A map from the rendered listeners to the render request state that was last written for them.
+			HashMap<const SoundListener*,EntityState> renderRequests;
+			
+			
+			/// The number of propagation frames that have been recorded in the current trace.
+			Size numPropagations;
+			
+			
+			/// The number of render calls that have been recorded in the current trace.
+			Size numRenders;
+			
+			
+			/// The number of render calls that have been dropped from the current trace.
+			Atomic<Size> numDroppedRenders;
+			
+			
+			/// The number of the trace that render calls are currently queued for, or 0 if no file is open.
+			Atomic<UInt32> recordingTrace;
+			
+			
+			/// The number of the most recently opened trace, accessed only with the mutex locked.
+			UInt32 traceIndex;
+			
+			
+			/// A bounded queue of render calls that can be added to from multiple threads without locking.
+			/**
+			  * Each entry's sequence number tells a producer when the entry is free and
+			  * the consumer, which holds the mutex, when the entry has been written.
+			  */
+			Array<PendingRender> renderQueue;
+			
+			
+			/// The queue position where the next render call will be added.
+			Atomic<UInt32> renderQueueEnd;
+			
+			
+			/// The queue position of the next render call to be written, accessed only with the mutex locked.
+			UInt32 renderQueueStart;
+			
+			
+			/// The number of render calls that can be queued between propagation frames, a power of two.
+			static const Size RENDER_QUEUE_SIZE = 256;
+			
+			
+			/// A mutex that serializes recording from multiple threads.
+			mutable Mutex mutex;
+			
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//******************************  End GSound Namespace  ************************************
+GSOUND_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SOUND_TRACE_RECORDER_H
@@ -181,6 +181,8 @@
 // Debug Classes.
 #include "gsDebugFlags.h"
 #include "gsDebugCache.h"
+#include "gsSoundHeatMap.h"
+#include "gsSoundMemoryUsage.h"
 
 
 // Propagation Classes.
@@ -207,6 +209,12 @@
 #include "gsSoundPropagationSystem.h"
 
 
+// Trace Classes.
+#include "gsSoundTraceRecorder.h"
+#include "gsSoundTracePlayer.h"
+#include "gsSoundProfiler.h"
+
+
 
 //##########################################################################################
 //******************************  Start GSound Namespace  **********************************
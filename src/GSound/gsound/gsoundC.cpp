@@ -66,64 +66,131 @@ using namespace gsound;
 
 
 
-/// A class that manages a pool of object references with associated object IDs.
+/// A class that manages a pool of object references with associated generational object IDs.
+/**
+  * Objects are stored in fixed-size slabs of slots that are allocated on demand
+  * and never move, so that an object can be looked up without holding any
+  * allocator-wide lock. Each object ID encodes the slot index and the generation
+  * of the slot when the object was added. Removing an object increments the slot's
+  * generation, so that stale IDs for a reused slot are rejected by find().
+  *
+  * Each slot also has a mutex that the C API uses to serialize access to that object,
+  * so that threads manipulating different objects never contend for the same lock.
+  */
 template < typename ObjectType >
 class ObjectAllocator
 {
-	public:	
+	public:
+		
+		/// Create a new empty object allocator.
+		GSOUND_INLINE ObjectAllocator()
+			:	numSlots( 0 ),
+				numObjects( 0 )
+		{
+			om::util::zeroPOD( slabs, MAX_SLAB_COUNT );
+		}
+		
+		
+		/// Destroy this object allocator, releasing all objects and slabs.
+		GSOUND_INLINE ~ObjectAllocator()
+		{
+			for ( Index i = 0; i < MAX_SLAB_COUNT && slabs[i] != NULL; i++ )
+				om::util::destructArray( slabs[i], SLAB_SIZE );
+		}
+		
 		
 		/// Return the number of valid objects there are in this object allocator.
 		GSOUND_INLINE Size getSize() const
 		{
-			return objects.getSize() - freeList.getSize();
+			return numObjects;
 		}
 		
 		
 		/// Add a new object to this object allocator, returning the new ID for the object.
+		/**
+		  * The method returns 0 (an invalid ID) if the allocator has no more space for objects.
+		  */
 		GSOUND_INLINE gsID add( const Shared<ObjectType>& newObject )
 		{
+			ScopedMutex lock( allocatorMutex );
+			Index slotIndex;
+			
 			// Is there space in the free list?
 			if ( freeList.getSize() > 0 )
 			{
-				const Index objectIndex = freeList.getLast();
+				slotIndex = freeList.getLast();
 				freeList.removeLast();
-				objects[objectIndex] = newObject;
+			}
+			else
+			{
+				if ( numSlots == MAX_SLOT_COUNT )
+					return 0;
+				
+				slotIndex = numSlots;
+				const Index slabIndex = slotIndex / SLAB_SIZE;
 				
-				return indexToID( objectIndex );
+				// Allocate a new slab if the last one is full.
+				if ( slabs[slabIndex] == NULL )
+					slabs[slabIndex] = om::util::constructArray<Slot>( SLAB_SIZE );
+				
+				numSlots++;
 			}
 			
-			// Otherwise, add to the end of the object list.
-			objects.add( newObject );
-			return indexToID( objects.getSize() - 1 );
+			Slot& slot = getSlot( slotIndex );
+			slot.lockReference();
+			slot.object = newObject;
+			const UInt32 generation = slot.generation;
+			slot.unlockReference();
+			numObjects++;
+			
+			return indexToID( slotIndex, generation );
 		}
 		
 		
 		/// Find the object with the specified ID in this allocator.
 		GSOUND_INLINE Bool find( gsID objectID, Shared<ObjectType>& object )
 		{
-			const Index objectIndex = idToIndex( objectID );
+			Slot* slot = findSlot( objectID );
+			
+			if ( slot == NULL )
+				return false;
 			
-			if ( objectIndex < objects.getSize() && objects[objectIndex].isSet() )
+			// Recheck the generation while holding the slot's reference lock.
+			slot->lockReference();
+			
+			if ( slot->generation == idToGeneration( objectID ) && slot->object.isSet() )
 			{
-				object = objects[objectIndex];
+				object = slot->object;
+				slot->unlockReference();
 				return true;
 			}
 			
+			slot->unlockReference();
 			return false;
 		}
 		
 		
-		/// Find the object with the specified ID in this allocator.
+		/// Replace the object with the specified ID in this allocator.
 		GSOUND_INLINE Bool set( gsID objectID, const Shared<ObjectType>& object )
 		{
-			const Index objectIndex = idToIndex( objectID );
+			Slot* slot = findSlot( objectID );
+			
+			if ( slot == NULL )
+				return false;
+			
+			Shared<ObjectType> oldObject;
+			slot->lockReference();
 			
-			if ( objectIndex < objects.getSize() )
+			if ( slot->generation == idToGeneration( objectID ) )
 			{
-				objects[objectIndex] = object;
+				// Release the old object after unlocking.
+				oldObject = slot->object;
+				slot->object = object;
+				slot->unlockReference();
 				return true;
 			}
 			
+			slot->unlockReference();
 			return false;
 		}
 		
@@ -131,50 +198,389 @@ class ObjectAllocator
 		/// Remove the object with the specified ID in this allocator, releasing the object.
 		GSOUND_INLINE Bool remove( gsID objectID )
 		{
-			const Index objectIndex = idToIndex( objectID );
+			Shared<ObjectType> oldObject;
+			ScopedMutex lock( allocatorMutex );
+			Slot* slot = findSlot( objectID );
+			
+			if ( slot == NULL )
+				return false;
 			
-			if ( objectIndex < objects.getSize() && objects[objectIndex].isSet() )
+			slot->lockReference();
+			
+			if ( slot->generation != idToGeneration( objectID ) || slot->object.isNull() )
 			{
-				objects[objectIndex].release();
-				freeList.add( objectIndex );
-				return true;
+				slot->unlockReference();
+				return false;
 			}
 			
-			return false;
+			// Invalidate all outstanding IDs for the slot.
+			oldObject = slot->object;
+			slot->object.release();
+			slot->generation++;
+			slot->unlockReference();
+			
+			freeList.add( idToIndex( objectID ) );
+			numObjects--;
+			
+			return true;
 		}
 		
 		
-		/// Remove all objects from this allocator, reclaiming their memory.
+		/// Remove all objects from this allocator, invalidating their IDs.
+		/**
+		  * The slabs are kept so that lookups on other threads never see freed memory.
+		  */
 		GSOUND_INLINE void clear()
 		{
-			objects.clear();
+			ArrayList< Shared<ObjectType> > oldObjects;
+			ScopedMutex lock( allocatorMutex );
 			freeList.clear();
+			
+			for ( Index i = numSlots; i > 0; i-- )
+			{
+				Slot& slot = getSlot( i - 1 );
+				slot.lockReference();
+				
+				if ( slot.object.isSet() )
+				{
+					oldObjects.add( slot.object );
+					slot.object.release();
+					slot.generation++;
+				}
+				
+				slot.unlockReference();
+				freeList.add( i - 1 );
+			}
+			
+			numObjects = 0;
+		}
+		
+		
+		/// Return a pointer to the mutex for the object slot with the specified ID, or NULL if the ID is invalid.
+		/**
+		  * The mutex is not tied to the slot's generation, so locking it for a stale ID
+		  * is harmless: any following find() with that ID fails.
+		  */
+		GSOUND_INLINE Mutex* getMutex( gsID objectID )
+		{
+			Slot* slot = findSlot( objectID );
+			
+			return slot ? &slot->objectMutex : NULL;
+		}
+		
+		
+		
+	private:
+		
+		//********************************************************************************
+		//******	Private Slot Class Declaration
+			
+			
+			/// A class that stores a single object reference, its generation, and its locks.
+			class Slot
+			{
+				public:
+					
+					GSOUND_INLINE Slot()
+						:	generation( 0 ),
+							referenceLock( 0 )
+					{
+					}
+					
+					/// Acquire the spin lock that protects the object reference.
+					GSOUND_INLINE void lockReference()
+					{
+						while ( !referenceLock.testAndSet( 0, 1 ) )
+						{
+						}
+					}
+					
+					/// Release the spin lock that protects the object reference.
+					GSOUND_INLINE void unlockReference()
+					{
+						referenceLock.testAndSet( 1, 0 );
+					}
+					
+					/// The object stored in this slot, protected by the reference lock.
+					Shared<ObjectType> object;
+					
+					/// The generation of this slot, incremented whenever its object is removed.
+					Atomic<UInt32> generation;
+					
+					/// A spin lock that protects the object reference during copies.
+					Atomic<UInt32> referenceLock;
+					
+					/// A mutex that serializes C API access to the object in this slot.
+					Mutex objectMutex;
+					
+			};
+			
+			
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Return the slot with the specified ID if its index and generation are valid.
+			GSOUND_INLINE Slot* findSlot( gsID id )
+			{
+				if ( id == 0 )
+					return NULL;
+				
+				const Index slotIndex = idToIndex( id );
+				
+				if ( slotIndex >= numSlots )
+					return NULL;
+				
+				Slot& slot = getSlot( slotIndex );
+				
+				// Reject stale IDs without taking any lock.
+				if ( slot.generation != idToGeneration( id ) )
+					return NULL;
+				
+				return &slot;
+			}
+			
+			
+			/// Return a reference to the slot with the specified index.
+			GSOUND_INLINE Slot& getSlot( Index slotIndex )
+			{
+				return slabs[slotIndex / SLAB_SIZE][slotIndex % SLAB_SIZE];
+			}
+			
+			
+			/// Return the object ID for the given slot index and generation.
+			GSOUND_INLINE static gsID indexToID( Index i, UInt32 generation )
+			{
+				return gsID(((generation & GENERATION_MASK) << INDEX_BITS) | (i + 1));
+			}
+			
+			
+			/// Return the slot index for the given object ID.
+			GSOUND_INLINE static Index idToIndex( gsID id )
+			{
+				return (id & INDEX_MASK) - 1;
+			}
+			
+			
+			/// Return the slot generation for the given object ID.
+			GSOUND_INLINE static UInt32 idToGeneration( gsID id )
+			{
+				return UInt32(id >> INDEX_BITS) & GENERATION_MASK;
+			}
+			
+			
+		//********************************************************************************
+		//******	Private Static Data Members
+			
+			
+			/// The number of low bits of an object ID that store the slot index plus one.
+			static const UInt32 INDEX_BITS = 20;
+			
+			
+			/// A mask for the slot index bits of an object ID.
+			static const UInt32 INDEX_MASK = (UInt32(1) << INDEX_BITS) - 1;
+			
+			
+			/// A mask for the generation of an object ID, after shifting by the index bits.
+			static const UInt32 GENERATION_MASK = (UInt32(1) << (32 - INDEX_BITS)) - 1;
+			
+			
+			/// The number of object slots that are allocated in each slab.
+			static const Size SLAB_SIZE = 1024;
+			
+			
+			/// The maximum number of slots that an allocator can have.
+			static const Size MAX_SLOT_COUNT = INDEX_MASK;
+			
+			
+			/// The maximum number of slabs that an allocator can have.
+			static const Size MAX_SLAB_COUNT = (MAX_SLOT_COUNT + SLAB_SIZE - 1) / SLAB_SIZE;
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// The slabs of object slots, allocated in order as they are needed.
+			Slot* slabs[MAX_SLAB_COUNT];
+			
+			
+			/// The number of slots that have been handed out, published after the slot's slab exists.
+			Atomic<Size> numSlots;
+			
+			
+			/// The number of valid objects in this allocator.
+			Atomic<Size> numObjects;
+			
+			
+			/// A list of the unused slots in the object allocator.
+			ArrayList<Index> freeList;
+			
+			
+			/// A mutex that serializes adding and removing objects.
+			Mutex allocatorMutex;
+			
+			
+};
+
+
+
+
+/// A class that locks the mutex for a single library object for the lifetime of the lock.
+class ScopedObjectLock
+{
+	public:
+		
+		/// Lock the specified object mutex, or do nothing if the mutex is NULL.
+		GSOUND_INLINE ScopedObjectLock( Mutex* newMutex )
+			:	mutex( newMutex )
+		{
+			if ( mutex )
+				mutex->lock();
 		}
 		
 		
+		/// Unlock the object mutex.
+		GSOUND_INLINE ~ScopedObjectLock()
+		{
+			if ( mutex )
+				mutex->unlock();
+		}
+		
 		
 	private:
 		
-		/// Return the object ID for the given index.
-		GSOUND_INLINE static gsID indexToID( Index i )
+		/// The mutex that is locked, or NULL if there is no object.
+		Mutex* mutex;
+		
+		
+};
+
+
+
+
+/// A reader/writer lock that synchronizes changes to scene objects with the systems that read them.
+/**
+  * Functions that modify sources, listeners, or objects take the lock shared, so that they
+  * only contend through their object's slot mutex. System updates and rendering take the lock
+  * exclusively, since they read the state of every object in the scene without the slot mutexes.
+  */
+class SceneStateLock
+{
+	public:
+		
+		/// Create a new unlocked scene state lock.
+		GSOUND_INLINE SceneStateLock()
+			:	numSharedLocks( 0 )
+		{
+		}
+		
+		
+		/// Acquire a shared lock for modifying scene objects.
+		GSOUND_INLINE void lockShared()
+		{
+			exclusiveMutex.lock();
+			numSharedLocks++;
+			exclusiveMutex.unlock();
+		}
+		
+		
+		/// Release a shared lock.
+		GSOUND_INLINE void unlockShared()
+		{
+			numSharedLocks--;
+		}
+		
+		
+		/// Acquire an exclusive lock, waiting for the functions that hold a shared lock to finish.
+		GSOUND_INLINE void lockExclusive()
+		{
+			// Holding the mutex blocks new shared locks, while the current ones are short.
+			exclusiveMutex.lock();
+			
+			// Compare the count with zero using a barrier so that the shared lock holders' writes are visible.
+			while ( !numSharedLocks.testAndSet( Size(0), Size(0) ) )
+				om::threads::Thread::yield();
+		}
+		
+		
+		/// Release an exclusive lock.
+		GSOUND_INLINE void unlockExclusive()
+		{
+			exclusiveMutex.unlock();
+		}
+		
+		
+	private:
+		
+		/// A mutex that is held by the exclusive owner of the lock.
+		Mutex exclusiveMutex;
+		
+		
+		/// The number of shared locks that are currently held.
+		Atomic<Size> numSharedLocks;
+		
+		
+};
+
+
+
+
+/// A class that holds a shared scene state lock for the lifetime of the object.
+class ScopedSharedLock
+{
+	public:
+		
+		/// Acquire a shared lock on the specified scene state lock.
+		GSOUND_INLINE ScopedSharedLock( SceneStateLock& newLock )
+			:	lock( newLock )
 		{
-			return gsID(i + 1);
+			lock.lockShared();
 		}
 		
 		
-		/// Return the object index for the given object ID.
-		GSOUND_INLINE static Index idToIndex( gsID id )
+		/// Release the lock.
+		GSOUND_INLINE ~ScopedSharedLock()
+		{
+			lock.unlockShared();
+		}
+		
+		
+	private:
+		
+		/// The scene state lock that is held.
+		SceneStateLock& lock;
+		
+		
+};
+
+
+
+
+/// A class that holds an exclusive scene state lock for the lifetime of the object.
+class ScopedExclusiveLock
+{
+	public:
+		
+		/// Acquire an exclusive lock on the specified scene state lock.
+		GSOUND_INLINE ScopedExclusiveLock( SceneStateLock& newLock )
+			:	lock( newLock )
 		{
-			return id - 1;
+			lock.lockExclusive();
 		}
 		
 		
-		/// A list of the objects that are allocated by this object allocator.
-		ArrayList< Shared<ObjectType> > objects;
+		/// Release the lock.
+		GSOUND_INLINE ~ScopedExclusiveLock()
+		{
+			lock.unlockExclusive();
+		}
+		
 		
+	private:
 		
-		/// A list of the unused objects in the object allcoator.
-		ArrayList<Index> freeList;
+		/// The scene state lock that is held.
+		SceneStateLock& lock;
 		
 		
 };
@@ -367,6 +773,106 @@ static ChannelLayout convertChannelLayout( gsChannelLayout layout )
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Batch Transform Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// Set the transforms of an array of detectors from structure-of-arrays input, returning the number updated.
+template < typename DetectorType >
+static Size setDetectorTransforms( ObjectAllocator<DetectorType>& allocator, const gsID* ids, Size numDetectors,
+									const gsFloat* const* position, const gsFloat* const* velocity,
+									const gsFloat* const* orientation )
+{
+	if ( ids == NULL )
+		return 0;
+	
+	Size numUpdated = 0;
+	Shared<DetectorType> detector;
+	
+	for ( Index i = 0; i < numDetectors; i++ )
+	{
+		ScopedObjectLock lock( allocator.getMutex( ids[i] ) );
+		
+		if ( !allocator.find( ids[i], detector ) )
+			continue;
+		
+		if ( position )
+			detector->setPosition( Vector3f( position[0][i], position[1][i], position[2][i] ) );
+		
+		if ( velocity )
+			detector->setVelocity( Vector3f( velocity[0][i], velocity[1][i], velocity[2][i] ) );
+		
+		if ( orientation )
+		{
+			Vector3f x( orientation[0][i], orientation[1][i], orientation[2][i] );
+			Vector3f y( orientation[3][i], orientation[4][i], orientation[5][i] );
+			Vector3f z = math::cross( x, y );
+			
+			detector->setOrientation( Matrix3f( x, y, z ) );
+		}
+		
+		numUpdated++;
+	}
+	
+	return numUpdated;
+}
+
+
+
+
+/// Get the transforms of an array of detectors as structure-of-arrays output, returning the number read.
+template < typename DetectorType >
+static Size getDetectorTransforms( ObjectAllocator<DetectorType>& allocator, const gsID* ids, Size numDetectors,
+									gsFloat* const* position, gsFloat* const* velocity, gsFloat* const* orientation )
+{
+	if ( ids == NULL )
+		return 0;
+	
+	Size numRead = 0;
+	Shared<DetectorType> detector;
+	
+	for ( Index i = 0; i < numDetectors; i++ )
+	{
+		ScopedObjectLock lock( allocator.getMutex( ids[i] ) );
+		
+		if ( !allocator.find( ids[i], detector ) )
+			continue;
+		
+		if ( position )
+		{
+			const Vector3f& p = detector->getPosition();
+			position[0][i] = p.x;	position[1][i] = p.y;	position[2][i] = p.z;
+		}
+		
+		if ( velocity )
+		{
+			const Vector3f& v = detector->getVelocity();
+			velocity[0][i] = v.x;	velocity[1][i] = v.y;	velocity[2][i] = v.z;
+		}
+		
+		if ( orientation )
+		{
+			const Matrix3f& o = detector->getOrientation();
+			orientation[0][i] = o.x.x;	orientation[1][i] = o.x.y;	orientation[2][i] = o.x.z;
+			orientation[3][i] = o.y.x;	orientation[4][i] = o.y.y;	orientation[5][i] = o.y.z;
+		}
+		
+		numRead++;
+	}
+	
+	return numRead;
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -400,6 +906,11 @@ class SoundLibrary
 		GSOUND_INLINE void reset()
 		{
 			systems.clear();
+			
+			bindingMutex.lock();
+			systemBindings.clear();
+			bindingMutex.unlock();
+			
 			requests.clear();
 			renderRequests.clear();
 			meshRequests.clear();
@@ -429,12 +940,89 @@ class SoundLibrary
 		ObjectAllocator<om::sound::HRTF> hrtfs;
 		
 		
+		/// Remember the IDs of the scene and request that a propagation system uses.
+		/**
+		  * An ID of 0 leaves the previous binding unchanged.
+		  */
+		GSOUND_INLINE void bindSystem( gsSystemID systemID, gsSceneID sceneID, gsRequestID requestID )
+		{
+			ScopedMutex lock( bindingMutex );
+			SystemBinding* binding = systemBindings.get( systemID, systemID );
+			
+			if ( binding == NULL )
+				binding = systemBindings.add( systemID, systemID, SystemBinding() );
+			
+			if ( sceneID != 0 )
+				binding->sceneID = sceneID;
+			
+			if ( requestID != 0 )
+				binding->requestID = requestID;
+		}
+		
+		
+		/// Forget the scene and request IDs for the specified propagation system.
+		GSOUND_INLINE void unbindSystem( gsSystemID systemID )
+		{
+			ScopedMutex lock( bindingMutex );
+			systemBindings.remove( systemID, systemID );
+		}
+		
+		
+		/// Get the IDs of the scene and request that a propagation system uses, or 0 if they are not set.
+		GSOUND_INLINE void getSystemBinding( gsSystemID systemID, gsSceneID& sceneID, gsRequestID& requestID )
+		{
+			ScopedMutex lock( bindingMutex );
+			const SystemBinding* binding = systemBindings.get( systemID, systemID );
+			
+			sceneID = binding ? binding->sceneID : 0;
+			requestID = binding ? binding->requestID : 0;
+		}
+		
+		
 		/// An object that manages the on-disk resources for the sound library.
 		om::resources::ResourceManager resourceManager;
 
-		/// A mutex that handles synchronizing access to the library.
+		/// A mutex that synchronizes library resets and access to the resource manager.
+		/**
+		  * Individual objects are synchronized by their allocator slot's mutex instead.
+		  */
 		Mutex mutex;
 		
+		/// A lock that keeps object setters from running while a system reads the scene state.
+		SceneStateLock stateLock;
+		
+		
+	private:
+		
+		/// A class that stores the IDs of the scene and request that a propagation system uses.
+		class SystemBinding
+		{
+			public:
+				
+				GSOUND_INLINE SystemBinding()
+					:	sceneID( 0 ),
+						requestID( 0 )
+				{
+				}
+				
+				gsSceneID sceneID;
+				gsRequestID requestID;
+				
+		};
+		
+		
+		/// A map from system ID to the scene and request that the system was given.
+		/**
+		  * A system update copies the scene and modifies the request, so it must hold
+		  * the slot mutexes for both objects while it runs.
+		  */
+		HashMap<gsSystemID,SystemBinding> systemBindings;
+		
+		
+		/// A mutex that synchronizes access to the system bindings.
+		Mutex bindingMutex;
+		
+		
 };
 
 
@@ -496,7 +1084,6 @@ extern "C" void GSOUND_EXPORT gsGetVersion( gsSize* major, gsSize* minor, gsSize
 
 extern "C" gsSystemID GSOUND_EXPORT gsNewSystem()
 {
-	ScopedMutex lock( library->mutex );
 	gsSystemID systemID = library->systems.add( Shared<SoundPropagationSystem>::construct() );
 	
 	return systemID;
@@ -507,8 +1094,8 @@ extern "C" gsSystemID GSOUND_EXPORT gsNewSystem()
 
 extern "C" void GSOUND_EXPORT gsDeleteSystem( gsSystemID systemID )
 {
-	ScopedMutex lock( library->mutex );
 	library->systems.remove( systemID );
+	library->unbindSystem( systemID );
 }
 
 
@@ -516,8 +1103,17 @@ extern "C" void GSOUND_EXPORT gsDeleteSystem( gsSystemID systemID )
 
 extern "C" gsBool GSOUND_EXPORT gsSystemUpdate( gsSystemID systemID, gsFloat dt, gsBool synchronous )
 {
-	ScopedMutex lock( library->mutex );
 	Shared<SoundPropagationSystem> system;
+	gsSceneID sceneID;
+	gsRequestID requestID;
+	
+	// Lock the system's request and scene so that they can't be modified while
+	// the update copies the scene and writes the request's quality and time step.
+	// The exclusive state lock also keeps the scene's objects from being modified.
+	library->getSystemBinding( systemID, sceneID, requestID );
+	ScopedExclusiveLock stateLock( library->stateLock );
+	ScopedObjectLock requestLock( library->requests.getMutex( requestID ) );
+	ScopedObjectLock sceneLock( library->scenes.getMutex( sceneID ) );
 	
 	if ( library->systems.find( systemID, system ) )
 	{
@@ -533,12 +1129,12 @@ extern "C" gsBool GSOUND_EXPORT gsSystemUpdate( gsSystemID systemID, gsFloat dt,
 
 extern "C" gsBool GSOUND_EXPORT gsSystemSetScene( gsSystemID systemID, gsSceneID sceneID )
 {
-	ScopedMutex lock( library->mutex );
 	Shared<SoundPropagationSystem> system;
 	Shared<SoundScene> scene;
 	
 	if ( library->systems.find( systemID, system ) && library->scenes.find( sceneID, scene ) )
 	{
+		library->bindSystem( systemID, sceneID, 0 );
 		system->setScene( scene );
 		return true;
 	}
@@ -551,7 +1147,6 @@ extern "C" gsBool GSOUND_EXPORT gsSystemSetScene( gsSystemID systemID, gsSceneID
 
 extern "C" gsBool GSOUND_EXPORT gsSystemAddListener( gsSystemID systemID, gsListenerID listenerID, gsRenderRequestID renderingRequestID )
 {
-	ScopedMutex lock( library->mutex );
 	Shared<SoundPropagationSystem> system;
 	Shared<SoundListener> listener;
 	Shared<RenderRequest> renderingRequest;
@@ -572,12 +1167,12 @@ extern "C" gsBool GSOUND_EXPORT gsSystemAddListener( gsSystemID systemID, gsList
 
 extern "C" gsBool GSOUND_EXPORT gsSystemSetRequest( gsSystemID systemID, gsRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
 	Shared<SoundPropagationSystem> system;
 	Shared<PropagationRequest> request;
 	
 	if ( library->systems.find( systemID, system ) && library->requests.find( requestID, request ) )
 	{
+		library->bindSystem( systemID, 0, requestID );
 		system->setRequest( request );
 		return true;
 	}
@@ -594,9 +1189,16 @@ extern "C" gsBool GSOUND_EXPORT gsSystemReadSamples( gsSystemID systemID, gsRequ
 	if ( samples == NULL || numSamples == 0 || numChannels == 0 )
 		return false;
 	
-	ScopedMutex lock( library->mutex );
 	Shared<SoundPropagationSystem> system;
 	Shared<SoundListener> listener;
+	gsSceneID sceneID;
+	gsRequestID requestID;
+	
+	// Lock the system's scene because the sound for its sources is buffered while rendering,
+	// and lock the state of its sources and listeners, which the renderer reads.
+	library->getSystemBinding( systemID, sceneID, requestID );
+	ScopedExclusiveLock stateLock( library->stateLock );
+	ScopedObjectLock sceneLock( library->scenes.getMutex( sceneID ) );
 	
 	if ( library->systems.find( systemID, system ) && library->listeners.find( listenerID, listener ) )
 	{
@@ -636,6 +1238,87 @@ extern "C" gsBool GSOUND_EXPORT gsSystemReadSamples( gsSystemID systemID, gsRequ
 
 
 
+extern "C" gsSize GSOUND_EXPORT gsSystemGetSourceIRs( gsSystemID systemID, gsListenerID listenerID,
+													const gsSourceID* sourceIDs, gsSize numSources,
+													gsSize* pathCounts, gsFloat* irLengths, gsFloat* reverbTimes )
+{
+	if ( sourceIDs == NULL || numSources == 0 )
+		return 0;
+	
+	Shared<SoundPropagationSystem> system;
+	Shared<SoundListener> listener;
+	
+	if ( !library->systems.find( systemID, system ) || !library->listeners.find( listenerID, listener ) )
+		return 0;
+	
+	// Copy the last IR once for all of the sources.
+	SoundSceneIR sceneIR;
+	system->getSceneIR( sceneIR );
+	
+	const SoundListenerIR* listenerIR = NULL;
+	
+	for ( Index l = 0; l < sceneIR.getListenerCount(); l++ )
+	{
+		if ( sceneIR.getListenerIR(l).getListener() == listener.getPointer() )
+		{
+			listenerIR = &sceneIR.getListenerIR(l);
+			break;
+		}
+	}
+	
+	// Map each source in the listener's IR to the IR for its cluster.
+	HashMap<const SoundSource*,Index> sourceIRMap;
+	
+	if ( listenerIR )
+	{
+		for ( Index c = 0; c < listenerIR->getSourceCount(); c++ )
+		{
+			const SoundSourceIR& sourceIR = listenerIR->getSourceIR(c);
+			
+			for ( Index s = 0; s < sourceIR.getSourceCount(); s++ )
+			{
+				const SoundSource* source = sourceIR.getSource(s);
+				
+				// Skip sources that were removed while their IR was still buffered.
+				if ( source == NULL )
+					continue;
+				
+				sourceIRMap.add( source->getHashCode(), source, c );
+			}
+		}
+	}
+	
+	Size numFound = 0;
+	Shared<SoundSource> source;
+	
+	for ( Index i = 0; i < numSources; i++ )
+	{
+		const Index* clusterIndex;
+		
+		if ( library->sources.find( sourceIDs[i], source ) &&
+			sourceIRMap.find( source->getHashCode(), source.getPointer(), clusterIndex ) )
+		{
+			const SoundSourceIR& sourceIR = listenerIR->getSourceIR( *clusterIndex );
+			
+			if ( pathCounts ) pathCounts[i] = sourceIR.getPathCount();
+			if ( irLengths ) irLengths[i] = sourceIR.getLength();
+			if ( reverbTimes ) reverbTimes[i] = sourceIR.getReverbTime();
+			numFound++;
+		}
+		else
+		{
+			if ( pathCounts ) pathCounts[i] = 0;
+			if ( irLengths ) irLengths[i] = 0;
+			if ( reverbTimes ) reverbTimes[i] = 0;
+		}
+	}
+	
+	return numFound;
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -649,7 +1332,6 @@ extern "C" gsBool GSOUND_EXPORT gsSystemReadSamples( gsSystemID systemID, gsRequ
 
 extern "C" gsRequestID GSOUND_EXPORT gsNewRequest()
 {
-	ScopedMutex lock( library->mutex );
 	gsRequestID requestID = library->requests.add( Shared<PropagationRequest>::construct() );
 	
 	return requestID;
@@ -660,7 +1342,6 @@ extern "C" gsRequestID GSOUND_EXPORT gsNewRequest()
 
 extern "C" void GSOUND_EXPORT gsDeleteRequest( gsRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
 	library->requests.remove( requestID );
 }
 
@@ -669,7 +1350,7 @@ extern "C" void GSOUND_EXPORT gsDeleteRequest( gsRequestID requestID )
 
 extern "C" gsBool GSOUND_EXPORT gsRequestGetFlag( gsRequestID requestID, gsFlag flag, gsBool* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( library->requests.find( requestID, request ) )
@@ -709,7 +1390,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestGetFlag( gsRequestID requestID, gsFlag
 
 extern "C" gsBool GSOUND_EXPORT gsRequestSetFlag( gsRequestID requestID, gsFlag flag, gsBool value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( library->requests.find( requestID, request ) )
@@ -751,7 +1432,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestSetFlag( gsRequestID requestID, gsFlag
 
 extern "C" gsBool GSOUND_EXPORT gsRequestGetParamF( gsRequestID requestID, gsParameter parameter, gsFloat* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( value && library->requests.find( requestID, request ) )
@@ -786,7 +1467,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestGetParamF( gsRequestID requestID, gsPar
 
 extern "C" gsBool GSOUND_EXPORT gsRequestSetParamF( gsRequestID requestID, gsParameter parameter, gsFloat value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( library->requests.find( requestID, request ) )
@@ -820,7 +1501,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestSetParamF( gsRequestID requestID, gsPar
 
 extern "C" gsBool GSOUND_EXPORT gsRequestGetParamI( gsRequestID requestID, gsParameter parameter, gsSize* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( value && library->requests.find( requestID, request ) )
@@ -837,6 +1518,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestGetParamI( gsRequestID requestID, gsPar
 			case GS_DIFFUSE_MAX_DEPTH:			*value = (gsSize)request->maxDiffuseDepth;				break;
 			case GS_DIFFUSE_RAY_COUNT:			*value = (gsSize)request->numDiffuseRays;				break;
 			case GS_DIFFUSE_SAMPLE_COUNT:		*value = (gsSize)request->numDiffuseSamples;			break;
+			case GS_RAY_SLICE_COUNT:			*value = (gsSize)request->raySliceCount;				break;
 			default:
 				return false;
 		}
@@ -852,7 +1534,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestGetParamI( gsRequestID requestID, gsPar
 
 extern "C" gsBool GSOUND_EXPORT gsRequestSetParamI( gsRequestID requestID, gsParameter parameter, gsSize value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( library->requests.find( requestID, request ) )
@@ -870,6 +1552,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestSetParamI( gsRequestID requestID, gsPar
 			case GS_DIFFUSE_RAY_COUNT:			request->numDiffuseRays = math::min( (Size)value, Size(1000000000) );			break;
 			case GS_DIFFUSE_SAMPLE_COUNT:		request->numDiffuseSamples = math::clamp( (Size)value, Size(1), Size(10000) );	break;
 			case GS_VISIBILITY_RAY_COUNT:		request->numVisibilityRays = math::min( (Size)value, Size(1000000000) );		break;
+			case GS_RAY_SLICE_COUNT:			request->raySliceCount = math::clamp( (Size)value, Size(1), Size(1000) );		break;
 			default:
 				return false;
 		}
@@ -885,7 +1568,7 @@ extern "C" gsBool GSOUND_EXPORT gsRequestSetParamI( gsRequestID requestID, gsPar
 
 extern "C" gsBool GSOUND_EXPORT gsRequestReset( gsRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	Shared<PropagationRequest> request;
 	
 	if ( library->requests.find( requestID, request ) )
@@ -913,7 +1596,6 @@ extern "C" gsBool GSOUND_EXPORT gsRequestReset( gsRequestID requestID )
 
 extern "C" gsRenderRequestID GSOUND_EXPORT gsNewRenderRequest()
 {
-	ScopedMutex lock( library->mutex );
 	gsRequestID requestID = library->renderRequests.add( Shared<RenderRequest>::construct() );
 	
 	return requestID;
@@ -924,7 +1606,6 @@ extern "C" gsRenderRequestID GSOUND_EXPORT gsNewRenderRequest()
 
 extern "C" void GSOUND_EXPORT gsDeleteRenderRequest( gsRenderRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
 	library->renderRequests.remove( requestID );
 }
 
@@ -933,7 +1614,7 @@ extern "C" void GSOUND_EXPORT gsDeleteRenderRequest( gsRenderRequestID requestID
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetFlag( gsRenderRequestID requestID, gsFlag flag, gsBool* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	
 	if ( library->renderRequests.find( requestID, request ) )
@@ -943,6 +1624,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetFlag( gsRenderRequestID reques
 			case GS_CONVOLUTION:		*value = request->flags.isSet( RenderFlags::CONVOLUTION );		break;
 			case GS_DISCRETE_PATHS:		*value = request->flags.isSet( RenderFlags::DISCRETE_PATHS );	break;
 			case GS_HRTF:				*value = request->flags.isSet( RenderFlags::HRTF );				break;
+			case GS_LATE_REVERB:		*value = request->flags.isSet( RenderFlags::LATE_REVERB );		break;
 			default:
 				return false;
 		}
@@ -958,7 +1640,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetFlag( gsRenderRequestID reques
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetFlag( gsRenderRequestID requestID, gsFlag flag, gsBool value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	
 	if ( library->renderRequests.find( requestID, request ) )
@@ -970,6 +1652,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetFlag( gsRenderRequestID reques
 			case GS_CONVOLUTION:		request->flags.set( RenderFlags::CONVOLUTION, boolValue );		break;
 			case GS_DISCRETE_PATHS:		request->flags.set( RenderFlags::DISCRETE_PATHS, boolValue );	break;
 			case GS_HRTF:				request->flags.set( RenderFlags::HRTF, boolValue );				break;
+			case GS_LATE_REVERB:		request->flags.set( RenderFlags::LATE_REVERB, boolValue );		break;
 			default:
 				return false;
 		}
@@ -985,7 +1668,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetFlag( gsRenderRequestID reques
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetParamF( gsRenderRequestID requestID, gsParameter parameter, gsFloat* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	
 	if ( value && library->renderRequests.find( requestID, request ) )
@@ -1002,6 +1685,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetParamF( gsRenderRequestID requ
 			case GS_CLUSTER_FADE_IN_TIME:		*value = request->clusterFadeInTime;		break;
 			case GS_CLUSTER_FADE_OUT_TIME:		*value = request->clusterFadeOutTime;		break;
 			case GS_VOLUME:						*value = request->volume;					break;
+			case GS_EARLY_IR_LENGTH:			*value = request->earlyIRLength;			break;
 			default:
 				return false;
 		}
@@ -1017,7 +1701,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetParamF( gsRenderRequestID requ
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetParamF( gsRequestID requestID, gsParameter parameter, gsFloat value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	
 	if ( library->renderRequests.find( requestID, request ) )
@@ -1034,6 +1718,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetParamF( gsRequestID requestID,
 			case GS_CLUSTER_FADE_IN_TIME:		request->clusterFadeInTime = math::clamp( value, Float(0.01), Float(10) );		break;
 			case GS_CLUSTER_FADE_OUT_TIME:		request->clusterFadeOutTime = math::clamp( value, Float(0.01), Float(10) );		break;
 			case GS_VOLUME:						request->volume = math::max( value, Float(0) );									break;
+			case GS_EARLY_IR_LENGTH:			request->earlyIRLength = math::max( value, Float(0) );							break;
 			default:
 				return false;
 		}
@@ -1049,7 +1734,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetParamF( gsRequestID requestID,
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetParamI( gsRequestID requestID, gsParameter parameter, gsSize* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	
 	if ( value && library->renderRequests.find( requestID, request ) )
@@ -1074,7 +1759,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestGetParamI( gsRequestID requestID,
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetParamI( gsRequestID requestID, gsParameter parameter, gsSize value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	
 	if ( library->renderRequests.find( requestID, request ) )
@@ -1099,7 +1784,7 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetParamI( gsRequestID requestID,
 
 extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetHRTF( gsRequestID requestID, gsHRTFID hrtfID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	Shared<RenderRequest> request;
 	Shared<om::sound::HRTF> hrtf;
 	
@@ -1129,7 +1814,6 @@ extern "C" gsBool GSOUND_EXPORT gsRenderRequestSetHRTF( gsRequestID requestID, g
 
 extern "C" gsMeshRequestID GSOUND_EXPORT gsNewMeshRequest()
 {
-	ScopedMutex lock( library->mutex );
 	gsRequestID requestID = library->meshRequests.add( Shared<MeshRequest>::construct() );
 	
 	return requestID;
@@ -1140,7 +1824,6 @@ extern "C" gsMeshRequestID GSOUND_EXPORT gsNewMeshRequest()
 
 extern "C" void GSOUND_EXPORT gsDeleteMeshRequest( gsMeshRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
 	library->meshRequests.remove( requestID );
 }
 
@@ -1149,7 +1832,7 @@ extern "C" void GSOUND_EXPORT gsDeleteMeshRequest( gsMeshRequestID requestID )
 
 extern "C" gsBool GSOUND_EXPORT gsMeshRequestGetFlag( gsMeshRequestID requestID, gsFlag flag, gsBool* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	Shared<MeshRequest> request;
 	
 	if ( library->meshRequests.find( requestID, request ) )
@@ -1176,7 +1859,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshRequestGetFlag( gsMeshRequestID requestID,
 
 extern "C" gsBool GSOUND_EXPORT gsMeshRequestSetFlag( gsMeshRequestID requestID, gsFlag flag, gsBool value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	Shared<MeshRequest> request;
 	
 	if ( library->meshRequests.find( requestID, request ) )
@@ -1205,7 +1888,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshRequestSetFlag( gsMeshRequestID requestID,
 
 extern "C" gsBool GSOUND_EXPORT gsMeshRequestGetParamF( gsMeshRequestID requestID, gsParameter parameter, gsFloat* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	Shared<MeshRequest> request;
 	
 	if ( value && library->meshRequests.find( requestID, request ) )
@@ -1234,7 +1917,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshRequestGetParamF( gsMeshRequestID requestI
 
 extern "C" gsBool GSOUND_EXPORT gsMeshRequestSetParamF( gsRequestID requestID, gsParameter parameter, gsFloat value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	Shared<MeshRequest> request;
 	
 	if ( library->meshRequests.find( requestID, request ) )
@@ -1263,7 +1946,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshRequestSetParamF( gsRequestID requestID, g
 
 extern "C" gsBool GSOUND_EXPORT gsMeshRequestGetParamI( gsRequestID requestID, gsParameter parameter, gsSize* value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	Shared<MeshRequest> request;
 	
 	if ( value && library->meshRequests.find( requestID, request ) )
@@ -1288,7 +1971,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshRequestGetParamI( gsRequestID requestID, g
 
 extern "C" gsBool GSOUND_EXPORT gsMeshRequestSetParamI( gsRequestID requestID, gsParameter parameter, gsSize value )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	Shared<MeshRequest> request;
 	
 	if ( library->meshRequests.find( requestID, request ) )
@@ -1324,7 +2007,6 @@ extern "C" gsBool GSOUND_EXPORT gsMeshRequestSetParamI( gsRequestID requestID, g
 
 extern "C" gsSceneID GSOUND_EXPORT gsNewScene()
 {
-	ScopedMutex lock( library->mutex );
 	gsSceneID sceneID = library->scenes.add( Shared<SoundScene>::construct() );
 	
 	return sceneID;
@@ -1335,7 +2017,6 @@ extern "C" gsSceneID GSOUND_EXPORT gsNewScene()
 
 extern "C" void GSOUND_EXPORT gsDeleteScene( gsSceneID sceneID )
 {
-	ScopedMutex lock( library->mutex );
 	library->scenes.remove( sceneID );
 }
 
@@ -1344,6 +2025,7 @@ extern "C" void GSOUND_EXPORT gsDeleteScene( gsSceneID sceneID )
 
 extern "C" gsBool GSOUND_EXPORT gsSceneGetObjectCount( gsSceneID sceneID, gsSize* objectCount )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	
 	if ( objectCount && library->scenes.find( sceneID, scene ) )
@@ -1360,6 +2042,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneGetObjectCount( gsSceneID sceneID, gsSize
 
 extern "C" gsBool GSOUND_EXPORT gsSceneAddObject( gsSceneID sceneID, gsObjectID objectID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	Shared<SoundObject> object;
 	
@@ -1377,6 +2060,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneAddObject( gsSceneID sceneID, gsObjectID
 
 extern "C" gsBool GSOUND_EXPORT gsSceneRemoveObject( gsSceneID sceneID, gsObjectID objectID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	Shared<SoundObject> object;
 	
@@ -1391,6 +2075,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneRemoveObject( gsSceneID sceneID, gsObject
 
 extern "C" gsBool GSOUND_EXPORT gsSceneClearObjects( gsSceneID sceneID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	
 	if ( library->scenes.find( sceneID, scene ) )
@@ -1407,6 +2092,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneClearObjects( gsSceneID sceneID )
 
 extern "C" gsBool GSOUND_EXPORT gsSceneGetSourceCount( gsSceneID sceneID, gsSize* sourceCount )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	
 	if ( sourceCount && library->scenes.find( sceneID, scene ) )
@@ -1423,6 +2109,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneGetSourceCount( gsSceneID sceneID, gsSize
 
 extern "C" gsBool GSOUND_EXPORT gsSceneAddSource( gsSceneID sceneID, gsSourceID sourceID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	Shared<SoundSource> source;
 	
@@ -1440,6 +2127,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneAddSource( gsSceneID sceneID, gsSourceID
 
 extern "C" gsBool GSOUND_EXPORT gsSceneRemoveSource( gsSceneID sceneID, gsSourceID sourceID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	Shared<SoundSource> source;
 	
@@ -1454,6 +2142,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneRemoveSource( gsSceneID sceneID, gsSource
 
 extern "C" gsBool GSOUND_EXPORT gsSceneClearSources( gsSceneID sceneID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	
 	if ( library->scenes.find( sceneID, scene ) )
@@ -1470,6 +2159,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneClearSources( gsSceneID sceneID )
 
 extern "C" gsBool GSOUND_EXPORT gsSceneGetListenerCount( gsSceneID sceneID, gsSize* listenerCount )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	
 	if ( listenerCount && library->scenes.find( sceneID, scene ) )
@@ -1486,6 +2176,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneGetListenerCount( gsSceneID sceneID, gsSi
 
 extern "C" gsBool GSOUND_EXPORT gsSceneAddListener( gsSceneID sceneID, gsListenerID listenerID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	Shared<SoundListener> listener;
 	
@@ -1503,6 +2194,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneAddListener( gsSceneID sceneID, gsListene
 
 extern "C" gsBool GSOUND_EXPORT gsSceneRemoveListener( gsSceneID sceneID, gsListenerID listenerID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	Shared<SoundListener> listener;
 	
@@ -1517,6 +2209,7 @@ extern "C" gsBool GSOUND_EXPORT gsSceneRemoveListener( gsSceneID sceneID, gsList
 
 extern "C" gsBool GSOUND_EXPORT gsSceneClearListeners( gsSceneID sceneID )
 {
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	Shared<SoundScene> scene;
 	
 	if ( library->scenes.find( sceneID, scene ) )
@@ -1546,7 +2239,6 @@ extern "C" gsSourceID GSOUND_EXPORT gsNewSource()
 {
 	Shared<SoundSource> source = Shared<SoundSource>::construct();
 	
-	ScopedMutex lock( library->mutex );
 	gsSourceID sourceID = library->sources.add( source );
 	
 	return sourceID;
@@ -1557,7 +2249,6 @@ extern "C" gsSourceID GSOUND_EXPORT gsNewSource()
 
 extern "C" void GSOUND_EXPORT gsDeleteSource( gsSourceID sourceID )
 {
-	ScopedMutex lock( library->mutex );
 	library->sources.remove( sourceID );
 }
 
@@ -1566,7 +2257,7 @@ extern "C" void GSOUND_EXPORT gsDeleteSource( gsSourceID sourceID )
 
 extern "C" gsBool GSOUND_EXPORT gsSourceGetPosition( gsSourceID sourceID, gsFloat* x, gsFloat* y, gsFloat* z )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1588,7 +2279,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetPosition( gsSourceID sourceID, gsFloa
 
 extern "C" gsBool GSOUND_EXPORT gsSourceSetPosition( gsSourceID sourceID, gsFloat x, gsFloat y, gsFloat z )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1605,7 +2297,7 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetPosition( gsSourceID sourceID, gsFloa
 
 extern "C" gsBool GSOUND_EXPORT gsSourceGetVelocity( gsSourceID sourceID, gsFloat* vx, gsFloat* vy, gsFloat* vz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1627,7 +2319,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetVelocity( gsSourceID sourceID, gsFloa
 
 extern "C" gsBool GSOUND_EXPORT gsSourceSetVelocity( gsSourceID sourceID, gsFloat vx, gsFloat vy, gsFloat vz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1644,7 +2337,7 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetVelocity( gsSourceID sourceID, gsFloa
 
 extern "C" gsBool GSOUND_EXPORT gsSourceGetRadius( gsSourceID sourceID, gsFloat* radius )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( radius && library->sources.find( sourceID, source ) )
@@ -1661,7 +2354,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetRadius( gsSourceID sourceID, gsFloat*
 
 extern "C" gsBool GSOUND_EXPORT gsSourceSetRadius( gsSourceID sourceID, gsFloat radius )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1679,7 +2373,7 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetRadius( gsSourceID sourceID, gsFloat
 extern "C" gsBool GSOUND_EXPORT gsSourceGetOrientation( gsSourceID sourceID, gsFloat* xx, gsFloat* xy, gsFloat* xz,
 																		gsFloat* yx, gsFloat* yy, gsFloat* yz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1705,7 +2399,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetOrientation( gsSourceID sourceID, gsF
 extern "C" gsBool GSOUND_EXPORT gsSourceSetOrientation( gsSourceID sourceID, gsFloat xx, gsFloat xy, gsFloat xz,
 																		gsFloat yx, gsFloat yy, gsFloat yz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1727,7 +2422,7 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetOrientation( gsSourceID sourceID, gsF
 
 extern "C" gsBool GSOUND_EXPORT gsSourceGetPowerLevel( gsSourceID sourceID, gsFloat* powerDBSWL )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( powerDBSWL && library->sources.find( sourceID, source ) )
@@ -1744,7 +2439,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetPowerLevel( gsSourceID sourceID, gsFl
 
 extern "C" gsBool GSOUND_EXPORT gsSourceSetPowerLevel( gsSourceID sourceID, gsFloat powerDBSWL )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1761,7 +2457,7 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetPowerLevel( gsSourceID sourceID, gsFl
 
 extern "C" gsBool GSOUND_EXPORT gsSourceGetPower( gsSourceID sourceID, gsFloat* power )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( power && library->sources.find( sourceID, source ) )
@@ -1778,7 +2474,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetPower( gsSourceID sourceID, gsFloat*
 
 extern "C" gsBool GSOUND_EXPORT gsSourceSetPower( gsSourceID sourceID, gsFloat power )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1795,7 +2492,7 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetPower( gsSourceID sourceID, gsFloat p
 
 extern "C" gsBool GSOUND_EXPORT gsSourceGetSampleRate( gsSourceID sourceID, gsSampleRate* sampleRate )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( sampleRate && library->sources.find( sourceID, source ) )
@@ -1812,7 +2509,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceGetSampleRate( gsSourceID sourceID, gsSa
 
 extern "C" gsBool GSOUND_EXPORT gsSourceSetSampleRate( gsSourceID sourceID, gsSampleRate sampleRate )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1829,7 +2527,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceSetSampleRate( gsSourceID sourceID, gsSa
 
 extern "C" gsBool GSOUND_EXPORT gsSourcePlaySound( gsSourceID sourceID, gsSoundID soundID, gsFloat volume, gsBool loop )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	Shared<om::sound::Sound> sound;
 	
@@ -1847,7 +2546,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourcePlaySound( gsSourceID sourceID, gsSoundI
 
 extern "C" gsBool GSOUND_EXPORT gsSourcePauseSound( gsSourceID sourceID, gsSoundID soundID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	Shared<om::sound::Sound> sound;
 	/*
@@ -1865,7 +2565,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourcePauseSound( gsSourceID sourceID, gsSound
 
 extern "C" gsBool GSOUND_EXPORT gsSourceResumeSound( gsSourceID sourceID, gsSoundID soundID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	Shared<om::sound::Sound> sound;
 	/*
@@ -1883,7 +2584,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceResumeSound( gsSourceID sourceID, gsSoun
 
 extern "C" gsBool GSOUND_EXPORT gsSourceStopSound( gsSourceID sourceID, gsSoundID soundID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	Shared<om::sound::Sound> sound;
 	/*
@@ -1901,7 +2603,8 @@ extern "C" gsBool GSOUND_EXPORT gsSourceStopSound( gsSourceID sourceID, gsSoundI
 
 extern "C" gsBool GSOUND_EXPORT gsSourceStopSounds( gsSourceID sourceID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	Shared<SoundSource> source;
 	
 	if ( library->sources.find( sourceID, source ) )
@@ -1916,6 +2619,27 @@ extern "C" gsBool GSOUND_EXPORT gsSourceStopSounds( gsSourceID sourceID )
 
 
 
+extern "C" gsSize GSOUND_EXPORT gsSourcesSetTransforms( const gsSourceID* sourceIDs, gsSize numSources,
+														const gsFloat* const* position, const gsFloat* const* velocity,
+														const gsFloat* const* orientation )
+{
+	ScopedSharedLock stateLock( library->stateLock );
+	return setDetectorTransforms( library->sources, sourceIDs, (Size)numSources, position, velocity, orientation );
+}
+
+
+
+
+extern "C" gsSize GSOUND_EXPORT gsSourcesGetTransforms( const gsSourceID* sourceIDs, gsSize numSources,
+														gsFloat* const* position, gsFloat* const* velocity,
+														gsFloat* const* orientation )
+{
+	return getDetectorTransforms( library->sources, sourceIDs, (Size)numSources, position, velocity, orientation );
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -1929,7 +2653,6 @@ extern "C" gsBool GSOUND_EXPORT gsSourceStopSounds( gsSourceID sourceID )
 
 extern "C" gsListenerID GSOUND_EXPORT gsNewListener()
 {
-	ScopedMutex lock( library->mutex );
 	gsListenerID listenerID = library->listeners.add( Shared<SoundListener>::construct() );
 	
 	return listenerID;
@@ -1940,7 +2663,6 @@ extern "C" gsListenerID GSOUND_EXPORT gsNewListener()
 
 extern "C" void GSOUND_EXPORT gsDeleteListener( gsListenerID listenerID )
 {
-	ScopedMutex lock( library->mutex );
 	library->listeners.remove( listenerID );
 }
 
@@ -1949,7 +2671,7 @@ extern "C" void GSOUND_EXPORT gsDeleteListener( gsListenerID listenerID )
 
 extern "C" gsBool GSOUND_EXPORT gsListenerGetPosition( gsListenerID listenerID, gsFloat* x, gsFloat* y, gsFloat* z )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -1969,7 +2691,8 @@ extern "C" gsBool GSOUND_EXPORT gsListenerGetPosition( gsListenerID listenerID,
 
 extern "C" gsBool GSOUND_EXPORT gsListenerSetPosition( gsListenerID listenerID, gsFloat x, gsFloat y, gsFloat z )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -1986,7 +2709,7 @@ extern "C" gsBool GSOUND_EXPORT gsListenerSetPosition( gsListenerID listenerID,
 
 extern "C" gsBool GSOUND_EXPORT gsListenerGetVelocity( gsListenerID listenerID, gsFloat* vx, gsFloat* vy, gsFloat* vz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -2006,7 +2729,8 @@ extern "C" gsBool GSOUND_EXPORT gsListenerGetVelocity( gsListenerID listenerID,
 
 extern "C" gsBool GSOUND_EXPORT gsListenerSetVelocity( gsListenerID listenerID, gsFloat vx, gsFloat vy, gsFloat vz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -2023,7 +2747,7 @@ extern "C" gsBool GSOUND_EXPORT gsListenerSetVelocity( gsListenerID listenerID,
 
 extern "C" gsBool GSOUND_EXPORT gsListenerGetRadius( gsListenerID listenerID, gsFloat* radius )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( radius && library->listeners.find( listenerID, listener ) )
@@ -2040,7 +2764,8 @@ extern "C" gsBool GSOUND_EXPORT gsListenerGetRadius( gsListenerID listenerID, gs
 
 extern "C" gsBool GSOUND_EXPORT gsListenerSetRadius( gsListenerID listenerID, gsFloat radius )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -2057,7 +2782,7 @@ extern "C" gsBool GSOUND_EXPORT gsListenerSetRadius( gsListenerID listenerID, gs
 
 extern "C" gsBool GSOUND_EXPORT gsListenerGetSensitivity( gsListenerID listenerID, gsFloat* sensitivity )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( sensitivity && library->listeners.find( listenerID, listener ) )
@@ -2074,7 +2799,8 @@ extern "C" gsBool GSOUND_EXPORT gsListenerGetSensitivity( gsListenerID listenerI
 
 extern "C" gsBool GSOUND_EXPORT gsListenerSetSensitivity( gsListenerID listenerID, gsFloat sensitivity )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -2092,7 +2818,7 @@ extern "C" gsBool GSOUND_EXPORT gsListenerSetSensitivity( gsListenerID listenerI
 extern "C" gsBool GSOUND_EXPORT gsListenerGetOrientation( gsListenerID listenerID, gsFloat* xx, gsFloat* xy, gsFloat* xz,
 																			gsFloat* yx, gsFloat* yy, gsFloat* yz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -2117,7 +2843,8 @@ extern "C" gsBool GSOUND_EXPORT gsListenerGetOrientation( gsListenerID listenerI
 extern "C" gsBool GSOUND_EXPORT gsListenerSetOrientation( gsListenerID listenerID, gsFloat xx, gsFloat xy, gsFloat xz,
 																			gsFloat yx, gsFloat yy, gsFloat yz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	Shared<SoundListener> listener;
 	
 	if ( library->listeners.find( listenerID, listener ) )
@@ -2137,6 +2864,27 @@ extern "C" gsBool GSOUND_EXPORT gsListenerSetOrientation( gsListenerID listenerI
 
 
 
+extern "C" gsSize GSOUND_EXPORT gsListenersSetTransforms( const gsListenerID* listenerIDs, gsSize numListeners,
+															const gsFloat* const* position, const gsFloat* const* velocity,
+															const gsFloat* const* orientation )
+{
+	ScopedSharedLock stateLock( library->stateLock );
+	return setDetectorTransforms( library->listeners, listenerIDs, (Size)numListeners, position, velocity, orientation );
+}
+
+
+
+
+extern "C" gsSize GSOUND_EXPORT gsListenersGetTransforms( const gsListenerID* listenerIDs, gsSize numListeners,
+															gsFloat* const* position, gsFloat* const* velocity,
+															gsFloat* const* orientation )
+{
+	return getDetectorTransforms( library->listeners, listenerIDs, (Size)numListeners, position, velocity, orientation );
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -2150,7 +2898,6 @@ extern "C" gsBool GSOUND_EXPORT gsListenerSetOrientation( gsListenerID listenerI
 
 extern "C" gsObjectID GSOUND_EXPORT gsNewObject()
 {
-	ScopedMutex lock( library->mutex );
 	gsObjectID objectID = library->objects.add( Shared<SoundObject>::construct() );
 	
 	return objectID;
@@ -2161,7 +2908,6 @@ extern "C" gsObjectID GSOUND_EXPORT gsNewObject()
 
 extern "C" void GSOUND_EXPORT gsDeleteObject( gsObjectID objectID )
 {
-	ScopedMutex lock( library->mutex );
 	library->objects.remove( objectID );
 }
 
@@ -2170,7 +2916,8 @@ extern "C" void GSOUND_EXPORT gsDeleteObject( gsObjectID objectID )
 
 extern "C" gsBool GSOUND_EXPORT gsObjectSetMesh( gsObjectID objectID, gsMeshID meshID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	Shared<SoundMesh> mesh;
 	
@@ -2188,7 +2935,7 @@ extern "C" gsBool GSOUND_EXPORT gsObjectSetMesh( gsObjectID objectID, gsMeshID m
 
 extern "C" gsBool GSOUND_EXPORT gsObjectGetPosition( gsObjectID objectID, gsFloat* x, gsFloat* y, gsFloat* z )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	
 	if ( library->objects.find( objectID, object ) )
@@ -2210,7 +2957,8 @@ extern "C" gsBool GSOUND_EXPORT gsObjectGetPosition( gsObjectID objectID, gsFloa
 
 extern "C" gsBool GSOUND_EXPORT gsObjectSetPosition( gsObjectID objectID, gsFloat x, gsFloat y, gsFloat z )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	
 	if ( library->objects.find( objectID, object ) )
@@ -2229,7 +2977,7 @@ extern "C" gsBool GSOUND_EXPORT gsObjectSetPosition( gsObjectID objectID, gsFloa
 extern "C" gsBool GSOUND_EXPORT gsObjectGetOrientation( gsObjectID objectID, gsFloat* xx, gsFloat* xy, gsFloat* xz,
 																		gsFloat* yx, gsFloat* yy, gsFloat* yz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	
 	if ( library->objects.find( objectID, object ) )
@@ -2256,7 +3004,8 @@ extern "C" gsBool GSOUND_EXPORT gsObjectGetOrientation( gsObjectID objectID, gsF
 extern "C" gsBool GSOUND_EXPORT gsObjectSetOrientation( gsObjectID objectID, gsFloat xx, gsFloat xy, gsFloat xz,
 																		gsFloat yx, gsFloat yy, gsFloat yz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	
 	if ( library->objects.find( objectID, object ) )
@@ -2278,7 +3027,7 @@ extern "C" gsBool GSOUND_EXPORT gsObjectSetOrientation( gsObjectID objectID, gsF
 
 extern "C" gsBool GSOUND_EXPORT gsObjectGetScale( gsObjectID objectID, gsFloat* sx, gsFloat* sy, gsFloat* sz )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	
 	if ( library->objects.find( objectID, object ) )
@@ -2300,7 +3049,8 @@ extern "C" gsBool GSOUND_EXPORT gsObjectGetScale( gsObjectID objectID, gsFloat*
 
 extern "C" gsBool GSOUND_EXPORT gsObjectSetScale( gsObjectID objectID, gsFloat scaleX, gsFloat scaleY, gsFloat scaleZ )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedSharedLock stateLock( library->stateLock );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	Shared<SoundObject> object;
 	
 	if ( library->objects.find( objectID, object ) )
@@ -2328,7 +3078,6 @@ extern "C" gsBool GSOUND_EXPORT gsObjectSetScale( gsObjectID objectID, gsFloat s
 
 extern "C" gsMeshID GSOUND_EXPORT gsNewMesh()
 {
-	ScopedMutex lock( library->mutex );
 	gsMeshID meshID = library->meshes.add( Shared<SoundMesh>::construct() );
 	
 	return meshID;
@@ -2339,7 +3088,6 @@ extern "C" gsMeshID GSOUND_EXPORT gsNewMesh()
 
 extern "C" void GSOUND_EXPORT gsDeleteMesh( gsMeshID meshID )
 {
-	ScopedMutex lock( library->mutex );
 	library->meshes.remove( meshID );
 }
 
@@ -2355,7 +3103,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshSetData( gsMeshID meshID, gsSystemID syste
 	Shared<SoundPropagationSystem> system;
 	Shared<MeshRequest> meshRequest;
 	
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshes.getMutex( meshID ) );
 	
 	if ( vertices && triangles &&
 		library->meshes.find( meshID, mesh ) &&
@@ -2396,7 +3144,7 @@ extern "C" gsBool GSOUND_EXPORT gsMeshSetData( gsMeshID meshID, gsSystemID syste
 
 extern "C" gsBool GSOUND_EXPORT gsMeshSetMaterial( gsMeshID meshID, gsIndex materialIndex, gsMaterialID materialID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshes.getMutex( meshID ) );
 	Shared<SoundMesh> mesh;
 	Shared<SoundMaterial> material;
 	
@@ -2425,7 +3173,6 @@ extern "C" gsBool GSOUND_EXPORT gsMeshSetMaterial( gsMeshID meshID, gsIndex mate
 
 extern "C" gsMaterialID GSOUND_EXPORT gsNewMaterial()
 {
-	ScopedMutex lock( library->mutex );
 	gsMaterialID materialID = library->materials.add( Shared<SoundMaterial>::construct() );
 	
 	return materialID;
@@ -2436,7 +3183,6 @@ extern "C" gsMaterialID GSOUND_EXPORT gsNewMaterial()
 
 extern "C" void GSOUND_EXPORT gsDeleteMaterial( gsMaterialID materialID )
 {
-	ScopedMutex lock( library->mutex );
 	library->materials.remove( materialID );
 }
 
@@ -2446,7 +3192,7 @@ extern "C" void GSOUND_EXPORT gsDeleteMaterial( gsMaterialID materialID )
 extern "C" gsBool GSOUND_EXPORT gsMaterialGet( gsMaterialID materialID, gsResponseType responseType, gsFloat frequency, gsFloat* value )
 {
 	Shared<SoundMaterial> material;
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->materials.getMutex( materialID ) );
 	
 	if ( value && library->materials.find( materialID, material ) )
 	{
@@ -2470,7 +3216,7 @@ extern "C" gsBool GSOUND_EXPORT gsMaterialGet( gsMaterialID materialID, gsRespon
 extern "C" gsBool GSOUND_EXPORT gsMaterialSet( gsMaterialID materialID, gsResponseType responseType, gsFloat frequency, gsFloat value )
 {
 	Shared<SoundMaterial> material;
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->materials.getMutex( materialID ) );
 	
 	if ( value && library->materials.find( materialID, material ) )
 	{
@@ -2494,7 +3240,7 @@ extern "C" gsBool GSOUND_EXPORT gsMaterialSet( gsMaterialID materialID, gsRespon
 extern "C" gsBool GSOUND_EXPORT gsMaterialReset( gsMaterialID materialID, gsResponseType responseType, gsFloat value )
 {
 	Shared<SoundMaterial> material;
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->materials.getMutex( materialID ) );
 	
 	if ( value && library->materials.find( materialID, material ) )
 	{
@@ -2528,7 +3274,6 @@ extern "C" gsBool GSOUND_EXPORT gsMaterialReset( gsMaterialID materialID, gsResp
 
 extern "C" gsSoundID GSOUND_EXPORT gsNewSound()
 {
-	ScopedMutex lock( library->mutex );
 	gsSoundID soundID = library->sounds.add( Shared<om::sound::Sound>::construct() );
 	
 	return soundID;
@@ -2539,7 +3284,6 @@ extern "C" gsSoundID GSOUND_EXPORT gsNewSound()
 
 extern "C" void GSOUND_EXPORT gsDeleteSound( gsSoundID soundID )
 {
-	ScopedMutex lock( library->mutex );
 	library->sounds.remove( soundID );
 }
 
@@ -2548,13 +3292,14 @@ extern "C" void GSOUND_EXPORT gsDeleteSound( gsSoundID soundID )
 
 extern "C" gsBool GSOUND_EXPORT gsSoundSetFile( gsSoundID soundID, const char* filePath, gsBool streaming )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sounds.getMutex( soundID ) );
 	Shared<om::sound::Sound> sound;
 	
 	if ( filePath && library->sounds.find( soundID, sound ) )
 	{
 		om::UTF8String path( filePath );
 		om::resources::ResourceID resID( path );
+		ScopedMutex resourceLock( library->mutex );
 		om::resources::ResourceManager& resourceManager = library->getResourceManager();
 		om::resources::Resource<om::sound::Sound> resource = resourceManager.load<om::sound::Sound>( resID );
 		
@@ -2578,7 +3323,7 @@ extern "C" gsBool GSOUND_EXPORT gsSoundSetFile( gsSoundID soundID, const char* f
 extern "C" gsBool GSOUND_EXPORT gsSoundSetData( gsSoundID soundID, const gsFloat* samples, gsSize numChannels,
 												gsSize numSamples, gsSampleRate sampleRate )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sounds.getMutex( soundID ) );
 	Shared<om::sound::Sound> sound;
 	
 	if ( samples && library->sounds.find( soundID, sound ) )
@@ -2623,7 +3368,6 @@ extern "C" gsBool GSOUND_EXPORT gsSoundSetData( gsSoundID soundID, const gsFloat
 
 extern "C" gsHRTFID GSOUND_EXPORT gsNewHRTF()
 {
-	ScopedMutex lock( library->mutex );
 	gsHRTFID hrtfID = library->hrtfs.add( Shared<om::sound::HRTF>::construct() );
 	
 	return hrtfID;
@@ -2634,7 +3378,6 @@ extern "C" gsHRTFID GSOUND_EXPORT gsNewHRTF()
 
 extern "C" void GSOUND_EXPORT gsDeleteHRTF( gsHRTFID hrtfID )
 {
-	ScopedMutex lock( library->mutex );
 	library->hrtfs.remove( hrtfID );
 }
 
@@ -2643,13 +3386,14 @@ extern "C" void GSOUND_EXPORT gsDeleteHRTF( gsHRTFID hrtfID )
 
 extern "C" gsBool GSOUND_EXPORT gsHRTFSetFile( gsHRTFID hrtfID, const char* filePath )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->hrtfs.getMutex( hrtfID ) );
 	Shared<om::sound::HRTF> hrtf;
 	
 	if ( filePath && library->hrtfs.find( hrtfID, hrtf ) )
 	{
 		om::UTF8String path( filePath );
 		om::resources::ResourceID resID( path );
+		ScopedMutex resourceLock( library->mutex );
 		om::resources::ResourceManager& resourceManager = library->getResourceManager();
 		om::resources::Resource<om::sound::HRTF> resource = resourceManager.load<om::sound::HRTF>( resID );
 		
@@ -2679,7 +3423,7 @@ extern "C" gsBool GSOUND_EXPORT gsHRTFSetFile( gsHRTFID hrtfID, const char* file
 
 PropagationRequest* gsGetRequest( gsRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->requests.getMutex( requestID ) );
 	
 	Shared<PropagationRequest> request;
 	library->requests.find( requestID, request );
@@ -2692,7 +3436,7 @@ PropagationRequest* gsGetRequest( gsRequestID requestID )
 
 RenderRequest* gsGetRenderRequest( gsRenderRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->renderRequests.getMutex( requestID ) );
 	
 	Shared<RenderRequest> request;
 	library->renderRequests.find( requestID, request );
@@ -2705,7 +3449,7 @@ RenderRequest* gsGetRenderRequest( gsRenderRequestID requestID )
 
 MeshRequest* gsGetMeshRequest( gsMeshRequestID requestID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshRequests.getMutex( requestID ) );
 	
 	Shared<MeshRequest> request;
 	library->meshRequests.find( requestID, request );
@@ -2718,7 +3462,6 @@ MeshRequest* gsGetMeshRequest( gsMeshRequestID requestID )
 
 SoundPropagationSystem* gsGetSystem( gsSystemID systemID )
 {
-	ScopedMutex lock( library->mutex );
 	
 	Shared<SoundPropagationSystem> system;
 	library->systems.find( systemID, system );
@@ -2731,7 +3474,7 @@ SoundPropagationSystem* gsGetSystem( gsSystemID systemID )
 
 SoundScene* gsGetScene( gsSceneID sceneID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->scenes.getMutex( sceneID ) );
 	
 	Shared<SoundScene> scene;
 	library->scenes.find( sceneID, scene );
@@ -2743,7 +3486,7 @@ SoundScene* gsGetScene( gsSceneID sceneID )
 
 SoundSource* gsGetSource( gsSourceID sourceID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->sources.getMutex( sourceID ) );
 	
 	Shared<SoundSource> source;
 	library->sources.find( sourceID, source );
@@ -2756,7 +3499,7 @@ SoundSource* gsGetSource( gsSourceID sourceID )
 
 SoundListener* gsGetListener( gsListenerID listenerID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->listeners.getMutex( listenerID ) );
 	
 	Shared<SoundListener> listener;
 	library->listeners.find( listenerID, listener );
@@ -2769,7 +3512,7 @@ SoundListener* gsGetListener( gsListenerID listenerID )
 
 SoundObject* gsGetObject( gsObjectID objectID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->objects.getMutex( objectID ) );
 	
 	Shared<SoundObject> object;
 	library->objects.find( objectID, object );
@@ -2782,7 +3525,7 @@ SoundObject* gsGetObject( gsObjectID objectID )
 
 SoundMesh* gsGetMesh( gsMeshID meshID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->meshes.getMutex( meshID ) );
 	
 	Shared<SoundMesh> mesh;
 	library->meshes.find( meshID, mesh );
@@ -2795,7 +3538,7 @@ SoundMesh* gsGetMesh( gsMeshID meshID )
 
 SoundMaterial* gsGetMaterial( gsMaterialID materialID )
 {
-	ScopedMutex lock( library->mutex );
+	ScopedObjectLock lock( library->materials.getMutex( materialID ) );
 	
 	Shared<SoundMaterial> material;
 	library->materials.find( materialID, material );
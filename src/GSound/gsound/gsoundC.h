@@ -463,7 +463,20 @@ typedef enum
 	  *
 	  * If enabled, the mesh's surface is simplified based on the simplification tolerance parameter.
 	  */
-	GS_SIMPLIFIY = 28
+	GS_SIMPLIFIY = 28,
+	
+	/**********************************************************************************/
+	/* Additional Rendering Flags */
+	
+	/**
+	  * \brief A flag which indicates whether or not hybrid convolution and late reverb rendering should be used.
+	  *
+	  * If enabled, only the early part of each IR (see GS_EARLY_IR_LENGTH) is rendered
+	  * using convolution, while the late part is rendered by a single feedback delay network
+	  * for the listener whose decay time and level are estimated from the late IR energy.
+	  * This reduces the rendering cost significantly for long reverberant IRs.
+	  */
+	GS_LATE_REVERB = 29
 	
 } gsFlag;
 
@@ -753,6 +766,15 @@ typedef enum
 	  */
 	GS_RAY_OFFSET = 34,
 	
+	/**
+	  * \brief The number of propagation frames that the specular and diffuse ray budgets are spread over.
+	  *
+	  * Each frame traces 1/GS_RAY_SLICE_COUNT of the specular and diffuse rays, and the results
+	  * accumulate in the propagation caches. This makes the cost of each frame smaller and more uniform.
+	  * A propagation system propagates this many frames per target time step. The default value is 1.
+	  */
+	GS_RAY_SLICE_COUNT = 48,
+	
 	
 	/**********************************************************************************/
 	/* Caching Parameters */
@@ -841,7 +863,18 @@ typedef enum
 	GS_DIFFUSE_RESOLUTION = 45,
 	
 	/** \brief The number of threads to use to compute a mesh preprocessing request. */
-	GS_PREPROCESS_THREAD_COUNT = 46
+	GS_PREPROCESS_THREAD_COUNT = 46,
+	
+	/**********************************************************************************/
+	/* Additional Rendering Parameters */
+	
+	/**
+	  * \brief The length in seconds of the early part of the IR that is rendered using convolution.
+	  *
+	  * This parameter only has an effect if the GS_LATE_REVERB flag is set.
+	  * The rest of the IR is rendered using a feedback delay network.
+	  */
+	GS_EARLY_IR_LENGTH = 47
 	
 } gsParameter;
 
@@ -1047,6 +1080,18 @@ gsBool GSOUND_EXPORT gsSystemRemoveListener( gsSystemID systemID, gsListenerID l
 gsBool GSOUND_EXPORT gsSystemReadSamples( gsSystemID systemID, gsListenerID listenerID,
 											gsFloat* samples, gsSize numSamples, gsSize numChannels );
 
+/**
+  * \brief Read back a summary of the last computed IR for an array of sources.
+  *
+  * For each source in the sourceIDs array, the number of paths, the IR length in seconds,
+  * and the reverb time in seconds of the IR for that source's cluster are written to
+  * the corresponding entry of each non-NULL output array. Sources that have no IR for the listener
+  * have their outputs set to 0. The function returns the number of sources that had an IR.
+  */
+gsSize GSOUND_EXPORT gsSystemGetSourceIRs( gsSystemID systemID, gsListenerID listenerID,
+											const gsSourceID* sourceIDs, gsSize numSources,
+											gsSize* pathCounts, gsFloat* irLengths, gsFloat* reverbTimes );
+
 
 
 
@@ -1119,7 +1164,7 @@ gsBool GSOUND_EXPORT gsRequestSetParamF( gsRequestID requestID, gsParameter para
   * GS_PROPAGATION_THREAD_COUNT, GS_DIRECT_RAY_COUNT, GS_DIFFRACTION_MAX_DEPTH,
   * GS_DIFFRACTION_MAX_ORDER, GS_SPECULAR_MAX_DEPTH, GS_SPECULAR_RAY_COUNT,
   * GS_SPECULAR_SAMPLE_COUNT, GS_DIFFUSE_MAX_DEPTH, GS_DIFFUSE_RAY_COUNT,
-  * GS_DIFFUSE_SAMPLE_COUNT, GS_VISIBILITY_RAY_COUNT.
+  * GS_DIFFUSE_SAMPLE_COUNT, GS_VISIBILITY_RAY_COUNT, GS_RAY_SLICE_COUNT.
   */
 gsBool GSOUND_EXPORT gsRequestGetParamI( gsRequestID requestID, gsParameter parameter, gsSize* value );
 
@@ -1129,7 +1174,7 @@ gsBool GSOUND_EXPORT gsRequestGetParamI( gsRequestID requestID, gsParameter para
   * GS_PROPAGATION_THREAD_COUNT, GS_DIRECT_RAY_COUNT, GS_DIFFRACTION_MAX_DEPTH,
   * GS_DIFFRACTION_MAX_ORDER, GS_SPECULAR_MAX_DEPTH, GS_SPECULAR_RAY_COUNT,
   * GS_SPECULAR_SAMPLE_COUNT, GS_DIFFUSE_MAX_DEPTH, GS_DIFFUSE_RAY_COUNT,
-  * GS_DIFFUSE_SAMPLE_COUNT, GS_VISIBILITY_RAY_COUNT.
+  * GS_DIFFUSE_SAMPLE_COUNT, GS_VISIBILITY_RAY_COUNT, GS_RAY_SLICE_COUNT.
   */
 gsBool GSOUND_EXPORT gsRequestSetParamI( gsRequestID requestID, gsParameter parameter, gsSize value );
 
@@ -1160,7 +1205,7 @@ void GSOUND_EXPORT gsDeleteRenderRequest( gsRenderRequestID requestID );
   * \brief Get the value of a boolean flag for the specified render request.
   *
   * The function responds to the following flags:
-  * GS_CONVOLUTION, GS_DISCRETE_PATHS.
+  * GS_CONVOLUTION, GS_DISCRETE_PATHS, GS_HRTF, GS_LATE_REVERB.
   */
 gsBool GSOUND_EXPORT gsRenderRequestGetFlag( gsRenderRequestID requestID, gsFlag flag, gsBool* value );
 
@@ -1168,7 +1213,7 @@ gsBool GSOUND_EXPORT gsRenderRequestGetFlag( gsRenderRequestID requestID, gsFlag
   * \brief Set the value of a boolean flag for the specified render request.
   *
   * The function responds to the following flags:
-  * GS_CONVOLUTION, GS_DISCRETE_PATHS.
+  * GS_CONVOLUTION, GS_DISCRETE_PATHS, GS_HRTF, GS_LATE_REVERB.
   */
 gsBool GSOUND_EXPORT gsRenderRequestSetFlag( gsRenderRequestID requestID, gsFlag flag, gsBool value );
 
@@ -1178,7 +1223,7 @@ gsBool GSOUND_EXPORT gsRenderRequestSetFlag( gsRenderRequestID requestID, gsFlag
   * The function responds to the following parameters:
   * GS_SAMPLE_RATE, GS_IR_MAX_LENGTH, GS_MAX_LATENCY, GS_MAX_PATH_DELAY, GS_IR_FADE_TIME,
   * GS_PATH_FADE_TIME, GS_SOURCE_FADE_TIME, GS_CLUSTER_FADE_IN_TIME, GS_CLUSTER_FADE_OUT_TIME,
-  * GS_VOLUME.
+  * GS_VOLUME, GS_EARLY_IR_LENGTH.
   */
 gsBool GSOUND_EXPORT gsRenderRequestGetParamF( gsRenderRequestID requestID, gsParameter parameter, gsFloat* value );
 
@@ -1188,7 +1233,7 @@ gsBool GSOUND_EXPORT gsRenderRequestGetParamF( gsRenderRequestID requestID, gsPa
   * The function responds to the following parameters:
   * GS_SAMPLE_RATE, GS_IR_MAX_LENGTH, GS_MAX_LATENCY, GS_MAX_PATH_DELAY, GS_IR_FADE_TIME,
   * GS_PATH_FADE_TIME, GS_SOURCE_FADE_TIME, GS_CLUSTER_FADE_IN_TIME, GS_CLUSTER_FADE_OUT_TIME,
-  * GS_VOLUME.
+  * GS_VOLUME, GS_EARLY_IR_LENGTH.
   */
 gsBool GSOUND_EXPORT gsRenderRequestSetParamF( gsRenderRequestID requestID, gsParameter parameter, gsFloat value );
 
@@ -1438,6 +1483,33 @@ gsBool GSOUND_EXPORT gsSourceStopSound( gsSourceID sourceID, gsSoundID soundID )
 /** \brief Stop playing the all sounds through the given source. */
 gsBool GSOUND_EXPORT gsSourceStopSounds( gsSourceID sourceID );
 
+/**
+  * \brief Set the transforms of an array of sound sources in one call.
+  *
+  * The transform data uses a structure-of-arrays layout: position is an array of 3 pointers
+  * to the x, y, and z coordinate arrays, velocity is an array of 3 pointers to the vx, vy,
+  * and vz arrays, and orientation is an array of 6 pointers to the xx, xy, xz, yx, yy, and yz
+  * arrays. Each coordinate array has numSources entries. If position, velocity, or orientation
+  * is NULL, that part of the transforms is not changed.
+  *
+  * The function returns the number of sources that were updated. Invalid source IDs are skipped.
+  */
+gsSize GSOUND_EXPORT gsSourcesSetTransforms( const gsSourceID* sourceIDs, gsSize numSources,
+												const gsFloat* const* position, const gsFloat* const* velocity,
+												const gsFloat* const* orientation );
+
+/**
+  * \brief Get the transforms of an array of sound sources in one call.
+  *
+  * The output uses the same structure-of-arrays layout as gsSourcesSetTransforms().
+  * If position, velocity, or orientation is NULL, that part of the transforms is not written.
+  *
+  * The function returns the number of sources that were read. Invalid source IDs are skipped.
+  */
+gsSize GSOUND_EXPORT gsSourcesGetTransforms( const gsSourceID* sourceIDs, gsSize numSources,
+												gsFloat* const* position, gsFloat* const* velocity,
+												gsFloat* const* orientation );
+
 
 
 
@@ -1490,6 +1562,26 @@ gsBool GSOUND_EXPORT gsListenerGetOrientation( gsListenerID listenerID, gsFloat*
 gsBool GSOUND_EXPORT gsListenerSetOrientation( gsListenerID listenerID, gsFloat xx, gsFloat xy, gsFloat xz,
 																		gsFloat yx, gsFloat yy, gsFloat yz );
 
+/**
+  * \brief Set the transforms of an array of sound listeners in one call.
+  *
+  * The transform data uses the same structure-of-arrays layout as gsSourcesSetTransforms().
+  * The function returns the number of listeners that were updated. Invalid listener IDs are skipped.
+  */
+gsSize GSOUND_EXPORT gsListenersSetTransforms( const gsListenerID* listenerIDs, gsSize numListeners,
+												const gsFloat* const* position, const gsFloat* const* velocity,
+												const gsFloat* const* orientation );
+
+/**
+  * \brief Get the transforms of an array of sound listeners in one call.
+  *
+  * The output uses the same structure-of-arrays layout as gsSourcesSetTransforms().
+  * The function returns the number of listeners that were read. Invalid listener IDs are skipped.
+  */
+gsSize GSOUND_EXPORT gsListenersGetTransforms( const gsListenerID* listenerIDs, gsSize numListeners,
+												gsFloat* const* position, gsFloat* const* velocity,
+												gsFloat* const* orientation );
+
 
 
 
@@ -0,0 +1,363 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/internal/gsFDNReverb.cpp
+ * Contents:    gsound::internal::FDNReverb class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+
+#include "gsFDNReverb.h"
+
+
+//##########################################################################################
+//**************************  Start GSound Internal Namespace  *****************************
+GSOUND_INTERNAL_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+/// The nominal delay times in seconds of the delay lines, before they are rounded to prime lengths.
+static const Float DELAY_TIMES[FDNReverb::NUMBER_OF_DELAY_LINES] =
+{
+	0.0313f, 0.0379f, 0.0417f, 0.0461f, 0.0533f, 0.0591f, 0.0667f, 0.0737f
+};
+
+
+
+
+/// Return whether or not the specified number is prime.
+GSOUND_INLINE static Bool isPrime( Size n )
+{
+	if ( n < 2 )
+		return false;
+	
+	for ( Size i = 2; i*i <= n; i++ )
+	{
+		if ( n % i == 0 )
+			return false;
+	}
+	
+	return true;
+}
+
+
+
+
+/// Apply an in-place unnormalized 8x8 Hadamard transform to the specified values.
+template < typename T >
+GSOUND_FORCE_INLINE static void hadamard( T* v )
+{
+	for ( Index stride = 1; stride < FDNReverb::NUMBER_OF_DELAY_LINES; stride <<= 1 )
+	{
+		for ( Index i = 0; i < FDNReverb::NUMBER_OF_DELAY_LINES; i += 2*stride )
+		{
+			for ( Index j = i; j < i + stride; j++ )
+			{
+				const T a = v[j];
+				const T b = v[j + stride];
+				v[j] = a + b;
+				v[j + stride] = a - b;
+			}
+		}
+	}
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Constructor
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+FDNReverb:: FDNReverb()
+	:	decayTime( 1.0f ),
+		energyGain( 1.0f ),
+		preDelayInSamples( 0 ),
+		preDelayPosition( 0 ),
+		sampleRate( 0 )
+{
+	this->setSampleRate( SampleRate(44100) );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Parameter Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void FDNReverb:: setSampleRate( SampleRate newSampleRate )
+{
+	if ( newSampleRate <= SampleRate(0) || newSampleRate == sampleRate )
+		return;
+	
+	const SampleRate oldSampleRate = sampleRate;
+	sampleRate = newSampleRate;
+	
+	//******************************************************************************
+	// Choose a distinct prime length for each delay line so that the lengths are mutually prime.
+	
+	Size totalLength = 0;
+	
+	for ( Index i = 0; i < NUMBER_OF_DELAY_LINES; i++ )
+	{
+		Size length = math::max( (Size)math::round( DELAY_TIMES[i]*sampleRate ), Size(2) );
+		
+		if ( i > 0 && length <= delayLengths[i-1] )
+			length = delayLengths[i-1] + 1;
+		
+		while ( !isPrime( length ) )
+			length++;
+		
+		delayLengths[i] = length;
+		delayOffsets[i] = totalLength;
+		delayPositions[i] = 0;
+		totalLength += length;
+	}
+	
+	delayBuffer.setFormat( 1, totalLength*SIMDBands::getWidth() );
+	delayBuffer.allocate();
+	
+	//******************************************************************************
+	// Keep the same pre-delay time at the new sample rate.
+	
+	if ( oldSampleRate > SampleRate(0) )
+	{
+		const Float preDelay = Float(preDelayInSamples / oldSampleRate);
+		preDelayInSamples = 0;
+		this->setPreDelay( preDelay );
+	}
+	
+	this->updateGains();
+	this->reset();
+}
+
+
+
+
+void FDNReverb:: setDecayTime( const SIMDBands& newDecayTime )
+{
+	decayTime = math::max( newDecayTime, SIMDBands(0.01f) );
+	
+	this->updateGains();
+}
+
+
+
+
+void FDNReverb:: setPreDelay( Float newPreDelay )
+{
+	const Size newPreDelayInSamples = (Size)math::round( math::max( newPreDelay, Float(0) )*sampleRate );
+	
+	if ( newPreDelayInSamples == preDelayInSamples && preDelayBuffer.isAllocated() )
+		return;
+	
+	preDelayInSamples = newPreDelayInSamples;
+	preDelayPosition = 0;
+	
+	preDelayBuffer.setFormat( 1, (preDelayInSamples + 1)*SIMDBands::getWidth() );
+	preDelayBuffer.allocate();
+	preDelayBuffer.zero();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Gain Update Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void FDNReverb:: updateGains()
+{
+	const Float32 matrixNormalize = Float32(1) / math::sqrt( Float32(NUMBER_OF_DELAY_LINES) );
+	SIMDBands energySum( 0.0f );
+	
+	for ( Index i = 0; i < NUMBER_OF_DELAY_LINES; i++ )
+	{
+		// Compute the gain so that the energy decays by 60 dB after the decay time.
+		const SIMDBands gain = math::pow( SIMDBands(10.0f), SIMDBands(-3.0f*Float32(delayLengths[i]/sampleRate)) / decayTime );
+		
+		// Fold the feedback matrix normalization into the gain.
+		feedbackGains[i] = gain*matrixNormalize;
+		
+		// Each pass through a delay line scales the energy by the gain squared.
+		energySum += SIMDBands(1.0f) / (SIMDBands(1.0f) - gain*gain);
+	}
+	
+	energyGain = energySum / Float32(NUMBER_OF_DELAY_LINES);
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Processing Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void FDNReverb:: process( const SIMDBands* input, SoundBuffer& outputBuffer, Size numChannels, Size numSamples )
+{
+	if ( !delayBuffer.isAllocated() || numChannels == 0 )
+		return;
+	
+	if ( !preDelayBuffer.isAllocated() )
+		this->setPreDelay( 0 );
+	
+	UInt flushMode = _MM_GET_FLUSH_ZERO_MODE();
+	_MM_SET_FLUSH_ZERO_MODE( _MM_FLUSH_ZERO_ON );
+	
+	// Get the output channel pointers.
+	ShortArrayList<Sample32f*,8> outputs;
+	
+	for ( Index c = 0; c < numChannels; c++ )
+		outputs.add( outputBuffer.getChannel(c) );
+	
+	// Distribute the input energy equally among the delay lines.
+	const Float32 inputGain = Float32(1) / math::sqrt( Float32(NUMBER_OF_DELAY_LINES) );
+	
+	// Normalize the output so that the total energy is independent of the channel count.
+	const Float32 outputGain = Float32(1) / math::sqrt( Float32(numChannels) );
+	
+	SIMDBands* const lines = (SIMDBands*)delayBuffer.getChannel(0);
+	SIMDBands* const preDelay = (SIMDBands*)preDelayBuffer.getChannel(0);
+	const Size preDelayLength = preDelayInSamples + 1;
+	SIMDBands values[NUMBER_OF_DELAY_LINES];
+	Float32 taps[NUMBER_OF_DELAY_LINES];
+	
+	for ( Index n = 0; n < numSamples; n++ )
+	{
+		//******************************************************************************
+		// Delay the input.
+		
+		preDelay[preDelayPosition] = input[n];
+		preDelayPosition = (preDelayPosition + 1 == preDelayLength) ? 0 : preDelayPosition + 1;
+		
+		const SIMDBands delayedInput = preDelay[preDelayPosition]*inputGain;
+		
+		//******************************************************************************
+		// Read the output of each delay line.
+		
+		for ( Index i = 0; i < NUMBER_OF_DELAY_LINES; i++ )
+		{
+			values[i] = lines[delayOffsets[i] + delayPositions[i]];
+			taps[i] = math::sumScalar( values[i] );
+		}
+		
+		//******************************************************************************
+		// Mix the delay line outputs to each output channel with decorrelated sign patterns.
+		
+		hadamard( taps );
+		
+		for ( Index c = 0; c < numChannels; c++ )
+			outputs[c][n] += outputGain*taps[(c % (NUMBER_OF_DELAY_LINES - 1)) + 1];
+		
+		//******************************************************************************
+		// Apply the frequency-dependent decay and feedback matrix, then write back to the delay lines.
+		
+		for ( Index i = 0; i < NUMBER_OF_DELAY_LINES; i++ )
+			values[i] *= feedbackGains[i];
+		
+		hadamard( values );
+		
+		for ( Index i = 0; i < NUMBER_OF_DELAY_LINES; i++ )
+		{
+			lines[delayOffsets[i] + delayPositions[i]] = values[i] + delayedInput;
+			delayPositions[i] = (delayPositions[i] + 1 == delayLengths[i]) ? 0 : delayPositions[i] + 1;
+		}
+	}
+	
+	_MM_SET_FLUSH_ZERO_MODE( flushMode );
+}
+
+
+
+
+void FDNReverb:: reset()
+{
+	delayBuffer.zero();
+	preDelayBuffer.zero();
+	preDelayPosition = 0;
+	
+	for ( Index i = 0; i < NUMBER_OF_DELAY_LINES; i++ )
+		delayPositions[i] = 0;
+}
+
+
+
+
+//##########################################################################################
+//**************************  End GSound Internal Namespace  *******************************
+GSOUND_INTERNAL_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,273 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/internal/gsFDNReverb.h
+ * Contents:    gsound::internal::FDNReverb class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+
+#ifndef INCLUDE_GSOUND_FDN_REVERB_H
+#define INCLUDE_GSOUND_FDN_REVERB_H
+
+
+#include "gsInternalConfig.h"
+
+
+#include "gsSampleBuffer.h"
+
+
+//##########################################################################################
+//**************************  Start GSound Internal Namespace  *****************************
+GSOUND_INTERNAL_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that renders a late reverberation tail using a frequency-dependent feedback delay network.
+/**
+  * The network consists of 8 delay lines with mutually-prime lengths that are coupled
+  * through a normalized Hadamard feedback matrix. Each delay line stores interleaved
+  * SIMD frequency bands so that every band has its own decay time. The input to the
+  * network should be band-split (e.g. by a SIMDCrossover), and the band outputs are
+  * summed and distributed among the output channels using decorrelated output taps.
+  *
+  * The cost of the network is independent of the reverberation time, unlike
+  * convolution, and so it is used to render the late part of long impulse responses.
+  */
+class GSOUND_ALIGN(16) FDNReverb
+{
+	public:
+		
+		//********************************************************************************
+		//******	Public Constants
+			
+			
+			/// The number of delay lines in the feedback delay network.
+			static const Size NUMBER_OF_DELAY_LINES = 8;
+			
+			
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new feedback delay network reverb with the default sample rate of 44.1 kHz.
+			FDNReverb();
+			
+			
+		//********************************************************************************
+		//******	Sample Rate Accessor Methods
+			
+			
+			/// Return the sample rate of this reverb in samples per second.
+			GSOUND_INLINE SampleRate getSampleRate() const
+			{
+				return sampleRate;
+			}
+			
+			
+			/// Set the sample rate of this reverb in samples per second.
+			/**
+			  * This method recomputes the delay line lengths and causes the reverb to be reset.
+			  */
+			void setSampleRate( SampleRate newSampleRate );
+			
+			
+		//********************************************************************************
+		//******	Decay Time Accessor Methods
+			
+			
+			/// Return the -60 dB decay time in seconds for each frequency band.
+			GSOUND_INLINE const SIMDBands& getDecayTime() const
+			{
+				return decayTime;
+			}
+			
+			
+			/// Set the -60 dB decay time in seconds for each frequency band.
+			/**
+			  * The feedback gains for the delay lines are recomputed so that the
+			  * energy of the network decays at the requested rate in each band.
+			  */
+			void setDecayTime( const SIMDBands& newDecayTime );
+			
+			
+			/// Return the total output energy for each band that results from a unit-energy input impulse.
+			/**
+			  * This value can be used to normalize the input gain of the network
+			  * so that the output has a desired energy.
+			  */
+			GSOUND_INLINE const SIMDBands& getEnergyGain() const
+			{
+				return energyGain;
+			}
+			
+			
+		//********************************************************************************
+		//******	Delay Time Accessor Methods
+			
+			
+			/// Return the delay in seconds that is applied to the input before it enters the network.
+			GSOUND_INLINE Float getPreDelay() const
+			{
+				return Float(preDelayInSamples / sampleRate);
+			}
+			
+			
+			/// Set the delay in seconds that is applied to the input before it enters the network.
+			void setPreDelay( Float newPreDelay );
+			
+			
+			/// Return the delay in seconds of the shortest delay line in the network.
+			/**
+			  * This is the time after the pre-delay when the first output from
+			  * the network is produced.
+			  */
+			GSOUND_INLINE Float getMinDelayTime() const
+			{
+				return Float(delayLengths[0] / sampleRate);
+			}
+			
+			
+		//********************************************************************************
+		//******	Processing Methods
+			
+			
+			/// Process the specified number of samples of interleaved band input, mixing the result into the output buffer.
+			/**
+			  * The input buffer must contain numSamples band-interleaved SIMD samples.
+			  * The output of the network is added to the first numChannels channels of the output buffer.
+			  */
+			void process( const SIMDBands* input, SoundBuffer& outputBuffer, Size numChannels, Size numSamples );
+			
+			
+			/// Reset the internal state of the reverb, zeroing the contents of the delay lines.
+			void reset();
+			
+			
+		//********************************************************************************
+		//******	Size Accessor Method
+			
+			
+			/// Return the approximate size in bytes of the memory used by this reverb.
+			GSOUND_INLINE Size getSizeInBytes() const
+			{
+				return sizeof(FDNReverb) + delayBuffer.getSizeInBytes() + preDelayBuffer.getSizeInBytes();
+			}
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Recompute the feedback gain and energy gain for each delay line.
+			void updateGains();
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// The feedback gain for each delay line and frequency band.
+			SIMDBands feedbackGains[NUMBER_OF_DELAY_LINES];
+			
+			
+			/// The -60 dB decay time in seconds for each frequency band.
+			SIMDBands decayTime;
+			
+			
+			/// The total output energy for each band that results from a unit-energy input impulse.
+			SIMDBands energyGain;
+			
+			
+			/// A buffer containing the storage for all of the delay lines, one after another.
+			SampleBuffer<Float32> delayBuffer;
+			
+			
+			/// A buffer containing the pre-delay line for the network's input.
+			SampleBuffer<Float32> preDelayBuffer;
+			
+			
+			/// The length in samples of each delay line, in increasing order.
+			Size delayLengths[NUMBER_OF_DELAY_LINES];
+			
+			
+			/// The offset in samples of the start of each delay line within the delay buffer.
+			Index delayOffsets[NUMBER_OF_DELAY_LINES];
+			
+			
+			/// The current read/write position within each delay line.
+			Index delayPositions[NUMBER_OF_DELAY_LINES];
+			
+			
+			/// The number of samples of pre-delay that are applied to the input.
+			Size preDelayInSamples;
+			
+			
+			/// The current write position within the pre-delay line.
+			Index preDelayPosition;
+			
+			
+			/// The sample rate of this reverb.
+			SampleRate sampleRate;
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//**************************  End GSound Internal Namespace  *******************************
+GSOUND_INTERNAL_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_FDN_REVERB_H
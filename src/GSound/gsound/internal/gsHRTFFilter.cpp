@@ -11,6 +11,14 @@
 
 
 #include "fftw3.h"
+#include <cstring>
+
+
+#if defined(OM_PLATFORM_APPLE) || defined(OM_PLATFORM_LINUX)
+	#include <unistd.h>
+#elif defined(OM_PLATFORM_WINDOWS)
+	#include <process.h>
+#endif
 
 
 //##########################################################################################
@@ -57,6 +65,126 @@ class HRTFFilter:: Sample
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Cache File Header Declaration
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// The header at the start of a processed HRTF cache file.
+/**
+  * The header is followed by the frequency-domain filters for each channel and
+  * SH coefficient, stored as (length + 2) native floats each. Each filter is padded
+  * with zeros to a multiple of HRTF_CACHE_ALIGNMENT bytes, and the header is padded
+  * to 64 bytes, so that every filter in a mapped file is aligned for SIMD access.
+  */
+class HRTFCacheHeader
+{
+	public:
+		
+		/// The magic bytes that identify a processed HRTF cache file.
+		UByte magic[8];
+		
+		/// The version number of the cache file format.
+		UInt32 version;
+		
+		/// A known value that is used to reject files written with a different endianness.
+		UInt32 endianMarker;
+		
+		/// The key of the HRTF and fitting parameters that this file was generated from.
+		UInt64 key;
+		
+		/// The sample rate of the processed filters.
+		Float64 sampleRate;
+		
+		/// The size in bytes of each stored floating-point value.
+		UInt32 floatSize;
+		
+		/// The number of channels in the processed HRTF.
+		UInt32 channelCount;
+		
+		/// The spherical harmonic order of the processed HRTF.
+		UInt32 order;
+		
+		/// The power-of-two time-domain length of the filters.
+		UInt32 length;
+		
+		/// Padding so that the filter data starts on a 64-byte boundary.
+		UByte padding[16];
+		
+		
+};
+
+
+
+
+static const UByte HRTF_CACHE_MAGIC[8] = { 'G', 'S', 'H', 'R', 'T', 'F', 'C', 0 };
+static const UInt32 HRTF_CACHE_VERSION = 2;
+static const UInt32 HRTF_CACHE_ENDIAN_MARKER = 0x01020304;
+static const Size HRTF_CACHE_ALIGNMENT = 16;
+
+
+/// A counter that makes the temporary cache file names unique within this process.
+static Atomic<UInt32> hrtfCacheTempCounter( 0 );
+
+
+
+
+/// Return the number of floats that are stored for each filter of the given length in a cache file.
+static Size getCacheFilterStride( Size length )
+{
+	const Size alignment = HRTF_CACHE_ALIGNMENT / sizeof(Float);
+	
+	return ((length + 2 + alignment - 1) / alignment)*alignment;
+}
+
+
+
+
+/// Return an identifier for the current process, used to make temporary file names unique.
+static UInt64 getProcessID()
+{
+#if defined(OM_PLATFORM_APPLE) || defined(OM_PLATFORM_LINUX)
+	return UInt64(getpid());
+#elif defined(OM_PLATFORM_WINDOWS)
+	return UInt64(_getpid());
+#else
+	return 0;
+#endif
+}
+
+
+
+
+/// Accumulate the specified bytes into a 64-bit FNV-1a hash.
+static UInt64 hashBytes( UInt64 hash, const void* data, Size numBytes )
+{
+	const UByte* bytes = (const UByte*)data;
+	const UByte* const bytesEnd = bytes + numBytes;
+	
+	for ( ; bytes != bytesEnd; bytes++ )
+		hash = (hash ^ (*bytes))*UInt64(0x100000001B3ull);
+	
+	return hash;
+}
+
+
+
+
+template < typename T >
+GSOUND_FORCE_INLINE static UInt64 hashValue( UInt64 hash, const T& value )
+{
+	return hashBytes( hash, &value, sizeof(T) );
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -133,6 +261,90 @@ class HRTFFilter:: FFTData
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Fit State Class Declaration
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+class HRTFFilter:: FitState
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			GSOUND_INLINE FitState( const HRTF& newHRTF, Size numChannels, Float newResampleFactor,
+									Size newPaddedLength, Size newNumIntegrationSamples )
+				:	hrtf( &newHRTF ),
+					channels( numChannels ),
+					resampleFactor( newResampleFactor ),
+					paddedLength( newPaddedLength ),
+					numIntegrationSamples( newNumIntegrationSamples ),
+					order( 0 ),
+					coefficientCount( 0 ),
+					lastCoefficientCount( 0 ),
+					binChunkSize( newPaddedLength ),
+					numBinChunks( 1 )
+			{
+			}
+			
+			
+		//********************************************************************************
+		//******	Data Members
+			
+			
+			/// The HRTF that is being fit.
+			const HRTF* hrtf;
+			
+			/// The frequency-domain measured samples followed by the integration samples for each channel.
+			om::ShortArray<ArrayList<Sample>,2> channels;
+			
+			/// The random directions of the integration samples, shared by all channels.
+			Array<Vector3f> directions;
+			
+			/// The SH basis evaluated for each integration direction, stored contiguously per direction.
+			Array<Float> basis;
+			
+			/// The partial squared error for each channel and frequency bin chunk.
+			Array<Float> errors;
+			
+			/// The factor by which the HRTF is resampled.
+			Float resampleFactor;
+			
+			/// The number of floats in each frequency-domain filter.
+			Size paddedLength;
+			
+			/// The number of monte-carlo integration samples per channel.
+			Size numIntegrationSamples;
+			
+			/// The SH order that is currently being fit.
+			Size order;
+			
+			/// The number of SH coefficients for the current order.
+			Size coefficientCount;
+			
+			/// The number of SH coefficients that were fit for the previous order.
+			Size lastCoefficientCount;
+			
+			/// The number of frequency bins that are processed by each job.
+			Size binChunkSize;
+			
+			/// The number of frequency bin chunks per channel.
+			Size numBinChunks;
+			
+			
+};
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -148,7 +360,9 @@ HRTFFilter:: HRTFFilter()
 	:	channels(),
 		order( 0 ),
 		fftData( NULL ),
-		sampleRate( 0 )
+		sampleRate( 0 ),
+		threadCount( CPU::getCount() ),
+		cacheFile( NULL )
 {
 }
 
@@ -168,6 +382,7 @@ HRTFFilter:: HRTFFilter()
 
 HRTFFilter:: ~HRTFFilter()
 {
+	closeCache();
 	deinitializeFFTData();
 }
 
@@ -195,6 +410,21 @@ Bool HRTFFilter:: setHRTF( const HRTF& newHRTF, SampleRate newSampleRate, Size m
 	if ( maxIRLength == 0 || numChannels == 0 || newSampleRate <= SampleRate(0) )
 		return false;
 	
+	// Use the previously processed HRTF if there is a matching cache file.
+	const Bool cacheEnabled = cachePath.getLength() > 0;
+	UInt64 cacheKey = 0;
+	
+	if ( cacheEnabled )
+	{
+		cacheKey = getCacheKey( newHRTF, newSampleRate, maxOrder, maxError, convergence, numIntegrationSamples );
+		
+		if ( loadCache( cacheKey, numChannels, newSampleRate ) )
+			return true;
+	}
+	
+	// The filters are recomputed, so they can't point into a cache file.
+	closeCache();
+	
 	// Make sure this HRTF has the right number of channels.
 	if ( channels.getSize() != numChannels )
 		channels.setSize( numChannels );
@@ -210,83 +440,67 @@ Bool HRTFFilter:: setHRTF( const HRTF& newHRTF, SampleRate newSampleRate, Size m
 	if ( fftData == NULL || fftData->length != length )
 		initializeFFTData( length );
 	
-	// A temporary array of the frequency-domain HRTF samples for this HRTF.
-	om::ShortArray<ArrayList<Sample>,2> tempChannels( numChannels );
-	
-	// A temporary spherical harmonic basis used for HRTF projection.
-	Array<Float> basis;
-	
 	// A random variable used for monte-carlo integration of HRTF.
 	math::Random<Float> randomVariable;
 	
-	// A temporary filter.
-	Filter tempFilter( paddedLength );
+	// Start the worker threads that are used to fit the HRTF.
+	const Size numThreads = threadCount > 1 ? threadCount : 0;
+	
+	if ( threadPool.getThreadCount() != numThreads )
+		threadPool.setThreadCount( numThreads );
+	
+	// The temporary state shared by the fitting jobs.
+	FitState state( newHRTF, numChannels, resampleFactor, paddedLength, numIntegrationSamples );
+	
+	// Divide the frequency bins into SIMD-aligned chunks so that each job writes a disjoint part of the filters.
+	const Size numBinJobs = math::max( numThreads*2, Size(1) );
+	state.binChunkSize = math::max( math::nextMultiple( paddedLength / numBinJobs, Size(16) ), Size(64) );
+	state.numBinChunks = (paddedLength + state.binChunkSize - 1) / state.binChunkSize;
+	state.errors.setSize( numChannels*state.numBinChunks );
+	
+	const Size sampleChunkSize = math::max( numIntegrationSamples / numBinJobs, Size(16) );
 	
 	//*******************************************************************************
 	// Convert each sample in the new HRTF to frequency domain.
 	
 	const Matrix3f& orientation = newHRTF.getOrientation();
+	Size maxSampleCount = 0;
 	
 	for ( Index c = 0; c < numChannels; c++ )
 	{
 		const Size numSamples = newHRTF.getSampleCount(c);
-		ArrayList<Sample>& samples = tempChannels[c];
+		ArrayList<Sample>& samples = state.channels[c];
 		samples.setCapacity( numSamples + numIntegrationSamples );
 		
+		// Allocate the sample filters here so that the jobs don't modify the sample list.
 		for ( Index i = 0; i < numSamples; i++ )
-		{
-			Vector3f direction = orientation*newHRTF.getSampleDirection(c, i);
-			const Float* ir = newHRTF.getSampleData(c, i);
-			const Size irLength = maxIRLength;
-			
-			// Create a new reference-counted filter.
-			Filter filter( paddedLength );
-			
-			if ( resampleFactor == Float(1) )
-			{
-				om::util::copy( filter.getScalars(), ir, irLength );
-				om::util::zero( filter.getScalars() + irLength, paddedLength - irLength );
-			}
-			else
-			{
-				// Resample the IR.
-				math::resample( ir, irLength, filter.getScalars(), resampleFactor, 256 );
-				const Size resampledLength = (Size)math::ceiling( Float(irLength)*resampleFactor );
-				om::util::zero( filter.getScalars() + resampledLength, paddedLength - resampledLength );
-			}
-			
-			// Add the sample filter.
-			samples.add( Sample( direction, filter ) );
-			
-			// Convert the sample to frequency domain.
-			fftData->fft( samples.getLast().filter.getScalars() );
-		}
+			samples.add( Sample( orientation*newHRTF.getSampleDirection(c, i), Filter( paddedLength ) ) );
+		
+		maxSampleCount = math::max( maxSampleCount, numSamples );
 	}
 	
+	runJobs( &HRTFFilter::convertSamples, state, numChannels, maxSampleCount,
+			math::max( maxSampleCount / numBinJobs, Size(16) ) );
+	
 	//*******************************************************************************
 	// Generate integration samples.
 	
+	// The same random directions are used for all channels so that the SH basis only needs to be evaluated once.
+	state.directions.setSize( numIntegrationSamples );
+	
+	for ( Index i = 0; i < numIntegrationSamples; i++ )
+		state.directions[i] = getRandomDirection( randomVariable );
+	
 	for ( Index c = 0; c < numChannels; c++ )
 	{
-		const Size numSamples = newHRTF.getSampleCount(c);
-		ArrayList<Sample>& samples = tempChannels[c];
+		ArrayList<Sample>& samples = state.channels[c];
 		
 		for ( Index i = 0; i < numIntegrationSamples; i++ )
-		{
-			// Get a uniformly-distributed random direction.
-			Vector3f direction = getRandomDirection( randomVariable );
-			
-			// Create a new reference-counted filter.
-			Filter filter( paddedLength );
-			
-			// Interpolate the filter for the direction sample.
-			interpolateSample( direction, samples.getPointer(), numSamples, filter.getScalars(), paddedLength );
-			
-			// Add the sample filter.
-			samples.add( Sample( direction, filter ) );
-		}
+			samples.add( Sample( state.directions[i], Filter( paddedLength ) ) );
 	}
 	
+	runJobs( &HRTFFilter::interpolateSamples, state, numChannels, numIntegrationSamples, sampleChunkSize );
+	
 	//*******************************************************************************
 	// For increasing order, determine how well the SH approximation fits the data.
 	
@@ -306,87 +520,44 @@ Bool HRTFFilter:: setHRTF( const HRTF& newHRTF, SampleRate newSampleRate, Size m
 			
 			// Increase the HRTF size if necessary.
 			if ( hrtf.getSize() < coefficientCount )
-			{
 				hrtf.setSize( coefficientCount );
-				basis.setSize( coefficientCount );
-			}
 			
 			for ( Index i = lastCoefficientCount; i < coefficientCount; i++ )
 			{
 				if ( hrtf[i].getRowCount() != paddedLength )
-				{
 					hrtf[i].setSize( paddedLength, 1 );
-					om::util::zero( hrtf[i].getScalars(), paddedLength );
-				}
+				
+				// Clear any coefficients left over from a previous HRTF.
+				om::util::zero( hrtf[i].getScalars(), paddedLength );
 			}
 		}
 		
+		//*******************************************************************************
+		// Evaluate the SH basis for all integration directions at once.
+		
+		state.order = order;
+		state.coefficientCount = coefficientCount;
+		state.lastCoefficientCount = lastCoefficientCount;
+		state.basis.setSize( numIntegrationSamples*coefficientCount );
+		
+		runJobs( &HRTFFilter::evaluateBasis, state, 1, numIntegrationSamples, sampleChunkSize );
+		
 		//*******************************************************************************
 		// Integrate the source HRTF over the SH basis.
 		
-		for ( Index c = 0; c < numChannels; c++ )
-		{
-			const Size numSamples = newHRTF.getSampleCount(c);
-			const Size totalNumSamples = numSamples + numIntegrationSamples;
-			const Sample* samples = tempChannels[c].getPointer();
-			Array<Filter>& hrtf = channels[c].hrtf;
-			
-			for ( Index i = numSamples; i < totalNumSamples; i++ )
-			{
-				const Vector3f& direction = samples[i].direction;
-				const Filter& filter = samples[i].filter;
-				
-				SH::cartesian( order, direction, basis.getPointer() );
-				
-				for ( Index j = lastCoefficientCount; j < coefficientCount; j++ )
-				{
-					math::multiplyAdd( hrtf[j].getScalars(), filter.getScalars(),
-										basis[j], paddedLength );
-				}
-			}
-			
-			// Normalize based on the number of samples and sphere surface area.
-			const Float normalize = (Float(4)*math::pi<Float>()) / Float(numIntegrationSamples);
-			
-			for ( Index i = lastCoefficientCount; i < coefficientCount; i++ )
-				math::multiply( (Float*)hrtf[i].getScalars(), normalize, paddedLength );
-		}
+		runJobs( &HRTFFilter::projectSamples, state, numChannels, paddedLength, state.binChunkSize );
 		
 		//*******************************************************************************
 		// Determine the L2 error over all samples.
 		
+		runJobs( &HRTFFilter::computeError, state, numChannels, paddedLength, state.binChunkSize );
+		
 		Float error = 0.0f;
-		Size errorSamples = 0;
 		
-		for ( Index c = 0; c < numChannels; c++ )
-		{
-			const Size numSamples = newHRTF.getSampleCount(c);
-			const Size totalNumSamples = numSamples + numIntegrationSamples;
-			const Sample* samples = tempChannels[c].getPointer();
-			Array<Filter>& hrtf = channels[c].hrtf;
-			
-			for ( Index i = numSamples; i < totalNumSamples; i++ )
-			{
-				const Vector3f& direction = samples[i].direction;
-				const Filter& filter = samples[i].filter;
-				
-				// Project sample into SH basis.
-				SH::cartesian( order, direction, basis.getPointer() );
-				
-				// Compute the interpolated sample filter.
-				math::multiply( tempFilter.getScalars(), hrtf[0].getScalars(), basis[0], paddedLength );
-				
-				for ( Index j = 1; j < coefficientCount; j++ )
-					math::multiplyAdd( tempFilter.getScalars(), hrtf[j].getScalars(), basis[j], paddedLength );
-				
-				// Accumulate the squared error for the interpolated filter.
-				math::subtract( tempFilter.getScalars(), filter.getScalars(), paddedLength );
-				error += math::dot( tempFilter.getScalars(), tempFilter.getScalars(), paddedLength );
-			}
-			
-			errorSamples += numIntegrationSamples*paddedLength;
-		}
+		for ( Index i = 0; i < state.errors.getSize(); i++ )
+			error += state.errors[i];
 		
+		const Size errorSamples = numChannels*numIntegrationSamples*paddedLength;
 		error = math::sqrt(error / Float(errorSamples));
 		
 		if ( error > lastError && !backtracked )
@@ -407,12 +578,407 @@ Bool HRTFFilter:: setHRTF( const HRTF& newHRTF, SampleRate newSampleRate, Size m
 		lastCoefficientCount = coefficientCount;
 	}
 	
+	// Stop the worker threads until the next HRTF is fit.
+	threadPool.setThreadCount( 0 );
+	
+	// Point the filters for each channel at the fitted SH expansion.
+	const Size coefficientCount = SH::getCoefficientCount(order);
+	
+	for ( Index c = 0; c < numChannels; c++ )
+	{
+		Channel& channel = channels[c];
+		channel.filters.setSize( coefficientCount );
+		
+		for ( Index i = 0; i < coefficientCount; i++ )
+			channel.filters[i] = channel.hrtf[i].getScalars();
+	}
+	
+	// Save the processed HRTF so that it doesn't need to be fit again.
+	if ( cacheEnabled )
+		saveCache( cacheKey );
+	
 	return true;
 }
 
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		HRTF Fitting Job Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void HRTFFilter:: runJobs( FitJob job, FitState& state, Size numChannels, Size numItems, Size chunkSize )
+{
+	const Bool parallel = threadPool.getThreadCount() > 0;
+	
+	for ( Index c = 0; c < numChannels; c++ )
+	{
+		for ( Index start = 0; start < numItems; start += chunkSize )
+		{
+			const Index end = math::min( start + chunkSize, numItems );
+			
+			if ( parallel )
+			{
+				threadPool.addJob( FunctionCall<void (FitState&, Index, Index, Index)>(
+									bind( job, this ), state, c, start, end ) );
+			}
+			else
+				(this->*job)( state, c, start, end );
+		}
+	}
+	
+	if ( parallel )
+		threadPool.finishJobs();
+}
+
+
+
+
+void HRTFFilter:: convertSamples( FitState& state, Index channelIndex, Index startIndex, Index endIndex )
+{
+	const HRTF& newHRTF = *state.hrtf;
+	const Size irLength = newHRTF.getFilterLength();
+	const Size paddedLength = state.paddedLength;
+	Sample* samples = state.channels[channelIndex].getPointer();
+	
+	// Channels can have fewer samples than the number of items that the jobs were split over.
+	endIndex = math::min( endIndex, newHRTF.getSampleCount(channelIndex) );
+	
+	for ( Index i = startIndex; i < endIndex; i++ )
+	{
+		const Float* ir = newHRTF.getSampleData( channelIndex, i );
+		Float* filter = samples[i].filter.getScalars();
+		
+		if ( state.resampleFactor == Float(1) )
+		{
+			om::util::copy( filter, ir, irLength );
+			om::util::zero( filter + irLength, paddedLength - irLength );
+		}
+		else
+		{
+			// Resample the IR.
+			math::resample( ir, irLength, filter, state.resampleFactor, 256 );
+			const Size resampledLength = (Size)math::ceiling( Float(irLength)*state.resampleFactor );
+			om::util::zero( filter + resampledLength, paddedLength - resampledLength );
+		}
+		
+		// Convert the sample to frequency domain.
+		fftData->fft( filter );
+	}
+}
+
+
+
+
+void HRTFFilter:: interpolateSamples( FitState& state, Index channelIndex, Index startIndex, Index endIndex )
+{
+	const Size numSamples = state.hrtf->getSampleCount(channelIndex);
+	Sample* samples = state.channels[channelIndex].getPointer();
+	
+	// Interpolate the filter for each integration direction from the measured samples.
+	for ( Index i = startIndex; i < endIndex; i++ )
+	{
+		Sample& sample = samples[numSamples + i];
+		interpolateSample( sample.direction, samples, numSamples, sample.filter.getScalars(), state.paddedLength );
+	}
+}
+
+
+
+
+void HRTFFilter:: evaluateBasis( FitState& state, Index /*channelIndex*/, Index startIndex, Index endIndex )
+{
+	const Size coefficientCount = state.coefficientCount;
+	
+	for ( Index i = startIndex; i < endIndex; i++ )
+		SH::cartesian( state.order, state.directions[i], state.basis.getPointer() + i*coefficientCount );
+}
+
+
+
+
+void HRTFFilter:: projectSamples( FitState& state, Index channelIndex, Index binStart, Index binEnd )
+{
+	const Size numSamples = state.hrtf->getSampleCount(channelIndex);
+	const Size numIntegrationSamples = state.numIntegrationSamples;
+	const Size coefficientCount = state.coefficientCount;
+	const Size lastCoefficientCount = state.lastCoefficientCount;
+	const Size numBins = binEnd - binStart;
+	const Sample* samples = state.channels[channelIndex].getPointer() + numSamples;
+	const Float* basis = state.basis.getPointer();
+	Filter* hrtf = channels[channelIndex].hrtf.getPointer();
+	
+	// Accumulate the new coefficients for this job's frequency bins.
+	for ( Index i = 0; i < numIntegrationSamples; i++, basis += coefficientCount )
+	{
+		const Float* filter = samples[i].filter.getScalars() + binStart;
+		
+		for ( Index j = lastCoefficientCount; j < coefficientCount; j++ )
+			math::multiplyAdd( hrtf[j].getScalars() + binStart, filter, basis[j], numBins );
+	}
+	
+	// Normalize based on the number of samples and sphere surface area.
+	const Float normalize = (Float(4)*math::pi<Float>()) / Float(numIntegrationSamples);
+	
+	for ( Index j = lastCoefficientCount; j < coefficientCount; j++ )
+		math::multiply( hrtf[j].getScalars() + binStart, normalize, numBins );
+}
+
+
+
+
+void HRTFFilter:: computeError( FitState& state, Index channelIndex, Index binStart, Index binEnd )
+{
+	const Size numSamples = state.hrtf->getSampleCount(channelIndex);
+	const Size numIntegrationSamples = state.numIntegrationSamples;
+	const Size coefficientCount = state.coefficientCount;
+	const Size numBins = binEnd - binStart;
+	const Sample* samples = state.channels[channelIndex].getPointer() + numSamples;
+	const Float* basis = state.basis.getPointer();
+	const Filter* hrtf = channels[channelIndex].hrtf.getPointer();
+	
+	// A temporary filter for this job's frequency bins.
+	Array<Float> tempFilter( numBins );
+	Float* temp = tempFilter.getPointer();
+	Float error = 0;
+	
+	for ( Index i = 0; i < numIntegrationSamples; i++, basis += coefficientCount )
+	{
+		// Compute the interpolated sample filter.
+		math::multiply( temp, hrtf[0].getScalars() + binStart, basis[0], numBins );
+		
+		for ( Index j = 1; j < coefficientCount; j++ )
+			math::multiplyAdd( temp, hrtf[j].getScalars() + binStart, basis[j], numBins );
+		
+		// Accumulate the squared error for the interpolated filter.
+		math::subtract( temp, samples[i].filter.getScalars() + binStart, numBins );
+		error += math::dot( temp, temp, numBins );
+	}
+	
+	state.errors[channelIndex*state.numBinChunks + binStart/state.binChunkSize] = error;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		HRTF Cache Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+UInt64 HRTFFilter:: getCacheKey( const HRTF& newHRTF, SampleRate newSampleRate, Size maxOrder, Float maxError,
+								Float convergence, Size numIntegrationSamples )
+{
+	const Size numChannels = newHRTF.getChannelCount();
+	const Size filterLength = newHRTF.getFilterLength();
+	UInt64 hash = UInt64(0xCBF29CE484222325ull);
+	
+	// Hash the fitting parameters.
+	hash = hashValue( hash, Float64(newSampleRate) );
+	hash = hashValue( hash, UInt64(maxOrder) );
+	hash = hashValue( hash, Float32(maxError) );
+	hash = hashValue( hash, Float32(convergence) );
+	hash = hashValue( hash, UInt64(numIntegrationSamples) );
+	
+	// Hash the HRTF's format and orientation.
+	hash = hashValue( hash, Float64(newHRTF.getSampleRate()) );
+	hash = hashValue( hash, UInt64(numChannels) );
+	hash = hashValue( hash, UInt64(filterLength) );
+	hash = hashValue( hash, newHRTF.getOrientation() );
+	
+	// Hash the direction and filter of every sample.
+	for ( Index c = 0; c < numChannels; c++ )
+	{
+		const Size numSamples = newHRTF.getSampleCount(c);
+		hash = hashValue( hash, UInt64(numSamples) );
+		
+		for ( Index i = 0; i < numSamples; i++ )
+		{
+			hash = hashValue( hash, newHRTF.getSampleDirection( c, i ) );
+			hash = hashBytes( hash, newHRTF.getSampleData( c, i ), filterLength*sizeof(Float32) );
+		}
+	}
+	
+	return hash;
+}
+
+
+
+
+om::fs::Path HRTFFilter:: getCacheFilePath( UInt64 key ) const
+{
+	// The file name is the key in hexadecimal.
+	const char* const hexDigits = "0123456789abcdef";
+	char fileName[] = "hrtf_0000000000000000.gshrtf";
+	
+	for ( Index i = 0; i < 16; i++ )
+		fileName[5 + i] = hexDigits[(key >> (60 - 4*i)) & 0xF];
+	
+	return om::fs::Path( cachePath ) + fileName;
+}
+
+
+
+
+Bool HRTFFilter:: loadCache( UInt64 key, Size numChannels, SampleRate newSampleRate )
+{
+	closeCache();
+	
+	om::MappedFileReader* file = util::construct<om::MappedFileReader>( getCacheFilePath( key ) );
+	
+	if ( !file->open() )
+	{
+		util::destruct( file );
+		return false;
+	}
+	
+	// Make sure the file was generated from the same HRTF on a compatible platform.
+	const HRTFCacheHeader* header = (const HRTFCacheHeader*)file->getPointer( 0, sizeof(HRTFCacheHeader) );
+	
+	if ( header == NULL ||
+		std::memcmp( header->magic, HRTF_CACHE_MAGIC, sizeof(HRTF_CACHE_MAGIC) ) != 0 ||
+		header->version != HRTF_CACHE_VERSION ||
+		header->endianMarker != HRTF_CACHE_ENDIAN_MARKER ||
+		header->key != key ||
+		header->sampleRate != Float64(newSampleRate) ||
+		header->floatSize != sizeof(Float) ||
+		header->channelCount != numChannels ||
+		header->length == 0 || !math::isPowerOfTwo( header->length ) )
+	{
+		util::destruct( file );
+		return false;
+	}
+	
+	const Size filterSize = getCacheFilterStride( header->length );
+	const Size coefficientCount = SH::getCoefficientCount( header->order );
+	const Size dataSize = numChannels*coefficientCount*filterSize*sizeof(Float);
+	const Float* data = (const Float*)file->getPointer( sizeof(HRTFCacheHeader), dataSize );
+	
+	// The file must contain exactly the filters described by the header.
+	if ( data == NULL || file->getSize() != sizeof(HRTFCacheHeader) + dataSize )
+	{
+		util::destruct( file );
+		return false;
+	}
+	
+	if ( channels.getSize() != numChannels )
+		channels.setSize( numChannels );
+	
+	order = header->order;
+	length = header->length;
+	sampleRate = newSampleRate;
+	
+	if ( fftData == NULL || fftData->length != length )
+		initializeFFTData( length );
+	
+	// Point the filters into the mapped file and release the fitted filters.
+	for ( Index c = 0; c < numChannels; c++ )
+	{
+		Channel& channel = channels[c];
+		channel.hrtf.setSize( 0 );
+		channel.filters.setSize( coefficientCount );
+		
+		for ( Index i = 0; i < coefficientCount; i++ )
+			channel.filters[i] = data + (c*coefficientCount + i)*filterSize;
+	}
+	
+	cacheFile = file;
+	
+	return true;
+}
+
+
+
+
+Bool HRTFFilter:: saveCache( UInt64 key ) const
+{
+	const Size numChannels = channels.getSize();
+	const Size filterSize = length + 2;
+	const Size filterStride = getCacheFilterStride( length );
+	const Size coefficientCount = SH::getCoefficientCount( order );
+	const Float padding[HRTF_CACHE_ALIGNMENT/sizeof(Float)] = { 0 };
+	
+	HRTFCacheHeader header;
+	om::util::zeroPOD( &header, 1 );
+	om::util::copyPOD( header.magic, HRTF_CACHE_MAGIC, sizeof(HRTF_CACHE_MAGIC) );
+	header.version = HRTF_CACHE_VERSION;
+	header.endianMarker = HRTF_CACHE_ENDIAN_MARKER;
+	header.key = key;
+	header.sampleRate = Float64(sampleRate);
+	header.floatSize = sizeof(Float);
+	header.channelCount = (UInt32)numChannels;
+	header.order = (UInt32)order;
+	header.length = (UInt32)length;
+	
+	// Write to a temporary file and rename it when done so that readers never see a partial file.
+	// The temporary name is unique to this process and call so that concurrent writers don't collide.
+	const om::fs::Path filePath = getCacheFilePath( key );
+	om::File file( filePath.toString() + "." + UTF8String( getProcessID() ) +
+					"." + UTF8String( UInt64(hrtfCacheTempCounter++) ) + ".tmp" );
+	
+	if ( !file.erase() )
+		return false;
+	
+	om::FileWriter writer( file );
+	
+	if ( !writer.open() )
+		return false;
+	
+	Bool result = writer.writeData( (const UByte*)&header, sizeof(HRTFCacheHeader) ) == sizeof(HRTFCacheHeader);
+	
+	for ( Index c = 0; c < numChannels && result; c++ )
+	{
+		for ( Index i = 0; i < coefficientCount && result; i++ )
+		{
+			const Size filterBytes = filterSize*sizeof(Float);
+			const Size paddingBytes = (filterStride - filterSize)*sizeof(Float);
+			result = writer.writeData( (const UByte*)channels[c].filters[i], filterBytes ) == filterBytes &&
+					writer.writeData( (const UByte*)padding, paddingBytes ) == paddingBytes;
+		}
+	}
+	
+	writer.close();
+	
+	if ( !result || !file.setName( filePath.getName() ) )
+	{
+		file.remove();
+		return false;
+	}
+	
+	return true;
+}
+
+
+
+
+void HRTFFilter:: closeCache()
+{
+	if ( cacheFile )
+	{
+		util::destruct( cacheFile );
+		cacheFile = NULL;
+		
+		for ( Index c = 0; c < channels.getSize(); c++ )
+			channels[c].filters.setSize( 0 );
+	}
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -450,7 +1016,7 @@ Bool HRTFFilter:: getFilter( Index channelIndex, const SHExpansion<Float>& basis
 	if ( coefficients == NULL || channelIndex >= channels.getSize() )
 		return false;
 	
-	const Filter* filters = channels[channelIndex].hrtf.getPointer();
+	const Float* const* filters = channels[channelIndex].filters.getPointer();
 	
 	if ( filters == NULL )
 		return false;
@@ -463,10 +1029,10 @@ Bool HRTFFilter:: getFilter( Index channelIndex, const SHExpansion<Float>& basis
 	Float* filter = (Float*)complexFilter;
 	
 	// Compute the dot product of the basis with the HRTF filter for the channel.
-	math::multiply( filter, filters[0].getScalars(), coefficients[0], filterSize );
+	math::multiply( filter, filters[0], coefficients[0], filterSize );
 	
 	for ( Index i = 1; i < coefficientCount; i++ )
-		math::multiplyAdd( filter, filters[i].getScalars(), coefficients[i], filterSize );
+		math::multiplyAdd( filter, filters[i], coefficients[i], filterSize );
 	
 	return true;
 }
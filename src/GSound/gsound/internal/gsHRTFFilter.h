@@ -117,6 +117,55 @@ class HRTFFilter
 							Float convergence = Float(0.00), Size numIntegrationSamples = Size(2000) );
 			
 			
+		//********************************************************************************
+		//******	Thread Count Accessor Methods
+			
+			
+			/// Return the maximum number of threads that are used to fit an HRTF.
+			GSOUND_INLINE Size getThreadCount() const
+			{
+				return threadCount;
+			}
+			
+			
+			/// Set the maximum number of threads that are used to fit an HRTF.
+			/**
+			  * The worker threads only exist while setHRTF() is fitting an HRTF.
+			  * The default is the number of CPUs.
+			  */
+			GSOUND_INLINE void setThreadCount( Size newThreadCount )
+			{
+				threadCount = math::max( newThreadCount, Size(1) );
+			}
+			
+			
+		//********************************************************************************
+		//******	HRTF Cache Accessor Methods
+			
+			
+			/// Return the path of the directory where processed HRTFs are cached.
+			GSOUND_INLINE const UTF8String& getCachePath() const
+			{
+				return cachePath;
+			}
+			
+			
+			/// Set the path of the directory where processed HRTFs are cached.
+			/**
+			  * If the path is not empty, setHRTF() first looks in the directory for a cache file
+			  * that matches the HRTF data, sample rate and fitting parameters. If one is found,
+			  * it is memory-mapped and the filters are used in place, skipping the spherical
+			  * harmonic fitting. Otherwise, the HRTF is processed and the result is written to
+			  * the directory so that later calls (from any process) can use it.
+			  *
+			  * An empty path disables the cache. The cache is disabled by default.
+			  */
+			GSOUND_INLINE void setCachePath( const UTF8String& newCachePath )
+			{
+				cachePath = newCachePath;
+			}
+			
+			
 		//********************************************************************************
 		//******	Filter Accessor Methods
 			
@@ -182,6 +231,14 @@ class HRTFFilter
 			class Sample;
 			
 			
+			/// A class that stores the temporary state shared by the HRTF fitting jobs.
+			class FitState;
+			
+			
+			/// The type of a method that processes a range of items for a channel while fitting an HRTF.
+			typedef void (HRTFFilter::*FitJob)( FitState& state, Index channelIndex, Index startIndex, Index endIndex );
+			
+			
 			/// A class that stores information about an HRTF channel.
 			class Channel
 			{
@@ -192,6 +249,14 @@ class HRTFFilter
 					Array<Filter> hrtf;
 					
 					
+					/// Pointers to the frequency-domain filter for each SH coefficient of this channel.
+					/**
+					  * The filters point either to the filters in the hrtf array or to the
+					  * memory-mapped cache file that this HRTF was loaded from.
+					  */
+					Array<const Float*> filters;
+					
+					
 			};
 			
 			
@@ -224,6 +289,51 @@ class HRTFFilter
 			void  deinitializeFFTData();
 			
 			
+			/// Split the items for each channel into chunks and run the job on each chunk, in parallel if possible.
+			void runJobs( FitJob job, FitState& state, Size numChannels, Size numItems, Size chunkSize );
+			
+			
+			/// Convert the measured HRTF samples in the given range to frequency domain.
+			void convertSamples( FitState& state, Index channelIndex, Index startIndex, Index endIndex );
+			
+			
+			/// Interpolate the filters for the integration samples in the given range.
+			void interpolateSamples( FitState& state, Index channelIndex, Index startIndex, Index endIndex );
+			
+			
+			/// Evaluate the SH basis for the integration directions in the given range.
+			void evaluateBasis( FitState& state, Index channelIndex, Index startIndex, Index endIndex );
+			
+			
+			/// Project the integration samples onto the new SH coefficients for the given range of frequency bins.
+			void projectSamples( FitState& state, Index channelIndex, Index binStart, Index binEnd );
+			
+			
+			/// Compute the squared SH approximation error for the given range of frequency bins.
+			void computeError( FitState& state, Index channelIndex, Index binStart, Index binEnd );
+			
+			
+			/// Return a 64-bit key that identifies the processed result of the given HRTF and fitting parameters.
+			static UInt64 getCacheKey( const HRTF& newHRTF, SampleRate sampleRate, Size maxOrder, Float maxError,
+										Float convergence, Size numIntegrationSamples );
+			
+			
+			/// Return the path of the cache file for the specified cache key in the cache directory.
+			om::fs::Path getCacheFilePath( UInt64 key ) const;
+			
+			
+			/// Try to map the cache file with the given key, returning whether or not the HRTF was loaded.
+			Bool loadCache( UInt64 key, Size numChannels, SampleRate newSampleRate );
+			
+			
+			/// Write the currently processed HRTF to the cache file with the given key.
+			Bool saveCache( UInt64 key ) const;
+			
+			
+			/// Close the memory-mapped cache file, if there is one.
+			void closeCache();
+			
+			
 		//********************************************************************************
 		//******	Private Data Members
 			
@@ -248,6 +358,22 @@ class HRTFFilter
 			SampleRate sampleRate;
 			
 			
+			/// The maximum number of threads that are used to fit an HRTF.
+			Size threadCount;
+			
+			
+			/// A pool of worker threads that fit the HRTF in parallel.
+			ThreadPool threadPool;
+			
+			
+			/// The path of the directory where processed HRTFs are cached, or empty if caching is disabled.
+			UTF8String cachePath;
+			
+			
+			/// The memory-mapped cache file that the current filters point into, or NULL if not loaded from a cache.
+			om::MappedFileReader* cacheFile;
+			
+			
 			
 };
 
@@ -94,6 +94,15 @@ PropagationData:: PropagationData( const PropagationData& other )
 		
 		iterator++;
 	}
+	
+	// Copy each object's data in the other data object.
+	HashMap< const SoundObject*, Shared<ObjectData> >::ConstIterator object = other.objects.getIterator();
+	
+	while ( object )
+	{
+		objects.add( getObjectHash( object.getKey() ), object.getKey(), Shared<ObjectData>::construct( *object.getValue() ) );
+		object++;
+	}
 }
 
 
@@ -148,6 +157,17 @@ PropagationData& PropagationData:: operator = ( const PropagationData& other )
 			
 			iterator++;
 		}
+		
+		// Copy each object's data in the other data object.
+		objects.clear();
+		
+		HashMap< const SoundObject*, Shared<ObjectData> >::ConstIterator object = other.objects.getIterator();
+		
+		while ( object )
+		{
+			objects.add( getObjectHash( object.getKey() ), object.getKey(), Shared<ObjectData>::construct( *object.getValue() ) );
+			object++;
+		}
 	}
 	
 	return *this;
@@ -200,6 +220,22 @@ void PropagationData:: removeOldData()
 		
 		listener++;
 	}
+	
+	//*************************************************************************************
+	// Remove object data objects for objects that are no longer in the scene.
+	
+	HashMap< const SoundObject*, Shared<ObjectData> >::Iterator object = objects.getIterator();
+	
+	while ( object )
+	{
+		if ( (*object)->timeStamp < timeStamp )
+		{
+			object.remove();
+			continue;
+		}
+		
+		object++;
+	}
 }
 
 
@@ -219,6 +255,7 @@ void PropagationData:: removeOldData()
 void PropagationData:: reset()
 {
 	listeners.clear();
+	objects.clear();
 }
 
 
@@ -241,7 +278,7 @@ void PropagationData:: resetPaths()
 //##########################################################################################
 //##########################################################################################
 //############		
-//############		Data Size Method
+//############		Data Size Methods
 //############		
 //##########################################################################################
 //##########################################################################################
@@ -263,8 +300,8 @@ Size PropagationData:: getSizeInBytes() const
 		while ( source )
 		{
 			totalSize += sizeof(SourceData) +
-						(*source)->irCache.getSizeInBytes() + (*source)->visibilityCache.getSizeInBytes() +
-						(*source)->directivity.getSizeInBytes();
+						(*source)->irCache.getSizeInBytes() + (*source)->diffusePathCache.getSizeInBytes() +
+						(*source)->visibilityCache.getSizeInBytes() + (*source)->directivity.getSizeInBytes();
 			
 			source++;
 		}
@@ -273,12 +310,66 @@ Size PropagationData:: getSizeInBytes() const
 		listener++;
 	}
 	
+	HashMap< const SoundObject*, Shared<ObjectData> >::ConstIterator object = objects.getIterator();
+	
+	while ( object )
+	{
+		totalSize += sizeof(ObjectData) + (*object)->triangles.getCapacity()*sizeof(WorldSpaceTriangle);
+		object++;
+	}
+	
 	return totalSize + sizeof(PropagationData);
 }
 
 
 
 
+void PropagationData:: getMemoryUsage( SoundMemoryUsage& usage ) const
+{
+	usage.addLocalSize( sizeof(PropagationData) );
+	
+	HashMap< const SoundListener*, Shared<ListenerData> >::ConstIterator listener = listeners.getIterator();
+	Index listenerIndex = 0;
+	
+	while ( listener )
+	{
+		SoundMemoryUsage& listenerUsage = usage.addChild( UTF8String("listener ") + UTF8String((UInt64)listenerIndex), sizeof(ListenerData) );
+		listenerUsage.addChild( "path cache", (*listener)->soundPathCache.getSizeInBytes() );
+		
+		// Add a child for each source's caches.
+		HashMap< const SoundSource*, Shared<SourceData> >::Iterator source = (*listener)->sources.getIterator();
+		Index sourceIndex = 0;
+		
+		while ( source )
+		{
+			SoundMemoryUsage& sourceUsage = listenerUsage.addChild( UTF8String("source ") + UTF8String((UInt64)sourceIndex), sizeof(SourceData) );
+			sourceUsage.addChild( "IR cache", (*source)->irCache.getSizeInBytes() );
+			sourceUsage.addChild( "diffuse path cache", (*source)->diffusePathCache.getSizeInBytes() );
+			sourceUsage.addChild( "visibility cache", (*source)->visibilityCache.getSizeInBytes() );
+			sourceUsage.addChild( "directivity", (*source)->directivity.getSizeInBytes() );
+			
+			source++;
+			sourceIndex++;
+		}
+		
+		listener++;
+		listenerIndex++;
+	}
+	
+	// The object triangles are combined into one child because there may be many objects.
+	SoundMemoryUsage& objectUsage = usage.addChild( "object triangles" );
+	HashMap< const SoundObject*, Shared<ObjectData> >::ConstIterator object = objects.getIterator();
+	
+	while ( object )
+	{
+		objectUsage.addLocalSize( sizeof(ObjectData) + (*object)->triangles.getCapacity()*sizeof(WorldSpaceTriangle) );
+		object++;
+	}
+}
+
+
+
+
 //##########################################################################################
 //**************************  End GSound Internal Namespace  *******************************
 GSOUND_INTERNAL_NAMESPACE_END
@@ -60,7 +60,9 @@
 #include "gsDiffusePathCache.h"
 #include "gsIRCache.h"
 #include "gsVisibilityCache.h"
+#include "gsWorldSpaceTriangle.h"
 #include "gsSoundBandDirectivity.h"
+#include "../gsSoundMemoryUsage.h"
 
 
 //##########################################################################################
@@ -145,13 +147,32 @@ class PropagationData
 			
 			
 		//********************************************************************************
-		//******	Data Size Accessor Method
+		//******	Data Size Accessor Methods
 			
 			
 			/// Return the approximate number of bytes of memory occupied by this sound propagation data.
 			Size getSizeInBytes() const;
 			
 			
+			/// Add children to the memory usage object that break down the memory of this sound propagation data.
+			/**
+			  * There is a child for each listener's caches, with a child for each source's caches,
+			  * and a child for the cached world-space object triangles.
+			  */
+			void getMemoryUsage( SoundMemoryUsage& usage ) const;
+			
+			
+		//********************************************************************************
+		//******	Object Hash Method
+			
+			
+			/// Return a hash code for the specified sound object pointer.
+			GSOUND_FORCE_INLINE static Hash getObjectHash( const SoundObject* object )
+			{
+				return Hash(PointerInt(object) >> 4);
+			}
+			
+			
 			
 	//private:
 		
@@ -267,6 +288,54 @@ class PropagationData
 			};
 			
 			
+			/// A class that stores cached world-space data for a static sound object.
+			class ObjectData
+			{
+				public:
+					
+					/// Construct a default-initialized object data object.
+					GSOUND_INLINE ObjectData()
+						:	timeStamp( 0 ),
+							mesh( NULL )
+					{
+					}
+					
+					
+					/// Return a pointer to the cached world-space triangle for the specified triangle of the object.
+					/**
+					  * If the triangles are not cached because the object's transform
+					  * changed recently, NULL is returned.
+					  */
+					GSOUND_FORCE_INLINE const WorldSpaceTriangle* getTriangle( const InternalSoundTriangle* triangle ) const
+					{
+						const Index triangleIndex = mesh->getTriangleIndex( triangle );
+						
+						if ( triangleIndex >= triangles.getSize() )
+							return NULL;
+						
+						return &triangles[triangleIndex];
+					}
+					
+					
+					/// The index of the most recent propagation frame for this object data.
+					Index timeStamp;
+					
+					
+					/// The transform of the object when the triangles were cached.
+					Transform3f transform;
+					
+					
+					/// The mesh of the object when the triangles were cached.
+					const SoundMesh* mesh;
+					
+					
+					/// The world-space triangles of the object's mesh, or an empty list if they are not valid.
+					ArrayList<WorldSpaceTriangle> triangles;
+					
+					
+			};
+			
+			
 		//********************************************************************************
 		//******	Private Friend Class Declarations
 			
@@ -283,6 +352,10 @@ class PropagationData
 			HashMap< const SoundListener*, Shared<ListenerData> > listeners;
 			
 			
+			/// A map from sound objects to the cached world-space data for those objects.
+			HashMap< const SoundObject*, Shared<ObjectData> > objects;
+			
+			
 			/// The current frame timestamp, used to determine the age of cached information.
 			/**
 			  * In order for the caching of sound information to function properly, it is
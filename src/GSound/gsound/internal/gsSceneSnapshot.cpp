@@ -0,0 +1,358 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/internal/gsSceneSnapshot.cpp
+ * Contents:    gsound::internal::SceneSnapshot class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+
+#include "gsSceneSnapshot.h"
+
+
+//##########################################################################################
+//**************************  Start GSound Internal Namespace  *****************************
+GSOUND_INTERNAL_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Constructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SceneSnapshot:: SceneSnapshot()
+	:	timeStamp( 0 )
+{
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Destructor
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SceneSnapshot:: ~SceneSnapshot()
+{
+	clear();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Snapshot Update Method
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SceneSnapshot:: update( const SoundScene& scene )
+{
+	timeStamp++;
+	
+	// Update the copies of all scene objects.
+	updateObjects<SoundObject>( scene.objects, snapshotScene.objects, objects, NULL, NULL );
+	updateObjects<SoundListener>( scene.listeners, snapshotScene.listeners, listeners, &originalListeners, NULL );
+	
+	newSources.clear();
+	updateObjects<SoundSource>( scene.sources, snapshotScene.sources, sources, &originalSources, &newSources );
+	
+	// Add the new copies to the clusterer. Destroyed copies were already removed from it.
+	const Size numNewSources = newSources.getSize();
+	
+	for ( Index i = 0; i < numNewSources; i++ )
+		snapshotScene.sourceClusterer.addSource( newSources[i] );
+	
+	// Copy the global scene state.
+	snapshotScene.medium = scene.medium;
+	snapshotScene.reverbTime = scene.reverbTime;
+	snapshotScene.userData = scene.userData;
+}
+
+
+
+
+template < typename ObjectType >
+void SceneSnapshot:: updateObjects( const ArrayList<ObjectType*>& originals, ArrayList<ObjectType*>& copies,
+									HashMap<const ObjectType*,Entry<ObjectType> >& entries,
+									HashMap<const ObjectType*,const ObjectType*>* originalMap,
+									ArrayList<ObjectType*>* newCopies )
+{
+	const Size numOriginals = originals.getSize();
+	
+	copies.clear();
+	
+	for ( Index i = 0; i < numOriginals; i++ )
+	{
+		const ObjectType* original = originals[i];
+		
+		if ( original == NULL )
+			continue;
+		
+		// Find the existing copy of the object, or create a new one.
+		const Hash hash = getPointerHash( original );
+		Entry<ObjectType>* entry;
+		
+		if ( !entries.find( hash, original, entry ) )
+		{
+			entry = entries.add( hash, original, Entry<ObjectType>( util::construct<ObjectType>(), timeStamp ) );
+			
+			if ( originalMap )
+				originalMap->add( getPointerHash( entry->copy ), entry->copy, original );
+			
+			if ( newCopies )
+				newCopies->add( entry->copy );
+		}
+		
+		// Copy the full state of every object, since there is no way to tell which ones changed.
+		entry->timeStamp = timeStamp;
+		copyState( *original, *entry->copy );
+		copies.add( entry->copy );
+	}
+	
+	// Destroy the copies of objects that are no longer in the scene.
+	typename HashMap<const ObjectType*,Entry<ObjectType> >::Iterator iterator = entries.getIterator();
+	
+	while ( iterator )
+	{
+		Entry<ObjectType>& entry = iterator.getValue();
+		
+		if ( entry.timeStamp != timeStamp )
+		{
+			if ( originalMap )
+				originalMap->remove( getPointerHash( entry.copy ), entry.copy );
+			
+			destroyCopy( entry.copy );
+			iterator.remove();
+			continue;
+		}
+		
+		iterator++;
+	}
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		State Copy Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SceneSnapshot:: copyState( const SoundSource& original, SoundSource& copy )
+{
+	// Copy the detector state, including the hash code so that path IDs match the original.
+	(SoundDetector&)copy = (const SoundDetector&)original;
+	
+	copy.setFlags( original.getFlags() );
+	copy.setPower( original.getPower() );
+	copy.setPriority( original.getPriority() );
+	copy.setDirectivity( (SoundDirectivity*)original.getDirectivity() );
+}
+
+
+
+
+void SceneSnapshot:: copyState( const SoundListener& original, SoundListener& copy )
+{
+	copy = original;
+}
+
+
+
+
+void SceneSnapshot:: copyState( const SoundObject& original, SoundObject& copy )
+{
+	copy = original;
+}
+
+
+
+
+void SceneSnapshot:: destroyCopy( SoundSource* copy )
+{
+	// Remove the source from the clusterer's octree incrementally.
+	snapshotScene.sourceClusterer.removeSource( copy );
+	util::destruct( copy );
+}
+
+
+
+
+void SceneSnapshot:: destroyCopy( SoundListener* copy )
+{
+	util::destruct( copy );
+}
+
+
+
+
+void SceneSnapshot:: destroyCopy( SoundObject* copy )
+{
+	util::destruct( copy );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		IR Remapping Method
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SceneSnapshot:: remapIR( SoundSceneIR& sceneIR ) const
+{
+	const Size numListeners = sceneIR.getListenerCount();
+	
+	for ( Index l = 0; l < numListeners; l++ )
+	{
+		SoundListenerIR& listenerIR = sceneIR.getListenerIR(l);
+		const SoundListener* listener = listenerIR.getListener();
+		const SoundListener* const* originalListener;
+		
+		if ( listener && originalListeners.find( getPointerHash( listener ), listener, originalListener ) )
+			listenerIR.setListener( *originalListener );
+		
+		const Size numSourceIRs = listenerIR.getSourceCount();
+		
+		for ( Index i = 0; i < numSourceIRs; i++ )
+		{
+			SoundSourceIR& sourceIR = listenerIR.getSourceIR(i);
+			const Size numSources = sourceIR.getSourceCount();
+			
+			for ( Index s = 0; s < numSources; s++ )
+			{
+				const SoundSource* source = sourceIR.getSource(s);
+				const SoundSource* const* originalSource;
+				
+				if ( source && originalSources.find( getPointerHash( source ), source, originalSource ) )
+					sourceIR.setSource( s, *originalSource );
+			}
+		}
+	}
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Snapshot Reset Method
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SceneSnapshot:: clear()
+{
+	// Remove the copies from the snapshot scene before destroying them.
+	snapshotScene.sources.clear();
+	snapshotScene.listeners.clear();
+	snapshotScene.objects.clear();
+	snapshotScene.sourceClusterer.clearSources();
+	
+	HashMap<const SoundSource*,Entry<SoundSource> >::Iterator s = sources.getIterator();
+	for ( ; s; s++ )
+		util::destruct( s.getValue().copy );
+	
+	HashMap<const SoundListener*,Entry<SoundListener> >::Iterator l = listeners.getIterator();
+	for ( ; l; l++ )
+		util::destruct( l.getValue().copy );
+	
+	HashMap<const SoundObject*,Entry<SoundObject> >::Iterator o = objects.getIterator();
+	for ( ; o; o++ )
+		util::destruct( o.getValue().copy );
+	
+	sources.clear();
+	listeners.clear();
+	objects.clear();
+	originalSources.clear();
+	originalListeners.clear();
+}
+
+
+
+
+//##########################################################################################
+//**************************  End GSound Internal Namespace  *******************************
+GSOUND_INTERNAL_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,287 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/internal/gsSceneSnapshot.h
+ * Contents:    gsound::internal::SceneSnapshot class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+
+#ifndef INCLUDE_GSOUND_SCENE_SNAPSHOT_H
+#define INCLUDE_GSOUND_SCENE_SNAPSHOT_H
+
+
+#include "gsInternalConfig.h"
+
+
+#include "../gsSoundScene.h"
+#include "../gsSoundSceneIR.h"
+
+
+//##########################################################################################
+//**************************  Start GSound Internal Namespace  *****************************
+GSOUND_INTERNAL_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that maintains a private copy of a scene's state for asynchronous sound propagation.
+/**
+  * The snapshot mirrors each source, listener, and object in a scene with a persistent
+  * shadow copy that only the propagation thread reads, so that the application can keep
+  * modifying the original objects while propagation is in progress. Copies are kept
+  * from frame to frame so that their addresses remain valid keys for the propagation
+  * caches and the source clusterer. Only the transforms and detector state are copied,
+  * while meshes (and their BVHs) and directivities are shared with the original objects.
+  *
+  * The objects don't record when they change, so every update copies the state of
+  * every object in the scene, whether or not it changed since the last update.
+  *
+  * The IR computed for the snapshot scene refers to the copies, so remapIR() must
+  * be called to replace them with the original detectors before the IR is used.
+  */
+class SceneSnapshot
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new empty scene snapshot.
+			SceneSnapshot();
+			
+			
+		//********************************************************************************
+		//******	Destructor
+			
+			
+			/// Destroy a scene snapshot, releasing all object copies.
+			~SceneSnapshot();
+			
+			
+		//********************************************************************************
+		//******	Snapshot Update Method
+			
+			
+			/// Update this snapshot so that it matches the current state of the specified scene.
+			/**
+			  * This method must be called on the thread that modifies the scene, and not while
+			  * the snapshot is being used for sound propagation.
+			  */
+			void update( const SoundScene& scene );
+			
+			
+		//********************************************************************************
+		//******	Scene Accessor Method
+			
+			
+			/// Return a const reference to the scene that contains the copied objects.
+			GSOUND_INLINE const SoundScene& getScene() const
+			{
+				return snapshotScene;
+			}
+			
+			
+		//********************************************************************************
+		//******	IR Remapping Method
+			
+			
+			/// Replace the copied sources and listeners in the specified IR with the original objects.
+			void remapIR( SoundSceneIR& sceneIR ) const;
+			
+			
+		//********************************************************************************
+		//******	Snapshot Reset Method
+			
+			
+			/// Remove all objects from this snapshot, destroying the copies.
+			void clear();
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Copy Operations
+			
+			
+			/// Declared private so that a snapshot, which owns its object copies, cannot be copied.
+			SceneSnapshot( const SceneSnapshot& other );
+			
+			
+			/// Declared private so that a snapshot, which owns its object copies, cannot be copied.
+			SceneSnapshot& operator = ( const SceneSnapshot& other );
+			
+			
+		//********************************************************************************
+		//******	Private Class Declaration
+			
+			
+			/// A class that stores the copy of an original object and the last time it was in the scene.
+			template < typename ObjectType >
+			class Entry
+			{
+				public:
+					
+					GSOUND_INLINE Entry()
+						:	copy( NULL ),
+							timeStamp( 0 )
+					{
+					}
+					
+					GSOUND_INLINE Entry( ObjectType* newCopy, Index newTimeStamp )
+						:	copy( newCopy ),
+							timeStamp( newTimeStamp )
+					{
+					}
+					
+					/// The copy of the original object that is used by the snapshot scene.
+					ObjectType* copy;
+					
+					/// The snapshot time stamp when the original object was last in the scene.
+					Index timeStamp;
+					
+			};
+			
+			
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Update the copies of the specified original objects, storing the copies in the output list.
+			/**
+			  * If the original map is not NULL, new copies are added to it and destroyed copies
+			  * are removed from it. If the new copy list is not NULL, new copies are appended to it.
+			  */
+			template < typename ObjectType >
+			void updateObjects( const ArrayList<ObjectType*>& originals, ArrayList<ObjectType*>& copies,
+								HashMap<const ObjectType*,Entry<ObjectType> >& entries,
+								HashMap<const ObjectType*,const ObjectType*>* originalMap,
+								ArrayList<ObjectType*>* newCopies );
+			
+			
+			/// Copy the state of an original source that is needed for sound propagation.
+			static void copyState( const SoundSource& original, SoundSource& copy );
+			
+			
+			/// Copy the state of an original listener that is needed for sound propagation.
+			static void copyState( const SoundListener& original, SoundListener& copy );
+			
+			
+			/// Copy the state of an original object that is needed for sound propagation.
+			static void copyState( const SoundObject& original, SoundObject& copy );
+			
+			
+			/// Remove a source copy from the snapshot's source clusterer and destroy it.
+			void destroyCopy( SoundSource* copy );
+			
+			
+			/// Destroy a listener copy.
+			static void destroyCopy( SoundListener* copy );
+			
+			
+			/// Destroy an object copy.
+			static void destroyCopy( SoundObject* copy );
+			
+			
+			/// Return a hash code for the specified object pointer.
+			template < typename ObjectType >
+			GSOUND_FORCE_INLINE static Hash getPointerHash( const ObjectType* object )
+			{
+				return Hash(PointerInt(object) >> 4);
+			}
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// The scene that contains the copies of the original objects.
+			SoundScene snapshotScene;
+			
+			
+			/// A map from original sources to their copies.
+			HashMap<const SoundSource*,Entry<SoundSource> > sources;
+			
+			
+			/// A map from original listeners to their copies.
+			HashMap<const SoundListener*,Entry<SoundListener> > listeners;
+			
+			
+			/// A map from original objects to their copies.
+			HashMap<const SoundObject*,Entry<SoundObject> > objects;
+			
+			
+			/// A map from source copies to the original sources.
+			HashMap<const SoundSource*,const SoundSource*> originalSources;
+			
+			
+			/// A map from listener copies to the original listeners.
+			HashMap<const SoundListener*,const SoundListener*> originalListeners;
+			
+			
+			/// A temporary list of the source copies that were created on the current update.
+			ArrayList<SoundSource*> newSources;
+			
+			
+			/// The time stamp of the current snapshot, incremented on each update.
+			Index timeStamp;
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//**************************  End GSound Internal Namespace  *******************************
+GSOUND_INTERNAL_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SCENE_SNAPSHOT_H
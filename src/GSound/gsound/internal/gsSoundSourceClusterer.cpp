@@ -74,7 +74,6 @@ GSOUND_INTERNAL_NAMESPACE_START
 
 SoundSourceClusterer:: SoundSourceClusterer()
 	:	root( NULL ),
-		numClusters( 0 ),
 		numSources( 0 )
 {
 }
@@ -98,6 +97,14 @@ Bool SoundSourceClusterer:: addSource( SoundSource* newSource )
 	if ( newSource == NULL )
 		return false;
 	
+	const Hash hash = getSourceHash( newSource );
+	
+	// Don't add a source more than once.
+	if ( sourceNodes.contains( hash, newSource ) )
+		return false;
+	
+	// The source is inserted into the octree on the next update.
+	sourceNodes.add( hash, newSource, (Node*)NULL );
 	newSources.add( newSource );
 	numSources++;
 	
@@ -109,34 +116,42 @@ Bool SoundSourceClusterer:: addSource( SoundSource* newSource )
 
 Bool SoundSourceClusterer:: removeSource( SoundSource* newSource )
 {
-	if ( newSource == NULL || root == NULL )
+	if ( newSource == NULL )
 		return false;
 	
-	if ( removeSourceRecursive( newSource, root ) )
-	{
-		numSources--;
-		return true;
-	}
-	else
+	const Hash hash = getSourceHash( newSource );
+	Node** sourceNode;
+	
+	if ( !sourceNodes.find( hash, newSource, sourceNode ) )
 		return false;
+	
+	// Remove the source from the leaf node that contains it, or from the list of new sources.
+	if ( *sourceNode )
+		removeSourceFromNode( newSource, *sourceNode );
+	else
+		newSources.removeUnordered( newSource );
+	
+	sourceNodes.remove( hash, newSource );
+	numSources--;
+	
+	return true;
 }
 
 
 
 
-Bool SoundSourceClusterer:: removeSourceRecursive( SoundSource* source, Node* node )
+void SoundSourceClusterer:: clearSources()
 {
-	if ( node->isLeaf() )
-		return removeSourceFromNode( source, node );
-	else
+	if ( root )
 	{
-		Index childIndex = node->getChildIndex( source->getPosition() );
-		
-		if ( node->children[childIndex] )
-			return removeSourceRecursive( source, node->children[childIndex] );
-		else
-			return false;
+		util::destruct( root );
+		root = NULL;
 	}
+	
+	sourceNodes.clear();
+	newSources.clear();
+	numSources = 0;
+	clusters.clear();
 }
 
 
@@ -170,7 +185,8 @@ Bool SoundSourceClusterer:: removeSourceAtIndexInNode( Index sourceIndex, Node*
 
 
 void SoundSourceClusterer:: updateClusters( const SoundListener& listener, const SoundScene& scene,
-											Real innerClusteringAngle, Real outerClusteringAngle )
+											Real innerClusteringAngle, Real outerClusteringAngle,
+											ThreadPool* threadPool )
 {
 	//***********************************************************************************
 	// Update the octree with the new source positions.
@@ -184,10 +200,73 @@ void SoundSourceClusterer:: updateClusters( const SoundListener& listener, const
 	// Cluster the sources in their current configuration in the octree.
 	
 	// Reset the cluster list.
-	numClusters = 0;
+	clusters.clear();
 	
-	if ( root )
-		clusterSourcesRecursive( listener, scene, innerClusteringAngleRadians, outerClusteringAngleRadians, root );
+	if ( root == NULL )
+		return;
+	
+	// Find the leaf nodes that have sources. The sources in each leaf are clustered independently.
+	clusterLeafNodes.clear();
+	getClusterLeavesRecursive( root, clusterLeafNodes );
+	
+	const Size numLeaves = clusterLeafNodes.getSize();
+	
+	// Determine how many jobs to use, so that each job has enough sources to be worth the overhead.
+	Size numJobs = 1;
+	
+	if ( threadPool != NULL )
+	{
+		const Size minSourcesPerJob = 256;
+		numJobs = math::max( math::min( math::min( threadPool->getThreadCount(), numSources / minSourcesPerJob ), numLeaves ), Size(1) );
+	}
+	
+	while ( jobClusterLists.getSize() < numJobs )
+		jobClusterLists.add( ClusterList() );
+	
+	for ( Index j = 0; j < numJobs; j++ )
+		jobClusterLists[j].numClusters = 0;
+	
+	if ( numJobs > 1 )
+	{
+		// Split the leaves into contiguous ranges that contain roughly the same number of sources.
+		const Size sourcesPerJob = (numSources + numJobs - 1) / numJobs;
+		Index leafStartIndex = 0;
+		
+		for ( Index j = 0; j < numJobs && leafStartIndex < numLeaves; j++ )
+		{
+			Index leafEndIndex = leafStartIndex;
+			Size numJobSources = 0;
+			
+			while ( leafEndIndex < numLeaves && (numJobSources < sourcesPerJob || j == numJobs - 1) )
+			{
+				numJobSources += clusterLeafNodes[leafEndIndex]->leafData->sources.getSize();
+				leafEndIndex++;
+			}
+			
+			threadPool->addJob( FunctionCall< void ( const SoundListener&, const SoundScene&, Real, Real, Index, Size, ClusterList& )>(
+										bind( &SoundSourceClusterer::clusterLeaves, this ),
+										listener, scene, innerClusteringAngleRadians, outerClusteringAngleRadians,
+										leafStartIndex, leafEndIndex - leafStartIndex, jobClusterLists[j] ) );
+			
+			leafStartIndex = leafEndIndex;
+		}
+		
+		threadPool->finishJobs();
+	}
+	else
+	{
+		clusterLeaves( listener, scene, innerClusteringAngleRadians, outerClusteringAngleRadians,
+						0, numLeaves, jobClusterLists[0] );
+	}
+	
+	// Concatenate the clusters from each job in order, so that the result matches a serial update.
+	for ( Index j = 0; j < numJobs; j++ )
+	{
+		const ClusterList& jobClusters = jobClusterLists[j];
+		
+		for ( Index c = 0; c < jobClusters.numClusters; c++ )
+			clusters.add( &jobClusters.clusters[c] );
+	}
 }
 
 
@@ -253,7 +332,7 @@ void SoundSourceClusterer:: updateOctreeRecursive( const SoundListener& listener
 		Real minRadius = nodeDistance*math::tan( Real(0.5)*outerClusteringAngle );
 		
 		// Reorganize the node if it is too small or too large.
-		if ( node->radius < minRadius*Real(0.5) )
+		if ( node->parent != NULL && node->radius < minRadius*Real(0.5) )
 		{
 			// This node is too small, turn its parent into a leaf node containing all child sources.
 			Node* parent = node->parent;
@@ -264,7 +343,7 @@ void SoundSourceClusterer:: updateOctreeRecursive( const SoundListener& listener
 				if ( parent->children[i] )
 				{
 					// Add the sources from the child node to the parent.
-					getNodeSourcesRecursive( parent->children[i], parent->leafData->sources );
+					getNodeSourcesRecursive( parent->children[i], parent->leafData->sources, parent );
 					
 					// Destroy the child node.
 					util::destruct( parent->children[i] );
@@ -281,7 +360,13 @@ void SoundSourceClusterer:: updateOctreeRecursive( const SoundListener& listener
 			// It will be split when inserting them.
 			if ( node->leafData )
 			{
-				newSources.addAll( node->leafData->sources );
+				const ArrayList<SoundSource*>& leafSources = node->leafData->sources;
+				const Size numLeafSources = leafSources.getSize();
+				
+				for ( Index s = 0; s < numLeafSources; s++ )
+					setSourceNode( leafSources[s], NULL );
+				
+				newSources.addAll( leafSources );
 				util::destruct( node->leafData );
 				node->leafData = NULL;
 			}
@@ -299,6 +384,7 @@ void SoundSourceClusterer:: updateOctreeRecursive( const SoundListener& listener
 					removeSourceAtIndexInNode( s, node );
 					
 					// Add it to the list of new sources to be inserted.
+					setSourceNode( source, NULL );
 					newSources.add( source );
 					continue;
 				}
@@ -309,11 +395,38 @@ void SoundSourceClusterer:: updateOctreeRecursive( const SoundListener& listener
 	}
 	else
 	{
-		// Update child nodes.
-		for ( Index i = 0; i < 8; i++ )
+		// Update child nodes. The children may be collapsed into this node during the update.
+		for ( Index i = 0; i < 8 && node->children; i++ )
 		{
-			if ( node->children && node->children[i] )
-				updateOctreeRecursive( listener, outerClusteringAngle, node->children[i] );
+			Node* child = node->children[i];
+			
+			if ( child == NULL )
+				continue;
+			
+			// Remove empty leaf nodes so that the tree only contains the occupied regions.
+			if ( child->isLeaf() && (child->leafData == NULL || child->leafData->sources.getSize() == 0) )
+			{
+				util::destruct( child );
+				node->children[i] = NULL;
+				continue;
+			}
+			
+			updateOctreeRecursive( listener, outerClusteringAngle, child );
+		}
+		
+		// If all children were removed, this node becomes an empty leaf node.
+		if ( node->children )
+		{
+			Index i = 0;
+			
+			while ( i < 8 && node->children[i] == NULL )
+				i++;
+			
+			if ( i == 8 )
+			{
+				util::deallocate( node->children );
+				node->children = NULL;
+			}
 		}
 	}
 }
@@ -346,6 +459,7 @@ void SoundSourceClusterer:: insertSourceRecursive( const SoundListener& listener
 				
 				// Add this source to the node.
 				node->leafData->sources.add( source );
+				setSourceNode( source, node );
 			}
 			else
 			{
@@ -408,19 +522,27 @@ void SoundSourceClusterer:: insertSourceRecursive( const SoundListener& listener
 
 
 
-void SoundSourceClusterer:: getNodeSourcesRecursive( Node* node, ArrayList<SoundSource*>& sources )
+void SoundSourceClusterer:: getNodeSourcesRecursive( Node* node, ArrayList<SoundSource*>& sources, Node* leaf )
 {
 	if ( node->isLeaf() )
 	{
 		if ( node->leafData )
-			sources.addAll( node->leafData->sources );
+		{
+			const ArrayList<SoundSource*>& leafSources = node->leafData->sources;
+			const Size numLeafSources = leafSources.getSize();
+			
+			for ( Index s = 0; s < numLeafSources; s++ )
+				setSourceNode( leafSources[s], leaf );
+			
+			sources.addAll( leafSources );
+		}
 	}
 	else
 	{
 		for ( Index i = 0; i < 8; i++ )
 		{
 			if ( node->children[i] )
-				getNodeSourcesRecursive( node->children[i], sources );
+				getNodeSourcesRecursive( node->children[i], sources, leaf );
 		}
 	}
 }
@@ -439,152 +561,174 @@ void SoundSourceClusterer:: getNodeSourcesRecursive( Node* node, ArrayList<Sound
 
 
 
-void SoundSourceClusterer:: clusterSourcesRecursive( const SoundListener& listener, const SoundScene& scene,
-													Real innerClusteringAngleRadians, Real outerClusteringAngleRadians, Node* node )
+void SoundSourceClusterer:: getClusterLeavesRecursive( Node* node, ArrayList<Node*>& leaves )
 {
 	if ( node->isLeaf() )
 	{
-		if ( node->leafData )
+		if ( node->leafData && node->leafData->sources.getSize() > 0 )
+			leaves.add( node );
+	}
+	else
+	{
+		for ( Index i = 0; i < 8; i++ )
 		{
-			const ArrayList<SoundSource*>& leafSources = node->leafData->sources;
-			const Size numLeafSources = leafSources.getSize();
+			if ( node->children[i] )
+				getClusterLeavesRecursive( node->children[i], leaves );
+		}
+	}
+}
+
+
+
+
+void SoundSourceClusterer:: clusterLeaves( const SoundListener& listener, const SoundScene& scene,
+											Real innerClusteringAngleRadians, Real outerClusteringAngleRadians,
+											Index leafStartIndex, Size numLeaves, ClusterList& output )
+{
+	const Index leafEndIndex = leafStartIndex + numLeaves;
+	
+	for ( Index i = leafStartIndex; i < leafEndIndex; i++ )
+	{
+		clusterLeafSources( listener, scene, innerClusteringAngleRadians, outerClusteringAngleRadians,
+							clusterLeafNodes[i], output );
+	}
+}
+
+
+
+
+void SoundSourceClusterer:: clusterLeafSources( const SoundListener& listener, const SoundScene& scene,
+												Real innerClusteringAngleRadians, Real outerClusteringAngleRadians,
+												const Node* node, ClusterList& output )
+{
+	const ArrayList<SoundSource*>& leafSources = node->leafData->sources;
+	const Size numLeafSources = leafSources.getSize();
+	
+	if ( output.leafSourcesClustered.getSize() < numLeafSources )
+		output.leafSourcesClustered.setSize( numLeafSources );
+	
+	for ( Index s = 0; s < numLeafSources; s++ )
+		output.leafSourcesClustered[s] = false;
+	
+	// For each source that has not yet been clustered,
+	// find all other sources that could be in a cluster with that source.
+	for ( Index s = 0; s < numLeafSources; s++ )
+	{
+		// Skip sources that have already been clustered.
+		if ( output.leafSourcesClustered[s] )
+			continue;
+		
+		SoundSource* source = leafSources[s];
+		
+		// Skip disabled sources.
+		if ( !source->getIsEnabled() )
+			continue;
+		
+		Vector3f sourceVector = (source->getPosition() - listener.getPosition()).normalize();
+		
+		// Mark this source as clustered.
+		output.leafSourcesClustered[s] = true;
+		
+		// Create a new cluster for this source.
+		SoundSourceCluster& sourceCluster = output.getNewCluster();
+		sourceCluster.addSource( source );
+		Real maxD = 0;
+		
+		for ( Index s2 = s + 1; s2 < numLeafSources; s2++ )
+		{
+			// Skip other sources that have already been clustered.
+			if ( output.leafSourcesClustered[s2] )
+				continue;
 			
-			if ( leafSourcesClustered.getSize() < numLeafSources )
-				leafSourcesClustered.setSize( numLeafSources );
+			SoundSource* source2 = leafSources[s2];
 			
-			for ( Index s = 0; s < numLeafSources; s++ )
-				leafSourcesClustered[s] = false;
+			// Skip disabled sources.
+			if ( !source2->getIsEnabled() )
+				continue;
 			
-			// For each source that has not yet been clustered,
-			// find all other sources that could be in a cluster with that source.
-			for ( Index s = 0; s < numLeafSources; s++ )
+			Vector3f source2Vector = (source2->getPosition() - listener.getPosition()).normalize();
+			
+			// Determine the distance between the sources.
+			Vector3f sToS2 = source2->getPosition() - source->getPosition();
+			Real d;
+			sToS2.normalize( d );
+			maxD = math::max( d, maxD );
+			
+			// Compute the max clustering distances for the source midpoint.
+			Vector3f midpoint = math::midpoint( source->getPosition(), source2->getPosition() );
+			Real midD = (midpoint - listener.getPosition()).getMagnitude();
+			Real outerD = 2*midD*math::tan( Real(0.5)*innerClusteringAngleRadians );
+			
+			// Compute the angle between the sources from the listener's perspective.
+			Real angle = math::acos( math::dot( sourceVector, source2Vector ) );
+			
+			if ( angle < innerClusteringAngleRadians && d < outerD )
 			{
-				// Skip sources that have already been clustered.
-				if ( leafSourcesClustered[s] )
-					continue;
-				
-				SoundSource* source = leafSources[s];
+				Ray3f testRay( source->getPosition() + sToS2*source->getRadius(), sToS2 );
+				Real rayDistance = math::max( d - source->getRadius() - source2->getRadius(), Real(0) );
 				
-				// Skip disabled sources.
-				if ( !source->getIsEnabled() )
+				// Skip this source if it is not visible from the first one.
+				if ( !scene.intersectRay( testRay, rayDistance ) )
 					continue;
 				
-				Vector3f sourceVector = (source->getPosition() - listener.getPosition()).normalize();
-				
-				// Mark this source as clustered.
-				leafSourcesClustered[s] = true;
-				
-				// Create a new cluster for this source.
-				SoundSourceCluster& sourceCluster = getNewSourceCluster();
-				sourceCluster.addSource( source );
-				Real maxD = 0;
-				
-				for ( Index s2 = s + 1; s2 < numLeafSources; s2++ )
-				{
-					// Skip other sources that have already been clustered.
-					if ( leafSourcesClustered[s2] )
-						continue;
-					
-					SoundSource* source2 = leafSources[s2];
-					
-					// Skip disabled sources.
-					if ( !source2->getIsEnabled() )
-						continue;
-					
-					Vector3f source2Vector = (source2->getPosition() - listener.getPosition()).normalize();
-					
-					// Determine the distance between the sources.
-					Vector3f sToS2 = source2->getPosition() - source->getPosition();
-					Real d;
-					sToS2.normalize( d );
-					maxD = math::max( d, maxD );
-					
-					// Compute the max clustering distances for the source midpoint.
-					Vector3f midpoint = math::midpoint( source->getPosition(), source2->getPosition() );
-					Real midD = (midpoint - listener.getPosition()).getMagnitude();
-					Real outerD = 2*midD*math::tan( Real(0.5)*innerClusteringAngleRadians );
-					
-					// Compute the angle between the sources from the listener's perspective.
-					Real angle = math::acos( math::dot( sourceVector, source2Vector ) );
-					
-					if ( angle < innerClusteringAngleRadians && d < outerD )
-					{
-						Ray3f testRay( source->getPosition() + sToS2*source->getRadius(), sToS2 );
-						Real rayDistance = math::max( d - source->getRadius() - source2->getRadius(), Real(0) );
-						
-						// Skip this source if it is not visible from the first one.
-						if ( !scene.intersectRay( testRay, rayDistance ) )
-							continue;
-						
-						// Cluster the sources.
-						leafSourcesClustered[s2] = true;
-						sourceCluster.addSource( source2 );
-					}
-				}
-				
-				// After the cluster has been finalized, determine whether or not the sources should be merged.
-				// Sources are merged when the angular size of the cluster is less than the inner clustering angle.
-				
-				Vector3f centroid = sourceCluster.getCentroid();
-				const Size numClusteredSources = sourceCluster.getSourceCount();
-				
-				// Compute the bounding sphere of the sources in the cluster, centered at the centroid.
-				Sphere3f bs( centroid, sourceCluster.getSource(0)->getRadius() );
-				
-				for ( Index i = 0; i < numClusteredSources; i++ )
-				{
-					Sphere3f sourceBS( sourceCluster.getSource(i)->getPosition(), sourceCluster.getSource(i)->getRadius() );
-					Real maxR = bs.position.getDistanceTo( sourceBS.position );// + sourceBS.radius;
-					
-					if ( maxR > bs.radius )
-						bs.radius = maxR;
-				}
-				
-				// Set the cluster's position and radius.
-				sourceCluster.setPosition( bs.position );
-				sourceCluster.setRadius( bs.radius );
-				
-				// Compute the angular size of the cluster from the listener's perspective.
-				
-				Sphere3f bs2( sourceCluster.getSource(0)->getPosition(), sourceCluster.getSource(0)->getRadius() );
-				
-				for ( Index i = 1; i < numClusteredSources; i++ )
-					bs2.enlargeFor( sourceCluster.getSource(i)->getPosition() );
-				
-				maxD = math::max( maxD, sourceCluster.getSource(0)->getRadius()*Real(2) );
-				
-				Real angularSize = Real(2)*math::atan( math::min( Real(0.5)*maxD, bs2.radius ) / listener.getPosition().getDistanceTo( bs2.position ) );
-				
-				// If the max spread is less than the inner clustering angle, merge the sources.
-				//if ( angularSize < Real(1.1)*innerClusteringAngleRadians )
-					sourceCluster.setIsMerged( true );
-				/*else
-				{
-					sourceCluster.setIsMerged( false );
-					
-					// Determine how much to interpolate the source positions with the merged position.
-					Real interp = math::clamp( math::max( (outerClusteringAngleRadians - angularSize), Real(0) )/
-												(outerClusteringAngleRadians - innerClusteringAngleRadians),
-												Real(0), Real(1) );
-					
-					// Set the interpolated source positions.
-					for ( Index i = 0; i < numClusteredSources; i++ )
-					{
-						sourceCluster.setSourcePosition( i, centroid*interp +
-															sourceCluster.getSource(i)->getPosition()*(Real(1) - interp) );
-					}
-				}*/
+				// Cluster the sources.
+				output.leafSourcesClustered[s2] = true;
+				sourceCluster.addSource( source2 );
 			}
 		}
-	}
-	else
-	{
-		for ( Index i = 0; i < 8; i++ )
+		
+		// After the cluster has been finalized, determine whether or not the sources should be merged.
+		// Sources are merged when the angular size of the cluster is less than the inner clustering angle.
+		
+		Vector3f centroid = sourceCluster.getCentroid();
+		const Size numClusteredSources = sourceCluster.getSourceCount();
+		
+		// Compute the bounding sphere of the sources in the cluster, centered at the centroid.
+		Sphere3f bs( centroid, sourceCluster.getSource(0)->getRadius() );
+		
+		for ( Index i = 0; i < numClusteredSources; i++ )
 		{
-			if ( node->children[i] )
-				clusterSourcesRecursive( listener, scene, innerClusteringAngleRadians,
-										outerClusteringAngleRadians, node->children[i] );
+			Sphere3f sourceBS( sourceCluster.getSource(i)->getPosition(), sourceCluster.getSource(i)->getRadius() );
+			Real maxR = bs.position.getDistanceTo( sourceBS.position );// + sourceBS.radius;
+			
+			if ( maxR > bs.radius )
+				bs.radius = maxR;
 		}
+		
+		// Set the cluster's position and radius.
+		sourceCluster.setPosition( bs.position );
+		sourceCluster.setRadius( bs.radius );
+		
+		// Compute the angular size of the cluster from the listener's perspective.
+		
+		Sphere3f bs2( sourceCluster.getSource(0)->getPosition(), sourceCluster.getSource(0)->getRadius() );
+		
+		for ( Index i = 1; i < numClusteredSources; i++ )
+			bs2.enlargeFor( sourceCluster.getSource(i)->getPosition() );
+		
+		maxD = math::max( maxD, sourceCluster.getSource(0)->getRadius()*Real(2) );
+		
+		Real angularSize = Real(2)*math::atan( math::min( Real(0.5)*maxD, bs2.radius ) / listener.getPosition().getDistanceTo( bs2.position ) );
+		
+		// If the max spread is less than the inner clustering angle, merge the sources.
+		//if ( angularSize < Real(1.1)*innerClusteringAngleRadians )
+			sourceCluster.setIsMerged( true );
+		/*else
+		{
+			sourceCluster.setIsMerged( false );
+			
+			// Determine how much to interpolate the source positions with the merged position.
+			Real interp = math::clamp( math::max( (outerClusteringAngleRadians - angularSize), Real(0) )/
+										(outerClusteringAngleRadians - innerClusteringAngleRadians),
+										Real(0), Real(1) );
+			
+			// Set the interpolated source positions.
+			for ( Index i = 0; i < numClusteredSources; i++ )
+			{
+				sourceCluster.setSourcePosition( i, centroid*interp +
+													sourceCluster.getSource(i)->getPosition()*(Real(1) - interp) );
+			}
+		}*/
 	}
 }
 
@@ -113,6 +113,10 @@ class SoundSourceClusterer
 			Bool removeSource( SoundSource* newSource );
 			
 			
+			/// Remove all sound sources and clusters from this clusterer.
+			void clearSources();
+			
+			
 		//********************************************************************************
 		//******	Source Cluster Accessor Methods
 			
@@ -120,14 +124,14 @@ class SoundSourceClusterer
 			/// Return the number of sound source clusters that are in this clusterer.
 			GSOUND_FORCE_INLINE Size getClusterCount() const
 			{
-				return numClusters;
+				return clusters.getSize();
 			}
 			
 			
 			/// Return a pointer to the sound source cluster at the specified index in this clusterer.
 			GSOUND_FORCE_INLINE const SoundSourceCluster* getCluster( Index clusterIndex ) const
 			{
-				return &sourceClusters[clusterIndex];
+				return clusters[clusterIndex];
 			}
 			
 			
@@ -138,9 +142,12 @@ class SoundSourceClusterer
 			/// Update the source clusters in this clusterer for the specified listener.
 			/**
 			  * The clusterer uses the scene to do ray-based occlusion queries.
+			  * If a thread pool is given and there are enough sources, the octree leaves are
+			  * clustered in parallel on the pool's threads. The resulting clusters are the same.
 			  */
 			void updateClusters( const SoundListener& listener, const SoundScene& scene,
-								Real innerClusteringAngle, Real outerClusteringAngle );
+								Real innerClusteringAngle, Real outerClusteringAngle,
+								ThreadPool* threadPool = NULL );
 			
 			
 	private:
@@ -260,6 +267,45 @@ class SoundSourceClusterer
 			};
 			
 			
+			/// A class that stores the clusters that are generated by one clustering job.
+			class ClusterList
+			{
+				public:
+					
+					GSOUND_INLINE ClusterList()
+						:	numClusters( 0 )
+					{
+					}
+					
+					
+					/// Return a reference to a new empty cluster at the end of this list.
+					GSOUND_INLINE SoundSourceCluster& getNewCluster()
+					{
+						if ( numClusters == clusters.getSize() )
+							clusters.add( SoundSourceCluster() );
+						
+						SoundSourceCluster& sourceCluster = clusters[numClusters];
+						sourceCluster.clearSources();
+						numClusters++;
+						
+						return sourceCluster;
+					}
+					
+					
+					/// A list of the sound source clusters that have been created.
+					ArrayList<SoundSourceCluster> clusters;
+					
+					
+					/// The number of clusters that are valid in the list of clusters.
+					Size numClusters;
+					
+					
+					/// A temporary array used to keep track of which sources in a leaf are clustered.
+					Array<Bool> leafSourcesClustered;
+					
+			};
+			
+			
 		//********************************************************************************
 		//******	Octree Update Methods
 			
@@ -274,37 +320,49 @@ class SoundSourceClusterer
 			void insertSourceRecursive( const SoundListener& listener, Real outerClusteringAngle, SoundSource* source, Node* node );
 			
 			
-			Bool addSourceToNode( SoundSource* source, const SoundListener& listener, Real outerClusteringAngle, Node* node );
+			Bool removeSourceFromNode( SoundSource* source, Node* node );
+			Bool removeSourceAtIndexInNode( Index sourceIndex, Node* node );
 			
 			
-			Bool removeSourceRecursive( SoundSource* source, Node* node );
+			/// Add the sources from the specified subtree to the list, marking them as belonging to the given leaf node.
+			void getNodeSourcesRecursive( Node* node, ArrayList<SoundSource*>& sources, Node* leaf );
 			
-			Bool removeSourceFromNode( SoundSource* source, Node* node );
-			Bool removeSourceAtIndexInNode( Index sourceIndex, Node* node );
+			
+			/// Set the leaf node that the specified source is stored in, or NULL if it is waiting to be inserted.
+			GSOUND_INLINE void setSourceNode( SoundSource* source, Node* node )
+			{
+				Node** sourceNode;
+				
+				if ( sourceNodes.find( getSourceHash( source ), source, sourceNode ) )
+					*sourceNode = node;
+			}
 			
 			
-			void getNodeSourcesRecursive( Node* node, ArrayList<SoundSource*>& sources );
+			/// Return a hash code for the specified source pointer.
+			GSOUND_FORCE_INLINE static Hash getSourceHash( const SoundSource* source )
+			{
+				return Hash(PointerInt(source) >> 4);
+			}
 			
 			
 		//********************************************************************************
 		//******	Cluster Update Methods
 			
 			
-			void clusterSourcesRecursive( const SoundListener& listener, const SoundScene& scene,
-										Real innerClusteringAngleRadians, Real outerClusteringAngleRadians, Node* node );
+			/// Append the non-empty leaf nodes in the specified subtree to the output list.
+			void getClusterLeavesRecursive( Node* node, ArrayList<Node*>& leaves );
 			
 			
-			GSOUND_INLINE SoundSourceCluster& getNewSourceCluster()
-			{
-				if ( numClusters == sourceClusters.getSize() )
-					sourceClusters.add( SoundSourceCluster() );
-				
-				SoundSourceCluster& sourceCluster = sourceClusters[numClusters];
-				sourceCluster.clearSources();
-				numClusters++;
-				
-				return sourceCluster;
-			}
+			/// Cluster the sources of the leaf nodes in the specified range, appending the clusters to the output list.
+			void clusterLeaves( const SoundListener& listener, const SoundScene& scene,
+								Real innerClusteringAngleRadians, Real outerClusteringAngleRadians,
+								Index leafStartIndex, Size numLeaves, ClusterList& output );
+			
+			
+			/// Cluster the sources of a single leaf node, appending the clusters to the output list.
+			void clusterLeafSources( const SoundListener& listener, const SoundScene& scene,
+									Real innerClusteringAngleRadians, Real outerClusteringAngleRadians,
+									const Node* node, ClusterList& output );
 			
 			
 		//********************************************************************************
@@ -315,20 +373,29 @@ class SoundSourceClusterer
 			Node* root;
 			
 			
-			/// A list of the sound source clusters that have been created.
-			ArrayList<SoundSourceCluster> sourceClusters;
+			/// Pointers to the sound source clusters that were created by the last update, in octree order.
+			ArrayList<const SoundSourceCluster*> clusters;
 			
 			
-			/// The number of clusters that are valid in the list of clusters.
-			Size numClusters;
+			/// The cluster lists for each clustering job that store the clusters from the last update.
+			ArrayList<ClusterList> jobClusterLists;
 			
 			
-			/// A list of sources that have not yet been inserted into the octree.
-			ArrayList<SoundSource*> newSources;
+			/// A temporary list of the non-empty leaf nodes in the octree, in depth-first order.
+			ArrayList<Node*> clusterLeafNodes;
 			
 			
-			/// A temporary array used to keep track of which sources are clustered.
-			Array<Bool> leafSourcesClustered;
+			/// A map from each source in this clusterer to the leaf node that contains it.
+			/**
+			  * Sources that have not yet been inserted into the octree map to NULL.
+			  * This allows sources to be removed without searching the octree,
+			  * even if they have moved since the last update.
+			  */
+			HashMap<SoundSource*,Node*> sourceNodes;
+			
+			
+			/// A list of sources that have not yet been inserted into the octree.
+			ArrayList<SoundSource*> newSources;
 			
 			
 			/// The total number of sources that are currently in this sound source clusterer.
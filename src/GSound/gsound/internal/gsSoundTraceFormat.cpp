@@ -0,0 +1,663 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/internal/gsSoundTraceFormat.cpp
+ * Contents:    gsound::internal::SoundTraceFormat class implementation
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+
+#include "gsSoundTraceFormat.h"
+
+
+//##########################################################################################
+//**************************  Start GSound Internal Namespace  *****************************
+GSOUND_INTERNAL_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		File Header Declaration
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// The header at the start of a sound propagation trace file.
+class SoundTraceHeader
+{
+	public:
+		
+		/// The magic bytes that identify a trace file.
+		UByte magic[8];
+		
+		/// The version number of the trace file format.
+		UInt32 version;
+		
+		/// A known value that is used to reject files written with a different endianness.
+		UInt32 endianMarker;
+		
+		
+};
+
+
+
+
+/// The header that precedes the payload of each record in a trace file.
+class SoundTraceRecordHeader
+{
+	public:
+		
+		/// The type of the record, one of the SoundTraceFormat::RecordType values.
+		UInt32 type;
+		
+		/// The size in bytes of the record payload that follows this header.
+		UInt32 payloadSize;
+		
+		
+};
+
+
+
+
+static const UByte SOUND_TRACE_MAGIC[8] = { 'G', 'S', 'T', 'R', 'A', 'C', 'E', 0 };
+static const UInt32 SOUND_TRACE_VERSION = 1;
+static const UInt32 SOUND_TRACE_ENDIAN_MARKER = 0x01020304;
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		File Structure Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool SoundTraceFormat:: writeHeader( om::DataOutputStream& stream )
+{
+	SoundTraceHeader header;
+	om::util::zeroPOD( &header, 1 );
+	om::util::copyPOD( header.magic, SOUND_TRACE_MAGIC, sizeof(SOUND_TRACE_MAGIC) );
+	header.version = SOUND_TRACE_VERSION;
+	header.endianMarker = SOUND_TRACE_ENDIAN_MARKER;
+	
+	return stream.writeData( (const UByte*)&header, sizeof(SoundTraceHeader) ) == sizeof(SoundTraceHeader);
+}
+
+
+
+
+Bool SoundTraceFormat:: readHeader( om::DataInputStream& stream )
+{
+	SoundTraceHeader header;
+	
+	if ( stream.readData( (UByte*)&header, sizeof(SoundTraceHeader) ) < sizeof(SoundTraceHeader) )
+		return false;
+	
+	return std::memcmp( header.magic, SOUND_TRACE_MAGIC, sizeof(SOUND_TRACE_MAGIC) ) == 0 &&
+			header.version == SOUND_TRACE_VERSION &&
+			header.endianMarker == SOUND_TRACE_ENDIAN_MARKER;
+}
+
+
+
+
+Bool SoundTraceFormat:: writeRecord( om::DataOutputStream& stream, RecordType type, const UByte* payload, Size payloadSize )
+{
+	SoundTraceRecordHeader header;
+	header.type = (UInt32)type;
+	header.payloadSize = (UInt32)payloadSize;
+	
+	return stream.writeData( (const UByte*)&header, sizeof(SoundTraceRecordHeader) ) == sizeof(SoundTraceRecordHeader) &&
+			stream.writeData( payload, payloadSize ) == payloadSize;
+}
+
+
+
+
+Bool SoundTraceFormat:: readRecordHeader( om::DataInputStream& stream, UInt32& type, Size& payloadSize )
+{
+	SoundTraceRecordHeader header;
+	
+	if ( stream.readData( (UByte*)&header, sizeof(SoundTraceRecordHeader) ) < sizeof(SoundTraceRecordHeader) )
+		return false;
+	
+	type = header.type;
+	payloadSize = header.payloadSize;
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Request Encoding Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundTraceFormat:: writeRequest( om::BinaryEncoder& encoder, const PropagationRequest& request )
+{
+	encoder.write( (UInt32)request.flags );
+	encoder.write( request.dt );
+	encoder.write( request.targetDt );
+	encoder.write( request.minIRLength );
+	encoder.write( request.maxIRLength );
+	encoder.write( request.irGrowthRate );
+	encoder.write( request.quality );
+	encoder.write( request.minQuality );
+	encoder.write( request.maxQuality );
+	encoder.write( UInt64(request.numThreads) );
+	writeFrequencies( encoder, request.frequencies );
+	encoder.write( Float64(request.sampleRate) );
+	encoder.write( request.dopplerThreshold );
+	encoder.write( UInt64(request.numDirectRays) );
+	encoder.write( UInt64(request.maxDiffractionDepth) );
+	encoder.write( UInt64(request.maxDiffractionOrder) );
+	encoder.write( UInt64(request.maxSpecularDepth) );
+	encoder.write( UInt64(request.numSpecularRays) );
+	encoder.write( UInt64(request.numSpecularSamples) );
+	encoder.write( UInt64(request.maxDiffuseDepth) );
+	encoder.write( UInt64(request.numDiffuseRays) );
+	encoder.write( UInt64(request.raySliceCount) );
+	encoder.write( UInt64(request.numDiffuseSamples) );
+	encoder.write( UInt64(request.numVisibilityRays) );
+	encoder.write( request.rayOffset );
+	encoder.write( request.responseTime );
+	encoder.write( request.visibilityCacheTime );
+	encoder.write( request.innerClusteringAngle );
+	encoder.write( request.outerClusteringAngle );
+}
+
+
+
+
+Bool SoundTraceFormat:: readRequest( om::BinaryDecoder& decoder, PropagationRequest& request )
+{
+	Float64 sampleRate = 0;
+	Bool result = true;
+	
+	result &= readFlags( decoder, request.flags );
+	result &= decoder.read( request.dt );
+	result &= decoder.read( request.targetDt );
+	result &= decoder.read( request.minIRLength );
+	result &= decoder.read( request.maxIRLength );
+	result &= decoder.read( request.irGrowthRate );
+	result &= decoder.read( request.quality );
+	result &= decoder.read( request.minQuality );
+	result &= decoder.read( request.maxQuality );
+	result &= readSize( decoder, request.numThreads );
+	result &= readFrequencies( decoder, request.frequencies );
+	result &= decoder.read( sampleRate );
+	result &= decoder.read( request.dopplerThreshold );
+	result &= readSize( decoder, request.numDirectRays );
+	result &= readSize( decoder, request.maxDiffractionDepth );
+	result &= readSize( decoder, request.maxDiffractionOrder );
+	result &= readSize( decoder, request.maxSpecularDepth );
+	result &= readSize( decoder, request.numSpecularRays );
+	result &= readSize( decoder, request.numSpecularSamples );
+	result &= readSize( decoder, request.maxDiffuseDepth );
+	result &= readSize( decoder, request.numDiffuseRays );
+	result &= readSize( decoder, request.raySliceCount );
+	result &= readSize( decoder, request.numDiffuseSamples );
+	result &= readSize( decoder, request.numVisibilityRays );
+	result &= decoder.read( request.rayOffset );
+	result &= decoder.read( request.responseTime );
+	result &= decoder.read( request.visibilityCacheTime );
+	result &= decoder.read( request.innerClusteringAngle );
+	result &= decoder.read( request.outerClusteringAngle );
+	
+	request.sampleRate = sampleRate;
+	
+	return result;
+}
+
+
+
+
+void SoundTraceFormat:: writeRenderRequest( om::BinaryEncoder& encoder, const RenderRequest& request )
+{
+	encoder.write( (UInt32)request.flags );
+	encoder.write( (UInt32)request.channelLayout.getType() );
+	encoder.write( UInt64(request.channelLayout.getChannelCount()) );
+	encoder.write( UInt64(request.maxHRTFOrder) );
+	encoder.writeUTF8String( request.hrtfCachePath );
+	encoder.write( Float64(request.sampleRate) );
+	writeFrequencies( encoder, request.frequencies );
+	encoder.write( UInt64(request.numThreads) );
+	encoder.write( UInt64(request.numUpdateThreads) );
+	encoder.write( request.maxIRLength );
+	encoder.write( request.earlyIRLength );
+	encoder.write( request.maxLatency );
+	encoder.write( UInt64(request.maxSourcePathCount) );
+	encoder.write( request.renderingLoadBudget );
+	encoder.write( request.minClusterQuality );
+	encoder.write( request.maxPathDelay );
+	encoder.write( request.maxDelayRate );
+	encoder.write( request.irFadeTime );
+	encoder.write( request.pathFadeTime );
+	encoder.write( request.hrtfFadeTime );
+	encoder.write( request.sourceFadeTime );
+	encoder.write( request.clusterFadeInTime );
+	encoder.write( request.clusterFadeOutTime );
+	encoder.write( request.volume );
+}
+
+
+
+
+Bool SoundTraceFormat:: readRenderRequest( om::BinaryDecoder& decoder, RenderRequest& request )
+{
+	UInt32 layoutType = 0;
+	Size numChannels = 0;
+	Float64 sampleRate = 0;
+	Bool result = true;
+	
+	result &= readFlags( decoder, request.flags );
+	result &= decoder.read( layoutType );
+	result &= readSize( decoder, numChannels );
+	result &= readSize( decoder, request.maxHRTFOrder );
+	request.hrtfCachePath = decoder.readUTF8String();
+	result &= decoder.read( sampleRate );
+	result &= readFrequencies( decoder, request.frequencies );
+	result &= readSize( decoder, request.numThreads );
+	result &= readSize( decoder, request.numUpdateThreads );
+	result &= decoder.read( request.maxIRLength );
+	result &= decoder.read( request.earlyIRLength );
+	result &= decoder.read( request.maxLatency );
+	result &= readSize( decoder, request.maxSourcePathCount );
+	result &= decoder.read( request.renderingLoadBudget );
+	result &= decoder.read( request.minClusterQuality );
+	result &= decoder.read( request.maxPathDelay );
+	result &= decoder.read( request.maxDelayRate );
+	result &= decoder.read( request.irFadeTime );
+	result &= decoder.read( request.pathFadeTime );
+	result &= decoder.read( request.hrtfFadeTime );
+	result &= decoder.read( request.sourceFadeTime );
+	result &= decoder.read( request.clusterFadeInTime );
+	result &= decoder.read( request.clusterFadeOutTime );
+	result &= decoder.read( request.volume );
+	
+	// Custom layouts only keep their channel count, predefined layouts are restored by type.
+	if ( ChannelLayout::Type(layoutType) == ChannelLayout::CUSTOM )
+		request.channelLayout = ChannelLayout( numChannels );
+	else
+		request.channelLayout = ChannelLayout( ChannelLayout::Type(layoutType) );
+	
+	request.sampleRate = sampleRate;
+	request.hrtf = NULL;
+	
+	return result;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Scene State Encoding Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundTraceFormat:: writeSceneState( om::BinaryEncoder& encoder, const SoundScene& scene )
+{
+	const SoundMedium& medium = scene.getMedium();
+	const FrequencyBandResponse& absorption = medium.getAbsorption();
+	
+	encoder.write( medium.getSpeed() );
+	
+	for ( Index i = 0; i < GSOUND_FREQUENCY_COUNT; i++ )
+		encoder.write( absorption[i] );
+	
+	encoder.write( scene.getReverbTime() );
+}
+
+
+
+
+Bool SoundTraceFormat:: readSceneState( om::BinaryDecoder& decoder, SoundScene& scene )
+{
+	SoundMedium& medium = scene.getMedium();
+	FrequencyBandResponse absorption;
+	Real speed = 0, reverbTime = 0;
+	Bool result = true;
+	
+	result &= decoder.read( speed );
+	
+	for ( Index i = 0; i < GSOUND_FREQUENCY_COUNT; i++ )
+		result &= decoder.read( absorption[i] );
+	
+	result &= decoder.read( reverbTime );
+	
+	medium.setSpeed( speed );
+	medium.setAbsorption( absorption );
+	scene.setReverbTime( reverbTime );
+	
+	return result;
+}
+
+
+
+
+void SoundTraceFormat:: writeObject( om::BinaryEncoder& encoder, const SoundObject& object, UInt32 meshID )
+{
+	encoder.write( meshID );
+	encoder.write( object.getTransform() );
+	encoder.write( object.getVelocity() );
+	encoder.write( (UInt32)object.getFlags() );
+}
+
+
+
+
+Bool SoundTraceFormat:: readObject( om::BinaryDecoder& decoder, SoundObject& object, UInt32& meshID )
+{
+	Transform3f transform;
+	Vector3f velocity;
+	SoundObjectFlags flags;
+	Bool result = true;
+	
+	result &= decoder.read( meshID );
+	result &= decoder.read( transform );
+	result &= decoder.read( velocity );
+	result &= readFlags( decoder, flags );
+	
+	object.setTransform( transform );
+	object.setVelocity( velocity );
+	object.setFlags( flags );
+	
+	return result;
+}
+
+
+
+
+void SoundTraceFormat:: writeSource( om::BinaryEncoder& encoder, const SoundSource& source, UInt32 directivityID )
+{
+	encoder.write( source.getPosition() );
+	encoder.write( source.getOrientation() );
+	encoder.write( source.getVelocity() );
+	encoder.write( source.getRadius() );
+	encoder.write( source.getPower() );
+	encoder.write( source.getPriority() );
+	encoder.write( (UInt32)source.getFlags() );
+	encoder.write( directivityID );
+}
+
+
+
+
+Bool SoundTraceFormat:: readSource( om::BinaryDecoder& decoder, SoundSource& source, UInt32& directivityID )
+{
+	Vector3f position, velocity;
+	Matrix3f orientation;
+	Real radius = 0, power = 0;
+	Float priority = 0;
+	SoundSourceFlags flags;
+	Bool result = true;
+	
+	result &= decoder.read( position );
+	result &= decoder.read( orientation );
+	result &= decoder.read( velocity );
+	result &= decoder.read( radius );
+	result &= decoder.read( power );
+	result &= decoder.read( priority );
+	result &= readFlags( decoder, flags );
+	result &= decoder.read( directivityID );
+	
+	source.setPosition( position );
+	source.setOrientationRaw( orientation );
+	source.setVelocity( velocity );
+	source.setRadius( radius );
+	source.setPower( power );
+	source.setPriority( priority );
+	source.setFlags( flags );
+	
+	return result;
+}
+
+
+
+
+void SoundTraceFormat:: writeListener( om::BinaryEncoder& encoder, const SoundListener& listener )
+{
+	encoder.write( listener.getPosition() );
+	encoder.write( listener.getOrientation() );
+	encoder.write( listener.getVelocity() );
+	encoder.write( listener.getRadius() );
+	encoder.write( listener.getSensitivity() );
+	encoder.write( listener.getThresholdBias() );
+	writeResponse( encoder, listener.getThreshold() );
+	encoder.write( (UInt32)listener.getFlags() );
+}
+
+
+
+
+Bool SoundTraceFormat:: readListener( om::BinaryDecoder& decoder, SoundListener& listener )
+{
+	Vector3f position, velocity;
+	Matrix3f orientation;
+	Real radius = 0;
+	Float sensitivity = 0, thresholdBias = 0;
+	FrequencyResponse threshold;
+	SoundListenerFlags flags;
+	Bool result = true;
+	
+	result &= decoder.read( position );
+	result &= decoder.read( orientation );
+	result &= decoder.read( velocity );
+	result &= decoder.read( radius );
+	result &= decoder.read( sensitivity );
+	result &= decoder.read( thresholdBias );
+	result &= readResponse( decoder, threshold );
+	result &= readFlags( decoder, flags );
+	
+	listener.setPosition( position );
+	listener.setOrientationRaw( orientation );
+	listener.setVelocity( velocity );
+	listener.setRadius( radius );
+	listener.setSensitivity( sensitivity );
+	listener.setThresholdBias( thresholdBias );
+	listener.setThreshold( threshold );
+	listener.setFlags( flags );
+	
+	return result;
+}
+
+
+
+
+void SoundTraceFormat:: writeDirectivity( om::BinaryEncoder& encoder, const SoundDirectivity& directivity )
+{
+	const Size numSamples = directivity.getSampleCount();
+	
+	encoder.writeUTF8String( directivity.getName() );
+	encoder.write( directivity.getOrientation() );
+	encoder.write( UInt64(numSamples) );
+	
+	for ( Index i = 0; i < numSamples; i++ )
+	{
+		encoder.write( directivity.getSampleDirection(i) );
+		writeResponse( encoder, directivity.getSample(i) );
+	}
+}
+
+
+
+
+Bool SoundTraceFormat:: readDirectivity( om::BinaryDecoder& decoder, SoundDirectivity& directivity )
+{
+	Matrix3f orientation;
+	Size numSamples = 0;
+	Bool result = true;
+	
+	directivity.reset();
+	directivity.setName( decoder.readUTF8String() );
+	result &= decoder.read( orientation );
+	result &= readSize( decoder, numSamples );
+	
+	for ( Index i = 0; i < numSamples && result; i++ )
+	{
+		Vector3f direction;
+		FrequencyResponse response;
+		
+		result &= decoder.read( direction );
+		result &= readResponse( decoder, response );
+		directivity.addSample( direction, response );
+	}
+	
+	directivity.setOrientation( orientation );
+	
+	return result;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Private Helper Methods
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SoundTraceFormat:: writeResponse( om::BinaryEncoder& encoder, const FrequencyResponse& response )
+{
+	const Size numFrequencies = response.getFrequencyCount();
+	
+	encoder.write( UInt32(numFrequencies) );
+	
+	for ( Index f = 0; f < numFrequencies; f++ )
+	{
+		encoder.write( response.getFrequency(f) );
+		encoder.write( response.getFrequencyGain(f) );
+	}
+}
+
+
+
+
+Bool SoundTraceFormat:: readResponse( om::BinaryDecoder& decoder, FrequencyResponse& response )
+{
+	UInt32 numFrequencies = 0;
+	
+	if ( !decoder.read( numFrequencies ) )
+		return false;
+	
+	for ( Index f = 0; f < numFrequencies; f++ )
+	{
+		Real frequency = 0, gain = 0;
+		
+		if ( !decoder.read( frequency ) || !decoder.read( gain ) )
+			return false;
+		
+		response.setFrequency( frequency, gain );
+	}
+	
+	return true;
+}
+
+
+
+
+void SoundTraceFormat:: writeFrequencies( om::BinaryEncoder& encoder, const FrequencyBands& frequencies )
+{
+	for ( Index i = 0; i < GSOUND_FREQUENCY_COUNT; i++ )
+		encoder.write( frequencies[i] );
+}
+
+
+
+
+Bool SoundTraceFormat:: readFrequencies( om::BinaryDecoder& decoder, FrequencyBands& frequencies )
+{
+	Real bands[GSOUND_FREQUENCY_COUNT];
+	
+	for ( Index i = 0; i < GSOUND_FREQUENCY_COUNT; i++ )
+	{
+		if ( !decoder.read( bands[i] ) )
+			return false;
+	}
+	
+	frequencies = FrequencyBands( bands );
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//**************************  End GSound Internal Namespace  *******************************
+GSOUND_INTERNAL_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,269 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        gsound/internal/gsSoundTraceFormat.h
+ * Contents:    gsound::internal::SoundTraceFormat class declaration
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef INCLUDE_GSOUND_SOUND_TRACE_FORMAT_H
+#define INCLUDE_GSOUND_SOUND_TRACE_FORMAT_H
+
+
+#include "gsInternalConfig.h"
+
+
+#include "../gsSoundScene.h"
+#include "../gsPropagationRequest.h"
+#include "../gsRenderRequest.h"
+
+
+//##########################################################################################
+//**************************  Start GSound Internal Namespace  *****************************
+GSOUND_INTERNAL_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that encodes and decodes the records of a sound propagation trace file.
+/**
+  * A trace file starts with a small header that identifies the format version and endianness,
+  * followed by a sequence of records that each have a type and a payload size. Meshes and source
+  * directivities are written once in their own records and then referred to by ID. Each propagation
+  * record stores the request and the IDs of the scene's objects, sources, and listeners, along with the
+  * state of any that changed since the previous record. Values are stored in the native endianness,
+  * so a trace can only be replayed on a machine with the same endianness it was recorded on.
+  */
+class SoundTraceFormat
+{
+	public:
+		
+		//********************************************************************************
+		//******	Record Type Enum Declaration
+			
+			
+			/// An enum of the types of records that follow the header in a trace file.
+			enum RecordType
+			{
+				/// A record that defines a mesh that is referenced by objects in later records.
+				MESH = 1,
+				
+				/// A record that defines a source directivity that is referenced by sources in later records.
+				DIRECTIVITY = 2,
+				
+				/// A record that stores the scene state and request for one frame of sound propagation.
+				PROPAGATION = 3,
+				
+				/// A record that stores one call to render a listener's audio.
+				RENDER = 4
+			};
+			
+			
+		//********************************************************************************
+		//******	File Structure Methods
+			
+			
+			/// Write the header that starts a trace file to the specified stream.
+			static Bool writeHeader( om::DataOutputStream& stream );
+			
+			
+			/// Read the header that starts a trace file, returning whether or not it is a valid trace.
+			static Bool readHeader( om::DataInputStream& stream );
+			
+			
+			/// Write a record with the specified type and payload to the stream.
+			static Bool writeRecord( om::DataOutputStream& stream, RecordType type, const UByte* payload, Size payloadSize );
+			
+			
+			/// Read the type and payload size of the next record in the stream.
+			/**
+			  * The method returns FALSE if the end of the stream was reached.
+			  */
+			static Bool readRecordHeader( om::DataInputStream& stream, UInt32& type, Size& payloadSize );
+			
+			
+		//********************************************************************************
+		//******	Request Encoding Methods
+			
+			
+			/// Write the parameters of a propagation request that affect the result or cost of propagation.
+			/**
+			  * Pointers to debug caches and statistics are not written.
+			  */
+			static void writeRequest( om::BinaryEncoder& encoder, const PropagationRequest& request );
+			
+			
+			/// Read the parameters of a propagation request that were written by writeRequest().
+			static Bool readRequest( om::BinaryDecoder& decoder, PropagationRequest& request );
+			
+			
+			/// Write the parameters of a render request that affect the result or cost of rendering.
+			/**
+			  * The HRTF pointer is not written, so a replayed renderer uses the default HRTF.
+			  */
+			static void writeRenderRequest( om::BinaryEncoder& encoder, const RenderRequest& request );
+			
+			
+			/// Read the parameters of a render request that were written by writeRenderRequest().
+			static Bool readRenderRequest( om::BinaryDecoder& decoder, RenderRequest& request );
+			
+			
+		//********************************************************************************
+		//******	Scene State Encoding Methods
+			
+			
+			/// Write the global state of a scene, not including its objects, sources, and listeners.
+			static void writeSceneState( om::BinaryEncoder& encoder, const SoundScene& scene );
+			
+			
+			/// Read the global state of a scene that was written by writeSceneState().
+			static Bool readSceneState( om::BinaryDecoder& decoder, SoundScene& scene );
+			
+			
+			/// Write the state of an object, referring to its mesh with the specified ID.
+			static void writeObject( om::BinaryEncoder& encoder, const SoundObject& object, UInt32 meshID );
+			
+			
+			/// Read the state of an object, placing the ID of its mesh in the output parameter.
+			static Bool readObject( om::BinaryDecoder& decoder, SoundObject& object, UInt32& meshID );
+			
+			
+			/// Write the state of a source, referring to its directivity with the specified ID.
+			static void writeSource( om::BinaryEncoder& encoder, const SoundSource& source, UInt32 directivityID );
+			
+			
+			/// Read the state of a source, placing the ID of its directivity in the output parameter.
+			static Bool readSource( om::BinaryDecoder& decoder, SoundSource& source, UInt32& directivityID );
+			
+			
+			/// Write the state of a listener.
+			static void writeListener( om::BinaryEncoder& encoder, const SoundListener& listener );
+			
+			
+			/// Read the state of a listener that was written by writeListener().
+			static Bool readListener( om::BinaryDecoder& decoder, SoundListener& listener );
+			
+			
+			/// Write the samples of a source directivity.
+			static void writeDirectivity( om::BinaryEncoder& encoder, const SoundDirectivity& directivity );
+			
+			
+			/// Read the samples of a source directivity that was written by writeDirectivity().
+			static Bool readDirectivity( om::BinaryDecoder& decoder, SoundDirectivity& directivity );
+			
+			
+		//********************************************************************************
+		//******	Public Static Data Members
+			
+			
+			/// The ID that is written in place of a mesh or directivity that is not set.
+			static const UInt32 INVALID_ID = 0xFFFFFFFF;
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Write a frequency response as its number of frequencies followed by each frequency and gain.
+			static void writeResponse( om::BinaryEncoder& encoder, const FrequencyResponse& response );
+			
+			
+			/// Read a frequency response that was written by writeResponse().
+			static Bool readResponse( om::BinaryDecoder& decoder, FrequencyResponse& response );
+			
+			
+			/// Write the center frequencies of a set of frequency bands.
+			static void writeFrequencies( om::BinaryEncoder& encoder, const FrequencyBands& frequencies );
+			
+			
+			/// Read a set of frequency bands that was written by writeFrequencies().
+			static Bool readFrequencies( om::BinaryDecoder& decoder, FrequencyBands& frequencies );
+			
+			
+			/// Read a size that was written as a 64-bit unsigned integer.
+			GSOUND_FORCE_INLINE static Bool readSize( om::BinaryDecoder& decoder, Size& value )
+			{
+				UInt64 value64 = 0;
+				
+				if ( !decoder.read( value64 ) )
+					return false;
+				
+				value = (Size)value64;
+				return true;
+			}
+			
+			
+			/// Read a set of flags that were written as a 32-bit unsigned integer.
+			template < typename FlagsType >
+			GSOUND_FORCE_INLINE static Bool readFlags( om::BinaryDecoder& decoder, FlagsType& flags )
+			{
+				UInt32 value = 0;
+				
+				if ( !decoder.read( value ) )
+					return false;
+				
+				flags = FlagsType( value );
+				return true;
+			}
+			
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//**************************  End GSound Internal Namespace  *******************************
+GSOUND_INTERNAL_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_GSOUND_SOUND_TRACE_FORMAT_H
@@ -0,0 +1,154 @@
+/*
+ * Project:     GSound
+ * 
+ * File:        tools/gsReplayTrace.cpp
+ * Contents:    Command-line tool that replays a sound trace and reports timing
+ * 
+ * Author(s):   Carl Schissler
+ * Website:     http://gamma.cs.unc.edu/GSOUND/
+ * 
+ * License:
+ * 
+ *     Copyright (C) 2010-16 Carl Schissler, University of North Carolina at Chapel Hill.
+ *     All rights reserved.
+ *     
+ *     Permission to use, copy, modify, and distribute this software and its
+ *     documentation for educational, research, and non-profit purposes, without
+ *     fee, and without a written agreement is hereby granted, provided that the
+ *     above copyright notice, this paragraph, and the following four paragraphs
+ *     appear in all copies.
+ *     
+ *     Permission to incorporate this software into commercial products may be
+ *     obtained by contacting the University of North Carolina at Chapel Hill.
+ *     
+ *     This software program and documentation are copyrighted by Carl Schissler and
+ *     the University of North Carolina at Chapel Hill. The software program and
+ *     documentation are supplied "as is", without any accompanying services from
+ *     the University of North Carolina at Chapel Hill or the authors. The University
+ *     of North Carolina at Chapel Hill and the authors do not warrant that the
+ *     operation of the program will be uninterrupted or error-free. The end-user
+ *     understands that the program was developed for research purposes and is advised
+ *     not to rely exclusively on the program for any reason.
+ *     
+ *     IN NO EVENT SHALL THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR ITS
+ *     EMPLOYEES OR THE AUTHORS BE LIABLE TO ANY PARTY FOR DIRECT, INDIRECT,
+ *     SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING LOST PROFITS,
+ *     ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN IF THE
+ *     UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL OR THE AUTHORS HAVE BEEN ADVISED
+ *     OF THE POSSIBILITY OF SUCH DAMAGE.
+ *     
+ *     THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND THE AUTHORS SPECIFICALLY
+ *     DISCLAIM ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ *     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE AND ANY
+ *     STATUTORY WARRANTY OF NON-INFRINGEMENT. THE SOFTWARE PROVIDED HEREUNDER IS
+ *     ON AN "AS IS" BASIS, AND THE UNIVERSITY OF NORTH CAROLINA AT CHAPEL HILL AND
+ *     THE AUTHORS HAVE NO OBLIGATIONS TO PROVIDE MAINTENANCE, SUPPORT, UPDATES,
+ *     ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+#include "gsound/gsound.h"
+
+
+using namespace gsound;
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Timing Summary
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// Print the minimum, mean, maximum, and total of a list of times in milliseconds.
+static void printTimes( const char* name, const ArrayList<Time>& times )
+{
+	const Size numTimes = times.getSize();
+	
+	if ( numTimes == 0 )
+	{
+		std::printf( "%-12s %8d\n", name, 0 );
+		return;
+	}
+	
+	Double minTime = math::max<Double>();
+	Double maxTime = 0;
+	Double totalTime = 0;
+	
+	for ( Index i = 0; i < numTimes; i++ )
+	{
+		const Double time = Double(times[i])*Double(1000);
+		minTime = math::min( minTime, time );
+		maxTime = math::max( maxTime, time );
+		totalTime += time;
+	}
+	
+	std::printf( "%-12s %8d %10.3f %10.3f %10.3f %12.3f\n", name, (int)numTimes,
+				minTime, totalTime / Double(numTimes), maxTime, totalTime );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############
+//############		Main
+//############
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+int main( int argc, char** argv )
+{
+	const char* tracePath = NULL;
+	Bool validArguments = true;
+	SoundTracePlayer player;
+	
+	for ( int i = 1; i < argc; i++ )
+	{
+		if ( std::strcmp( argv[i], "--threads" ) == 0 && i + 1 < argc )
+			player.setThreadCount( (Size)std::atoi( argv[++i] ) );
+		else if ( std::strcmp( argv[i], "--no-render" ) == 0 )
+			player.setRenderingIsEnabled( false );
+		else if ( tracePath == NULL && argv[i][0] != '-' )
+			tracePath = argv[i];
+		else
+			validArguments = false;
+	}
+	
+	if ( !validArguments || tracePath == NULL )
+	{
+		std::fprintf( stderr, "usage: gsReplayTrace <trace file> [--threads N] [--no-render]\n" );
+		return 1;
+	}
+	
+	if ( !player.open( tracePath ) )
+	{
+		std::fprintf( stderr, "error: unable to open sound trace '%s'\n", tracePath );
+		return 1;
+	}
+	
+	const Bool finished = player.play();
+	
+	if ( !finished )
+		std::fprintf( stderr, "warning: sound trace '%s' is truncated or corrupt\n", tracePath );
+	
+	std::printf( "%-12s %8s %10s %10s %10s %12s\n", "stage (ms)", "count", "min", "mean", "max", "total" );
+	printTimes( "propagation", player.getPropagationTimes() );
+	printTimes( "ir update", player.getIRUpdateTimes() );
+	printTimes( "render", player.getRenderTimes() );
+	
+	return finished ? 0 : 2;
+}
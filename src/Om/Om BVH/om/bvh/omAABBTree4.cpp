@@ -31,6 +31,7 @@
  */
 
 #include "omAABBTree4.h"
+#include "omBVHTraversalStatistics.h"
 
 
 //##########################################################################################
@@ -941,12 +942,24 @@ void AABBTree4:: traceRayVsGeneric( BVHRay& rayData ) const
 	const SIMDFloat4 tMin = rayData.tMin;
 	SIMDFloat4 tMax = rayData.tMax;
 	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	Size numNodesVisited = 0;
+	Size numPrimitivesTested = 0;
+#endif
+	
 	while ( true )
 	{
 		nextNode:
 		
+#if OM_BVH_TRAVERSAL_STATISTICS
+		numNodesVisited++;
+#endif
+		
 		if ( Node::isLeaf( node ) )
 		{
+#if OM_BVH_TRAVERSAL_STATISTICS
+			numPrimitivesTested += Node::getLeafCount( node );
+#endif
 			geo->intersectRay( indices + Node::getLeafOffset( node ),
 								Node::getLeafCount( node ), rayData );
 			tMax = rayData.tMax;
@@ -963,6 +976,10 @@ void AABBTree4:: traceRayVsGeneric( BVHRay& rayData ) const
 		if ( stack == stackBase )
 			break;
 	}
+	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	BVHTraversalStatistics::getLocal().addRay( numNodesVisited, numPrimitivesTested );
+#endif
 }
 
 
@@ -995,14 +1012,28 @@ void AABBTree4:: traceRayVsTriangles( BVHRay& rayData ) const
 	SIMDFloat4 tMax = rayData.tMax;
 	SIMDFloat4 triangleDistance;
 	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	Size numNodesVisited = 0;
+	Size numPrimitivesTested = 0;
+#endif
+	
 	while ( true )
 	{
 		nextNode:
 		
+#if OM_BVH_TRAVERSAL_STATISTICS
+		numNodesVisited++;
+#endif
+		
 		if ( Node::isLeaf( node ) )
 		{
 			const UInt32 numNodePrimitives = Node::getLeafCount( node );
 			
+#if OM_BVH_TRAVERSAL_STATISTICS
+			// Each cached triangle tests 4 triangles at once.
+			numPrimitivesTested += 4*numNodePrimitives;
+#endif
+			
 			if ( numNodePrimitives == 1 )
 			{
 				// Fast case for a single quad triangle.
@@ -1039,6 +1070,10 @@ void AABBTree4:: traceRayVsTriangles( BVHRay& rayData ) const
 			break;
 	}
 	
+#if OM_BVH_TRAVERSAL_STATISTICS
+	BVHTraversalStatistics::getLocal().addRay( numNodesVisited, numPrimitivesTested );
+#endif
+	
 	// If the ray hit something closer than the input t-max, set the hit geometry.
 	if ( rayData.tMax < tMaxInput )
 		rayData.geometry = geometry;
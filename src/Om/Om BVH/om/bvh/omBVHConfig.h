@@ -37,6 +37,28 @@
 #include "om/omFramework.h"
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		BVH Configuration
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+/// Define whether or not BVH traversals count the nodes and primitives that each ray visits.
+/**
+  * If set to 1, the counts are accumulated per-thread in a BVHTraversalStatistics object
+  * that is accessed with BVHTraversalStatistics::getLocal(). If set to 0, the counters
+  * are compiled out of the traversal loops and have no runtime cost.
+  */
+#ifndef OM_BVH_TRAVERSAL_STATISTICS
+	#define OM_BVH_TRAVERSAL_STATISTICS 0
+#endif
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -0,0 +1,177 @@
+/*
+ * Project:     Om Software
+ * Version:     1.0.0
+ * Website:     http://www.carlschissler.com/om
+ * Author(s):   Carl Schissler
+ * 
+ * Copyright (c) 2016, Carl Schissler
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 	1. Redistributions of source code must retain the above copyright
+ * 	   notice, this list of conditions and the following disclaimer.
+ * 	2. Redistributions in binary form must reproduce the above copyright
+ * 	   notice, this list of conditions and the following disclaimer in the
+ * 	   documentation and/or other materials provided with the distribution.
+ * 	3. Neither the name of the copyright holder nor the
+ * 	   names of its contributors may be used to endorse or promote products
+ * 	   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_OM_BVH_TRAVERSAL_STATISTICS_H
+#define INCLUDE_OM_BVH_TRAVERSAL_STATISTICS_H
+
+
+#include "omBVHConfig.h"
+
+
+//##########################################################################################
+//******************************  Start Om BVH Namespace  **********************************
+OM_BVH_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that accumulates counts of the work done by BVH ray traversals.
+/**
+  * The counts are only updated when OM_BVH_TRAVERSAL_STATISTICS is enabled.
+  * Each thread has its own statistics object so that the traversal loops do
+  * not need any synchronization. A thread can reset its statistics before
+  * tracing a set of rays and read them afterwards to get per-ray averages.
+  */
+class BVHTraversalStatistics
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructor
+			
+			
+			/// Create a new traversal statistics object with all counts set to zero.
+			OM_INLINE BVHTraversalStatistics()
+			{
+				reset();
+			}
+			
+			
+		//********************************************************************************
+		//******	Statistics Update Methods
+			
+			
+			/// Add the counts for a single ray traversal to these statistics.
+			OM_FORCE_INLINE void addRay( Size numNodes, Size numPrimitives )
+			{
+				rayCount++;
+				nodeCount += numNodes;
+				primitiveCount += numPrimitives;
+				maxRayNodeCount = math::max( maxRayNodeCount, numNodes );
+				maxRayPrimitiveCount = math::max( maxRayPrimitiveCount, numPrimitives );
+			}
+			
+			
+			/// Add the counts from another statistics object to these statistics.
+			OM_INLINE BVHTraversalStatistics& operator += ( const BVHTraversalStatistics& other )
+			{
+				rayCount += other.rayCount;
+				nodeCount += other.nodeCount;
+				primitiveCount += other.primitiveCount;
+				maxRayNodeCount = math::max( maxRayNodeCount, other.maxRayNodeCount );
+				maxRayPrimitiveCount = math::max( maxRayPrimitiveCount, other.maxRayPrimitiveCount );
+				
+				return *this;
+			}
+			
+			
+			/// Reset all of the counts to zero.
+			OM_INLINE void reset()
+			{
+				rayCount = 0;
+				nodeCount = 0;
+				primitiveCount = 0;
+				maxRayNodeCount = 0;
+				maxRayPrimitiveCount = 0;
+			}
+			
+			
+		//********************************************************************************
+		//******	Average Accessor Methods
+			
+			
+			/// Return the average number of nodes that were visited per ray.
+			OM_INLINE Float getAverageNodeCount() const
+			{
+				return rayCount > 0 ? Float(nodeCount) / Float(rayCount) : Float(0);
+			}
+			
+			
+			/// Return the average number of primitives that were tested per ray.
+			OM_INLINE Float getAveragePrimitiveCount() const
+			{
+				return rayCount > 0 ? Float(primitiveCount) / Float(rayCount) : Float(0);
+			}
+			
+			
+		//********************************************************************************
+		//******	Thread-Local Statistics Accessor Method
+			
+			
+			/// Return a reference to the statistics that are accumulated by BVH traversals on the calling thread.
+			static BVHTraversalStatistics& getLocal();
+			
+			
+		//********************************************************************************
+		//******	Public Data Members
+			
+			
+			/// The number of rays that were traced.
+			Size rayCount;
+			
+			
+			/// The total number of inner and leaf nodes that were visited by all rays.
+			Size nodeCount;
+			
+			
+			/// The total number of ray-primitive intersection tests that were performed by all rays.
+			/**
+			  * For cached triangle geometry, the triangles of a leaf are tested 4 at a time,
+			  * so this count includes any padding triangles in partially-filled leaves.
+			  */
+			Size primitiveCount;
+			
+			
+			/// The largest number of nodes that were visited by a single ray.
+			Size maxRayNodeCount;
+			
+			
+			/// The largest number of primitives that were tested by a single ray.
+			Size maxRayPrimitiveCount;
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//******************************  End Om BVH Namespace  ************************************
+OM_BVH_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_OM_BVH_TRAVERSAL_STATISTICS_H
@@ -40,6 +40,7 @@
 #include "bvh/omBVHRay.h"
 #include "bvh/omBVHTransform.h"
 #include "bvh/omBVHGeometry.h"
+#include "bvh/omBVHTraversalStatistics.h"
 
 
 #include "bvh/omBVHBVH.h"
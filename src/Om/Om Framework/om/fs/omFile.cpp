@@ -505,9 +505,12 @@ void* File:: map( AccessType accessType )
 	// Map the file.
 	void* result = mmap( NULL, size_t(fileSize), protection, MAP_SHARED, mappedFile, off_t(0) );
 	
+	// mmap() signals failure with MAP_FAILED rather than NULL.
+	if ( result == MAP_FAILED )
+		return NULL;
+	
 	// If the mapping was successful, add it to the internal list of mappings.
-	if ( result != NULL )
-		mappedRegions.add( MappedRegion( result, Size(fileSize) ) );
+	mappedRegions.add( MappedRegion( result, Size(fileSize) ) );
 	
 	return result;
 	
@@ -560,9 +563,12 @@ void* File:: map( AccessType accessType, LargeIndex offset, Size length )
 	// Map the file region.
 	void* result = mmap( NULL, length, protection, MAP_SHARED, mappedFile, off_t(offset) );
 	
+	// mmap() signals failure with MAP_FAILED rather than NULL.
+	if ( result == MAP_FAILED )
+		return NULL;
+	
 	// If the mapping was successful, add it to the internal list of mappings.
-	if ( result != NULL )
-		mappedRegions.add( MappedRegion( result, length ) );
+	mappedRegions.add( MappedRegion( result, length ) );
 	
 	return result;
 	
@@ -99,6 +99,22 @@ class DataInputStream
 			Size readAllData( data::DataBuffer& buffer );
 			
 			
+			/// Return a pointer to the specified range of bytes in the stream's backing memory, or NULL if not available.
+			/**
+			  * Streams that are backed by memory (e.g. memory-mapped files) can override this
+			  * method to give zero-copy access to their data. The offset is an absolute byte
+			  * offset from the start of the stream, and the position of the stream is not changed.
+			  * The returned pointer remains valid until the stream is closed or destroyed.
+			  *
+			  * If the method returns NULL, the caller should use readData() instead.
+			  * The default implementation always returns NULL.
+			  */
+			virtual const UByte* getPointer( LargeIndex /*offset*/, Size /*numBytes*/ ) const
+			{
+				return NULL;
+			}
+			
+			
 		//********************************************************************************
 		//******	Seeking Methods
 			
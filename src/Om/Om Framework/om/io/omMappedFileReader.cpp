@@ -0,0 +1,408 @@
+/*
+ * Project:     Om Software
+ * Version:     1.0.0
+ * Website:     http://www.carlschissler.com/om
+ * Author(s):   Carl Schissler
+ * 
+ * Copyright (c) 2016, Carl Schissler
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 	1. Redistributions of source code must retain the above copyright
+ * 	   notice, this list of conditions and the following disclaimer.
+ * 	2. Redistributions in binary form must reproduce the above copyright
+ * 	   notice, this list of conditions and the following disclaimer in the
+ * 	   documentation and/or other materials provided with the distribution.
+ * 	3. Neither the name of the copyright holder nor the
+ * 	   names of its contributors may be used to endorse or promote products
+ * 	   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "omMappedFileReader.h"
+
+
+#if defined(OM_PLATFORM_APPLE) || defined(OM_PLATFORM_LINUX)
+	#include <unistd.h>
+	#include <sys/mman.h>
+#endif
+
+
+//##########################################################################################
+//*******************************  Start Om IO Namespace  **********************************
+OM_IO_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+/// The default number of bytes that are requested ahead of the current position.
+static const Size DEFAULT_READ_AHEAD_SIZE = 1 << 20;
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Constructors
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+MappedFileReader:: MappedFileReader( const Char* filePath )
+	:	file( filePath != NULL ? fs::Path( filePath ) : fs::Path() ),
+		data( NULL ),
+		size( 0 ),
+		position( 0 ),
+		readAheadPosition( 0 ),
+		readAheadSize( DEFAULT_READ_AHEAD_SIZE ),
+		accessPattern( NORMAL ),
+		opened( false )
+{
+}
+
+
+
+
+MappedFileReader:: MappedFileReader( const fs::UTF8String& filePath )
+	:	file( fs::Path( filePath ) ),
+		data( NULL ),
+		size( 0 ),
+		position( 0 ),
+		readAheadPosition( 0 ),
+		readAheadSize( DEFAULT_READ_AHEAD_SIZE ),
+		accessPattern( NORMAL ),
+		opened( false )
+{
+}
+
+
+
+
+MappedFileReader:: MappedFileReader( const fs::Path& filePath )
+	:	file( filePath ),
+		data( NULL ),
+		size( 0 ),
+		position( 0 ),
+		readAheadPosition( 0 ),
+		readAheadSize( DEFAULT_READ_AHEAD_SIZE ),
+		accessPattern( NORMAL ),
+		opened( false )
+{
+}
+
+
+
+
+MappedFileReader:: MappedFileReader( const fs::File& newFile )
+	:	file( newFile ),
+		data( NULL ),
+		size( 0 ),
+		position( 0 ),
+		readAheadPosition( 0 ),
+		readAheadSize( DEFAULT_READ_AHEAD_SIZE ),
+		accessPattern( NORMAL ),
+		opened( false )
+{
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Open/Close Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool MappedFileReader:: open()
+{
+	if ( opened )
+		return true;
+	
+	if ( !file.exists() )
+		return false;
+	
+	const LargeSize fileSize = file.getSize();
+	
+	// Empty files can't be mapped, but can still be opened.
+	if ( fileSize > 0 )
+	{
+		data = (const UByte*)file.map( fs::File::READ );
+		
+		if ( data == NULL )
+			return false;
+	}
+	
+	size = fileSize;
+	position = 0;
+	readAheadPosition = 0;
+	opened = true;
+	
+	// Apply the access pattern hint to the new mapping.
+	this->setAccessPattern( accessPattern );
+	
+	return true;
+}
+
+
+
+
+Bool MappedFileReader:: close()
+{
+	if ( !opened )
+		return false;
+	
+	if ( data != NULL )
+		file.unmap();
+	
+	data = NULL;
+	size = 0;
+	position = 0;
+	readAheadPosition = 0;
+	opened = false;
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Data Read Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Size MappedFileReader:: readData( UByte* buffer, Size numBytes )
+{
+	if ( position >= size )
+		return 0;
+	
+	numBytes = (Size)math::min( LargeSize(numBytes), size - position );
+	
+	this->readAhead( numBytes );
+	
+	util::copyPOD( buffer, data + position, numBytes );
+	position += numBytes;
+	
+	return numBytes;
+}
+
+
+
+
+const UByte* MappedFileReader:: getPointer( LargeIndex offset, Size numBytes ) const
+{
+	if ( data == NULL || offset > size || LargeSize(numBytes) > size - offset )
+		return NULL;
+	
+	return data + offset;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Seek/Move Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool MappedFileReader:: canSeek() const
+{
+	return opened;
+}
+
+
+
+
+Bool MappedFileReader:: canSeek( Int64 relativeOffset ) const
+{
+	if ( !opened )
+		return false;
+	
+	if ( relativeOffset > 0 )
+		return LargeSize(relativeOffset) <= size - position;
+	else if ( relativeOffset < 0 )
+		return position >= LargeIndex(-relativeOffset);
+	else
+		return true;
+}
+
+
+
+
+Int64 MappedFileReader:: seek( Int64 relativeOffset )
+{
+	if ( !opened )
+		return 0;
+	
+	const LargeIndex oldPosition = position;
+	
+	if ( relativeOffset > 0 )
+		position += math::min( LargeSize(relativeOffset), size - position );
+	else if ( relativeOffset < 0 )
+		position -= math::min( LargeIndex(-relativeOffset), position );
+	
+	// Restart read-ahead from the new position.
+	if ( position < oldPosition || position > readAheadPosition )
+		readAheadPosition = position;
+	
+	return Int64(position) - Int64(oldPosition);
+}
+
+
+
+
+LargeIndex MappedFileReader:: seekAbsolute( LargeIndex newPosition )
+{
+	if ( !opened )
+		return 0;
+	
+	position = math::min( newPosition, size );
+	readAheadPosition = position;
+	
+	return position;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Position Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+LargeIndex MappedFileReader:: getPosition() const
+{
+	return position;
+}
+
+
+
+
+LargeSize MappedFileReader:: getBytesRemaining() const
+{
+	return size - position;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Access Hint Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void MappedFileReader:: setAccessPattern( AccessPattern newAccessPattern )
+{
+	accessPattern = newAccessPattern;
+	
+	if ( data == NULL )
+		return;
+	
+#if defined(OM_PLATFORM_APPLE) || defined(OM_PLATFORM_LINUX)
+	int advice = MADV_NORMAL;
+	
+	switch ( accessPattern )
+	{
+		case SEQUENTIAL:	advice = MADV_SEQUENTIAL;	break;
+		case RANDOM:		advice = MADV_RANDOM;		break;
+		default:			advice = MADV_NORMAL;		break;
+	}
+	
+	// The mapping starts on a page boundary, so the whole file can be advised at once.
+	madvise( (void*)data, size_t(size), advice );
+#endif
+}
+
+
+
+
+Bool MappedFileReader:: prefetch( LargeIndex offset, LargeSize numBytes ) const
+{
+	if ( data == NULL || offset >= size )
+		return false;
+	
+	numBytes = math::min( numBytes, size - offset );
+	
+#if defined(OM_PLATFORM_APPLE) || defined(OM_PLATFORM_LINUX)
+	// madvise() requires a page-aligned start address.
+	const LargeIndex pageSize = (LargeIndex)sysconf( _SC_PAGESIZE );
+	const LargeIndex alignedOffset = offset - offset % pageSize;
+	
+	return madvise( (void*)(data + alignedOffset), size_t(numBytes + (offset - alignedOffset)), MADV_WILLNEED ) == 0;
+#else
+	return false;
+#endif
+}
+
+
+
+
+void MappedFileReader:: requestReadAhead()
+{
+	if ( readAheadSize == 0 || accessPattern == RANDOM )
+	{
+		readAheadPosition = size;
+		return;
+	}
+	
+	this->prefetch( position, readAheadSize );
+	
+	// Request the following window once half of this one has been read.
+	readAheadPosition = position + readAheadSize/2;
+}
+
+
+
+
+//##########################################################################################
+//*******************************  End Om IO Namespace  ************************************
+OM_IO_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,335 @@
+/*
+ * Project:     Om Software
+ * Version:     1.0.0
+ * Website:     http://www.carlschissler.com/om
+ * Author(s):   Carl Schissler
+ * 
+ * Copyright (c) 2016, Carl Schissler
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 	1. Redistributions of source code must retain the above copyright
+ * 	   notice, this list of conditions and the following disclaimer.
+ * 	2. Redistributions in binary form must reproduce the above copyright
+ * 	   notice, this list of conditions and the following disclaimer in the
+ * 	   documentation and/or other materials provided with the distribution.
+ * 	3. Neither the name of the copyright holder nor the
+ * 	   names of its contributors may be used to endorse or promote products
+ * 	   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_OM_MAPPED_FILE_READER_H
+#define INCLUDE_OM_MAPPED_FILE_READER_H
+
+
+#include "omIOConfig.h"
+
+
+#include "../omFileSystem.h"
+#include "omDataInputStream.h"
+
+
+//##########################################################################################
+//*******************************  Start Om IO Namespace  **********************************
+OM_IO_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that reads from a file by mapping its entire contents into memory.
+/** 
+  * Unlike FileReader, which copies data out of the C standard library's file
+  * buffers on every read, this class maps the file into the address space of the
+  * process and lets the virtual memory system page it in on demand. Reads are
+  * simple memory copies, and getPointer() returns a pointer directly into the
+  * mapped file so that large resources can be used in place without copying.
+  *
+  * The reader gives the operating system hints about the expected access
+  * pattern and issues read-ahead requests for the region following the current
+  * position as the stream is read sequentially. The hints are ignored on platforms
+  * that don't support them.
+  */
+class MappedFileReader : public DataInputStream
+{
+	public:
+		
+		//********************************************************************************
+		//******	Access Pattern Enum Declaration
+			
+			
+			/// An enum of the different access patterns that the reader can hint to the operating system.
+			enum AccessPattern
+			{
+				/// The file is accessed with no particular pattern.
+				NORMAL = 0,
+				
+				/// The file is accessed sequentially from the beginning to the end.
+				SEQUENTIAL = 1,
+				
+				/// The file is accessed in a random order, so read-ahead is not useful.
+				RANDOM = 2
+			};
+			
+			
+		//********************************************************************************
+		//******	Constructors
+			
+			
+			/// Create a MappedFileReader object that should read from the file at the specified path string.
+			MappedFileReader( const Char* filePath );
+			
+			
+			/// Create a MappedFileReader object that should read from the file at the specified path string.
+			MappedFileReader( const fs::UTF8String& filePath );
+			
+			
+			/// Create a MappedFileReader object that should read from the file at the specified path.
+			MappedFileReader( const fs::Path& filePath );
+			
+			
+			/// Create a MappedFileReader object that should read from the specified file.
+			MappedFileReader( const fs::File& file );
+			
+			
+		//********************************************************************************
+		//******	Destructor
+			
+			
+			/// Destroy a mapped file reader and free all of its resources (unmap the file).
+			OM_INLINE ~MappedFileReader()
+			{
+				if ( isOpen() )
+					close();
+			}
+			
+			
+		//********************************************************************************
+		//******	Open/Close Methods
+			
+			
+			/// Open the reader by mapping the file into memory.
+			/** 
+			  * If the file is already open, this method does nothing and returns TRUE.
+			  * The method returns FALSE if the file doesn't exist or could not be mapped.
+			  * The position of the reader is set to the beginning of the file.
+			  */
+			Bool open();
+			
+			
+			/// Return whether or not the reader's file is open.
+			OM_INLINE Bool isOpen() const
+			{
+				return opened;
+			}
+			
+			
+			/// Close the reader, unmapping the file.
+			/**
+			  * Any pointers previously returned by getPointer() or getData() become invalid.
+			  * The method returns FALSE if the reader was not open.
+			  */
+			Bool close();
+			
+			
+		//********************************************************************************
+		//******	Data Read Methods
+			
+			
+			/// Copy the specified number of bytes from the current position in the file into the buffer.
+			virtual Size readData( UByte* buffer, Size numBytes );
+			
+			
+			/// Return a pointer to the mapped file data at the specified absolute offset.
+			/**
+			  * The method returns NULL if the range of bytes is not entirely within the file.
+			  * The pointer remains valid until the reader is closed. The position of the
+			  * reader is not changed.
+			  */
+			virtual const UByte* getPointer( LargeIndex offset, Size numBytes ) const;
+			
+			
+			/// Return a pointer to the start of the mapped file data, or NULL if the reader is not open.
+			OM_INLINE const UByte* getData() const
+			{
+				return data;
+			}
+			
+			
+			/// Return the total size of the mapped file in bytes.
+			OM_INLINE LargeSize getSize() const
+			{
+				return size;
+			}
+			
+			
+		//********************************************************************************
+		//******	Seek/Move Methods
+			
+			
+			/// Return whether or not this reader can seek within the file.
+			virtual Bool canSeek() const;
+			
+			
+			/// Return whether or not this reader can seek by the specified amount in bytes.
+			virtual Bool canSeek( Int64 relativeOffset ) const;
+			
+			
+			/// Move the current position in the file by the specified relative signed offset in bytes.
+			/**
+			  * The position is clamped to the range of the file, and the signed amount that
+			  * the position was changed by is returned.
+			  */
+			virtual Int64 seek( Int64 relativeOffset );
+			
+			
+			/// Seek to an absolute position in the file and return the resulting position.
+			LargeIndex seekAbsolute( LargeIndex newPosition );
+			
+			
+		//********************************************************************************
+		//******	Position Accessor Methods
+			
+			
+			/// Return the current absolute position of the reader in the file.
+			virtual LargeIndex getPosition() const;
+			
+			
+			/// Return the number of bytes remaining in the file.
+			virtual LargeSize getBytesRemaining() const;
+			
+			
+		//********************************************************************************
+		//******	Access Hint Methods
+			
+			
+			/// Return the access pattern that is hinted to the operating system for this file.
+			OM_INLINE AccessPattern getAccessPattern() const
+			{
+				return accessPattern;
+			}
+			
+			
+			/// Set the access pattern that is hinted to the operating system for this file.
+			void setAccessPattern( AccessPattern newAccessPattern );
+			
+			
+			/// Return the number of bytes ahead of the current position that are requested as the file is read.
+			OM_INLINE Size getReadAheadSize() const
+			{
+				return readAheadSize;
+			}
+			
+			
+			/// Set the number of bytes ahead of the current position that are requested as the file is read.
+			/**
+			  * A value of 0 disables read-ahead. Read-ahead is not done for the RANDOM
+			  * access pattern. The default read-ahead size is 1 megabyte.
+			  */
+			OM_INLINE void setReadAheadSize( Size newReadAheadSize )
+			{
+				readAheadSize = newReadAheadSize;
+			}
+			
+			
+			/// Ask the operating system to start paging in the specified range of the file.
+			/**
+			  * This method returns immediately. The method returns whether or not
+			  * the hint was given.
+			  */
+			Bool prefetch( LargeIndex offset, LargeSize numBytes ) const;
+			
+			
+		//********************************************************************************
+		//******	File Attribute Accessor Methods
+			
+			
+			/// Get the file object that this reader is reading from.
+			OM_INLINE const fs::File& getFile() const
+			{
+				return file;
+			}
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Request the data after the current position if the reader has passed the previous request.
+			OM_FORCE_INLINE void readAhead( Size numBytes )
+			{
+				if ( position + numBytes > readAheadPosition )
+					this->requestReadAhead();
+			}
+			
+			
+			/// Request the next read-ahead window starting at the current position.
+			void requestReadAhead();
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// A file object representing the file that is mapped.
+			fs::File file;
+			
+			
+			/// A pointer to the start of the mapped file, or NULL if the file is not mapped.
+			const UByte* data;
+			
+			
+			/// The size of the mapped file in bytes.
+			LargeSize size;
+			
+			
+			/// The current position of the reader in the file.
+			LargeIndex position;
+			
+			
+			/// The position after which the next read-ahead request is made.
+			LargeIndex readAheadPosition;
+			
+			
+			/// The number of bytes after the current position that are requested as the file is read.
+			Size readAheadSize;
+			
+			
+			/// The access pattern that is hinted to the operating system.
+			AccessPattern accessPattern;
+			
+			
+			/// Whether or not the reader is currently open.
+			Bool opened;
+			
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//*******************************  End Om IO Namespace  ************************************
+OM_IO_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_OM_MAPPED_FILE_READER_H
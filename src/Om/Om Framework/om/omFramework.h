@@ -141,6 +141,7 @@ using om::io::StringInputStream;
 using om::io::StringOutputStream;
 
 using om::io::FileReader;
+using om::io::MappedFileReader;
 using om::io::FileWriter;
 using om::io::PrintStream;
 using om::io::Log;
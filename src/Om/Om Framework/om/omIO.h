@@ -54,6 +54,7 @@
 
 // File I/O
 #include "io/omFileReader.h"
+#include "io/omMappedFileReader.h"
 #include "io/omFileWriter.h"
 
 
@@ -37,6 +37,11 @@
 #include "omThreadsConfig.h"
 
 
+#if defined(OM_COMPILER_MSVC)
+	#include <intrin.h>
+#endif
+
+
 //##########################################################################################
 //****************************  Start Om Threads Namespace  ********************************
 OM_THREADS_NAMESPACE_START
@@ -205,6 +210,27 @@ Bool testAndSet( T& operand, T compareValue, T newValue );
 
 
 
+/// Atomically replace the pointer with the new value if it is equal to the comparison value, returning its previous value.
+/**
+  * The swap was done if the returned value is equal to the comparison value.
+  */
+template < typename T >
+T* compareAndSwapPointer( T*& operand, T* compareValue, T* newValue );
+
+
+
+
+/// Atomically replace the pointer with the new value and return its previous value.
+/**
+  * The exchange has at least acquire semantics, so that writes which were published
+  * before the previous value was stored are visible to the caller.
+  */
+template < typename T >
+T* swapPointer( T*& operand, T* newValue );
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -450,11 +476,48 @@ OM_INLINE T readAndSub( T& operand, T value )
 
 template < typename T >
 OM_INLINE Bool testAndSet( T& operand, T compareValue, T newValue )
+{
+	return __sync_bool_compare_and_swap( &operand, compareValue, newValue );
+}
+
+
+
+
+template < typename T >
+OM_INLINE T* compareAndSwapPointer( T*& operand, T* compareValue, T* newValue )
 {
 	return __sync_val_compare_and_swap( &operand, compareValue, newValue );
 }
 
 
+
+
+template < typename T >
+OM_INLINE T* swapPointer( T*& operand, T* newValue )
+{
+	return __sync_lock_test_and_set( &operand, newValue );
+}
+
+
+#elif defined(OM_COMPILER_MSVC)
+
+
+template < typename T >
+OM_INLINE T* compareAndSwapPointer( T*& operand, T* compareValue, T* newValue )
+{
+	return (T*)_InterlockedCompareExchangePointer( (void* volatile*)&operand, newValue, compareValue );
+}
+
+
+
+
+template < typename T >
+OM_INLINE T* swapPointer( T*& operand, T* newValue )
+{
+	return (T*)_InterlockedExchangePointer( (void* volatile*)&operand, newValue );
+}
+
+
 #endif
 
 
@@ -410,7 +410,10 @@ void ThreadPool:: setThreadCount( Size numThreads )
 	const Size oldNumThreads = threads.getSize();
 
 	if ( oldNumThreads == numThreads )
+	{
+		unlockThreads();
 		return;
+	}
 	else if ( oldNumThreads > numThreads )
 	{
 		// Remove threads from the pool.
@@ -1405,7 +1405,8 @@ void ArrayList<T,SizeType,AllocatorType>:: resize( SizeType newCapacity )
 		T* newArray = AllocatorType::template allocate<T>( newCapacity );
 		
 		// Copy objects from the old array if it has been allocated.
-		if ( capacity > 0 )
+		// A copy of an empty list can have an allocated array with zero capacity.
+		if ( array != NULL )
 		{
 			// Move the elements from the old array to the new array.
 			Allocator::moveArray( newArray, array, numElements );
@@ -49,6 +49,11 @@ OM_SOUND_BASE_NAMESPACE_START
 
 
 
+class SharedBufferPool;
+
+
+
+
 //********************************************************************************
 /// A class that holds information about a shared sound buffer buffer.
 /**
@@ -63,14 +68,24 @@ class SharedBufferInfo
 			
 			
 			/// Create a new shared sound buffer information structure with the specified buffer attributes.
-			OM_INLINE SharedBufferInfo( Size numChannels, Size numSamples, SampleRate sampleRate )
+			OM_INLINE SharedBufferInfo( SharedBufferPool* newPool, Size numChannels, Size numSamples, SampleRate sampleRate )
 				:	buffer( numChannels, numSamples, sampleRate ),
-					referenceCount( 0 )
+					referenceCount( 0 ),
+					pool( newPool ),
+					next( NULL )
 			{
 			}
 			
 			
 	private:
+		
+		//********************************************************************************
+		//******	Private Release Method
+			
+			
+			/// Return this buffer to the free lists of its pool once its last reference has been released.
+			void release();
+			
 			
 		//********************************************************************************
 		//******	Private Data Members
@@ -85,7 +100,15 @@ class SharedBufferInfo
 			  * If the value is 0, there are no outstanding references to the shared buffer,
 			  * otherwise this value indicates the number of shared references to the buffer.
 			  */
-			Index referenceCount;
+			Atomic<Size> referenceCount;
+			
+			
+			/// A pointer to the pool which owns this shared buffer.
+			SharedBufferPool* pool;
+			
+			
+			/// A pointer to the next buffer in the free list that this buffer is a part of.
+			SharedBufferInfo* next;
 			
 			
 		//********************************************************************************
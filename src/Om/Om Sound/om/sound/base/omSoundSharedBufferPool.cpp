@@ -47,6 +47,111 @@ SharedBufferPool* SharedBufferPool:: staticPool = om::util::construct<SharedBuff
 
 
 
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Thread Cache Class Definition
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+class SharedBufferPool:: ThreadCache
+{
+	public:
+		
+		/// Create a new empty thread cache.
+		OM_INLINE ThreadCache()
+			:	isValid( true )
+		{
+			for ( Index i = 0; i < SIZE_CLASS_COUNT; i++ )
+			{
+				freeLists[i] = NULL;
+				freeCounts[i] = 0;
+			}
+		}
+		
+		
+		/// Return the cached buffers to the global pool's overflow lists when the thread exits.
+		OM_INLINE ~ThreadCache()
+		{
+			isValid = false;
+			
+			for ( Index i = 0; i < SIZE_CLASS_COUNT; i++ )
+			{
+				SharedBufferInfo* first = freeLists[i];
+				
+				if ( first == NULL )
+					continue;
+				
+				SharedBufferInfo* last = first;
+				
+				while ( last->next != NULL )
+					last = last->next;
+				
+				staticPool->pushFreeList( i, first, last );
+				freeLists[i] = NULL;
+				freeCounts[i] = 0;
+			}
+		}
+		
+		
+		/// The maximum number of free buffers that a thread caches for each size class.
+		/**
+		  * Buffers released beyond this limit go to the global overflow list
+		  * so that they can be reused by other threads.
+		  */
+		static const Size MAX_FREE_COUNT = 4;
+		
+		
+		/// The heads of this thread's free lists for each size class.
+		SharedBufferInfo* freeLists[SIZE_CLASS_COUNT];
+		
+		
+		/// The number of buffers in each of this thread's free lists.
+		Size freeCounts[SIZE_CLASS_COUNT];
+		
+		
+		/// Whether or not this cache can still be used by its thread.
+		/**
+		  * This is false once the cache has been destroyed at thread exit, after which
+		  * buffers released by the thread go directly to the overflow lists.
+		  */
+		Bool isValid;
+		
+		
+};
+
+
+
+
+thread_local SharedBufferPool::ThreadCache SharedBufferPool:: threadCache;
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Constructor
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SharedBufferPool:: SharedBufferPool()
+{
+	for ( Index i = 0; i < SIZE_CLASS_COUNT; i++ )
+		freeLists[i] = NULL;
+}
+
+
+
+
 //##########################################################################################
 //##########################################################################################
 //############		
@@ -60,67 +165,110 @@ SharedBufferPool* SharedBufferPool:: staticPool = om::util::construct<SharedBuff
 
 SharedSoundBuffer SharedBufferPool:: getBuffer()
 {
-	bufferMutex.lock();
-	
-	for ( Index i = 0; i < buffers.getSize(); i++ )
+	// Look for any free buffer, checking this thread's own free lists first.
+	if ( this == staticPool && threadCache.isValid )
 	{
-		SharedBufferInfo* bufferInfo = buffers[i];
-		
-		if ( bufferInfo->referenceCount == 0 )
+		for ( Index i = 0; i < SIZE_CLASS_COUNT; i++ )
 		{
-			SharedSoundBuffer sharedBuffer( bufferInfo );
-			bufferMutex.unlock();
-			
-			return sharedBuffer;
+			if ( threadCache.freeLists[i] != NULL )
+				return SharedSoundBuffer( acquireBuffer( i ) );
 		}
 	}
 	
+	for ( Index i = 0; i < SIZE_CLASS_COUNT; i++ )
+	{
+		SharedBufferInfo* bufferInfo = acquireBuffer( i );
+		
+		if ( bufferInfo != NULL )
+			return SharedSoundBuffer( bufferInfo );
+	}
+	
 	// Didn't find a suitable buffer, create a new one.
-	buffers.add( om::util::construct<SharedBufferInfo>( 0, 0, 44100 ) );
+	return SharedSoundBuffer( createBuffer( 0, 0, 44100 ) );
+}
+
+
+
+
+SharedSoundBuffer SharedBufferPool:: getBuffer( Size numChannels, Size numSamples, SampleRate sampleRate )
+{
+	SharedBufferInfo* bufferInfo = acquireBuffer( getSizeClass( numChannels, numSamples ) );
 	
-	SharedSoundBuffer sharedBuffer( buffers.getLast() );
+	// Didn't find a suitable buffer, create a new one.
+	if ( bufferInfo == NULL )
+		return SharedSoundBuffer( createBuffer( numChannels, numSamples, sampleRate ) );
 	
-	bufferMutex.unlock();
+	if ( bufferInfo->buffer.getSize() < numSamples )
+		bufferInfo->buffer.setSize( numSamples );
+	
+	if ( bufferInfo->buffer.getChannelCount() != numChannels )
+		bufferInfo->buffer.setChannelCount( numChannels );
 	
-	return sharedBuffer;
+	bufferInfo->buffer.setSampleRate( sampleRate );
+	
+	return SharedSoundBuffer( bufferInfo );
 }
 
 
 
 
-SharedSoundBuffer SharedBufferPool:: getBuffer( Size numChannels, Size numSamples, SampleRate sampleRate )
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Pool Reset Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SharedBufferPool:: reset()
 {
 	bufferMutex.lock();
 	
-	for ( Index i = 0; i < buffers.getSize(); i++ )
+	for ( Index i = 0; i < SIZE_CLASS_COUNT; i++ )
 	{
-		SharedBufferInfo* bufferInfo = buffers[i];
+		// Wait for any pop from this list to finish before taking it.
+		while ( !popLocks[i].testAndSet( 0, 1 ) )
+		{
+		}
+		
+		SharedBufferInfo* bufferInfo = atomic::swapPointer( freeLists[i], (SharedBufferInfo*)NULL );
+		popLocks[i].testAndSet( 1, 0 );
 		
-		if ( bufferInfo->referenceCount == 0 )
+		// Reclaim the buffers that are cached by the calling thread.
+		if ( this == staticPool && threadCache.isValid )
 		{
-			if ( bufferInfo->buffer.getSize() < numSamples )
-				bufferInfo->buffer.setSize( numSamples );
+			SharedBufferInfo* cached = threadCache.freeLists[i];
 			
-			if ( bufferInfo->buffer.getChannelCount() != numChannels )
-				bufferInfo->buffer.setChannelCount( numChannels );
+			if ( cached != NULL )
+			{
+				SharedBufferInfo* last = cached;
+				
+				while ( last->next != NULL )
+					last = last->next;
+				
+				last->next = bufferInfo;
+				bufferInfo = cached;
+			}
 			
-			bufferInfo->buffer.setSampleRate( sampleRate );
+			threadCache.freeLists[i] = NULL;
+			threadCache.freeCounts[i] = 0;
+		}
+		
+		while ( bufferInfo != NULL )
+		{
+			SharedBufferInfo* next = bufferInfo->next;
 			
-			SharedSoundBuffer sharedBuffer( bufferInfo );
-			bufferMutex.unlock();
+			buffers.removeUnordered( bufferInfo );
+			om::util::destruct( bufferInfo );
 			
-			return sharedBuffer;
+			bufferInfo = next;
 		}
 	}
 	
-	// Didn't find a suitable buffer, create a new one.
-	buffers.add( om::util::construct<SharedBufferInfo>( numChannels, numSamples, sampleRate ) );
-	
-	SharedSoundBuffer sharedBuffer( buffers.getLast() );
-	
 	bufferMutex.unlock();
-	
-	return sharedBuffer;
 }
 
 
@@ -129,7 +277,7 @@ SharedSoundBuffer SharedBufferPool:: getBuffer( Size numChannels, Size numSample
 //##########################################################################################
 //##########################################################################################
 //############		
-//############		Pool Reset Method
+//############		Free List Helper Methods
 //############		
 //##########################################################################################
 //##########################################################################################
@@ -137,22 +285,151 @@ SharedSoundBuffer SharedBufferPool:: getBuffer( Size numChannels, Size numSample
 
 
 
-void SharedBufferPool:: reset()
+Index SharedBufferPool:: getSizeClass( Size numChannels, Size numSamples )
 {
-	bufferMutex.lock();
+	const Index channelClass = math::clamp( numChannels, Size(1), Size(CHANNEL_CLASS_COUNT) ) - 1;
+	Index sampleClass;
+	
+	if ( numSamples <= 256 )
+		sampleClass = 0;
+	else if ( numSamples <= 1024 )
+		sampleClass = 1;
+	else if ( numSamples <= 4096 )
+		sampleClass = 2;
+	else
+		sampleClass = 3;
 	
-	for ( Index i = 0; i < buffers.getSize(); )
+	return channelClass*SAMPLE_CLASS_COUNT + sampleClass;
+}
+
+
+
+
+SharedBufferInfo* SharedBufferPool:: acquireBuffer( Index sizeClass )
+{
+	if ( this == staticPool && threadCache.isValid )
 	{
-		if ( buffers[i]->referenceCount == 0 )
+		SharedBufferInfo* bufferInfo = threadCache.freeLists[sizeClass];
+		
+		if ( bufferInfo != NULL )
 		{
-			buffers.removeAtIndexUnordered(i);
-			continue;
+			threadCache.freeLists[sizeClass] = bufferInfo->next;
+			threadCache.freeCounts[sizeClass]--;
+			bufferInfo->next = NULL;
+			
+			return bufferInfo;
 		}
-		
-		i++;
 	}
 	
+	// Take one buffer from the overflow list, leaving the rest for other threads.
+	// This thread's cache is refilled by the buffers that it releases.
+	return popFreeList( sizeClass );
+}
+
+
+
+
+void SharedBufferPool:: releaseBuffer( SharedBufferInfo* bufferInfo )
+{
+	const Index sizeClass = getSizeClass( bufferInfo->buffer.getChannelCount(), bufferInfo->buffer.getSize() );
+	
+	if ( this == staticPool && threadCache.isValid &&
+		threadCache.freeCounts[sizeClass] < ThreadCache::MAX_FREE_COUNT )
+	{
+		bufferInfo->next = threadCache.freeLists[sizeClass];
+		threadCache.freeLists[sizeClass] = bufferInfo;
+		threadCache.freeCounts[sizeClass]++;
+		return;
+	}
+	
+	pushFreeList( sizeClass, bufferInfo, bufferInfo );
+}
+
+
+
+
+SharedBufferInfo* SharedBufferPool:: createBuffer( Size numChannels, Size numSamples, SampleRate sampleRate )
+{
+	SharedBufferInfo* bufferInfo = om::util::construct<SharedBufferInfo>( this, numChannels, numSamples, sampleRate );
+	
+	bufferMutex.lock();
+	buffers.add( bufferInfo );
 	bufferMutex.unlock();
+	
+	return bufferInfo;
+}
+
+
+
+
+void SharedBufferPool:: pushFreeList( Index sizeClass, SharedBufferInfo* first, SharedBufferInfo* last )
+{
+	// Guess that the list is empty, then retry with the head that the failed swap returns.
+	SharedBufferInfo* head = NULL;
+	
+	while ( true )
+	{
+		last->next = head;
+		
+		SharedBufferInfo* previousHead = atomic::compareAndSwapPointer( freeLists[sizeClass], head, first );
+		
+		if ( previousHead == head )
+			break;
+		
+		head = previousHead;
+	}
+}
+
+
+
+
+SharedBufferInfo* SharedBufferPool:: popFreeList( Index sizeClass )
+{
+	// Only one thread pops at a time, so the head can't be removed and pushed back
+	// by another pop between reading its next pointer and swapping it in.
+	while ( !popLocks[sizeClass].testAndSet( 0, 1 ) )
+	{
+	}
+	
+	// Read the current head by swapping it with itself.
+	SharedBufferInfo* head = atomic::compareAndSwapPointer( freeLists[sizeClass], (SharedBufferInfo*)NULL, (SharedBufferInfo*)NULL );
+	
+	while ( head != NULL )
+	{
+		// Concurrent pushes can change the head, in which case retry with the new head.
+		SharedBufferInfo* previousHead = atomic::compareAndSwapPointer( freeLists[sizeClass], head, head->next );
+		
+		if ( previousHead == head )
+			break;
+		
+		head = previousHead;
+	}
+	
+	popLocks[sizeClass].testAndSet( 1, 0 );
+	
+	if ( head != NULL )
+		head->next = NULL;
+	
+	return head;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Shared Buffer Info Release Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void SharedBufferInfo:: release()
+{
+	pool->releaseBuffer( this );
 }
 
 
@@ -39,6 +39,14 @@ OM_SOUND_BASE_NAMESPACE_START
   * When requesting a buffer, the user can specify the attributes of that buffer,
   * and the buffer pool will return a buffer (creating one if necessary) that matches
   * those characteristics.
+  *
+  * Free buffers are kept in size-class bins keyed by channel count and sample count.
+  * Each bin has a lock-free overflow list, and buffers from the global pool are
+  * additionally cached in per-thread free lists so that acquiring and releasing a
+  * temporary buffer in the audio path usually doesn't need to lock or spin. Buffers
+  * are pushed onto an overflow list without locking, while popping one holds a short
+  * per-bin spin lock so that the list can't be modified by another pop in between.
+  * The pool mutex is only taken when a new buffer must be allocated or when the pool is reset.
   */
 class SharedBufferPool
 {
@@ -49,9 +57,7 @@ class SharedBufferPool
 			
 			
 			/// Create a new empty shared buffer pool.
-			OM_INLINE SharedBufferPool()
-			{
-			}
+			SharedBufferPool();
 			
 			
 		//********************************************************************************
@@ -82,6 +88,10 @@ class SharedBufferPool
 			
 			
 			/// Clear all buffers from this buffer pool that are not in use.
+			/**
+			  * Buffers that are cached in the free lists of threads other than the
+			  * calling thread are not affected.
+			  */
 			void reset();
 			
 			
@@ -112,26 +122,98 @@ class SharedBufferPool
 			
 	private:
 		
+		//********************************************************************************
+		//******	Private Class Declarations
+			
+			
+			/// A class which stores the per-thread free lists for the global buffer pool.
+			class ThreadCache;
+			
+			
+		//********************************************************************************
+		//******	Private Helper Methods
+			
+			
+			/// Return the index of the size class bin for a buffer with the specified attributes.
+			static Index getSizeClass( Size numChannels, Size numSamples );
+			
+			
+			/// Return a free buffer from the specified size class, or NULL if there is none.
+			SharedBufferInfo* acquireBuffer( Index sizeClass );
+			
+			
+			/// Return a buffer that is no longer referenced to this pool's free lists.
+			void releaseBuffer( SharedBufferInfo* bufferInfo );
+			
+			
+			/// Allocate a new buffer with the specified attributes that is owned by this pool.
+			SharedBufferInfo* createBuffer( Size numChannels, Size numSamples, SampleRate sampleRate );
+			
+			
+			/// Push a linked list of free buffers onto the lock-free overflow list for a size class.
+			void pushFreeList( Index sizeClass, SharedBufferInfo* first, SharedBufferInfo* last );
+			
+			
+			/// Pop a single free buffer from the overflow list for a size class, or return NULL if it is empty.
+			SharedBufferInfo* popFreeList( Index sizeClass );
+			
+			
 		//********************************************************************************
 		//******	Private Static Data Members
 			
 			
+			/// The number of channel count classes that buffers are binned by.
+			static const Size CHANNEL_CLASS_COUNT = 8;
+			
+			
+			/// The number of sample count classes that buffers are binned by.
+			static const Size SAMPLE_CLASS_COUNT = 4;
+			
+			
+			/// The total number of size class bins in a pool.
+			static const Size SIZE_CLASS_COUNT = CHANNEL_CLASS_COUNT*SAMPLE_CLASS_COUNT;
+			
+			
 			/// A pointer to a global shared buffer pool.
 			static SharedBufferPool* staticPool;
 			
 			
+			/// The per-thread free lists for the global shared buffer pool.
+			static thread_local ThreadCache threadCache;
+			
+			
 		//********************************************************************************
 		//******	Private Data Members
 			
 			
-			/// A list of the buffers that are a part of this shared buffer pool.
+			/// The heads of the lock-free overflow lists of free buffers for each size class.
+			SharedBufferInfo* freeLists[SIZE_CLASS_COUNT];
+			
+			
+			/// Spin locks that allow only one thread at a time to pop from each overflow list.
+			/**
+			  * A pop reads the head's next pointer before swapping it in, which is only safe
+			  * if no other pop can remove the head and push it back in the meantime (the ABA problem).
+			  */
+			Atomic<UInt32> popLocks[SIZE_CLASS_COUNT];
+			
+			
+			/// A list of all of the buffers that are a part of this shared buffer pool.
 			ArrayList<SharedBufferInfo*> buffers;
 			
 			
-			/// A mutex which prevents concurrent access to the list of shared buffers.
+			/// A mutex which prevents concurrent access to the list of all shared buffers.
 			Mutex bufferMutex;
 			
 			
+		//********************************************************************************
+		//******	Private Friend Declarations
+			
+			
+			/// Declare the SharedBufferInfo class as a friend so that it can return itself to the pool.
+			friend class SharedBufferInfo;
+			
+			
 			
 };
 
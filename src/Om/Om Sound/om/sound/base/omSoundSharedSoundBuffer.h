@@ -82,7 +82,8 @@ class SharedSoundBuffer
 			/// Destroy this handle to a shared sound buffer, releasing it back to its pool.
 			OM_INLINE ~SharedSoundBuffer()
 			{
-				bufferInfo->referenceCount--;
+				if ( --bufferInfo->referenceCount == Size(0) )
+					bufferInfo->release();
 			}
 			
 			
@@ -95,9 +96,12 @@ class SharedSoundBuffer
 			{
 				if ( this != &other )
 				{
-					bufferInfo->referenceCount--;
+					SharedBufferInfo* oldBufferInfo = bufferInfo;
 					bufferInfo = other.bufferInfo;
 					bufferInfo->referenceCount++;
+					
+					if ( --oldBufferInfo->referenceCount == Size(0) )
+						oldBufferInfo->release();
 				}
 				
 				return *this;
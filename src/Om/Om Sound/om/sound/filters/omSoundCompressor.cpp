@@ -697,6 +697,78 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 	
 	if ( linkChannels )
 	{
+		// Get a temporary buffer that holds the linked envelope and then the gain for each sample.
+		SharedSoundBuffer sharedBuffer = SharedBufferPool::getGlobalBuffer( 1, numSamples, inputBuffer.getSampleRate() );
+		Sample32f* const gains = sharedBuffer.getBuffer().getChannel(0);
+		
+		om::util::zeroPOD( gains, numSamples );
+		
+		//****************************************************************************
+		// Update the envelope of each channel over the whole frame, keeping the maximum over all channels.
+		// Since the gain reduction increases monotonically with the envelope level, the channel with
+		// the highest envelope determines the linked gain reduction for each sample.
+		
+		for ( Index c = 0; c < numChannels; c++ )
+		{
+			const Sample32f* const input = inputBuffer.getChannel(c);
+			Float e = envelope[c];
+			Gain currentInputGain = inputGain;
+			
+			Sample32f* rmsStart, *rmsEnd;
+			Sample32f* rms;
+			Float sumSquares;
+			
+			if ( rmsEnabled )
+			{
+				rmsStart = rmsBuffer.getChannel(c);
+				rmsEnd = rmsStart + rmsLengthInSamples;
+				rms = rmsStart + currentRMSIndex;
+				sumSquares = rmsSumSquares[c];
+			}
+			
+			for ( Index i = 0; i < numSamples; i++ )
+			{
+				Float inputSample = input[i]*currentInputGain;
+				Float level;
+				
+				if ( rmsEnabled )
+				{
+					if ( rms == rmsEnd )
+						rms = rmsStart;
+					
+					// Compute the new sum-of-squares for the current sample.
+					Float sampleSquared = inputSample*inputSample;
+					sumSquares = math::max( sumSquares - *rms, Float(0) ) + sampleSquared;
+					*rms = sampleSquared;
+					rms++;
+					
+					// Compute the RMS level for this sample.
+					level = math::sqrt( sumSquares*inverseRMSLength );
+				}
+				else
+					level = math::abs( inputSample );
+				
+				// Update the envelope level for this sample.
+				if ( level > e )
+					e = level + envelopeAttack*(e - level);
+				else
+					e = level + envelopeRelease*(e - level);
+				
+				gains[i] = math::max( gains[i], e );
+				
+				if ( interpolateChanges )
+					currentInputGain += inputGainChangePerSample;
+			}
+			
+			envelope[c] = e;
+			
+			if ( rmsEnabled )
+				rmsSumSquares[c] = sumSquares;
+		}
+		
+		//****************************************************************************
+		// Compute the gain that is applied to all channels for each sample.
+		
 		Gain currentInputGain = inputGain;
 		Gain currentOutputGain = outputGain;
 		Gain currentMix = mix;
@@ -721,8 +793,6 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 		
 		for ( Index i = 0; i < numSamples; i++ )
 		{
-			Gain maxReduction = 0;
-			
 			// Recompute the knee and gain reduction constants for this sample.
 			if ( interpolateChanges )
 			{
@@ -735,55 +805,14 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 				kneeMax = currentThreshold*linearKnee;
 			}
 			
-			//****************************************************************************
+			const Float e = gains[i];
+			Gain maxReduction = 0;
 			
-			// Find the highest amount of gain reduction for all channels.
-			for ( Index c = 0; c < numChannels; c++ )
+			// Detect if the envelope is over the threshold, and if so, apply gain reduction.
+			if ( e > kneeMin )
 			{
-				Float inputSample = inputBuffer.getChannel(c)[i]*currentInputGain;
-				Float level;
-				
-				if ( rmsEnabled )
-				{
-					if ( currentRMSIndex >= rmsLengthInSamples )
-						currentRMSIndex = 0;
-					
-					Sample32f* rms = rmsBuffer.getChannel(c) + currentRMSIndex;
-					Float& sumSquares = rmsSumSquares[c];
-					
-					// Compute the new sum-of-squares for the current sample.
-					Float sampleSquared = inputSample*inputSample;
-					sumSquares = math::max( sumSquares - *rms, Float(0) ) + sampleSquared;
-					*rms = sampleSquared;
-					
-					// Compute the RMS level for this sample.
-					level = math::sqrt( sumSquares*inverseRMSLength );
-				}
-				else
-					level = math::abs( inputSample );
-				
-				//****************************************************************************
-				// Update the envelope level for this sample.
-				
-				Float& e = envelope[c];
-				
-				if ( level > e )
-					e = level + envelopeAttack*(e - level);
-				else
-					e = level + envelopeRelease*(e - level);
-				
-				//****************************************************************************
-				// Detect if the envelope is over the threshold, and if so, apply gain reduction.
-				
-				if ( e > kneeMin )
-				{
-					// Compute the reduction for this channel.
-					Gain dbReduction = getDBReduction2( e, currentThreshold, reductionConstant,
-														kneeMin, kneeMax, currentKnee );
-					
-					// Find the largest (most negative) reduction amount.
-					maxReduction = math::min( maxReduction, dbReduction );
-				}
+				maxReduction = math::min( getDBReduction2( e, currentThreshold, reductionConstant,
+															kneeMin, kneeMax, currentKnee ), Gain(0) );
 			}
 			
 			// Add the current reduction in dB to the total reduction.
@@ -796,18 +825,7 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 			// Compute how much gain is applied to the input when mixing with the output.
 			Gain inputMix = Gain(1) - currentMix;
 			
-			//****************************************************************************
-			// Compute the output for this sample.
-			
-			// Apply the final gain to all channels.
-			for ( Index c = 0; c < numChannels; c++ )
-			{
-				Sample32f inputSample = inputBuffer.getChannel(c)[i]*currentInputGain;
-				outputBuffer.getChannel(c)[i] = inputSample*inputMix + inputSample*finalGain;
-			}
-			
-			//****************************************************************************
-			// Increment values that need updating.
+			gains[i] = currentInputGain*(inputMix + finalGain);
 			
 			// Update the current state for interpolated parameters.
 			if ( interpolateChanges )
@@ -821,6 +839,18 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 			}
 		}
 		
+		//****************************************************************************
+		// Apply the linked gain to each channel.
+		
+		for ( Index c = 0; c < numChannels; c++ )
+		{
+			const Sample32f* const input = inputBuffer.getChannel(c);
+			Sample32f* const output = outputBuffer.getChannel(c);
+			
+			for ( Index i = 0; i < numSamples; i++ )
+				output[i] = input[i]*gains[i];
+		}
+		
 		// Store the final values for interpolated parameters.
 		if ( interpolateChanges )
 		{
@@ -947,11 +977,6 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 			}
 		}
 		
-		//****************************************************************************
-		
-		// Update the current position in the RMS buffer.
-		currentRMSIndex = (currentRMSIndex + numSamples) % rmsLengthInSamples;
-		
 		// Store the final values for interpolated parameters.
 		if ( interpolateChanges )
 		{
@@ -964,6 +989,9 @@ void Compressor:: compress( const SoundBuffer& inputBuffer, SoundBuffer& outputB
 		}
 	}
 	
+	// Update the current position in the RMS buffer.
+	currentRMSIndex = (currentRMSIndex + numSamples) % rmsLengthInSamples;
+	
 	// Update the current average gain reduction amount.
 	if ( numReductionSamples > 0 )
 		currentReduction = -reductionTotal / numReductionSamples;
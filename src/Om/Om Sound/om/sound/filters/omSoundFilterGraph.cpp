@@ -0,0 +1,1102 @@
+/*
+ * Project:     Om Software
+ * Version:     1.0.0
+ * Website:     http://www.carlschissler.com/om
+ * Author(s):   Carl Schissler
+ * 
+ * Copyright (c) 2016, Carl Schissler
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 	1. Redistributions of source code must retain the above copyright
+ * 	   notice, this list of conditions and the following disclaimer.
+ * 	2. Redistributions in binary form must reproduce the above copyright
+ * 	   notice, this list of conditions and the following disclaimer in the
+ * 	   documentation and/or other materials provided with the distribution.
+ * 	3. Neither the name of the copyright holder nor the
+ * 	   names of its contributors may be used to endorse or promote products
+ * 	   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "omSoundFilterGraph.h"
+
+
+//##########################################################################################
+//*************************  Start Om Sound Filters Namespace  *****************************
+OM_SOUND_FILTERS_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+const UTF8String FilterGraph:: NAME( "Filter Graph" );
+const UTF8String FilterGraph:: MANUFACTURER( "Om Sound" );
+const FilterVersion FilterGraph:: VERSION( 1, 0, 0 );
+
+
+const Index FilterGraph:: GRAPH_NODE;
+const Index FilterGraph:: INVALID_SLOT;
+const Index FilterGraph:: OUTPUT_LEVEL;
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Constructors
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+FilterGraph:: FilterGraph()
+	:	SoundFilter( 1, 1 ),
+		needsCompile( true ),
+		compiledValid( false )
+{
+}
+
+
+
+
+FilterGraph:: FilterGraph( Size numInputs, Size numOutputs )
+	:	SoundFilter( numInputs, numOutputs ),
+		needsCompile( true ),
+		compiledValid( false )
+{
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Destructor
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+FilterGraph:: ~FilterGraph()
+{
+	for ( Index i = 0; i < nodes.getSize(); i++ )
+		nodes[i].filter->setIsSynchronized( nodes[i].wasSynchronized );
+	
+	for ( Index i = 0; i < storageBuffers.getSize(); i++ )
+		util::destruct( storageBuffers[i] );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Filter Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool FilterGraph:: hasFilter( const SoundFilter* filter ) const
+{
+	return this->getNodeIndex( filter ) != GRAPH_NODE;
+}
+
+
+
+
+Bool FilterGraph:: addFilter( SoundFilter* filter )
+{
+	if ( filter == NULL || filter == this )
+		return false;
+	
+	lockMutex();
+	
+	if ( this->getNodeIndex( filter ) != GRAPH_NODE )
+	{
+		unlockMutex();
+		return false;
+	}
+	
+	// The graph's own mutex protects the filter from now on.
+	nodes.add( Node( filter ) );
+	filter->setIsSynchronized( false );
+	needsCompile = true;
+	
+	unlockMutex();
+	
+	return true;
+}
+
+
+
+
+Bool FilterGraph:: removeFilter( SoundFilter* filter )
+{
+	lockMutex();
+	
+	const Index nodeIndex = this->getNodeIndex( filter );
+	
+	if ( nodeIndex == GRAPH_NODE )
+	{
+		unlockMutex();
+		return false;
+	}
+	
+	filter->setIsSynchronized( nodes[nodeIndex].wasSynchronized );
+	nodes.removeAtIndex( nodeIndex );
+	
+	// Remove the filter's connections and renumber the connections to the nodes after it.
+	for ( Index i = 0; i < connections.getSize(); )
+	{
+		Connection& connection = connections[i];
+		
+		if ( connection.sourceNode == nodeIndex || connection.destinationNode == nodeIndex )
+		{
+			connections.removeAtIndex( i );
+			continue;
+		}
+		
+		if ( connection.sourceNode != GRAPH_NODE && connection.sourceNode > nodeIndex )
+			connection.sourceNode--;
+		
+		if ( connection.destinationNode != GRAPH_NODE && connection.destinationNode > nodeIndex )
+			connection.destinationNode--;
+		
+		i++;
+	}
+	
+	needsCompile = true;
+	
+	unlockMutex();
+	
+	return true;
+}
+
+
+
+
+void FilterGraph:: clearFilters()
+{
+	lockMutex();
+	
+	for ( Index i = 0; i < nodes.getSize(); i++ )
+		nodes[i].filter->setIsSynchronized( nodes[i].wasSynchronized );
+	
+	nodes.clear();
+	connections.clear();
+	needsCompile = true;
+	
+	unlockMutex();
+}
+
+
+
+
+Index FilterGraph:: getNodeIndex( const SoundFilter* filter ) const
+{
+	for ( Index i = 0; i < nodes.getSize(); i++ )
+	{
+		if ( nodes[i].filter == filter )
+			return i;
+	}
+	
+	return GRAPH_NODE;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Connection Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool FilterGraph:: connect( SoundFilter* source, Index sourceOutputIndex, SoundFilter* destination, Index destinationInputIndex )
+{
+	lockMutex();
+	
+	const Index sourceNode = this->getNodeIndex( source );
+	const Index destinationNode = this->getNodeIndex( destination );
+	Bool result = false;
+	
+	if ( sourceNode != GRAPH_NODE && destinationNode != GRAPH_NODE &&
+		sourceOutputIndex < source->getOutputCount() && destinationInputIndex < destination->getInputCount() )
+	{
+		result = this->addConnection( Connection( sourceNode, sourceOutputIndex, destinationNode, destinationInputIndex ) );
+	}
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: connectInput( Index graphInputIndex, SoundFilter* destination, Index destinationInputIndex )
+{
+	lockMutex();
+	
+	const Index destinationNode = this->getNodeIndex( destination );
+	Bool result = false;
+	
+	if ( destinationNode != GRAPH_NODE && graphInputIndex < this->getInputCount() &&
+		destinationInputIndex < destination->getInputCount() )
+	{
+		result = this->addConnection( Connection( GRAPH_NODE, graphInputIndex, destinationNode, destinationInputIndex ) );
+	}
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: connectOutput( SoundFilter* source, Index sourceOutputIndex, Index graphOutputIndex )
+{
+	lockMutex();
+	
+	const Index sourceNode = this->getNodeIndex( source );
+	Bool result = false;
+	
+	if ( sourceNode != GRAPH_NODE && sourceOutputIndex < source->getOutputCount() &&
+		graphOutputIndex < this->getOutputCount() )
+	{
+		result = this->addConnection( Connection( sourceNode, sourceOutputIndex, GRAPH_NODE, graphOutputIndex ) );
+	}
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: connectInputToOutput( Index graphInputIndex, Index graphOutputIndex )
+{
+	lockMutex();
+	
+	Bool result = false;
+	
+	if ( graphInputIndex < this->getInputCount() && graphOutputIndex < this->getOutputCount() )
+		result = this->addConnection( Connection( GRAPH_NODE, graphInputIndex, GRAPH_NODE, graphOutputIndex ) );
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: disconnect( SoundFilter* source, Index sourceOutputIndex, SoundFilter* destination, Index destinationInputIndex )
+{
+	lockMutex();
+	
+	const Index sourceNode = this->getNodeIndex( source );
+	const Index destinationNode = this->getNodeIndex( destination );
+	Bool result = false;
+	
+	if ( sourceNode != GRAPH_NODE && destinationNode != GRAPH_NODE )
+		result = this->removeConnection( Connection( sourceNode, sourceOutputIndex, destinationNode, destinationInputIndex ) );
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: disconnectInput( Index graphInputIndex, SoundFilter* destination, Index destinationInputIndex )
+{
+	lockMutex();
+	
+	const Index destinationNode = this->getNodeIndex( destination );
+	Bool result = false;
+	
+	if ( destinationNode != GRAPH_NODE )
+		result = this->removeConnection( Connection( GRAPH_NODE, graphInputIndex, destinationNode, destinationInputIndex ) );
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: disconnectOutput( SoundFilter* source, Index sourceOutputIndex, Index graphOutputIndex )
+{
+	lockMutex();
+	
+	const Index sourceNode = this->getNodeIndex( source );
+	Bool result = false;
+	
+	if ( sourceNode != GRAPH_NODE )
+		result = this->removeConnection( Connection( sourceNode, sourceOutputIndex, GRAPH_NODE, graphOutputIndex ) );
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+Bool FilterGraph:: disconnectInputFromOutput( Index graphInputIndex, Index graphOutputIndex )
+{
+	lockMutex();
+	
+	Bool result = this->removeConnection( Connection( GRAPH_NODE, graphInputIndex, GRAPH_NODE, graphOutputIndex ) );
+	
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+void FilterGraph:: clearConnections()
+{
+	lockMutex();
+	
+	connections.clear();
+	needsCompile = true;
+	
+	unlockMutex();
+}
+
+
+
+
+Bool FilterGraph:: addConnection( const Connection& connection )
+{
+	if ( connections.contains( connection ) )
+		return false;
+	
+	connections.add( connection );
+	needsCompile = true;
+	
+	return true;
+}
+
+
+
+
+Bool FilterGraph:: removeConnection( const Connection& connection )
+{
+	if ( !connections.remove( connection ) )
+		return false;
+	
+	needsCompile = true;
+	
+	return true;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Graph Validity Accessor Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool FilterGraph:: isValid() const
+{
+	ArrayList<Index> order;
+	ArrayList<Index> levels;
+	
+	lockMutex();
+	Bool result = this->sortNodes( order, levels );
+	unlockMutex();
+	
+	return result;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Thread Count Accessor Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void FilterGraph:: setThreadCount( Size newNumThreads )
+{
+	lockMutex();
+	threadPool.setThreadCount( newNumThreads );
+	unlockMutex();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Filter Attribute Accessor Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+UTF8String FilterGraph:: getName() const
+{
+	return NAME;
+}
+
+
+
+
+UTF8String FilterGraph:: getManufacturer() const
+{
+	return MANUFACTURER;
+}
+
+
+
+
+FilterVersion FilterGraph:: getVersion() const
+{
+	return VERSION;
+}
+
+
+
+
+FilterCategory FilterGraph:: getCategory() const
+{
+	return FilterCategory::ROUTING;
+}
+
+
+
+
+Time FilterGraph:: getLatency() const
+{
+	ArrayList<Index> order;
+	ArrayList<Index> levels;
+	Time latency;
+	
+	lockMutex();
+	
+	if ( this->sortNodes( order, levels ) )
+	{
+		// Accumulate the latency along each path in schedule order.
+		ArrayList<Time> nodeLatencies( nodes.getSize() );
+		
+		for ( Index i = 0; i < nodes.getSize(); i++ )
+			nodeLatencies.add( Time() );
+		
+		for ( Index i = 0; i < order.getSize(); i++ )
+		{
+			const Index nodeIndex = order[i];
+			Time inputLatency;
+			
+			for ( Index c = 0; c < connections.getSize(); c++ )
+			{
+				const Connection& connection = connections[c];
+				
+				if ( connection.destinationNode == nodeIndex && connection.sourceNode != GRAPH_NODE &&
+					nodeLatencies[connection.sourceNode] > inputLatency )
+					inputLatency = nodeLatencies[connection.sourceNode];
+			}
+			
+			nodeLatencies[nodeIndex] = inputLatency + nodes[nodeIndex].filter->getLatency();
+		}
+		
+		for ( Index c = 0; c < connections.getSize(); c++ )
+		{
+			const Connection& connection = connections[c];
+			
+			if ( connection.destinationNode == GRAPH_NODE && connection.sourceNode != GRAPH_NODE &&
+				nodeLatencies[connection.sourceNode] > latency )
+				latency = nodeLatencies[connection.sourceNode];
+		}
+	}
+	
+	unlockMutex();
+	
+	return latency;
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Stream Reset Method
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+void FilterGraph:: resetStream()
+{
+	for ( Index i = 0; i < nodes.getSize(); i++ )
+		nodes[i].filter->reset();
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Filter Processing Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+SoundResult FilterGraph:: processFrame( const SoundFrame& inputFrame,
+											SoundFrame& outputFrame, Size numSamples )
+{
+	if ( needsCompile )
+	{
+		compiledValid = this->compile();
+		needsCompile = false;
+	}
+	
+	if ( !compiledValid )
+		return SoundResult::ERROR;
+	
+	//******************************************************************************
+	// Bind the caller's buffers to the external slots.
+	
+	for ( Index i = 0; i < slots.getSize(); i++ )
+	{
+		Slot& slot = slots[i];
+		
+		if ( slot.type == Slot::INPUT )
+		{
+			// Input slots are never written, so it is safe to pass them through the filters' input frames.
+			slot.buffer = slot.externalIndex < inputFrame.getBufferCount() ?
+							const_cast<SoundBuffer*>( inputFrame.getBuffer( slot.externalIndex ) ) : NULL;
+		}
+		else if ( slot.type == Slot::OUTPUT )
+		{
+			SoundBuffer* outputBuffer = slot.externalIndex < outputFrame.getBufferCount() ?
+										outputFrame.getBuffer( slot.externalIndex ) : NULL;
+			
+			slot.buffer = outputBuffer != NULL ? outputBuffer : slot.storage;
+		}
+	}
+	
+	for ( Index i = 0; i < nodes.getSize(); i++ )
+	{
+		Node& node = nodes[i];
+		
+		for ( Index j = 0; j < node.inputs.getSize(); j++ )
+		{
+			const Index slotIndex = node.inputs[j].slot;
+			node.inputFrame.setBuffer( j, slotIndex != INVALID_SLOT ? slots[slotIndex].buffer : NULL );
+		}
+		
+		for ( Index j = 0; j < node.outputSlots.getSize(); j++ )
+			node.outputFrame.setBuffer( j, slots[node.outputSlots[j]].buffer );
+	}
+	
+	//******************************************************************************
+	// Process the filters one level at a time.
+	
+	const Size numLevels = levelStarts.getSize() - 1;
+	const Bool parallel = threadPool.getThreadCount() > 0;
+	
+	for ( Index level = 0; level < numLevels; level++ )
+	{
+		const Index levelStart = levelStarts[level];
+		const Index levelEnd = levelStarts[level + 1];
+		
+		if ( parallel && levelEnd - levelStart > 1 )
+		{
+			// Keep the first filter for the calling thread and give the rest to the worker threads.
+			for ( Index i = levelStart + 1; i < levelEnd; i++ )
+			{
+				threadPool.addJob( FunctionCall< void ( Node&, Size )>(
+									bind( &FilterGraph::processNode, this ), nodes[schedule[i]], numSamples ) );
+			}
+			
+			this->processNode( nodes[schedule[levelStart]], numSamples );
+			threadPool.finishJobs();
+		}
+		else
+		{
+			for ( Index i = levelStart; i < levelEnd; i++ )
+				this->processNode( nodes[schedule[i]], numSamples );
+		}
+	}
+	
+	SoundResult::Status status = SoundResult::SUCCESS;
+	
+	for ( Index i = 0; i < nodes.getSize(); i++ )
+	{
+		if ( nodes[i].result.getStatus() == SoundResult::ERROR )
+			status = SoundResult::ERROR;
+	}
+	
+	//******************************************************************************
+	// Produce the graph outputs which weren't written directly by a filter.
+	
+	const Size numOutputs = math::min( outputFrame.getBufferCount(), graphOutputs.getSize() );
+	
+	for ( Index i = 0; i < numOutputs; i++ )
+	{
+		const GraphOutput& graphOutput = graphOutputs[i];
+		SoundBuffer* outputBuffer = outputFrame.getBuffer(i);
+		
+		if ( graphOutput.slot != INVALID_SLOT || outputBuffer == NULL )
+			continue;
+		
+		Bool first = true;
+		
+		for ( Index j = 0; j < graphOutput.mixSlots.getSize(); j++ )
+		{
+			const SoundBuffer* source = slots[graphOutput.mixSlots[j]].buffer;
+			
+			if ( source == NULL || source == outputBuffer )
+				continue;
+			
+			if ( first )
+			{
+				source->copyFormatTo( *outputBuffer, numSamples );
+				source->copyTo( *outputBuffer, numSamples );
+				first = false;
+			}
+			else
+				source->mixTo( *outputBuffer, numSamples );
+		}
+		
+		if ( first )
+		{
+			if ( outputBuffer->getSize() < numSamples )
+				outputBuffer->setSize( numSamples );
+			
+			outputBuffer->zero( 0, numSamples );
+		}
+	}
+	
+	return SoundResult( status, numSamples );
+}
+
+
+
+
+void FilterGraph:: processNode( Node& node, Size numSamples )
+{
+	// Mix together the connections to inputs with more than one source.
+	for ( Index i = 0; i < node.inputs.getSize(); i++ )
+	{
+		const NodeInput& input = node.inputs[i];
+		
+		if ( input.mixSlots.getSize() == 0 )
+			continue;
+		
+		SoundBuffer* mixBuffer = slots[input.slot].buffer;
+		Bool first = true;
+		
+		for ( Index j = 0; j < input.mixSlots.getSize(); j++ )
+		{
+			const SoundBuffer* source = slots[input.mixSlots[j]].buffer;
+			
+			if ( source == NULL )
+				continue;
+			
+			if ( first )
+			{
+				source->copyFormatTo( *mixBuffer, numSamples );
+				source->copyTo( *mixBuffer, numSamples );
+				first = false;
+			}
+			else
+				source->mixTo( *mixBuffer, numSamples );
+		}
+		
+		if ( first )
+		{
+			if ( mixBuffer->getSize() < numSamples )
+				mixBuffer->setSize( numSamples );
+			
+			mixBuffer->zero( 0, numSamples );
+		}
+	}
+	
+	node.result = node.filter->process( node.inputFrame, node.outputFrame, numSamples );
+}
+
+
+
+
+//##########################################################################################
+//##########################################################################################
+//############		
+//############		Graph Compilation Methods
+//############		
+//##########################################################################################
+//##########################################################################################
+
+
+
+
+Bool FilterGraph:: compile()
+{
+	const Size numNodes = nodes.getSize();
+	const Size numGraphInputs = this->getInputCount();
+	const Size numGraphOutputs = this->getOutputCount();
+	ArrayList<Index> levels;
+	
+	schedule.clear();
+	levelStarts.clear();
+	slots.clear();
+	graphOutputs.clear();
+	
+	if ( !this->sortNodes( schedule, levels ) )
+		return false;
+	
+	// Record where each level starts in the schedule.
+	for ( Index i = 0; i < schedule.getSize(); i++ )
+	{
+		if ( i == 0 || levels[schedule[i]] != levels[schedule[i - 1]] )
+			levelStarts.add( i );
+	}
+	
+	levelStarts.add( schedule.getSize() );
+	
+	//******************************************************************************
+	// Create the slots for the graph inputs. Their slot indices match the input indices.
+	
+	for ( Index i = 0; i < numGraphInputs; i++ )
+		slots.add( Slot( Slot::INPUT, i, NULL ) );
+	
+	for ( Index i = 0; i < numNodes; i++ )
+	{
+		Node& node = nodes[i];
+		const Size numInputs = node.filter->getInputCount();
+		const Size numOutputs = node.filter->getOutputCount();
+		
+		node.inputs.clear();
+		node.outputSlots.clear();
+		
+		for ( Index j = 0; j < numInputs; j++ )
+			node.inputs.add( NodeInput() );
+		
+		for ( Index j = 0; j < numOutputs; j++ )
+			node.outputSlots.add( INVALID_SLOT );
+		
+		node.inputFrame.setBufferCount( numInputs );
+		node.outputFrame.setBufferCount( numOutputs );
+	}
+	
+	//******************************************************************************
+	// Let filter outputs that feed exactly one graph output write to it directly.
+	
+	Size numStorageBuffers = 0;
+	
+	for ( Index i = 0; i < numGraphOutputs; i++ )
+	{
+		graphOutputs.add( GraphOutput() );
+		
+		const Connection* source = NULL;
+		Size numSources = 0;
+		
+		for ( Index c = 0; c < connections.getSize(); c++ )
+		{
+			if ( connections[c].destinationNode == GRAPH_NODE && connections[c].destinationInput == i )
+			{
+				source = &connections[c];
+				numSources++;
+			}
+		}
+		
+		if ( numSources != 1 || source->sourceNode == GRAPH_NODE ||
+			source->sourceOutput >= nodes[source->sourceNode].outputSlots.getSize() )
+			continue;
+		
+		Index& outputSlot = nodes[source->sourceNode].outputSlots[source->sourceOutput];
+		
+		if ( outputSlot != INVALID_SLOT )
+			continue;
+		
+		// Back the slot with a buffer in case the caller doesn't provide this output.
+		if ( numStorageBuffers == storageBuffers.getSize() )
+			storageBuffers.add( util::construct<SoundBuffer>() );
+		
+		outputSlot = slots.getSize();
+		graphOutputs[i].slot = outputSlot;
+		slots.add( Slot( Slot::OUTPUT, i, storageBuffers[numStorageBuffers++] ) );
+		
+		Slot& slot = slots.getLast();
+		slot.lastUse = levels[source->sourceNode];
+		this->addSlotReaders( slot, source->sourceNode, source->sourceOutput, levels );
+	}
+	
+	//******************************************************************************
+	// Assign slots to the filter inputs and outputs level by level.
+	
+	ArrayList<Index> freeSlots;
+	const Size numLevels = levelStarts.getSize() - 1;
+	
+	for ( Index level = 0; level < numLevels; level++ )
+	{
+		for ( Index s = levelStarts[level]; s < levelStarts[level + 1]; s++ )
+		{
+			const Index nodeIndex = schedule[s];
+			Node& node = nodes[nodeIndex];
+			
+			// Determine the slot that feeds each input.
+			for ( Index j = 0; j < node.inputs.getSize(); j++ )
+			{
+				NodeInput& input = node.inputs[j];
+				
+				for ( Index c = 0; c < connections.getSize(); c++ )
+				{
+					const Connection& connection = connections[c];
+					
+					if ( connection.destinationNode == nodeIndex && connection.destinationInput == j )
+						input.mixSlots.add( this->getSourceSlot( connection ) );
+				}
+				
+				if ( input.mixSlots.getSize() == 1 )
+				{
+					input.slot = input.mixSlots[0];
+					input.mixSlots.clear();
+				}
+				else if ( input.mixSlots.getSize() > 1 )
+				{
+					// Mix the connections into a temporary slot that lives until the end of this level.
+					input.slot = this->allocateSlot( freeSlots, numStorageBuffers );
+					slots[input.slot].lastUse = level;
+					slots[input.slot].numLastUseReaders = 1;
+				}
+			}
+			
+			// Determine the slot that each output is written to.
+			const Bool inPlace = node.filter->allowsInPlaceProcessing();
+			
+			for ( Index j = 0; j < node.outputSlots.getSize(); j++ )
+			{
+				if ( node.outputSlots[j] != INVALID_SLOT )
+					continue;
+				
+				Index slotIndex = INVALID_SLOT;
+				
+				// Write over the corresponding input if this filter is the only remaining reader.
+				if ( inPlace && j < node.inputs.getSize() && node.inputs[j].slot != INVALID_SLOT )
+				{
+					const Slot& inputSlot = slots[node.inputs[j].slot];
+					
+					if ( inputSlot.type == Slot::INTERNAL && inputSlot.lastUse == level &&
+						inputSlot.numLastUseReaders == 1 )
+						slotIndex = node.inputs[j].slot;
+				}
+				
+				if ( slotIndex == INVALID_SLOT )
+					slotIndex = this->allocateSlot( freeSlots, numStorageBuffers );
+				
+				Slot& slot = slots[slotIndex];
+				slot.lastUse = level;
+				slot.numLastUseReaders = 0;
+				this->addSlotReaders( slot, nodeIndex, j, levels );
+				node.outputSlots[j] = slotIndex;
+			}
+		}
+		
+		// Release the internal slots which are not read after this level.
+		for ( Index i = 0; i < slots.getSize(); i++ )
+		{
+			if ( slots[i].type == Slot::INTERNAL && slots[i].lastUse == level )
+				freeSlots.add( i );
+		}
+	}
+	
+	//******************************************************************************
+	// Determine the sources of the graph outputs that must be mixed.
+	
+	for ( Index i = 0; i < numGraphOutputs; i++ )
+	{
+		GraphOutput& graphOutput = graphOutputs[i];
+		
+		if ( graphOutput.slot != INVALID_SLOT )
+			continue;
+		
+		for ( Index c = 0; c < connections.getSize(); c++ )
+		{
+			const Connection& connection = connections[c];
+			
+			if ( connection.destinationNode == GRAPH_NODE && connection.destinationInput == i )
+				graphOutput.mixSlots.add( this->getSourceSlot( connection ) );
+		}
+	}
+	
+	return true;
+}
+
+
+
+
+Bool FilterGraph:: sortNodes( ArrayList<Index>& order, ArrayList<Index>& levels ) const
+{
+	const Size numNodes = nodes.getSize();
+	ArrayList<Size> numPredecessors( numNodes );
+	ArrayList<Index> frontier;
+	ArrayList<Index> nextFrontier;
+	
+	order.clear();
+	levels.clear();
+	
+	for ( Index i = 0; i < numNodes; i++ )
+	{
+		numPredecessors.add( 0 );
+		levels.add( 0 );
+	}
+	
+	for ( Index c = 0; c < connections.getSize(); c++ )
+	{
+		const Connection& connection = connections[c];
+		
+		if ( connection.sourceNode != GRAPH_NODE && connection.destinationNode != GRAPH_NODE )
+			numPredecessors[connection.destinationNode]++;
+	}
+	
+	for ( Index i = 0; i < numNodes; i++ )
+	{
+		if ( numPredecessors[i] == 0 )
+			frontier.add( i );
+	}
+	
+	// Remove the nodes with no remaining predecessors one level at a time.
+	for ( Index level = 0; frontier.getSize() > 0; level++ )
+	{
+		nextFrontier.clear();
+		
+		for ( Index i = 0; i < frontier.getSize(); i++ )
+		{
+			const Index nodeIndex = frontier[i];
+			
+			order.add( nodeIndex );
+			levels[nodeIndex] = level;
+			
+			for ( Index c = 0; c < connections.getSize(); c++ )
+			{
+				const Connection& connection = connections[c];
+				
+				if ( connection.sourceNode == nodeIndex && connection.destinationNode != GRAPH_NODE &&
+					--numPredecessors[connection.destinationNode] == 0 )
+					nextFrontier.add( connection.destinationNode );
+			}
+		}
+		
+		frontier = nextFrontier;
+	}
+	
+	// If any nodes were not reached, the graph has a cycle.
+	return order.getSize() == numNodes;
+}
+
+
+
+
+Index FilterGraph:: allocateSlot( ArrayList<Index>& freeSlots, Size& numStorageBuffers )
+{
+	if ( freeSlots.getSize() > 0 )
+	{
+		const Index slotIndex = freeSlots.getLast();
+		freeSlots.removeLast();
+		
+		return slotIndex;
+	}
+	
+	// Reuse the buffers from previous compilations before allocating new ones.
+	if ( numStorageBuffers == storageBuffers.getSize() )
+		storageBuffers.add( util::construct<SoundBuffer>() );
+	
+	slots.add( Slot( Slot::INTERNAL, 0, storageBuffers[numStorageBuffers++] ) );
+	
+	return slots.getSize() - 1;
+}
+
+
+
+
+void FilterGraph:: addSlotReaders( Slot& slot, Index sourceNode, Index sourceOutput,
+									const ArrayList<Index>& levels ) const
+{
+	for ( Index c = 0; c < connections.getSize(); c++ )
+	{
+		const Connection& connection = connections[c];
+		
+		if ( connection.sourceNode != sourceNode || connection.sourceOutput != sourceOutput )
+			continue;
+		
+		const Index readLevel = connection.destinationNode == GRAPH_NODE ?
+								OUTPUT_LEVEL : levels[connection.destinationNode];
+		
+		if ( readLevel > slot.lastUse || slot.numLastUseReaders == 0 )
+		{
+			slot.lastUse = readLevel;
+			slot.numLastUseReaders = 1;
+		}
+		else if ( readLevel == slot.lastUse )
+			slot.numLastUseReaders++;
+	}
+}
+
+
+
+
+//##########################################################################################
+//*************************  End Om Sound Filters Namespace  *******************************
+OM_SOUND_FILTERS_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
@@ -0,0 +1,596 @@
+/*
+ * Project:     Om Software
+ * Version:     1.0.0
+ * Website:     http://www.carlschissler.com/om
+ * Author(s):   Carl Schissler
+ * 
+ * Copyright (c) 2016, Carl Schissler
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 	1. Redistributions of source code must retain the above copyright
+ * 	   notice, this list of conditions and the following disclaimer.
+ * 	2. Redistributions in binary form must reproduce the above copyright
+ * 	   notice, this list of conditions and the following disclaimer in the
+ * 	   documentation and/or other materials provided with the distribution.
+ * 	3. Neither the name of the copyright holder nor the
+ * 	   names of its contributors may be used to endorse or promote products
+ * 	   derived from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_OM_SOUND_FILTER_GRAPH_H
+#define INCLUDE_OM_SOUND_FILTER_GRAPH_H
+
+
+#include "omSoundFiltersConfig.h"
+
+
+#include "omSoundFilter.h"
+
+
+//##########################################################################################
+//*************************  Start Om Sound Filters Namespace  *****************************
+OM_SOUND_FILTERS_NAMESPACE_START
+//******************************************************************************************
+//##########################################################################################
+
+
+
+
+//********************************************************************************
+/// A class that processes a directed acyclic graph of sound filters as a single filter.
+/**
+  * The graph's filters are connected to each other and to the graph's inputs and outputs.
+  * Before the first frame after any change to the graph's structure, the graph is compiled
+  * into a schedule of levels, where each level contains filters whose inputs are all
+  * produced by earlier levels. Filters within a level are independent and can be processed
+  * in parallel on the graph's thread pool.
+  *
+  * Intermediate buffers are assigned using a liveness analysis of the schedule, so that
+  * a buffer is reused as soon as every filter that reads it has finished. Filters that
+  * allow in-place processing write their output directly over their input buffer when
+  * no other filter still needs it, and filter outputs that are connected to exactly one
+  * graph output write directly into the caller's output buffer. Buffers are only copied
+  * when several connections are mixed into the same input or output.
+  *
+  * The graph takes ownership of the synchronization of its filters: when a filter is
+  * added, its own per-filter mutex is disabled and the graph's mutex is locked once
+  * per frame instead. Filter parameters should therefore only be changed between frames
+  * or while the graph is locked with lock(). Removing the filter from the graph
+  * restores its previous synchronization setting. The graph doesn't own the memory
+  * for its filters.
+  */
+class FilterGraph : public SoundFilter
+{
+	public:
+		
+		//********************************************************************************
+		//******	Constructors
+			
+			
+			/// Create a new empty filter graph with 1 input and 1 output.
+			FilterGraph();
+			
+			
+			/// Create a new empty filter graph with the specified number of inputs and outputs.
+			FilterGraph( Size numInputs, Size numOutputs );
+			
+			
+		//********************************************************************************
+		//******	Destructor
+			
+			
+			/// Destroy this filter graph, restoring the synchronization of its filters.
+			~FilterGraph();
+			
+			
+		//********************************************************************************
+		//******	Filter Accessor Methods
+			
+			
+			/// Return the number of filters that are part of this filter graph.
+			OM_INLINE Size getFilterCount() const
+			{
+				return nodes.getSize();
+			}
+			
+			
+			/// Return a pointer to the filter at the specified index in this filter graph.
+			OM_INLINE SoundFilter* getFilter( Index filterIndex ) const
+			{
+				return nodes[filterIndex].filter;
+			}
+			
+			
+			/// Return whether or not this filter graph contains the specified filter.
+			Bool hasFilter( const SoundFilter* filter ) const;
+			
+			
+			/// Add a new filter to this filter graph.
+			/**
+			  * The method returns whether or not the filter was able to be added.
+			  * The method fails if the filter is NULL, is this graph, or is already
+			  * part of the graph.
+			  */
+			Bool addFilter( SoundFilter* filter );
+			
+			
+			/// Remove the specified filter and all of its connections from this filter graph.
+			/**
+			  * The method returns whether or not the filter was part of the graph.
+			  */
+			Bool removeFilter( SoundFilter* filter );
+			
+			
+			/// Remove all filters and connections from this filter graph.
+			void clearFilters();
+			
+			
+		//********************************************************************************
+		//******	Connection Accessor Methods
+			
+			
+			/// Return the total number of connections in this filter graph.
+			OM_INLINE Size getConnectionCount() const
+			{
+				return connections.getSize();
+			}
+			
+			
+			/// Connect an output of one filter in the graph to an input of another filter in the graph.
+			/**
+			  * If several connections go to the same input, they are mixed together.
+			  * The method returns whether or not the connection was able to be made.
+			  * It fails if either filter is not in the graph, if either index is out of
+			  * range, or if the connection already exists. Connections that create a
+			  * cycle are accepted, but the graph will fail to process until the cycle is removed.
+			  */
+			Bool connect( SoundFilter* source, Index sourceOutputIndex, SoundFilter* destination, Index destinationInputIndex );
+			
+			
+			/// Connect an input of this filter graph to an input of a filter in the graph.
+			Bool connectInput( Index graphInputIndex, SoundFilter* destination, Index destinationInputIndex );
+			
+			
+			/// Connect an output of a filter in the graph to an output of this filter graph.
+			Bool connectOutput( SoundFilter* source, Index sourceOutputIndex, Index graphOutputIndex );
+			
+			
+			/// Connect an input of this filter graph directly to an output of this filter graph.
+			Bool connectInputToOutput( Index graphInputIndex, Index graphOutputIndex );
+			
+			
+			/// Remove the connection between the specified filter output and filter input.
+			Bool disconnect( SoundFilter* source, Index sourceOutputIndex, SoundFilter* destination, Index destinationInputIndex );
+			
+			
+			/// Remove the connection between the specified graph input and filter input.
+			Bool disconnectInput( Index graphInputIndex, SoundFilter* destination, Index destinationInputIndex );
+			
+			
+			/// Remove the connection between the specified filter output and graph output.
+			Bool disconnectOutput( SoundFilter* source, Index sourceOutputIndex, Index graphOutputIndex );
+			
+			
+			/// Remove the connection between the specified graph input and graph output.
+			Bool disconnectInputFromOutput( Index graphInputIndex, Index graphOutputIndex );
+			
+			
+			/// Remove all connections from this filter graph, leaving its filters.
+			void clearConnections();
+			
+			
+		//********************************************************************************
+		//******	Graph Validity Accessor Method
+			
+			
+			/// Return whether or not this filter graph is acyclic and can be processed.
+			Bool isValid() const;
+			
+			
+		//********************************************************************************
+		//******	Thread Count Accessor Methods
+			
+			
+			/// Return the number of worker threads that this graph uses to process independent filters.
+			OM_INLINE Size getThreadCount() const
+			{
+				return threadPool.getThreadCount();
+			}
+			
+			
+			/// Set the number of worker threads that this graph uses to process independent filters.
+			/**
+			  * If the thread count is 0 (the default), all filters are processed serially
+			  * on the thread that is processing the graph. Otherwise, filters in the same
+			  * level of the schedule are spread across the calling thread and the worker threads.
+			  */
+			void setThreadCount( Size newNumThreads );
+			
+			
+		//********************************************************************************
+		//******	Graph Lock Methods
+			
+			
+			/// Lock this filter graph so that the parameters of its filters can be safely modified.
+			/**
+			  * Every call to this method should be paired with a call to unlock().
+			  */
+			OM_INLINE void lock() const
+			{
+				this->lockMutex();
+			}
+			
+			
+			/// Release the lock on this filter graph that was acquired with lock().
+			OM_INLINE void unlock() const
+			{
+				this->unlockMutex();
+			}
+			
+			
+		//********************************************************************************
+		//******	Filter Attribute Accessor Methods
+			
+			
+			/// Return a human-readable name for this filter graph.
+			virtual UTF8String getName() const;
+			
+			
+			/// Return the manufacturer name of this filter graph.
+			virtual UTF8String getManufacturer() const;
+			
+			
+			/// Return an object representing the version of this filter graph.
+			virtual FilterVersion getVersion() const;
+			
+			
+			/// Return an object that describes the category of effect that this filter implements.
+			/**
+			  * This method returns the value FilterCategory::ROUTING.
+			  */
+			virtual FilterCategory getCategory() const;
+			
+			
+			/// Return the latency of the longest path from an input of this graph to one of its outputs.
+			virtual Time getLatency() const;
+			
+			
+		//********************************************************************************
+		//******	Public Static Property Objects
+			
+			
+			/// A string indicating the human-readable name of this filter graph.
+			static const UTF8String NAME;
+			
+			
+			/// A string indicating the manufacturer name of this filter graph.
+			static const UTF8String MANUFACTURER;
+			
+			
+			/// An object indicating the version of this filter graph.
+			static const FilterVersion VERSION;
+			
+			
+	private:
+		
+		//********************************************************************************
+		//******	Private Class Declarations
+			
+			
+			/// A class which represents a connection between two ports in the graph.
+			class Connection
+			{
+				public:
+					
+					OM_INLINE Connection( Index newSourceNode, Index newSourceOutput,
+										Index newDestinationNode, Index newDestinationInput )
+						:	sourceNode( newSourceNode ),
+							sourceOutput( newSourceOutput ),
+							destinationNode( newDestinationNode ),
+							destinationInput( newDestinationInput )
+					{
+					}
+					
+					OM_INLINE Bool operator == ( const Connection& other ) const
+					{
+						return sourceNode == other.sourceNode && sourceOutput == other.sourceOutput &&
+								destinationNode == other.destinationNode && destinationInput == other.destinationInput;
+					}
+					
+					/// The index of the node which produces the audio, or GRAPH_NODE for a graph input.
+					Index sourceNode;
+					
+					/// The index of the output of the source node, or the index of the graph input.
+					Index sourceOutput;
+					
+					/// The index of the node which consumes the audio, or GRAPH_NODE for a graph output.
+					Index destinationNode;
+					
+					/// The index of the input of the destination node, or the index of the graph output.
+					Index destinationInput;
+					
+			};
+			
+			
+			/// A class which represents a buffer that is used to pass audio between filters.
+			class Slot
+			{
+				public:
+					
+					/// An enum of the different kinds of buffer slots.
+					enum Type
+					{
+						/// A slot whose buffer is owned by the graph.
+						INTERNAL,
+						
+						/// A read-only slot whose buffer is one of the graph's input buffers.
+						INPUT,
+						
+						/// A slot whose buffer is one of the graph's output buffers.
+						OUTPUT
+					};
+					
+					OM_INLINE Slot( Type newType, Index newExternalIndex, SoundBuffer* newStorage )
+						:	buffer( newStorage ),
+							storage( newStorage ),
+							type( newType ),
+							externalIndex( newExternalIndex ),
+							lastUse( 0 ),
+							numLastUseReaders( 0 )
+					{
+					}
+					
+					/// The buffer that is bound to this slot for the current frame.
+					SoundBuffer* buffer;
+					
+					/// A buffer owned by the graph which backs this slot if there is no external buffer.
+					SoundBuffer* storage;
+					
+					/// The kind of slot that this is.
+					Type type;
+					
+					/// The index of the graph input or output for an external slot.
+					Index externalIndex;
+					
+					/// The last schedule level at which the current contents of this slot are read.
+					Index lastUse;
+					
+					/// The number of reads of this slot's current contents at its last use level.
+					Size numLastUseReaders;
+					
+			};
+			
+			
+			/// A class which stores how an input of a filter is fed.
+			class NodeInput
+			{
+				public:
+					
+					OM_INLINE NodeInput()
+						:	slot( INVALID_SLOT )
+					{
+					}
+					
+					/// The slot which is passed to the filter for this input, or INVALID_SLOT if there is none.
+					Index slot;
+					
+					/// The slots which are mixed into the input slot if there is more than one connection.
+					ArrayList<Index> mixSlots;
+					
+			};
+			
+			
+			/// A class which stores information about a filter that is part of the graph.
+			class Node
+			{
+				public:
+					
+					OM_INLINE Node( SoundFilter* newFilter )
+						:	filter( newFilter ),
+							wasSynchronized( newFilter->getIsSynchronized() ),
+							result( SoundResult::SUCCESS )
+					{
+					}
+					
+					/// A pointer to the filter for this node.
+					SoundFilter* filter;
+					
+					/// Whether or not the filter was synchronized before it was added to the graph.
+					Bool wasSynchronized;
+					
+					/// Information about how each of the filter's inputs is fed.
+					ArrayList<NodeInput> inputs;
+					
+					/// The slot that each of the filter's outputs is written to.
+					ArrayList<Index> outputSlots;
+					
+					/// The input frame that is passed to the filter.
+					SoundFrame inputFrame;
+					
+					/// The output frame that is passed to the filter.
+					SoundFrame outputFrame;
+					
+					/// The result of the most recent frame that the filter processed.
+					SoundResult result;
+					
+			};
+			
+			
+			/// A class which stores how an output of the graph is produced.
+			class GraphOutput
+			{
+				public:
+					
+					OM_INLINE GraphOutput()
+						:	slot( INVALID_SLOT )
+					{
+					}
+					
+					/// The OUTPUT slot that a filter writes to directly, or INVALID_SLOT if the output is mixed.
+					Index slot;
+					
+					/// The slots which are mixed into this graph output if it is not written directly.
+					ArrayList<Index> mixSlots;
+					
+			};
+			
+			
+		//********************************************************************************
+		//******	Private Stream Reset Method
+			
+			
+			/// Reset the streams of all of the filters in this graph.
+			virtual void resetStream();
+			
+			
+		//********************************************************************************
+		//******	Private Filter Processing Methods
+			
+			
+			/// Process all of the filters in this graph for the specified input and output frames.
+			virtual SoundResult processFrame( const SoundFrame& inputFrame,
+													SoundFrame& outputFrame, Size numSamples );
+			
+			
+			/// Mix the inputs of a node if necessary and process its filter.
+			void processNode( Node& node, Size numSamples );
+			
+			
+		//********************************************************************************
+		//******	Private Graph Compilation Methods
+			
+			
+			/// Compute the schedule, buffer assignments, and frames used to process the graph.
+			/**
+			  * The method returns FALSE if the graph contains a cycle.
+			  */
+			Bool compile();
+			
+			
+			/// Sort the nodes in the graph into levels which can be processed in order.
+			/**
+			  * The nodes are placed in the output order sorted by level, and the level
+			  * of each node is placed in the levels list. The method returns FALSE
+			  * if the graph contains a cycle.
+			  */
+			Bool sortNodes( ArrayList<Index>& order, ArrayList<Index>& levels ) const;
+			
+			
+			/// Return the index of a free internal slot, creating a new one if necessary.
+			Index allocateSlot( ArrayList<Index>& freeSlots, Size& numStorageBuffers );
+			
+			
+			/// Extend the lifetime of a slot to include every reader of the specified port.
+			void addSlotReaders( Slot& slot, Index sourceNode, Index sourceOutput,
+								const ArrayList<Index>& levels ) const;
+			
+			
+			/// Return the slot that contains the audio from the specified port.
+			OM_INLINE Index getSourceSlot( const Connection& connection ) const
+			{
+				if ( connection.sourceNode == GRAPH_NODE )
+					return connection.sourceOutput;
+				
+				return nodes[connection.sourceNode].outputSlots[connection.sourceOutput];
+			}
+			
+			
+			/// Return the index of the node for the specified filter, or GRAPH_NODE if it is not part of the graph.
+			Index getNodeIndex( const SoundFilter* filter ) const;
+			
+			
+			/// Add a new connection if it doesn't already exist.
+			Bool addConnection( const Connection& connection );
+			
+			
+			/// Remove an existing connection.
+			Bool removeConnection( const Connection& connection );
+			
+			
+		//********************************************************************************
+		//******	Private Static Data Members
+			
+			
+			/// The node index that refers to the graph's own inputs or outputs.
+			static const Index GRAPH_NODE = Index(-1);
+			
+			
+			/// The slot index that indicates there is no slot.
+			static const Index INVALID_SLOT = Index(-1);
+			
+			
+			/// The level index which indicates that a slot is read by a graph output after all levels.
+			static const Index OUTPUT_LEVEL = Index(-1);
+			
+			
+		//********************************************************************************
+		//******	Private Data Members
+			
+			
+			/// A list of the filters in this graph.
+			ArrayList<Node> nodes;
+			
+			
+			/// A list of the connections between filters in this graph.
+			ArrayList<Connection> connections;
+			
+			
+			/// The order in which the nodes are processed, sorted by level.
+			ArrayList<Index> schedule;
+			
+			
+			/// The index in the schedule of the first node in each level, followed by the total number of nodes.
+			ArrayList<Index> levelStarts;
+			
+			
+			/// The buffer slots that are used to pass audio between filters.
+			ArrayList<Slot> slots;
+			
+			
+			/// Information about how each of the graph outputs is produced.
+			ArrayList<GraphOutput> graphOutputs;
+			
+			
+			/// The buffers owned by this graph which back its internal slots.
+			ArrayList<SoundBuffer*> storageBuffers;
+			
+			
+			/// A thread pool which processes independent filters in parallel.
+			ThreadPool threadPool;
+			
+			
+			/// Whether or not the graph has changed since it was last compiled.
+			Bool needsCompile;
+			
+			
+			/// Whether or not the graph was acyclic when it was last compiled.
+			Bool compiledValid;
+			
+			
+			
+};
+
+
+
+
+//##########################################################################################
+//*************************  End Om Sound Filters Namespace  *******************************
+OM_SOUND_FILTERS_NAMESPACE_END
+//******************************************************************************************
+//##########################################################################################
+
+
+#endif // INCLUDE_OM_SOUND_FILTER_GRAPH_H
@@ -582,37 +582,63 @@ void Limiter:: limit( const SoundBuffer& inputBuffer, SoundBuffer& outputBuffer,
 	
 	if ( linkChannels )
 	{
+		// Get a temporary buffer that holds the linked envelope and then the gain for each sample.
+		SharedSoundBuffer sharedBuffer = SharedBufferPool::getGlobalBuffer( 1, numSamples, inputBuffer.getSampleRate() );
+		Sample32f* const gains = sharedBuffer.getBuffer().getChannel(0);
+		
+		om::util::zeroPOD( gains, numSamples );
+		
+		//****************************************************************************
+		// Update the envelope of each channel over the whole frame, keeping the maximum over all channels.
+		// Since the gain reduction increases monotonically with the envelope level, the channel with
+		// the highest envelope determines the linked gain reduction for each sample.
+		
+		for ( Index c = 0; c < numChannels; c++ )
+		{
+			const Sample32f* const input = inputBuffer.getChannel(c);
+			Float e = envelope[c];
+			Gain currentInputGain = inputGain;
+			
+			for ( Index i = 0; i < numSamples; i++ )
+			{
+				// Compute the level for this sample.
+				Float level = math::abs( input[i]*currentInputGain );
+				
+				// Update the envelope level for this sample.
+				if ( level > e )
+					e = level + envelopeAttack*(e - level);
+				else
+					e = level + envelopeRelease*(e - level);
+				
+				gains[i] = math::max( gains[i], e );
+				
+				if ( interpolateChanges )
+					currentInputGain += inputGainChangePerSample;
+			}
+			
+			envelope[c] = e;
+		}
+		
+		//****************************************************************************
+		// Compute the gain that is applied to all channels for each sample.
+		
 		Gain currentInputGain = inputGain;
-		Gain currentOutputGain = outputGain;
 		Gain currentThreshold = threshold;
 		Gain currentKnee = knee;
-		Gain currentSaturationKnee = saturationKnee;
 		
 		// Temporary variables that help apply the knee and gain reduction.
 		Gain linearKnee, kneeMin, kneeMax;
 		
-		// Declare dependent saturation parameters.
-		Gain linearSaturationKnee, saturationThreshold, inverseSaturationHardness,
-			saturationHardness, saturationOffset;
-		
 		if ( !interpolateChanges )
 		{
 			// Compute the minimum and maximum knee thresholds on a linear scale.
 			linearKnee = math::dbToLinear( currentKnee );
 			kneeMin = currentThreshold/linearKnee;
 			kneeMax = currentThreshold*linearKnee;
-			
-			linearSaturationKnee = math::dbToLinear( currentSaturationKnee );
-			saturationThreshold = 1 / linearSaturationKnee;
-			inverseSaturationHardness = Gain(1) - saturationThreshold;
-			saturationHardness = Gain(1) / inverseSaturationHardness;
-			saturationOffset = saturationHardness*saturationThreshold;
 		}
 		
 		for ( Index i = 0; i < numSamples; i++ )
 		{
-			Gain maxReduction = 0;
-			
 			// Recompute the knee constants for this sample.
 			if ( interpolateChanges )
 			{
@@ -620,59 +646,84 @@ void Limiter:: limit( const SoundBuffer& inputBuffer, SoundBuffer& outputBuffer,
 				linearKnee = math::dbToLinear( currentKnee );
 				kneeMin = currentThreshold/linearKnee;
 				kneeMax = currentThreshold*linearKnee;
-				
-				linearSaturationKnee = math::dbToLinear( currentSaturationKnee );
-				saturationThreshold = 1 / linearSaturationKnee;
-				inverseSaturationHardness = Gain(1) - saturationThreshold;
-				saturationHardness = Gain(1) / inverseSaturationHardness;
-				saturationOffset = saturationHardness*saturationThreshold;
 			}
 			
-			// Find the highest amount of gain reduction for all channels.
-			for ( Index c = 0; c < numChannels; c++ )
-			{
-				Float inputSample = inputBuffer.getChannel(c)[i]*currentInputGain;
-				
-				// Compute the level for this sample.
-				Float level = math::abs( inputSample );
-				Float& e = envelope[c];
-				
-				// Update the envelope level for this sample.
-				if ( level > e )
-					e = level + envelopeAttack*(e - level);
-				else
-					e = level + envelopeRelease*(e - level);
-				
-				//****************************************************************************
-				
-				// Detect if the envelope is over the threshold, and if so, apply gain reduction.
-				if ( e > kneeMin )
-				{
-					// Compute the reduction for this channel.
-					Gain dbReduction = getDBReduction( e, currentThreshold, kneeMin, kneeMax, currentKnee );
-					
-					// Find the largest (most negative) reduction amount.
-					maxReduction = math::min( maxReduction, dbReduction );
-				}
-			}
+			const Float e = gains[i];
+			Gain maxReduction = 0;
 			
-			//****************************************************************************
-			// Compute the output for this sample.
+			// Detect if the envelope is over the threshold, and if so, apply gain reduction.
+			if ( e > kneeMin )
+				maxReduction = math::min( getDBReduction( e, currentThreshold, kneeMin, kneeMax, currentKnee ), Gain(0) );
 			
 			// Add the current reduction in dB to the total reduction.
 			reductionTotal += maxReduction;
 			numReductionSamples++;
 			
 			// Compute the final gain which should be applied to all channels.
-			Gain finalGain = math::dbToLinear( maxReduction );
+			gains[i] = currentInputGain*math::dbToLinear( maxReduction );
 			
-			// Apply the final gain to all channels.
-			for ( Index c = 0; c < numChannels; c++ )
+			// Update the current state for interpolated parameters.
+			if ( interpolateChanges )
 			{
-				Float outputSample = inputBuffer.getChannel(c)[i]*inputGain*finalGain;
+				currentInputGain += inputGainChangePerSample;
+				currentThreshold += thresholdChangePerSample;
+				currentKnee += kneeChangePerSample;
+			}
+		}
+		
+		//****************************************************************************
+		// Apply the linked gain and output saturation to each channel.
+		
+		Gain currentOutputGain = outputGain;
+		Gain currentSaturationKnee = saturationKnee;
+		
+		// Declare dependent saturation parameters.
+		Gain linearSaturationKnee, saturationThreshold, inverseSaturationHardness,
+			saturationHardness, saturationOffset;
+		
+		if ( !interpolateChanges )
+		{
+			linearSaturationKnee = math::dbToLinear( currentSaturationKnee );
+			saturationThreshold = 1 / linearSaturationKnee;
+			inverseSaturationHardness = Gain(1) - saturationThreshold;
+			saturationHardness = Gain(1) / inverseSaturationHardness;
+			saturationOffset = saturationHardness*saturationThreshold;
+		}
+		
+		for ( Index c = 0; c < numChannels; c++ )
+		{
+			const Sample32f* const input = inputBuffer.getChannel(c);
+			Sample32f* const output = outputBuffer.getChannel(c);
+			
+			currentOutputGain = outputGain;
+			currentThreshold = threshold;
+			currentSaturationKnee = saturationKnee;
+			
+			if ( !saturationEnabled && !interpolateChanges )
+			{
+				// Fast path with no saturation and constant output gain.
+				for ( Index i = 0; i < numSamples; i++ )
+					output[i] = currentOutputGain*input[i]*gains[i];
+				
+				continue;
+			}
+			
+			for ( Index i = 0; i < numSamples; i++ )
+			{
+				Float outputSample = input[i]*gains[i];
 				
 				if ( saturationEnabled )
 				{
+					// Update dependent saturation parameters.
+					if ( interpolateChanges )
+					{
+						linearSaturationKnee = math::dbToLinear( currentSaturationKnee );
+						saturationThreshold = 1 / linearSaturationKnee;
+						inverseSaturationHardness = Gain(1) - saturationThreshold;
+						saturationHardness = Gain(1) / inverseSaturationHardness;
+						saturationOffset = saturationHardness*saturationThreshold;
+					}
+					
 					outputSample /= currentThreshold;
 					
 					if ( outputSample > saturationThreshold )
@@ -689,20 +740,15 @@ void Limiter:: limit( const SoundBuffer& inputBuffer, SoundBuffer& outputBuffer,
 					outputSample *= currentThreshold;
 				}
 				
-				outputBuffer.getChannel(c)[i] = currentOutputGain*outputSample;
-			}
-			
-			//****************************************************************************
-			// Increment values that need updating.
-			
-			// Update the current state for interpolated parameters.
-			if ( interpolateChanges )
-			{
-				currentInputGain += inputGainChangePerSample;
-				currentOutputGain += outputGainChangePerSample;
-				currentThreshold += thresholdChangePerSample;
-				currentKnee += kneeChangePerSample;
-				currentSaturationKnee += saturationKneeChangePerSample;
+				output[i] = currentOutputGain*outputSample;
+				
+				// Update the current state for interpolated parameters.
+				if ( interpolateChanges )
+				{
+					currentOutputGain += outputGainChangePerSample;
+					currentThreshold += thresholdChangePerSample;
+					currentSaturationKnee += saturationKneeChangePerSample;
+				}
 			}
 		}
 		
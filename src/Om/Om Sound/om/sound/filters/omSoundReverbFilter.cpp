@@ -746,6 +746,8 @@ void ReverbFilter:: processCombFilterNoChanges( const Sample32f* input, Sample32
 												Sample32f* const delayBufferStart, Sample32f* const delayBufferEnd,
 												Sample32f* delay, Gain feedbackGain )
 {
+	const Size simdWidth = math::SIMDFloat4::getWidth();
+	const math::SIMDFloat4 simdFeedbackGain( feedbackGain );
 	const Sample32f* const outputEnd = output + numSamples;
 	
 	while ( output < outputEnd )
@@ -753,19 +755,43 @@ void ReverbFilter:: processCombFilterNoChanges( const Sample32f* input, Sample32
 		if ( delay >= delayBufferEnd )
 			delay = delayBufferStart;
 		
-		// Compute the next output sample by combining the delay sample and input sample.
-		Sample32f newSample = *delay;
+		// Each delay sample is read and written only once before the delay pointer wraps around,
+		// so the samples up to the wrap point are independent and can be processed with SIMD.
+		const Size runLength = math::min( Size(outputEnd - output), Size(delayBufferEnd - delay) );
+		const Sample32f* const simdEnd = output + (runLength - runLength % simdWidth);
+		const Sample32f* const runEnd = output + runLength;
 		
-		// Compute the new delay value.
-		*delay = (*delay)*feedbackGain + *input;
-		
-		// Mix the output value.
-		*output += newSample;
+		while ( output < simdEnd )
+		{
+			const math::SIMDFloat4 delaySample = math::SIMDFloat4::loadUnaligned( delay );
+			
+			// Compute the new delay value.
+			(delaySample*simdFeedbackGain + math::SIMDFloat4::loadUnaligned( input )).storeUnaligned( delay );
+			
+			// Mix the output value.
+			(math::SIMDFloat4::loadUnaligned( output ) + delaySample).storeUnaligned( output );
+			
+			input += simdWidth;
+			output += simdWidth;
+			delay += simdWidth;
+		}
 		
-		// Increment the input, output, and delay pointers.
-		input++;
-		output++;
-		delay++;
+		while ( output < runEnd )
+		{
+			// Compute the next output sample by combining the delay sample and input sample.
+			Sample32f newSample = *delay;
+			
+			// Compute the new delay value.
+			*delay = (*delay)*feedbackGain + *input;
+			
+			// Mix the output value.
+			*output += newSample;
+			
+			// Increment the input, output, and delay pointers.
+			input++;
+			output++;
+			delay++;
+		}
 	}
 }
 
@@ -787,6 +813,8 @@ void ReverbFilter:: processAllPassFilterNoChanges( const Sample32f* input, Sampl
 													Sample32f* const delayBufferStart, Sample32f* const delayBufferEnd,
 													Sample32f* delay, Gain feedbackGain )
 {
+	const Size simdWidth = math::SIMDFloat4::getWidth();
+	const math::SIMDFloat4 simdFeedbackGain( feedbackGain );
 	const Sample32f* const outputEnd = output + numSamples;
 	
 	while ( output < outputEnd )
@@ -794,18 +822,43 @@ void ReverbFilter:: processAllPassFilterNoChanges( const Sample32f* input, Sampl
 		if ( delay >= delayBufferEnd )
 			delay = delayBufferStart;
 		
-		Sample32f delaySample = *delay;
+		// Process the independent samples up to the delay wrap point with SIMD.
+		// The input and output may alias, but each vector is loaded before it is stored.
+		const Size runLength = math::min( Size(outputEnd - output), Size(delayBufferEnd - delay) );
+		const Sample32f* const simdEnd = output + (runLength - runLength % simdWidth);
+		const Sample32f* const runEnd = output + runLength;
 		
-		// Compute the new delay value.
-		*delay = delaySample*feedbackGain + *input;
-		
-		// Compute the output sample.
-		*output = delaySample - (*delay)*feedbackGain;
+		while ( output < simdEnd )
+		{
+			const math::SIMDFloat4 delaySample = math::SIMDFloat4::loadUnaligned( delay );
+			
+			// Compute the new delay value.
+			const math::SIMDFloat4 newDelay = delaySample*simdFeedbackGain + math::SIMDFloat4::loadUnaligned( input );
+			newDelay.storeUnaligned( delay );
+			
+			// Compute the output sample.
+			(delaySample - newDelay*simdFeedbackGain).storeUnaligned( output );
+			
+			input += simdWidth;
+			output += simdWidth;
+			delay += simdWidth;
+		}
 		
-		// Increment the input, output, and delay pointers.
-		input++;
-		output++;
-		delay++;
+		while ( output < runEnd )
+		{
+			Sample32f delaySample = *delay;
+			
+			// Compute the new delay value.
+			*delay = delaySample*feedbackGain + *input;
+			
+			// Compute the output sample.
+			*output = delaySample - (*delay)*feedbackGain;
+			
+			// Increment the input, output, and delay pointers.
+			input++;
+			output++;
+			delay++;
+		}
 	}
 }
 
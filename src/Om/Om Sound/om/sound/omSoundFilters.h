@@ -49,6 +49,10 @@
 #include "filters/omSoundFilter.h"
 
 
+// Filter Graphs
+#include "filters/omSoundFilterGraph.h"
+
+
 // Equalization Filters
 #include "filters/omSoundCutoffFilter.h"
 